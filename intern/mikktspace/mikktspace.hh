@@ -198,19 +198,24 @@ template<typename Mesh> class Mikktspace {
       degenEpilogue();
     }
 
-    uint index = 0;
-    for (uint f = 0; f < nrFaces; f++) {
-      const uint verts = mesh.GetNumVerticesOfFace(f);
-      if (verts != 3 && verts != 4) {
-        continue;
-      }
+    // find the first TSpace of every face, so that faces can be written independently
+    std::vector<uint> faceTSpaceIdx(nrFaces, UNSET_ENTRY);
+    for (const Triangle &triangle : triangles) {
+      faceTSpaceIdx[triangle.faceIdx] = triangle.tSpaceIdx;
+    }
 
-      // set data
+    // set data
+    runParallel(0u, nrFaces, [&](uint f) {
+      const uint index = faceTSpaceIdx[f];
+      if (index == UNSET_ENTRY) {
+        return;
+      }
+      const uint verts = mesh.GetNumVerticesOfFace(f);
       for (uint i = 0; i < verts; i++) {
-        const TSpace &tSpace = tSpaces[index++];
+        const TSpace &tSpace = tSpaces[index + i];
         mesh.SetTangentSpace(f, i, tSpace.tangent, tSpace.orientPreserving);
       }
-    }
+    });
   }
 
  protected:
@@ -808,10 +813,7 @@ template<typename Mesh> class Mikktspace {
       }
     }
 
-    /* TODO: Worth parallelizing? Probably not. */
-    for (Group &group : groups) {
-      group.normalizeTSpace();
-    }
+    runParallel(0u, uint(groups.size()), [&](uint g) { groups[g].normalizeTSpace(); });
 
     tSpaces.resize(nrTSpaces);
 
@@ -4,6 +4,41 @@
  *
  * Author: Sergey Sharybin. */
 
+#include "internal/evaluator/eval_output_cpu.h"
+
+#include "BLI_task.hh"
+
 namespace blender::opensubdiv {
 
+bool ParallelCpuEvaluator::EvalStencils(const float *src,
+                                        const BufferDescriptor &src_desc,
+                                        float *dst,
+                                        const BufferDescriptor &dst_desc,
+                                        const int *sizes,
+                                        const int *offsets,
+                                        const int *indices,
+                                        const float *weights,
+                                        const int num_stencils)
+{
+  threading::parallel_for(IndexRange(num_stencils), 1024, [&](const IndexRange range) {
+    // Evaluate the range as if it was a complete stencil table starting at its first stencil. The
+    // serial kernel doesn't offset the destination by the start of the range on all code paths.
+    const int start = int(range.start());
+    const int weights_start = offsets[start];
+    BufferDescriptor range_dst_desc = dst_desc;
+    range_dst_desc.offset += start * dst_desc.stride;
+    CpuEvaluator::EvalStencils(src,
+                               src_desc,
+                               dst,
+                               range_dst_desc,
+                               sizes + start,
+                               offsets + start,
+                               indices + weights_start,
+                               weights + weights_start,
+                               0,
+                               int(range.size()));
+  });
+  return true;
+}
+
 }  // namespace blender::opensubdiv
@@ -19,13 +19,55 @@ using OpenSubdiv::Osd::CpuVertexBuffer;
 
 namespace blender::opensubdiv {
 
+// Same as CpuEvaluator, but evaluates stencils from multiple threads.
+//
+// The stencils are factorized, so every stencil only reads the coarse control vertices and writes
+// its own refined vertex, which makes ranges of stencils independent. Patches are still evaluated
+// by the base class, they are queried a few coordinates at a time by callers which are threaded
+// already.
+class ParallelCpuEvaluator : public CpuEvaluator {
+ public:
+  template<typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+  static bool EvalStencils(SRC_BUFFER *src_buffer,
+                           const BufferDescriptor &src_desc,
+                           DST_BUFFER *dst_buffer,
+                           const BufferDescriptor &dst_desc,
+                           const STENCIL_TABLE *stencil_table,
+                           const ParallelCpuEvaluator * /*instance*/ = nullptr,
+                           void * /*device_context*/ = nullptr)
+  {
+    if (stencil_table->GetNumStencils() == 0) {
+      return false;
+    }
+    return EvalStencils(src_buffer->BindCpuBuffer(),
+                        src_desc,
+                        dst_buffer->BindCpuBuffer(),
+                        dst_desc,
+                        &stencil_table->GetSizes()[0],
+                        &stencil_table->GetOffsets()[0],
+                        &stencil_table->GetControlIndices()[0],
+                        &stencil_table->GetWeights()[0],
+                        stencil_table->GetNumStencils());
+  }
+
+  static bool EvalStencils(const float *src,
+                           const BufferDescriptor &src_desc,
+                           float *dst,
+                           const BufferDescriptor &dst_desc,
+                           const int *sizes,
+                           const int *offsets,
+                           const int *indices,
+                           const float *weights,
+                           int num_stencils);
+};
+
 // NOTE: Define as a class instead of typedef to make it possible
 // to have anonymous class in opensubdiv_evaluator_internal.h
 class CpuEvalOutput : public VolatileEvalOutput<CpuVertexBuffer,
                                                 CpuVertexBuffer,
                                                 StencilTable,
                                                 CpuPatchTable,
-                                                CpuEvaluator> {
+                                                ParallelCpuEvaluator> {
  public:
   CpuEvalOutput(const StencilTable *vertex_stencils,
                 const StencilTable *varying_stencils,
@@ -37,7 +79,7 @@ class CpuEvalOutput : public VolatileEvalOutput<CpuVertexBuffer,
                            CpuVertexBuffer,
                            StencilTable,
                            CpuPatchTable,
-                           CpuEvaluator>(vertex_stencils,
+                           ParallelCpuEvaluator>(vertex_stencils,
                                          varying_stencils,
                                          all_face_varying_stencils,
                                          face_varying_width,
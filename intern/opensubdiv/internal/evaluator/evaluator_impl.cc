@@ -5,6 +5,7 @@
  * Author: Sergey Sharybin. */
 
 #include <cassert>
+#include <memory>
 
 #ifdef _MSC_VER
 #  include <iso646.h>
@@ -421,10 +422,27 @@ OpenSubdiv_Evaluator::~OpenSubdiv_Evaluator()
   delete patch_table;
 }
 
-OpenSubdiv_Evaluator *openSubdiv_createEvaluatorFromTopologyRefiner(
-    blender::opensubdiv::TopologyRefinerImpl *topology_refiner,
-    eOpenSubdivEvaluator evaluator_type,
-    OpenSubdiv_EvaluatorCache *evaluator_cache_descr)
+namespace blender::opensubdiv {
+
+// Work around ASAN warnings, due to OpenSubdiv pretending to have an actual StencilTable
+// instance while it's really its base class.
+static void delete_stencil_table(const StencilTable *table)
+{
+  static_assert(std::is_base_of_v<StencilTableReal<float>, StencilTable>);
+  delete reinterpret_cast<const StencilTableReal<float> *>(table);
+}
+
+static size_t stencil_table_memory_size(const StencilTable *table)
+{
+  if (table == nullptr) {
+    return 0;
+  }
+  return table->GetSizes().size() * sizeof(int) + table->GetOffsets().size() * sizeof(int) +
+         table->GetControlIndices().size() * sizeof(int) +
+         table->GetWeights().size() * sizeof(float);
+}
+
+EvaluatorTables *EvaluatorTables::create(TopologyRefinerImpl *topology_refiner)
 {
   TopologyRefiner *refiner = topology_refiner->topology_refiner;
   if (refiner == nullptr) {
@@ -454,13 +472,6 @@ OpenSubdiv_Evaluator *openSubdiv_createEvaluatorFromTopologyRefiner(
     refiner->RefineUniform(options);
   }
 
-  // Work around ASAN warnings, due to OpenSubdiv pretending to have an actual StencilTable
-  // instance while it's really its base class.
-  auto delete_stencil_table = [](const StencilTable *table) {
-    static_assert(std::is_base_of_v<StencilTableReal<float>, StencilTable>);
-    delete reinterpret_cast<const StencilTableReal<float> *>(table);
-  };
-
   // Generate stencil table to update the bi-cubic patches control vertices
   // after they have been re-posed (both for vertex & varying interpolation).
   //
@@ -536,43 +547,106 @@ OpenSubdiv_Evaluator *openSubdiv_createEvaluatorFromTopologyRefiner(
       all_face_varying_stencils[face_varying_channel] = table;
     }
   }
+  EvaluatorTables *tables = new EvaluatorTables();
+  tables->vertex_stencils = vertex_stencils;
+  tables->varying_stencils = varying_stencils;
+  tables->all_face_varying_stencils = std::move(all_face_varying_stencils);
+  tables->patch_table = patch_table;
+  return tables;
+}
+
+EvaluatorTables::~EvaluatorTables()
+{
+  // TODO(sergey): Look into whether we've got duplicated stencils arrays.
+  delete_stencil_table(vertex_stencils);
+  delete_stencil_table(varying_stencils);
+  for (const StencilTable *table : all_face_varying_stencils) {
+    delete_stencil_table(table);
+  }
+  delete patch_table;
+}
+
+size_t EvaluatorTables::memory_size() const
+{
+  size_t size = stencil_table_memory_size(vertex_stencils) +
+                stencil_table_memory_size(varying_stencils);
+  for (const StencilTable *table : all_face_varying_stencils) {
+    size += stencil_table_memory_size(table);
+  }
+  if (patch_table != nullptr) {
+    size += patch_table->GetPatchControlVerticesTable().size() * sizeof(int) +
+            patch_table->GetPatchParamTable().size() * sizeof(OpenSubdiv::Far::PatchParam);
+  }
+  return size;
+}
+
+// Create the evaluator, which takes ownership of the patch table.
+static OpenSubdiv_Evaluator *create_evaluator(const EvaluatorTables &tables,
+                                              const PatchTable *patch_table,
+                                              eOpenSubdivEvaluator evaluator_type,
+                                              OpenSubdiv_EvaluatorCache *evaluator_cache_descr)
+{
   // Create OpenSubdiv's CPU side evaluator.
-  blender::opensubdiv::EvalOutputAPI::EvalOutput *eval_output = nullptr;
+  EvalOutputAPI::EvalOutput *eval_output = nullptr;
 
   const bool use_gpu_evaluator = evaluator_type == OPENSUBDIV_EVALUATOR_GPU;
   if (use_gpu_evaluator) {
-    blender::opensubdiv::GpuEvalOutput::EvaluatorCache *evaluator_cache = nullptr;
+    GpuEvalOutput::EvaluatorCache *evaluator_cache = nullptr;
     if (evaluator_cache_descr) {
-      evaluator_cache = static_cast<blender::opensubdiv::GpuEvalOutput::EvaluatorCache *>(
+      evaluator_cache = static_cast<GpuEvalOutput::EvaluatorCache *>(
           evaluator_cache_descr->impl->eval_cache);
     }
 
-    eval_output = new blender::opensubdiv::GpuEvalOutput(vertex_stencils,
-                                                         varying_stencils,
-                                                         all_face_varying_stencils,
-                                                         2,
-                                                         patch_table,
-                                                         evaluator_cache);
+    eval_output = new GpuEvalOutput(tables.vertex_stencils,
+                                    tables.varying_stencils,
+                                    tables.all_face_varying_stencils,
+                                    2,
+                                    patch_table,
+                                    evaluator_cache);
   }
   else {
-    eval_output = new blender::opensubdiv::CpuEvalOutput(
-        vertex_stencils, varying_stencils, all_face_varying_stencils, 2, patch_table);
+    eval_output = new CpuEvalOutput(tables.vertex_stencils,
+                                    tables.varying_stencils,
+                                    tables.all_face_varying_stencils,
+                                    2,
+                                    patch_table);
   }
 
-  blender::opensubdiv::PatchMap *patch_map = new blender::opensubdiv::PatchMap(*patch_table);
+  PatchMap *patch_map = new PatchMap(*patch_table);
   // Wrap everything we need into an object which we control from our side.
   OpenSubdiv_Evaluator *evaluator = new OpenSubdiv_Evaluator();
   evaluator->type = evaluator_type;
 
-  evaluator->eval_output = new blender::opensubdiv::EvalOutputAPI(eval_output, patch_map);
+  evaluator->eval_output = new EvalOutputAPI(eval_output, patch_map);
   evaluator->patch_map = patch_map;
   evaluator->patch_table = patch_table;
-  // TODO(sergey): Look into whether we've got duplicated stencils arrays.
-  delete_stencil_table(vertex_stencils);
-  delete_stencil_table(varying_stencils);
-  for (const StencilTable *table : all_face_varying_stencils) {
-    delete_stencil_table(table);
-  }
 
   return evaluator;
 }
+
+}  // namespace blender::opensubdiv
+
+OpenSubdiv_Evaluator *openSubdiv_createEvaluatorFromTopologyRefiner(
+    blender::opensubdiv::TopologyRefinerImpl *topology_refiner,
+    eOpenSubdivEvaluator evaluator_type,
+    OpenSubdiv_EvaluatorCache *evaluator_cache_descr)
+{
+  using namespace blender::opensubdiv;
+  std::unique_ptr<EvaluatorTables> tables(EvaluatorTables::create(topology_refiner));
+  if (!tables) {
+    return nullptr;
+  }
+  // The tables are only used once, pass the patch table on instead of copying it.
+  const PatchTable *patch_table = tables->patch_table;
+  tables->patch_table = nullptr;
+  return create_evaluator(*tables, patch_table, evaluator_type, evaluator_cache_descr);
+}
+
+OpenSubdiv_Evaluator *openSubdiv_createEvaluatorFromTables(
+    const blender::opensubdiv::EvaluatorTables &tables,
+    eOpenSubdivEvaluator evaluator_type,
+    OpenSubdiv_EvaluatorCache *evaluator_cache_descr)
+{
+  return blender::opensubdiv::create_evaluator(
+      tables, new PatchTable(*tables.patch_table), evaluator_type, evaluator_cache_descr);
+}
@@ -11,8 +11,11 @@
 #  include <iso646.h>
 #endif
 
+#include <vector>
+
 #include <opensubdiv/far/patchMap.h>
 #include <opensubdiv/far/patchTable.h>
+#include <opensubdiv/far/stencilTable.h>
 
 #include "opensubdiv_capi_type.hh"
 
@@ -178,6 +181,26 @@ class EvalOutputAPI {
   EvalOutput *implementation_;
 };
 
+// Stencil and patch tables of a refined topology. They only depend on the topology and the
+// refinement settings, so evaluators of all meshes with the same topology can be created from the
+// same tables.
+class EvaluatorTables {
+ public:
+  const OpenSubdiv::Far::StencilTable *vertex_stencils = nullptr;
+  const OpenSubdiv::Far::StencilTable *varying_stencils = nullptr;
+  std::vector<const OpenSubdiv::Far::StencilTable *> all_face_varying_stencils;
+  const OpenSubdiv::Far::PatchTable *patch_table = nullptr;
+
+  // Refine the topology and create the tables for it. The refiner is modified, and the tables
+  // don't reference it. Returns null on bad topology.
+  static EvaluatorTables *create(TopologyRefinerImpl *topology_refiner);
+
+  ~EvaluatorTables();
+
+  // Approximate size of the tables in bytes.
+  size_t memory_size() const;
+};
+
 }  // namespace blender::opensubdiv
 
 struct OpenSubdiv_Evaluator {
@@ -196,4 +219,11 @@ OpenSubdiv_Evaluator *openSubdiv_createEvaluatorFromTopologyRefiner(
     eOpenSubdivEvaluator evaluator_type,
     OpenSubdiv_EvaluatorCache *evaluator_cache_descr);
 
+// Create an evaluator from tables created for the same topology before. The tables are not
+// referenced by the evaluator.
+OpenSubdiv_Evaluator *openSubdiv_createEvaluatorFromTables(
+    const blender::opensubdiv::EvaluatorTables &tables,
+    eOpenSubdivEvaluator evaluator_type,
+    OpenSubdiv_EvaluatorCache *evaluator_cache_descr);
+
 #endif  // OPENSUBDIV_EVALUATOR_IMPL_H_
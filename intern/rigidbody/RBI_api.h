@@ -186,6 +186,12 @@ void RB_body_get_transform_matrix(rbRigidBody *object, float m_out[4][4]);
 
 /* Set RigidBody's location and rotation */
 void RB_body_set_loc_rot(rbRigidBody *object, const float loc[3], const float rot[4]);
+/* Set the location and rotation of many RigidBodies in one pass, and activate them so that the
+ * new transforms affect the simulation. */
+void RB_bodies_set_loc_rot(rbRigidBody **objects,
+                           int objects_num,
+                           const float (*locs)[3],
+                           const float (*rots)[4]);
 /* Set RigidBody's local scaling */
 void RB_body_set_scale(rbRigidBody *object, const float scale[3]);
 
@@ -195,6 +201,11 @@ void RB_body_set_scale(rbRigidBody *object, const float scale[3]);
 void RB_body_get_position(rbRigidBody *object, float v_out[3]);
 /* Get RigidBody's orientation as a quaternion */
 void RB_body_get_orientation(rbRigidBody *object, float v_out[4]);
+/* Get the positions and orientations of many RigidBodies in one pass */
+void RB_bodies_get_loc_rot(rbRigidBody **objects,
+                           int objects_num,
+                           float (*r_locs)[3],
+                           float (*r_rots)[4]);
 /* Get RigidBody's local scale as a vector */
 void RB_body_get_scale(rbRigidBody *object, float v_out[3]);
 
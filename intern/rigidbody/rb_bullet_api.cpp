@@ -597,6 +597,24 @@ void RB_body_set_loc_rot(rbRigidBody *object, const float loc[3], const float ro
   ms->setWorldTransform(trans);
 }
 
+void RB_bodies_set_loc_rot(rbRigidBody **objects,
+                           int objects_num,
+                           const float (*locs)[3],
+                           const float (*rots)[4])
+{
+  for (int i = 0; i < objects_num; i++) {
+    btRigidBody *body = objects[i]->body;
+    body->setActivationState(ACTIVE_TAG);
+
+    btTransform trans;
+    trans.setIdentity();
+    trans.setOrigin(btVector3(locs[i][0], locs[i][1], locs[i][2]));
+    trans.setRotation(btQuaternion(rots[i][1], rots[i][2], rots[i][3], rots[i][0]));
+
+    body->getMotionState()->setWorldTransform(trans);
+  }
+}
+
 void RB_body_set_scale(rbRigidBody *object, const float scale[3])
 {
   btRigidBody *body = object->body;
@@ -630,6 +648,18 @@ void RB_body_get_orientation(rbRigidBody *object, float v_out[4])
   copy_quat_btquat(v_out, body->getWorldTransform().getRotation());
 }
 
+void RB_bodies_get_loc_rot(rbRigidBody **objects,
+                           int objects_num,
+                           float (*r_locs)[3],
+                           float (*r_rots)[4])
+{
+  for (int i = 0; i < objects_num; i++) {
+    const btTransform &trans = objects[i]->body->getWorldTransform();
+    copy_v3_btvec3(r_locs[i], trans.getOrigin());
+    copy_quat_btquat(r_rots[i], trans.getRotation());
+  }
+}
+
 void RB_body_get_scale(rbRigidBody *object, float v_out[3])
 {
   btRigidBody *body = object->body;
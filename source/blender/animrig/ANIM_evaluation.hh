@@ -14,6 +14,10 @@
 
 #include "ANIM_action.hh"
 
+namespace blender::bke {
+class FCurveEvalPlan;
+}
+
 namespace blender::animrig {
 
 /* Identifies the property that an evaluated animation value is for.
@@ -66,8 +70,18 @@ class AnimatedProperty {
   float value;
   PathResolvedRNA prop_rna;
 
-  AnimatedProperty(const float value, const PathResolvedRNA &prop_rna)
-      : value(value), prop_rna(prop_rna)
+  /**
+   * Compiled plan (and index of the F-Curve in it) that produced the value, if any. Used to write
+   * the value to the original data-block without resolving the RNA path again.
+   */
+  bke::FCurveEvalPlan *eval_plan = nullptr;
+  int eval_plan_index = -1;
+
+  AnimatedProperty(const float value,
+                   const PathResolvedRNA &prop_rna,
+                   bke::FCurveEvalPlan *eval_plan = nullptr,
+                   const int eval_plan_index = -1)
+      : value(value), prop_rna(prop_rna), eval_plan(eval_plan), eval_plan_index(eval_plan_index)
   {
   }
 };
@@ -104,10 +118,12 @@ class EvaluationResult {
   void store(const StringRefNull rna_path,
              const int array_index,
              const float value,
-             const PathResolvedRNA &prop_rna)
+             const PathResolvedRNA &prop_rna,
+             bke::FCurveEvalPlan *eval_plan = nullptr,
+             const int eval_plan_index = -1)
   {
     PropIdentifier key(rna_path, array_index);
-    AnimatedProperty anim_prop(value, prop_rna);
+    AnimatedProperty anim_prop(value, prop_rna, eval_plan, eval_plan_index);
     result_.add_overwrite(key, anim_prop);
   }
 
@@ -4,6 +4,8 @@
 
 #include "ANIM_evaluation.hh"
 
+#include "BKE_anim_data.hh"
+#include "BKE_anim_eval_plan.hh"
 #include "BKE_animsys.h"
 #include "BKE_fcurve.hh"
 
@@ -150,8 +152,15 @@ static EvaluationResult evaluate_keyframe_data(PointerRNA &animated_id_ptr,
     return {};
   }
 
+  const Span<FCurve *> fcurves = channelbag_for_slot->fcurves();
+  AnimData *adt = BKE_animdata_from_id(animated_id_ptr.owner_id);
+  bke::FCurveEvalPlan *plan = adt ? bke::fcurve_eval_plan_ensure(
+                                        animated_id_ptr, *adt, channelbag_for_slot, fcurves) :
+                                    nullptr;
+
   EvaluationResult evaluation_result;
-  for (FCurve *fcu : channelbag_for_slot->fcurves()) {
+  for (const int i : fcurves.index_range()) {
+    FCurve *fcu = fcurves[i];
     /* Blatant copy of animsys_evaluate_fcurves(). */
 
     if (!is_fcurve_evaluatable(fcu)) {
@@ -159,9 +168,12 @@ static EvaluationResult evaluate_keyframe_data(PointerRNA &animated_id_ptr,
     }
 
     PathResolvedRNA anim_rna;
-    if (!BKE_animsys_rna_path_resolve(
-            &animated_id_ptr, fcu->rna_path, fcu->array_index, &anim_rna))
-    {
+    const bool is_resolved = plan ? plan->resolve(animated_id_ptr, i, anim_rna) :
+                                    BKE_animsys_rna_path_resolve(&animated_id_ptr,
+                                                                 fcu->rna_path,
+                                                                 fcu->array_index,
+                                                                 &anim_rna);
+    if (!is_resolved) {
       /* Log this at quite a high level, because it can get _very_ noisy when playing back
        * animation. */
       CLOG_INFO(&LOG,
@@ -173,6 +185,13 @@ static EvaluationResult evaluate_keyframe_data(PointerRNA &animated_id_ptr,
       continue;
     }
 
+    if (plan) {
+      const float curval = calculate_fcurve_with_segment_hint(
+          &anim_rna, fcu, &offset_eval_context, plan->targets[i].segment_hint);
+      evaluation_result.store(fcu->rna_path, fcu->array_index, curval, anim_rna, plan, i);
+      continue;
+    }
+
     const float curval = calculate_fcurve(&anim_rna, fcu, &offset_eval_context);
     evaluation_result.store(fcu->rna_path, fcu->array_index, curval, anim_rna);
   }
@@ -192,7 +211,10 @@ void apply_evaluation_result(const EvaluationResult &evaluation_result,
 
     BKE_animsys_write_to_rna_path(&anim_rna, animated_value);
 
-    if (flush_to_original) {
+    if (flush_to_original && anim_prop.eval_plan) {
+      anim_prop.eval_plan->write_orig(animated_id_ptr, anim_prop.eval_plan_index, animated_value);
+    }
+    else if (flush_to_original) {
       /* Convert the StringRef to a `const char *`, as the rest of the RNA path handling code in
        * BKE still uses `char *` instead of `StringRef`. */
       animsys_write_orig_anim_rna(&animated_id_ptr,
@@ -244,7 +266,9 @@ EvaluationResult blend_layer_results(const EvaluationResult &last_result,
       blend.store(prop_ident.rna_path,
                   prop_ident.array_index,
                   anim_prop.value * current_layer.influence,
-                  anim_prop.prop_rna);
+                  anim_prop.prop_rna,
+                  anim_prop.eval_plan,
+                  anim_prop.eval_plan_index);
       continue;
     }
 
@@ -3,10 +3,13 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
 #include "ANIM_action.hh"
+#include "ANIM_keyframing.hh"
 #include "ANIM_nla.hh"
 
 #include "BKE_action.hh"
 #include "BKE_anim_data.hh"
+#include "BKE_anim_eval_plan.hh"
+#include "BKE_animsys.h"
 #include "BKE_idtype.hh"
 #include "BKE_lib_id.hh"
 #include "BKE_main.hh"
@@ -171,4 +174,92 @@ TEST_F(NLASlottedActionTest, assign_slot_to_multiple_strips)
   EXPECT_FALSE(slot.runtime_users().contains(&cube->id));
 }
 
+/**
+ * Create an Action with a slot for the ID, with linearly interpolated keys on `location` at
+ * frame 1 and 11.
+ */
+static Action &action_with_location_keys(Main *bmain,
+                                         const ID &id,
+                                         const float3 &location_start,
+                                         const float3 &location_end)
+{
+  Action &action = BKE_id_new<bAction>(bmain, "Action")->wrap();
+  Slot &slot = action.slot_add_for_id(id);
+  action.layer_keystrip_ensure();
+  StripKeyframeData &strip_data = action.layer(0)->strip(0)->data<StripKeyframeData>(action);
+
+  KeyframeSettings settings = get_keyframe_settings(false);
+  settings.interpolation = BEZT_IPO_LIN;
+  for (const int axis : IndexRange(3)) {
+    strip_data.keyframe_insert(
+        bmain, slot, {"location", axis}, {1.0f, location_start[axis]}, settings);
+    strip_data.keyframe_insert(
+        bmain, slot, {"location", axis}, {11.0f, location_end[axis]}, settings);
+  }
+  return action;
+}
+
+static NlaStrip *nla_strip_add(AnimData *adt,
+                               ID &id,
+                               Action &action,
+                               const short blendmode,
+                               const float influence)
+{
+  NlaTrack *track = BKE_nlatrack_new_tail(&adt->nla_tracks, false);
+  NlaStrip *strip = BKE_nlastrip_new(&action, id);
+  EXPECT_TRUE(BKE_nlatrack_add_strip(track, strip, false));
+  /* Reassign the Action, so that its slot is picked for the ID. */
+  nla::unassign_action(*strip, id);
+  EXPECT_TRUE(nla::assign_action(*strip, action, id));
+  strip->blendmode = blendmode;
+  strip->influence = influence;
+  strip->flag |= NLASTRIP_FLAG_USR_INFLUENCE;
+  return strip;
+}
+
+TEST_F(NLASlottedActionTest, evaluate_blended_strips)
+{
+  AnimData *adt = BKE_animdata_ensure_id(&cube->id);
+
+  Action &action_base = action_with_location_keys(bmain, cube->id, {1, 2, 3}, {11, 12, 13});
+  Action &action_add = action_with_location_keys(bmain, cube->id, {10, 20, 30}, {20, 30, 40});
+  Action &action_multiply = action_with_location_keys(bmain, cube->id, {2, 2, 2}, {4, 4, 4});
+  Action &action_replace = action_with_location_keys(bmain, cube->id, {0, 0, 0}, {10, 10, 10});
+
+  nla_strip_add(adt, cube->id, action_base, NLASTRIP_MODE_REPLACE, 1.0f);
+  nla_strip_add(adt, cube->id, action_add, NLASTRIP_MODE_ADD, 0.5f);
+  nla_strip_add(adt, cube->id, action_multiply, NLASTRIP_MODE_MULTIPLY, 0.25f);
+  nla_strip_add(adt, cube->id, action_replace, NLASTRIP_MODE_REPLACE, 0.5f);
+
+  const auto expected_location = [](const float frame) {
+    const float factor = (frame - 1.0f) / 10.0f;
+    const float3 base = math::interpolate(float3(1, 2, 3), float3(11, 12, 13), factor);
+    const float3 add = math::interpolate(float3(10, 20, 30), float3(20, 30, 40), factor);
+    const float multiply = math::interpolate(2.0f, 4.0f, factor);
+    const float replace = math::interpolate(0.0f, 10.0f, factor);
+
+    float3 location = base + add * 0.5f;
+    location = location * multiply * 0.25f + location * 0.75f;
+    return location * 0.5f + float3(replace) * 0.5f;
+  };
+
+  /* Evaluate both the original data-block and (by tagging it) an evaluated copy, which keeps
+   * its NLA channels for the next evaluation. */
+  for (const bool is_evaluated_copy : {false, true}) {
+    SCOPED_TRACE(is_evaluated_copy ? "evaluated copy" : "original");
+    SET_FLAG_FROM_TEST(cube->id.tag, is_evaluated_copy, ID_TAG_COPIED_ON_EVAL);
+
+    for (const float frame : {1.0f, 4.0f, 7.5f, 11.0f, 4.0f}) {
+      const AnimationEvalContext anim_eval_context = BKE_animsys_eval_context_construct(nullptr,
+                                                                                         frame);
+      BKE_animsys_evaluate_animdata(&cube->id, adt, &anim_eval_context, ADT_RECALC_ANIM, false);
+      EXPECT_V3_NEAR(float3(cube->loc), expected_location(frame), 1e-5f);
+    }
+
+    EXPECT_EQ(adt->runtime != nullptr && adt->runtime->nla_eval_data != nullptr,
+              is_evaluated_copy);
+  }
+  cube->id.tag &= ~ID_TAG_COPIED_ON_EVAL;
+}
+
 }  // namespace blender::animrig::nla::tests
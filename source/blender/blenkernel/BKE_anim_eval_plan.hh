@@ -0,0 +1,121 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup bke
+ *
+ * Compiled evaluation plans for F-Curves.
+ *
+ * Evaluating an animated data-block resolves the RNA path of every F-Curve on every frame, and
+ * searches the keyframe array for the segment containing the current frame. For rigs with
+ * thousands of animated bones this dominates the playback time. A plan caches the resolved
+ * properties of a list of F-Curves on one evaluated data-block, together with the keyframe
+ * segment used by the previous evaluation.
+ *
+ * Only properties that are stored on the animated ID itself or on its pose channels are cached,
+ * as pointers to those stay valid for the lifetime of the evaluated copy. Plans are discarded
+ * when the evaluated copy is updated, and all of them are invalidated when an Action is copied or
+ * a pose channel is freed (see #eval_plans_tag_outdated). Other properties are resolved on every
+ * evaluation like before.
+ *
+ * The NLA channels of a data-block are kept under the same conditions, so that the NLA stack
+ * doesn't have to resolve and hash the paths of all its F-Curves on every frame.
+ */
+
+#include <memory>
+
+#include "BLI_array.hh"
+#include "BLI_map.hh"
+#include "BLI_span.hh"
+
+#include "RNA_types.hh"
+
+struct AnimData;
+struct FCurve;
+struct NlaEvalData;
+
+namespace blender::bke {
+
+/** Write target of a single F-Curve in a #FCurveEvalPlan. */
+struct FCurveEvalTarget {
+  /** Property on the evaluated data-block, only valid when #is_cached is set. */
+  PathResolvedRNA anim_rna;
+  /** Property on the original data-block, only valid when #is_orig_cached is set. */
+  PathResolvedRNA orig_anim_rna;
+  bool is_cached = false;
+  bool is_orig_resolved = false;
+  bool is_orig_cached = false;
+  /** Keyframe segment of the last evaluation, see #calculate_fcurve_with_segment_hint. */
+  int segment_hint = 0;
+};
+
+/**
+ * Pre-resolved write targets for a list of F-Curves evaluated on one data-block. The F-Curves are
+ * owned by an evaluated Action, the plan only stores them to detect changes.
+ */
+class FCurveEvalPlan {
+ public:
+  Array<FCurve *> fcurves;
+  Array<FCurveEvalTarget> targets;
+
+  /**
+   * Resolve the property animated by the F-Curve with the given index, using the cached
+   * resolution when possible.
+   */
+  bool resolve(PointerRNA &id_ptr, int index, PathResolvedRNA &r_anim_rna) const;
+
+  /**
+   * Write the value to the original data-block, like #BKE_animsys_write_to_rna_path does for the
+   * evaluated one. The original property is resolved on first use.
+   */
+  void write_orig(PointerRNA &id_ptr, int index, float value);
+};
+
+/** Runtime data of #AnimData, only allocated for evaluated copies. */
+class AnimDataRuntime {
+ public:
+  /** Value of the global plan generation at the time the plans were built. */
+  uint64_t eval_plans_generation = 0;
+  /** Plans keyed by the container of the F-Curves (legacy Action or layered Channelbag). */
+  Map<const void *, std::unique_ptr<FCurveEvalPlan>> eval_plans;
+  /** NLA channels of the previous evaluation, may be null. */
+  NlaEvalData *nla_eval_data = nullptr;
+
+  ~AnimDataRuntime();
+
+  /** Discard all cached data. */
+  void clear();
+};
+
+/**
+ * Get the runtime data of the #AnimData, discarding cached data that may be outdated. Returns null
+ * when nothing can be cached for this data-block, e.g. because it is not an evaluated copy.
+ */
+AnimDataRuntime *animdata_runtime_ensure(PointerRNA &id_ptr, AnimData &adt);
+
+/**
+ * Get the plan for evaluating the given F-Curves on the data-block, building it if it does not
+ * exist yet or is outdated. Returns null when plans can't be used for this data-block, e.g.
+ * because it is not an evaluated copy.
+ *
+ * \param key: Identifies the container of the F-Curves, so that a data-block can have multiple
+ * plans at the same time.
+ */
+FCurveEvalPlan *fcurve_eval_plan_ensure(PointerRNA &id_ptr,
+                                        AnimData &adt,
+                                        const void *key,
+                                        Span<FCurve *> fcurves);
+
+/** Free the runtime data of the #AnimData, when the #AnimData itself is freed. */
+void animdata_runtime_free(AnimData &adt);
+
+/**
+ * Invalidate all existing plans. Must be called when data that plans may point to is freed
+ * without freeing the evaluated copies that own the plans.
+ */
+void eval_plans_tag_outdated();
+
+}  // namespace blender::bke
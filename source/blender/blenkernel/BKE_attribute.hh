@@ -23,6 +23,9 @@
 
 struct Mesh;
 struct PointCloud;
+namespace blender {
+class ImplicitSharingKey;
+}
 namespace blender::fn {
 namespace multi_function {
 class MultiFunction;
@@ -985,4 +988,15 @@ void fill_attribute_range_default(MutableAttributeAccessor dst_attributes,
                                   const AttributeFilter &attribute_filter,
                                   IndexRange range);
 
+/**
+ * Identify all attributes by their name, domain, type and sharing info. Returns false if there is
+ * an attribute without sharing info (e.g. a vertex group), which can't be identified that way.
+ *
+ * \param skip_fn: Optionally ignore some attributes.
+ */
+[[nodiscard]] bool attributes_add_to_key(
+    ImplicitSharingKey &key,
+    AttributeAccessor attributes,
+    FunctionRef<bool(const AttributeIter &iter)> skip_fn = nullptr);
+
 }  // namespace blender::bke
@@ -48,6 +48,16 @@ class BlobReader {
    */
   [[nodiscard]] virtual bool read_as_stream(const BlobSlice &slice,
                                             FunctionRef<bool(std::istream &)> fn) const;
+
+  /**
+   * Provides access to the data of the slice without reading it into a new buffer, if the reader
+   * supports that. The data may be modified in place when the returned sharing info has a single
+   * user, this never changes the stored data.
+   * \param alignment: Required alignment of the returned data.
+   * \return None if the data can't be accessed directly and has to be read instead.
+   */
+  [[nodiscard]] virtual std::optional<ImplicitSharingInfoAndData> map(const BlobSlice &slice,
+                                                                      int64_t alignment) const;
 };
 
 /**
@@ -161,22 +171,35 @@ class BlobReadSharing : NonCopyable, NonMovable {
       FunctionRef<std::optional<ImplicitSharingInfoAndData>()> read_fn) const;
 };
 
+class MappedBlobFile;
+
 /**
  * A specific #BlobReader that reads from disk.
+ *
+ * Blob files are memory-mapped when their data is accessed with #map, so that large attributes
+ * are paged in on demand instead of being parsed and copied. The mapped files stay alive as long
+ * as any data referencing them, even after the reader has been destructed.
  */
 class DiskBlobReader : public BlobReader {
  private:
   const std::string blobs_dir_;
   mutable Mutex mutex_;
   mutable Map<std::string, std::unique_ptr<fstream>> open_input_streams_;
+  /** Null when mapping the file failed. */
+  mutable Map<std::string, std::shared_ptr<MappedBlobFile>> mapped_files_;
 
  public:
   DiskBlobReader(std::string blobs_dir);
   [[nodiscard]] bool read(const BlobSlice &slice, void *r_data) const override;
+  [[nodiscard]] std::optional<ImplicitSharingInfoAndData> map(const BlobSlice &slice,
+                                                              int64_t alignment) const override;
 };
 
 /**
  * A specific #BlobWriter that writes to a file on disk.
+ *
+ * All arrays start at an offset that is a multiple of #alignment, so that they can be mapped into
+ * memory directly when reading them again (see #DiskBlobReader::map).
  */
 class DiskBlobWriter : public BlobWriter {
  private:
@@ -193,6 +216,8 @@ class DiskBlobWriter : public BlobWriter {
   int independent_file_count_ = 0;
 
  public:
+  static constexpr int64_t alignment = 64;
+
   DiskBlobWriter(std::string blob_dir, std::string base_name);
 
   BlobSlice write(const void *data, int64_t size) override;
@@ -398,6 +398,35 @@ void CustomData_bmesh_copy_block(CustomData &dst_data,
                                  const void *src_block,
                                  void **dst_block);
 
+/** Holds the data necessary to move data blocks from one custom data format to another. */
+struct BMCustomDataMoveMap {
+  struct FreeSrc {
+    cd_free fn;
+    int src_offset;
+  };
+  /**
+   * Layers that exist in both formats are moved with trivial copies, layers that only exist in
+   * the destination format are set to their default value.
+   */
+  BMCustomDataCopyMap copy;
+  /** Layers that only exist in the source format and have to be freed. */
+  blender::Vector<FreeSrc> free_src;
+};
+
+/** Precalculate a map for moving data blocks to another custom data format. */
+BMCustomDataMoveMap CustomData_bmesh_move_map_calc(const CustomData &src, const CustomData &dst);
+
+/**
+ * Move custom data layers for one element to a new block in a different format. Unlike copying,
+ * the data of layers that exist in both formats is transferred rather than duplicated, so the
+ * source block must be discarded afterwards without being freed (typically by destroying its
+ * whole memory pool).
+ */
+void CustomData_bmesh_move_block(CustomData &dst_data,
+                                 const BMCustomDataMoveMap &map,
+                                 void *src_block,
+                                 void **dst_block);
+
 /**
  * Copies data of a single layer of a given type.
  */
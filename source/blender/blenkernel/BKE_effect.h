@@ -126,6 +126,17 @@ void BKE_effectors_apply(struct ListBase *effectors,
                          float *wind_force,
                          float *impulse);
 void BKE_effectors_free(struct ListBase *lb);
+/**
+ * True when #BKE_effectors_apply draws from the random number generators of the effectors (e.g.
+ * for wind noise). The generators are not thread-safe, such effectors can't be applied to
+ * multiple points in parallel.
+ */
+bool BKE_effectors_use_random(const struct ListBase *effectors);
+/**
+ * Reset the random number generators to their state after #BKE_effectors_create, so that the next
+ * point gets the same noise as if the effectors were created for it alone.
+ */
+void BKE_effectors_reset_random(struct ListBase *effectors);
 
 void pd_point_from_particle(struct ParticleSimulationData *sim,
                             struct ParticleData *pa,
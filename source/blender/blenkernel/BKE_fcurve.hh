@@ -617,6 +617,15 @@ bool BKE_fcurve_is_empty(const FCurve *fcu);
 float calculate_fcurve(PathResolvedRNA *anim_rna,
                        FCurve *fcu,
                        const AnimationEvalContext *anim_eval_context);
+/**
+ * Same as #calculate_fcurve, but reuses the keyframe segment found by a previous evaluation of the
+ * same F-Curve when it still contains the evaluation time. This skips the binary search over the
+ * keyframes for consecutive frames. The hint is updated when a different segment is used.
+ */
+float calculate_fcurve_with_segment_hint(PathResolvedRNA *anim_rna,
+                                         FCurve *fcu,
+                                         const AnimationEvalContext *anim_eval_context,
+                                         int &segment_hint);
 
 /* ************* F-Curve Samples API ******************** */
 
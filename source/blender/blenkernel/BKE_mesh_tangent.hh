@@ -9,8 +9,10 @@
 
 #include "DNA_customdata_types.h"
 
+#include "BLI_implicit_sharing_ptr.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_offset_indices.hh"
+#include "BLI_string_ref.hh"
 #include "BLI_sys_types.h"
 
 struct ReportList;
@@ -66,11 +68,38 @@ void BKE_mesh_calc_loop_tangent_ex(blender::Span<blender::float3> vert_positions
                                    uint loopdata_out_len,
                                    short *tangent_mask_curr_p);
 
+/**
+ * Same as #BKE_mesh_calc_loop_tangent_ex for the data of \a mesh, but tangents of UV maps are
+ * shared with other users of the mesh, see #blender::bke::mesh::uv_map_tangents_get.
+ */
+void BKE_mesh_calc_loop_tangents_cached(const Mesh &mesh,
+                                        bool calc_active_tangent,
+                                        const char (*tangent_names)[MAX_CUSTOMDATA_LAYER_NAME],
+                                        int tangent_names_len,
+                                        blender::Span<blender::float3> vert_orco,
+                                        /* result */
+                                        CustomData *loopdata_out,
+                                        uint loopdata_out_len,
+                                        short *tangent_mask_curr_p);
+
 void BKE_mesh_calc_loop_tangents(Mesh *mesh_eval,
                                  bool calc_active_tangent,
                                  const char (*tangent_names)[MAX_CUSTOMDATA_LAYER_NAME],
                                  int tangent_names_len);
 
+namespace blender::bke::mesh {
+
+/**
+ * Tangents and bi-tangent signs (#CD_TANGENT) of the face corners for a UV map, computed with
+ * MikkTSpace from the mesh normals (see #Mesh::normals_domain()). The result is cached on the
+ * mesh runtime data and shared with copies of the mesh until positions, topology, normals or the
+ * UV map change.
+ * Returns empty data when the UV map doesn't exist.
+ */
+ImplicitSharingPtrAndData uv_map_tangents_get(const Mesh &mesh, StringRef uv_map_name);
+
+}  // namespace blender::bke::mesh
+
 /* Helpers */
 void BKE_mesh_add_loop_tangent_named_layer_for_uv(const CustomData *uv_data,
                                                   CustomData *tan_data,
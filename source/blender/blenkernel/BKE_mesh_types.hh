@@ -9,12 +9,14 @@
  */
 
 #include <memory>
+#include <string>
 #include <variant>
 
 #include "BLI_array.hh"
 #include "BLI_bit_vector.hh"
 #include "BLI_bounds_types.hh"
 #include "BLI_implicit_sharing.hh"
+#include "BLI_implicit_sharing_ptr.hh"
 #include "BLI_kdopbvh.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_mutex.hh"
@@ -31,6 +33,7 @@ class ShrinkwrapBoundaryData;
 struct SubdivCCG;
 struct SubsurfRuntimeData;
 namespace blender::bke {
+struct ArmatureSkinWeights;
 struct EditMeshData;
 }  // namespace blender::bke
 namespace blender::bke::bake {
@@ -128,6 +131,34 @@ struct TrianglesCache {
   void tag_dirty();
 };
 
+/**
+ * Vertex group weights compiled for armature deformation, see `armature_deform.cc`. The table
+ * stores the version of the vertex group layer it was built from, so unlike a #SharedCache it
+ * doesn't have to be tagged dirty when the weights change; a stale table is rebuilt on access.
+ */
+struct ArmatureSkinWeightsCache {
+  Mutex mutex;
+  std::shared_ptr<const ArmatureSkinWeights> data;
+};
+
+/**
+ * Face corner tangents of UV maps, computed with MikkTSpace from the mesh normals. Changes to
+ * positions, topology and normals tag the whole cache dirty. Each entry also stores the version of
+ * the UV map it was computed from, so writing to a UV map only invalidates its own tangents.
+ */
+struct UVTangentsCache {
+  struct UVMapTangents {
+    std::string uv_map_name;
+    WeakImplicitSharingPtr uv_sharing_info;
+    int64_t uv_version = 0;
+    /** Tangent and bi-tangent sign for every face corner, see #CD_TANGENT. */
+    ImplicitSharingPtrAndData tangents;
+  };
+  /** Entries are added lazily after the cache has been ensured, the mutex protects them. */
+  mutable Mutex mutex;
+  mutable Vector<UVMapTangents> uv_maps;
+};
+
 struct MeshRuntime {
   /**
    * "Evaluated" mesh owned by this mesh. Used for objects which don't have effective modifiers, so
@@ -252,6 +283,13 @@ struct MeshRuntime {
   /** Cache of non-manifold boundary data for shrinkwrap target Project. */
   SharedCache<ShrinkwrapBoundaryData> shrinkwrap_boundary_cache;
 
+  /** Cache of UV map tangents, see #mesh::uv_map_tangents_get(). */
+  SharedCache<UVTangentsCache> uv_tangents_cache;
+
+  /** Compiled vertex group weights for armature deformation, shared between copies. */
+  std::shared_ptr<ArmatureSkinWeightsCache> armature_skin_weights_cache =
+      std::make_shared<ArmatureSkinWeightsCache>();
+
   /**
    * A bit vector the size of the number of vertices, set to true for the center vertices of
    * subdivided faces. The values are set by the subdivision surface modifier and used by
@@ -410,6 +410,12 @@ struct bNodeType {
 
   /** True when the node cannot be muted. */
   bool no_muting = false;
+  /**
+   * True when the outputs of a geometry node only depend on its inputs and settings, and
+   * computing them is expensive enough to be worth caching across evaluations. See
+   * #nodes::execute_geometry_node_memoized.
+   */
+  bool geometry_node_memoizable = false;
   /** Some nodes should ignore the inferred visibility for improved UX. */
   bool ignore_inferred_input_socket_visibility = false;
   /** True when the node still works but it's usage is discouraged. */
@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include "BLI_math_matrix_types.hh"
+#include "BLI_span.hh"
+
 #include "BKE_subdiv.hh"
 
 /* Hardcoded for until GPU shaders are automatically generated, then we will have a more
@@ -85,6 +88,19 @@ extern void (*BKE_subsurf_modifier_free_gpu_cache_cb)(blender::bke::subdiv::Subd
 blender::bke::subdiv::Subdiv *BKE_subsurf_modifier_subdiv_descriptor_ensure(
     SubsurfRuntimeData *runtime_data, const Mesh *mesh, bool for_draw_code);
 
+/**
+ * Lower \a requested_levels so that subdivided edges are not much shorter than \a pixel_size
+ * after projecting them with \a object_to_clip into an image of \a resolution. The longest
+ * projected coarse edge decides, since the whole mesh is subdivided with a single resolution.
+ * The result is at least one.
+ */
+int BKE_subsurf_modifier_adaptive_level_get(blender::Span<blender::float3> positions,
+                                            blender::Span<blender::int2> edges,
+                                            const blender::float4x4 &object_to_clip,
+                                            const blender::int2 &resolution,
+                                            float pixel_size,
+                                            int requested_levels);
+
 /**
  * Return the #ModifierMode required for the evaluation of the subsurf modifier,
  * which should be used to check if the modifier is enabled.
@@ -38,6 +38,21 @@ struct LazyLoadedGrid {
    */
   std::shared_ptr<openvdb::GridBase> grid;
   ImplicitSharingPtr<> tree_sharing_info;
+  /** Set when the grid could not be loaded or computed, in which case #grid is null. */
+  std::string error_message;
+};
+
+/**
+ * Computes a grid from other data when it is first accessed, instead of loading it from a file.
+ * Contrary to a file, the computed tree can't be reloaded, so it is kept once it has been computed
+ * and the source is freed. Until then, code that knows the concrete source type can use the source
+ * directly instead of computing the grid, e.g. to fuse it into another computation.
+ */
+class LazyGridSource {
+ public:
+  virtual ~LazyGridSource() = default;
+
+  virtual LazyLoadedGrid compute() const = 0;
 };
 
 /**
@@ -113,6 +128,10 @@ class VolumeGridData : public ImplicitSharingMixin {
    * A function that can load the full grid or also just the tree lazily.
    */
   std::function<LazyLoadedGrid()> lazy_load_grid_;
+  /**
+   * The source of a computed grid, until the grid has been computed.
+   */
+  std::shared_ptr<const LazyGridSource> lazy_source_;
   /**
    * An error produced while trying to lazily load the grid.
    */
@@ -155,6 +174,14 @@ class VolumeGridData : public ImplicitSharingMixin {
   explicit VolumeGridData(std::function<LazyLoadedGrid()> lazy_load_grid,
                           std::shared_ptr<openvdb::GridBase> meta_data_and_transform_grid = {});
 
+  /**
+   * Constructs a new volume grid that is computed by the source when its tree is first needed.
+   * \param meta_data_and_transform_grid: A grid without tree that has the meta-data and transform
+   *   of the computed grid, so that those can be accessed without computing the grid.
+   */
+  VolumeGridData(std::shared_ptr<const LazyGridSource> source,
+                 std::shared_ptr<openvdb::GridBase> meta_data_and_transform_grid);
+
   ~VolumeGridData() override;
 
   /**
@@ -238,6 +265,12 @@ class VolumeGridData : public ImplicitSharingMixin {
    */
   bool is_reloadable() const;
 
+  /**
+   * The source that computes the grid, or null if the grid is not computed or has been computed
+   * already.
+   */
+  std::shared_ptr<const LazyGridSource> lazy_source() const;
+
  private:
   /**
    * Unloads the tree data if it's reloadable and no one is using it right now.
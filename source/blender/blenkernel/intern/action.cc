@@ -41,6 +41,7 @@
 
 #include "BKE_action.hh"
 #include "BKE_anim_data.hh"
+#include "BKE_anim_eval_plan.hh"
 #include "BKE_anim_visualization.h"
 #include "BKE_animsys.h"
 #include "BKE_armature.hh"
@@ -136,6 +137,10 @@ static void action_copy_data(Main * /*bmain*/,
   BLI_duplicatelist(&action_dst.groups, &action_src.groups);
   BKE_copy_time_markers(action_dst.markers, action_src.markers, flag);
 
+  /* Evaluation plans of animated data-blocks refer to the F-Curves of evaluated Actions, which are
+   * re-created when the evaluated copy is updated. */
+  blender::bke::eval_plans_tag_outdated();
+
   /* Copy F-Curves, fixing up the links as we go. */
   BLI_listbase_clear(&action_dst.curves);
 
@@ -1519,6 +1524,9 @@ void BKE_pose_channels_remove(Object *ob,
 
 void BKE_pose_channel_free_ex(bPoseChannel *pchan, bool do_id_user)
 {
+  /* Evaluation plans may point to this pose channel. */
+  blender::bke::eval_plans_tag_outdated();
+
   if (pchan->custom) {
     if (do_id_user) {
       id_us_min(&pchan->custom->id);
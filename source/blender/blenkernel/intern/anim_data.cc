@@ -12,6 +12,7 @@
 
 #include "BKE_action.hh"
 #include "BKE_anim_data.hh"
+#include "BKE_anim_eval_plan.hh"
 #include "BKE_animsys.h"
 #include "BKE_context.hh"
 #include "BKE_fcurve.hh"
@@ -291,6 +292,9 @@ void BKE_animdata_free(ID *id, const bool do_id_user)
   /* free driver array cache */
   MEM_SAFE_FREE(adt->driver_array);
 
+  /* free compiled evaluation plans */
+  blender::bke::animdata_runtime_free(*adt);
+
   /* free overrides */
   /* TODO... */
 
@@ -401,6 +405,7 @@ AnimData *BKE_animdata_copy_in_lib(Main *bmain,
   /* duplicate drivers (F-Curves) */
   BKE_fcurves_copy(&dadt->drivers, &adt->drivers);
   dadt->driver_array = nullptr;
+  dadt->runtime = nullptr;
 
   /* don't copy overrides */
   BLI_listbase_clear(&dadt->overrides);
@@ -1413,6 +1418,7 @@ void BKE_animdata_blend_read_data(BlendDataReader *reader, ID *id)
   BLO_read_struct_list(reader, FCurve, &adt->drivers);
   BKE_fcurve_blend_read_data_listbase(reader, &adt->drivers);
   adt->driver_array = nullptr;
+  adt->runtime = nullptr;
 
   /* link overrides */
   /* TODO... */
@@ -0,0 +1,186 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bke
+ */
+
+#include <atomic>
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_anim_types.h"
+
+#include "BKE_anim_eval_plan.hh"
+#include "BKE_animsys.h"
+
+#include "DEG_depsgraph_query.hh"
+
+#include "RNA_access.hh"
+#include "RNA_prototypes.hh"
+
+#include "nla_private.h"
+
+namespace blender::bke {
+
+/**
+ * Incremented whenever data that plans may point to is freed. Plans built with an older value are
+ * rebuilt on their next use.
+ */
+static std::atomic<uint64_t> eval_plans_generation = 1;
+
+void eval_plans_tag_outdated()
+{
+  eval_plans_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * Check whether the resolved property can be cached for the lifetime of the evaluated copy of the
+ * animated data-block. ID properties are excluded, as they can be replaced by Python at any time.
+ */
+static bool is_cacheable_target(const PathResolvedRNA &anim_rna, const ID *owner_id)
+{
+  if (RNA_property_is_idprop(anim_rna.prop)) {
+    return false;
+  }
+  if (anim_rna.ptr.data == owner_id) {
+    return true;
+  }
+  return anim_rna.ptr.type == &RNA_PoseBone;
+}
+
+bool FCurveEvalPlan::resolve(PointerRNA &id_ptr,
+                             const int index,
+                             PathResolvedRNA &r_anim_rna) const
+{
+  const FCurveEvalTarget &target = this->targets[index];
+  if (target.is_cached) {
+    r_anim_rna = target.anim_rna;
+    return true;
+  }
+  const FCurve *fcu = this->fcurves[index];
+  return BKE_animsys_rna_path_resolve(&id_ptr, fcu->rna_path, fcu->array_index, &r_anim_rna);
+}
+
+void FCurveEvalPlan::write_orig(PointerRNA &id_ptr, const int index, const float value)
+{
+  FCurveEvalTarget &target = this->targets[index];
+  const FCurve *fcu = this->fcurves[index];
+
+  if (target.is_orig_cached) {
+    BKE_animsys_write_to_rna_path(&target.orig_anim_rna, value);
+    return;
+  }
+
+  ID *orig_id = id_ptr.owner_id->orig_id;
+  PointerRNA ptr_orig = RNA_id_pointer_create(orig_id);
+  PathResolvedRNA orig_anim_rna;
+  if (!BKE_animsys_rna_path_resolve(&ptr_orig, fcu->rna_path, fcu->array_index, &orig_anim_rna))
+  {
+    return;
+  }
+  if (!target.is_orig_resolved) {
+    target.is_orig_resolved = true;
+    if (is_cacheable_target(orig_anim_rna, orig_id)) {
+      target.orig_anim_rna = orig_anim_rna;
+      target.is_orig_cached = true;
+    }
+  }
+  BKE_animsys_write_to_rna_path(&orig_anim_rna, value);
+}
+
+static bool plan_is_up_to_date(const FCurveEvalPlan &plan, const Span<FCurve *> fcurves)
+{
+  if (plan.fcurves.size() != fcurves.size()) {
+    return false;
+  }
+  for (const int i : fcurves.index_range()) {
+    if (plan.fcurves[i] != fcurves[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static std::unique_ptr<FCurveEvalPlan> plan_build(PointerRNA &id_ptr, const Span<FCurve *> fcurves)
+{
+  std::unique_ptr<FCurveEvalPlan> plan = std::make_unique<FCurveEvalPlan>();
+  plan->fcurves.reinitialize(fcurves.size());
+  plan->targets.reinitialize(fcurves.size());
+  for (const int i : fcurves.index_range()) {
+    FCurve *fcu = fcurves[i];
+    plan->fcurves[i] = fcu;
+
+    FCurveEvalTarget &target = plan->targets[i];
+    PathResolvedRNA anim_rna;
+    /* Paths that don't resolve are not cached, they are resolved (and reported) again on every
+     * evaluation like before. */
+    if (fcu->rna_path &&
+        BKE_animsys_rna_path_resolve(&id_ptr, fcu->rna_path, fcu->array_index, &anim_rna) &&
+        is_cacheable_target(anim_rna, id_ptr.owner_id))
+    {
+      target.anim_rna = anim_rna;
+      target.is_cached = true;
+    }
+  }
+  return plan;
+}
+
+AnimDataRuntime::~AnimDataRuntime()
+{
+  this->clear();
+}
+
+void AnimDataRuntime::clear()
+{
+  this->eval_plans.clear();
+  if (this->nla_eval_data) {
+    nlaeval_cache_free(this->nla_eval_data);
+    this->nla_eval_data = nullptr;
+  }
+}
+
+AnimDataRuntime *animdata_runtime_ensure(PointerRNA &id_ptr, AnimData &adt)
+{
+  ID *owner_id = id_ptr.owner_id;
+  if (owner_id == nullptr || id_ptr.data != owner_id || !DEG_is_evaluated(owner_id)) {
+    /* Original data can be modified at any time, so nothing can be cached for it. */
+    return nullptr;
+  }
+
+  if (adt.runtime == nullptr) {
+    adt.runtime = MEM_new<AnimDataRuntime>(__func__);
+  }
+  const uint64_t generation = eval_plans_generation.load(std::memory_order_relaxed);
+  if (adt.runtime->eval_plans_generation != generation) {
+    /* Cached data may point to freed data, and the plan keys may not exist anymore. */
+    adt.runtime->clear();
+    adt.runtime->eval_plans_generation = generation;
+  }
+  return adt.runtime;
+}
+
+FCurveEvalPlan *fcurve_eval_plan_ensure(PointerRNA &id_ptr,
+                                        AnimData &adt,
+                                        const void *key,
+                                        const Span<FCurve *> fcurves)
+{
+  AnimDataRuntime *runtime = animdata_runtime_ensure(id_ptr, adt);
+  if (runtime == nullptr) {
+    return nullptr;
+  }
+  std::unique_ptr<FCurveEvalPlan> &plan = runtime->eval_plans.lookup_or_add_default(key);
+  if (!plan || !plan_is_up_to_date(*plan, fcurves)) {
+    plan = plan_build(id_ptr, fcurves);
+  }
+  return plan.get();
+}
+
+void animdata_runtime_free(AnimData &adt)
+{
+  MEM_delete(adt.runtime);
+  adt.runtime = nullptr;
+}
+
+}  // namespace blender::bke
@@ -14,9 +14,11 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_bit_vector.hh"
 #include "BLI_listbase.h"
 #include "BLI_listbase_wrapper.hh"
+#include "BLI_map.hh"
 #include "BLI_math_rotation.h"
 #include "BLI_math_vector.h"
 #include "BLI_math_vector_types.hh"
@@ -24,6 +26,7 @@
 #include "BLI_string.h"
 #include "BLI_string_utf8.h"
 #include "BLI_string_utils.hh"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.hh"
@@ -39,6 +42,7 @@
 
 #include "BKE_action.hh"
 #include "BKE_anim_data.hh"
+#include "BKE_anim_eval_plan.hh"
 #include "BKE_animsys.h"
 #include "BKE_context.hh"
 #include "BKE_fcurve.hh"
@@ -590,6 +594,33 @@ static void animsys_evaluate_fcurves(PointerRNA *ptr,
   }
 }
 
+/**
+ * Same as #animsys_evaluate_fcurves, but using the pre-resolved properties and keyframe segments
+ * of a compiled plan.
+ */
+static void animsys_evaluate_fcurves_with_plan(PointerRNA *ptr,
+                                               blender::bke::FCurveEvalPlan &plan,
+                                               const AnimationEvalContext *anim_eval_context,
+                                               bool flush_to_original)
+{
+  for (const int i : plan.fcurves.index_range()) {
+    FCurve *fcu = plan.fcurves[i];
+    if (!is_fcurve_evaluatable(fcu)) {
+      continue;
+    }
+
+    PathResolvedRNA anim_rna;
+    if (plan.resolve(*ptr, i, anim_rna)) {
+      const float curval = calculate_fcurve_with_segment_hint(
+          &anim_rna, fcu, anim_eval_context, plan.targets[i].segment_hint);
+      BKE_animsys_write_to_rna_path(&anim_rna, curval);
+      if (flush_to_original) {
+        plan.write_orig(*ptr, i, curval);
+      }
+    }
+  }
+}
+
 /**
  * This function assumes that the quaternion keys are sequential. They do not
  * have to be in array_index order. If the quaternion is only partially keyed,
@@ -908,6 +939,27 @@ void animsys_evaluate_action(PointerRNA *ptr,
   animsys_evaluate_fcurves(ptr, fcurves, anim_eval_context, flush_to_original);
 }
 
+/**
+ * Evaluate the active legacy Action of the data-block, using a compiled plan when possible.
+ */
+static void animsys_evaluate_active_legacy_action(PointerRNA *ptr,
+                                                  AnimData *adt,
+                                                  const AnimationEvalContext *anim_eval_context,
+                                                  const bool flush_to_original)
+{
+  bAction *act = adt->action;
+  action_idcode_patch_check(ptr->owner_id, act);
+
+  Vector<FCurve *> fcurves = animrig::legacy::fcurves_all(act);
+  if (blender::bke::FCurveEvalPlan *plan = blender::bke::fcurve_eval_plan_ensure(
+          *ptr, *adt, act, fcurves))
+  {
+    animsys_evaluate_fcurves_with_plan(ptr, *plan, anim_eval_context, flush_to_original);
+    return;
+  }
+  animsys_evaluate_fcurves(ptr, fcurves, anim_eval_context, flush_to_original);
+}
+
 void animsys_blend_in_action(PointerRNA *ptr,
                              bAction *act,
                              const int32_t action_slot_handle,
@@ -1197,13 +1249,23 @@ static bool nlaevalchan_keycmp(const void *a, const void *b)
 
 /* ---------------------- */
 
-/* Allocate a new blending value snapshot for the channel. */
+/* Allocate a new blending value snapshot for the channel, reusing a freed one when possible. */
 static NlaEvalChannelSnapshot *nlaevalchan_snapshot_new(NlaEvalChannel *nec)
 {
   int length = nec->base_snapshot.length;
 
+  NlaEvalChannelSnapshot *nec_snapshot = nec->free_snapshots;
+  if (nec_snapshot != nullptr) {
+    nec->free_snapshots = nec_snapshot->next_free;
+    nec_snapshot->next_free = nullptr;
+    memset(nec_snapshot->values, 0, sizeof(float) * length);
+    BLI_bitmap_set_all(nec_snapshot->blend_domain.ptr, false, length);
+    BLI_bitmap_set_all(nec_snapshot->remap_domain.ptr, false, length);
+    return nec_snapshot;
+  }
+
   size_t byte_size = sizeof(NlaEvalChannelSnapshot) + sizeof(float) * length;
-  NlaEvalChannelSnapshot *nec_snapshot = static_cast<NlaEvalChannelSnapshot *>(
+  nec_snapshot = static_cast<NlaEvalChannelSnapshot *>(
       MEM_callocN(byte_size, "NlaEvalChannelSnapshot"));
 
   nec_snapshot->channel = nec;
@@ -1214,14 +1276,25 @@ static NlaEvalChannelSnapshot *nlaevalchan_snapshot_new(NlaEvalChannel *nec)
   return nec_snapshot;
 }
 
-/* Free a channel's blending value snapshot. */
+/* Free a channel's blending value snapshot, keeping its memory in the channel for reuse. */
 static void nlaevalchan_snapshot_free(NlaEvalChannelSnapshot *nec_snapshot)
 {
   BLI_assert(!nec_snapshot->is_base);
 
-  nlavalidmask_free(&nec_snapshot->blend_domain);
-  nlavalidmask_free(&nec_snapshot->remap_domain);
-  MEM_freeN(nec_snapshot);
+  NlaEvalChannel *nec = nec_snapshot->channel;
+  nec_snapshot->next_free = nec->free_snapshots;
+  nec->free_snapshots = nec_snapshot;
+}
+
+/* Free the memory of all snapshots kept by the channel for reuse. */
+static void nlaevalchan_free_snapshots(NlaEvalChannel *nec)
+{
+  while (NlaEvalChannelSnapshot *nec_snapshot = nec->free_snapshots) {
+    nec->free_snapshots = nec_snapshot->next_free;
+    nlavalidmask_free(&nec_snapshot->blend_domain);
+    nlavalidmask_free(&nec_snapshot->remap_domain);
+    MEM_freeN(nec_snapshot);
+  }
 }
 
 /* Copy all data in the snapshot. */
@@ -1331,9 +1404,29 @@ static void nlaeval_snapshot_free_data(NlaEvalSnapshot *snapshot)
 
 /* ---------------------- */
 
+using ActionAndSlot = std::pair<bAction *, animrig::slot_handle_t>;
+using ActionAndSlotSet = Set<ActionAndSlot>;
+
+/**
+ * Channels animated by the F-Curves of an action slot, in the order returned by
+ * #animrig::legacy::fcurves_for_action_slot. This avoids hashing the RNA path of every F-Curve
+ * each time the action is evaluated.
+ */
+struct NlaEvalActionChannels {
+  Array<const FCurve *> fcurves;
+  /** Channel of the F-Curve with the same index, only valid when #is_resolved is set. */
+  Array<NlaEvalChannel *> channels;
+  Array<bool> is_resolved;
+};
+
+struct NlaEvalActionChannelsMap {
+  Map<ActionAndSlot, std::unique_ptr<NlaEvalActionChannels>> map;
+};
+
 /* Free memory owned by this evaluation channel. */
 static void nlaevalchan_free_data(NlaEvalChannel *nec)
 {
+  nlaevalchan_free_snapshots(nec);
   nlavalidmask_free(&nec->domain);
   nec->key.~NlaEvalChannelKey();
 }
@@ -1364,6 +1457,23 @@ static void nlaeval_free(NlaEvalData *nlaeval)
   BLI_freelistN(&nlaeval->channels);
   BLI_ghash_free(nlaeval->path_hash, nullptr, nullptr);
   BLI_ghash_free(nlaeval->key_hash, nullptr, nullptr);
+  MEM_delete(nlaeval->action_channels);
+}
+
+void nlaeval_cache_free(NlaEvalData *nlaeval)
+{
+  nlaeval_free(nlaeval);
+  MEM_freeN(nlaeval);
+}
+
+/* Prepare channels kept from a previous evaluation of the same data-block for evaluating again. */
+static void nlaeval_reset(NlaEvalData *nlaeval)
+{
+  nlaeval_snapshot_free_data(&nlaeval->eval_snapshot);
+
+  LISTBASE_FOREACH (NlaEvalChannel *, nec, &nlaeval->channels) {
+    BLI_bitmap_set_all(nec->domain.ptr, false, nec->base_snapshot.length);
+  }
 }
 
 /* ---------------------- */
@@ -1551,6 +1661,22 @@ static NlaEvalChannel *nlaevalchan_verify_key(NlaEvalData *nlaeval,
   return nec;
 }
 
+/**
+ * Check whether the channel property stays valid for the lifetime of the evaluated copy of the
+ * animated data-block, so that the channel can be reused by later evaluations. This is the same
+ * condition as for F-Curve evaluation plans, see #BKE_anim_eval_plan.hh.
+ */
+static bool nlaevalchan_key_is_cacheable(const NlaEvalChannelKey *key, const ID *owner_id)
+{
+  if (RNA_property_is_idprop(key->prop)) {
+    return false;
+  }
+  if (key->ptr.data == owner_id) {
+    return true;
+  }
+  return key->ptr.type == &RNA_PoseBone;
+}
+
 /* Verify that an appropriate NlaEvalChannel for this path exists. */
 static NlaEvalChannel *nlaevalchan_verify(PointerRNA *ptr, NlaEvalData *nlaeval, const char *path)
 {
@@ -1573,6 +1699,9 @@ static NlaEvalChannel *nlaevalchan_verify(PointerRNA *ptr, NlaEvalData *nlaeval,
   NlaEvalChannelKey key{};
 
   if (!RNA_path_resolve_property(ptr, path, &key.ptr, &key.prop)) {
+    /* The path may resolve later, so the cached result can't be reused by later evaluations. */
+    nlaeval->has_uncacheable_channels = true;
+
     /* Report failure to resolve the path. */
     if (G.debug & G_DEBUG) {
       CLOG_WARN(&LOG,
@@ -1595,9 +1724,54 @@ static NlaEvalChannel *nlaevalchan_verify(PointerRNA *ptr, NlaEvalData *nlaeval,
     nec->rna_path = path;
   }
 
+  if (!nlaevalchan_key_is_cacheable(&key, ptr->owner_id)) {
+    nlaeval->has_uncacheable_channels = true;
+  }
+
   return *p_path_nec = nec;
 }
 
+/**
+ * Get the channels of the F-Curves of the action slot, rebuilding them when the F-Curves changed.
+ * The channels are looked up lazily with #nla_action_channel_ensure.
+ */
+static NlaEvalActionChannels &nla_action_channels_ensure(NlaEvalData *nlaeval,
+                                                         bAction *action,
+                                                         const animrig::slot_handle_t slot_handle)
+{
+  if (nlaeval->action_channels == nullptr) {
+    nlaeval->action_channels = MEM_new<NlaEvalActionChannelsMap>(__func__);
+  }
+  std::unique_ptr<NlaEvalActionChannels> &action_channels =
+      nlaeval->action_channels->map.lookup_or_add_default({action, slot_handle});
+
+  const Vector<const FCurve *> fcurves = animrig::legacy::fcurves_for_action_slot(
+      const_cast<const bAction *>(action), slot_handle);
+  if (action_channels && action_channels->fcurves.as_span() == fcurves.as_span()) {
+    return *action_channels;
+  }
+
+  action_channels = std::make_unique<NlaEvalActionChannels>();
+  action_channels->fcurves = fcurves.as_span();
+  action_channels->channels.reinitialize(fcurves.size());
+  action_channels->is_resolved = Array<bool>(fcurves.size(), false);
+  return *action_channels;
+}
+
+/* Get the channel animated by the F-Curve with the given index, creating it if necessary. */
+static NlaEvalChannel *nla_action_channel_ensure(PointerRNA *ptr,
+                                                 NlaEvalData *nlaeval,
+                                                 NlaEvalActionChannels &action_channels,
+                                                 const int index)
+{
+  if (!action_channels.is_resolved[index]) {
+    action_channels.channels[index] = nlaevalchan_verify(
+        ptr, nlaeval, action_channels.fcurves[index]->rna_path);
+    action_channels.is_resolved[index] = true;
+  }
+  return action_channels.channels[index];
+}
+
 /* ---------------------- */
 
 /** \returns true if a solution exists and the output was written to. */
@@ -2637,17 +2811,46 @@ static void nlaeval_fmodifiers_split_stacks(ListBase *list1, ListBase *list2)
 
 /* ---------------------- */
 
-/** Fills \a r_snapshot with the \a action's evaluated fcurve values with modifiers applied. */
-static void nlasnapshot_from_action(PointerRNA *ptr,
-                                    NlaEvalData *channels,
-                                    ListBase *modifiers,
-                                    bAction *action,
-                                    const animrig::slot_handle_t slot_handle,
-                                    const float evaltime,
-                                    NlaEvalSnapshot *r_snapshot)
+/**
+ * Create the channels in \a r_snapshot that are written by #nlasnapshot_evaluate_action. This may
+ * create new channels, so unlike the evaluation itself it can't run in parallel.
+ */
+static void nlasnapshot_ensure_action_channels(PointerRNA *ptr,
+                                               NlaEvalData *channels,
+                                               NlaEvalActionChannels &action_channels,
+                                               NlaEvalSnapshot *r_snapshot)
 {
-  action_idcode_patch_check(ptr->owner_id, action);
+  for (const int i : action_channels.fcurves.index_range()) {
+    const FCurve *fcu = action_channels.fcurves[i];
+    if (!is_fcurve_evaluatable(fcu)) {
+      continue;
+    }
+
+    NlaEvalChannel *nec = nla_action_channel_ensure(ptr, channels, action_channels, i);
 
+    /* Invalid path or property cannot be animated. */
+    if (nec == nullptr) {
+      continue;
+    }
+
+    if (!nlaevalchan_validate_index_ex(nec, fcu->array_index)) {
+      continue;
+    }
+
+    nlaeval_snapshot_ensure_channel(r_snapshot, nec);
+  }
+}
+
+/**
+ * Write the evaluated fcurve values of the action into the channels created by
+ * #nlasnapshot_ensure_action_channels. Only the snapshot is modified, so different snapshots can
+ * be filled in parallel.
+ */
+static void nlasnapshot_evaluate_action(const NlaEvalActionChannels &action_channels,
+                                        ListBase *modifiers,
+                                        const float evaltime,
+                                        NlaEvalSnapshot *r_snapshot)
+{
   /* Evaluate modifiers which modify time to evaluate the base curves at. */
   FModifiersStackStorage storage;
   storage.modifier_count = BLI_listbase_count(modifiers);
@@ -2657,23 +2860,19 @@ static void nlasnapshot_from_action(PointerRNA *ptr,
   const float modified_evaltime = evaluate_time_fmodifiers(
       &storage, modifiers, nullptr, 0.0f, evaltime);
 
-  for (const FCurve *fcu : animrig::legacy::fcurves_for_action_slot(action, slot_handle)) {
+  for (const int i : action_channels.fcurves.index_range()) {
+    const FCurve *fcu = action_channels.fcurves[i];
     if (!is_fcurve_evaluatable(fcu)) {
       continue;
     }
 
-    NlaEvalChannel *nec = nlaevalchan_verify(ptr, channels, fcu->rna_path);
-
-    /* Invalid path or property cannot be animated. */
-    if (nec == nullptr) {
-      continue;
-    }
-
-    if (!nlaevalchan_validate_index_ex(nec, fcu->array_index)) {
+    const NlaEvalChannel *nec = action_channels.channels[i];
+    if (nec == nullptr || nlaevalchan_validate_index(nec, fcu->array_index) < 0) {
       continue;
     }
 
-    NlaEvalChannelSnapshot *necs = nlaeval_snapshot_ensure_channel(r_snapshot, nec);
+    NlaEvalChannelSnapshot *necs = nlaeval_snapshot_get(r_snapshot, nec->index);
+    BLI_assert(necs != nullptr);
 
     float value = evaluate_fcurve(fcu, modified_evaltime);
     evaluate_value_fmodifiers(&storage, modifiers, fcu, &value, evaltime);
@@ -2688,6 +2887,23 @@ static void nlasnapshot_from_action(PointerRNA *ptr,
   }
 }
 
+/** Fills \a r_snapshot with the \a action's evaluated fcurve values with modifiers applied. */
+static void nlasnapshot_from_action(PointerRNA *ptr,
+                                    NlaEvalData *channels,
+                                    ListBase *modifiers,
+                                    bAction *action,
+                                    const animrig::slot_handle_t slot_handle,
+                                    const float evaltime,
+                                    NlaEvalSnapshot *r_snapshot)
+{
+  action_idcode_patch_check(ptr->owner_id, action);
+
+  NlaEvalActionChannels &action_channels = nla_action_channels_ensure(
+      channels, action, slot_handle);
+  nlasnapshot_ensure_action_channels(ptr, channels, action_channels, r_snapshot);
+  nlasnapshot_evaluate_action(action_channels, modifiers, evaltime, r_snapshot);
+}
+
 /* evaluate action-clip strip */
 static void nlastrip_evaluate_actionclip(const int evaluation_mode,
                                          PointerRNA *ptr,
@@ -3135,9 +3351,6 @@ void nladata_flush_channels(PointerRNA *ptr,
 
 /* ---------------------- */
 
-using ActionAndSlot = std::pair<bAction *, animrig::slot_handle_t>;
-using ActionAndSlotSet = Set<ActionAndSlot>;
-
 static void nla_eval_domain_action(PointerRNA *ptr,
                                    NlaEvalData *channels,
                                    bAction *act,
@@ -3149,13 +3362,15 @@ static void nla_eval_domain_action(PointerRNA *ptr,
     return;
   }
 
-  for (const FCurve *fcu : animrig::legacy::fcurves_for_action_slot(act, slot_handle)) {
+  NlaEvalActionChannels &action_channels = nla_action_channels_ensure(channels, act, slot_handle);
+  for (const int i : action_channels.fcurves.index_range()) {
+    const FCurve *fcu = action_channels.fcurves[i];
     /* check if this curve should be skipped */
     if (!is_fcurve_evaluatable(fcu)) {
       continue;
     }
 
-    NlaEvalChannel *nec = nlaevalchan_verify(ptr, channels, fcu->rna_path);
+    NlaEvalChannel *nec = nla_action_channel_ensure(ptr, channels, action_channels, i);
 
     if (nec != nullptr) {
       /* For quaternion properties, enable all sub-channels. */
@@ -3372,6 +3587,84 @@ static NlaTrack *nlatrack_find_tweaked(const AnimData *adt)
   return nullptr;
 }
 
+/** Action-clip strip whose action is evaluated before blending, see #nlastrips_blend. */
+struct NlaEvalStripAction {
+  NlaEvalStrip *nes;
+  NlaEvalActionChannels *action_channels;
+  NlaEvalSnapshot snapshot;
+};
+
+static bool nlastrip_can_evaluate_action_ahead(const NlaEvalStrip *nes)
+{
+  const NlaStrip *strip = nes->strip;
+  return strip->type == NLASTRIP_TYPE_CLIP && strip->act != nullptr &&
+         (strip->flag & NLASTRIP_FLAG_EDIT_TOUCHED) == 0;
+}
+
+/**
+ * Blend the strips on top of each other in order. The action of an action-clip strip doesn't
+ * depend on the strips below it, so these actions are evaluated in parallel first and only
+ * blended in order afterwards. Other strip types are evaluated while blending.
+ */
+static void nlastrips_blend(PointerRNA *ptr,
+                            NlaEvalData *channels,
+                            ListBase *estrips,
+                            NlaEvalSnapshot *snapshot,
+                            const AnimationEvalContext *anim_eval_context,
+                            const bool flush_to_original)
+{
+  Vector<NlaEvalStripAction> strip_actions;
+  LISTBASE_FOREACH (NlaEvalStrip *, nes, estrips) {
+    if (nlastrip_can_evaluate_action_ahead(nes)) {
+      strip_actions.append({nes, nullptr, {}});
+    }
+  }
+
+  /* Creating the channels may add new channels, so it is done before the parallel evaluation. */
+  int64_t fcurves_num = 0;
+  for (NlaEvalStripAction &strip_action : strip_actions) {
+    NlaStrip *strip = strip_action.nes->strip;
+    action_idcode_patch_check(ptr->owner_id, strip->act);
+    strip_action.action_channels = &nla_action_channels_ensure(
+        channels, strip->act, strip->action_slot_handle);
+    nlaeval_snapshot_init(&strip_action.snapshot, channels, nullptr);
+    nlasnapshot_ensure_action_channels(
+        ptr, channels, *strip_action.action_channels, &strip_action.snapshot);
+    fcurves_num += strip_action.action_channels->fcurves.size();
+  }
+
+  /* Only use multiple threads when there is enough work to make up for the overhead. */
+  const int64_t grain_size = fcurves_num < 1024 ? strip_actions.size() : 1;
+  threading::parallel_for(strip_actions.index_range(), grain_size, [&](const IndexRange range) {
+    for (NlaEvalStripAction &strip_action : strip_actions.as_mutable_span().slice(range)) {
+      NlaStrip *strip = strip_action.nes->strip;
+      nlasnapshot_evaluate_action(*strip_action.action_channels,
+                                  &strip->modifiers,
+                                  strip->strip_time,
+                                  &strip_action.snapshot);
+    }
+  });
+
+  int64_t strip_action_index = 0;
+  LISTBASE_FOREACH (NlaEvalStrip *, nes, estrips) {
+    if (strip_action_index < strip_actions.size() &&
+        strip_actions[strip_action_index].nes == nes)
+    {
+      NlaEvalStripAction &strip_action = strip_actions[strip_action_index++];
+      nlasnapshot_blend(channels,
+                        snapshot,
+                        &strip_action.snapshot,
+                        nes->strip->blendmode,
+                        nes->strip->influence,
+                        snapshot);
+      nlaeval_snapshot_free_data(&strip_action.snapshot);
+      continue;
+    }
+    nlasnapshot_blend_strip(
+        ptr, channels, nullptr, nes, snapshot, anim_eval_context, flush_to_original);
+  }
+}
+
 /**
  * NLA Evaluation function - values are calculated and stored in temporary "NlaEvalChannels"
  * \param[out] echannels: Evaluation channels with calculated values
@@ -3429,15 +3722,8 @@ static bool animsys_evaluate_nla_for_flush(NlaEvalData *echannels,
   nlastrips_ctime_get_strip_single(&estrips, &action_strip, anim_eval_context, flush_to_original);
 
   /* Per strip, evaluate and accumulate on top of existing channels. */
-  LISTBASE_FOREACH (NlaEvalStrip *, nes, &estrips) {
-    nlasnapshot_blend_strip(ptr,
-                            echannels,
-                            nullptr,
-                            nes,
-                            &echannels->eval_snapshot,
-                            anim_eval_context,
-                            flush_to_original);
-  }
+  nlastrips_blend(
+      ptr, echannels, &estrips, &echannels->eval_snapshot, anim_eval_context, flush_to_original);
 
   /* Free temporary evaluation data that's not used elsewhere. */
   BLI_freelistN(&estrips);
@@ -3590,23 +3876,38 @@ static bool animsys_calculate_nla(PointerRNA *ptr,
                                   const AnimationEvalContext *anim_eval_context,
                                   const bool flush_to_original)
 {
-  NlaEvalData echannels;
-
-  nlaeval_init(&echannels);
+  /* Reuse the channels of the previous evaluation of the same evaluated data-block, so that paths
+   * are only resolved once. */
+  bke::AnimDataRuntime *runtime = bke::animdata_runtime_ensure(*ptr, *adt);
+  NlaEvalData *echannels;
+  if (runtime && runtime->nla_eval_data) {
+    echannels = runtime->nla_eval_data;
+    runtime->nla_eval_data = nullptr;
+    nlaeval_reset(echannels);
+  }
+  else {
+    echannels = MEM_mallocN<NlaEvalData>(__func__);
+    nlaeval_init(echannels);
+  }
 
   /* evaluate the NLA stack, obtaining a set of values to flush */
   const bool did_evaluate_something = animsys_evaluate_nla_for_flush(
-      &echannels, ptr, adt, anim_eval_context, flush_to_original);
+      echannels, ptr, adt, anim_eval_context, flush_to_original);
   if (did_evaluate_something) {
     /* reset any channels touched by currently inactive actions to default value */
-    animsys_evaluate_nla_domain(ptr, &echannels, adt);
+    animsys_evaluate_nla_domain(ptr, echannels, adt);
 
     /* flush effects of accumulating channels in NLA to the actual data they affect */
-    nladata_flush_channels(ptr, &echannels, &echannels.eval_snapshot, flush_to_original);
+    nladata_flush_channels(ptr, echannels, &echannels->eval_snapshot, flush_to_original);
   }
 
-  /* free temp data */
-  nlaeval_free(&echannels);
+  if (runtime && did_evaluate_something && !echannels->has_uncacheable_channels) {
+    runtime->nla_eval_data = echannels;
+  }
+  else {
+    /* free temp data */
+    nlaeval_cache_free(echannels);
+  }
 
   return did_evaluate_something;
 }
@@ -3982,6 +4283,10 @@ void BKE_animsys_evaluate_animdata(ID *id,
         blender::animrig::evaluate_and_apply_action(
             id_ptr, action, adt->slot_handle, *anim_eval_context, flush_to_original);
       }
+      else if (action.is_action_legacy()) {
+        animsys_evaluate_active_legacy_action(
+            &id_ptr, adt, anim_eval_context, flush_to_original);
+      }
       else {
         animsys_evaluate_action(
             &id_ptr, adt->action, animrig::Slot::unassigned, anim_eval_context, flush_to_original);
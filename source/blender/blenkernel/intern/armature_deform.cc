@@ -8,6 +8,7 @@
  * Deform coordinates by a armature object (used by modifier).
  */
 
+#include <array>
 #include <cctype>
 #include <cfloat>
 #include <cmath>
@@ -16,11 +17,14 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_implicit_sharing_ptr.hh"
 #include "BLI_listbase.h"
 #include "BLI_math_matrix.h"
+#include "BLI_math_matrix.hh"
 #include "BLI_math_rotation.h"
 #include "BLI_math_vector.h"
 #include "BLI_task.h"
+#include "BLI_task.hh"
 
 #include "DNA_armature_types.h"
 #include "DNA_lattice_types.h"
@@ -36,6 +40,7 @@
 #include "BKE_editmesh.hh"
 #include "BKE_lattice.hh"
 #include "BKE_mesh.hh"
+#include "BKE_mesh_types.hh"
 
 #include "CLG_log.h"
 
@@ -478,6 +483,335 @@ static void armature_vert_task_editmesh_no_dvert(void *__restrict userdata,
   armature_vert_task_with_dvert(data, BM_elem_index_get(v), nullptr);
 }
 
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Compiled Skin Weights
+ *
+ * For dense meshes, walking the #MDeformVert list of every vertex, looking up the pose channel of
+ * each group and checking its flags is a large part of the deformation time. In the common case
+ * (no B-Bones, envelopes or deform matrices) the weights are compiled into a table with a fixed
+ * number of influences per vertex, which is cached on the mesh and evaluated in batches of
+ * vertices. The influences are stored per slot (structure of arrays), so that the loops over a
+ * batch are simple enough to be vectorized by the compiler. Vertices that don't fit into the
+ * table use the generic code path.
+ * \{ */
+
+namespace blender::bke {
+
+/** Maximum number of influences per vertex in #ArmatureSkinWeights. */
+static constexpr int SKIN_MAX_INFLUENCES = 4;
+/** Number of vertices deformed together. */
+static constexpr int SKIN_BATCH_SIZE = 256;
+
+struct ArmatureSkinWeights {
+  /** The vertex group layer the table was built from, and its version at that time. */
+  WeakImplicitSharingPtr dverts_sharing_info;
+  int64_t dverts_version = 0;
+  int verts_num = 0;
+  int armature_def_nr = -1;
+  /** Whether each vertex group is used by a deforming bone. */
+  Array<bool> group_is_deform;
+
+  /**
+   * Vertices that are evaluated with the generic code path, because they have more than
+   * #SKIN_MAX_INFLUENCES influences or none at all.
+   */
+  Array<bool> use_generic;
+  /**
+   * Vertex group index and weight of every influence, stored per slot:
+   * `groups[slot * verts_num + vert]`. Unused slots have a zero weight.
+   */
+  Array<int> groups;
+  Array<float> weights;
+  /** Weight in the armature modifier vertex group, empty when there is none. */
+  Array<float> armature_weights;
+};
+
+static bool skin_weights_is_up_to_date(const ArmatureSkinWeights &skin,
+                                       const ImplicitSharingInfo *dverts_sharing_info,
+                                       const int verts_num,
+                                       const int armature_def_nr,
+                                       const Span<bool> group_is_deform)
+{
+  return skin.dverts_sharing_info.get() == dverts_sharing_info &&
+         skin.dverts_version == dverts_sharing_info->version() && skin.verts_num == verts_num &&
+         skin.armature_def_nr == armature_def_nr &&
+         skin.group_is_deform.as_span() == group_is_deform;
+}
+
+static std::shared_ptr<const ArmatureSkinWeights> skin_weights_build(
+    const Span<MDeformVert> dverts,
+    const ImplicitSharingInfo *dverts_sharing_info,
+    const int armature_def_nr,
+    const Span<bool> group_is_deform)
+{
+  const int verts_num = dverts.size();
+
+  std::shared_ptr<ArmatureSkinWeights> skin = std::make_shared<ArmatureSkinWeights>();
+  dverts_sharing_info->add_weak_user();
+  skin->dverts_sharing_info = WeakImplicitSharingPtr(dverts_sharing_info);
+  skin->dverts_version = dverts_sharing_info->version();
+  skin->verts_num = verts_num;
+  skin->armature_def_nr = armature_def_nr;
+  skin->group_is_deform = group_is_deform;
+
+  skin->use_generic.reinitialize(verts_num);
+  skin->groups.reinitialize(SKIN_MAX_INFLUENCES * verts_num);
+  skin->weights.reinitialize(SKIN_MAX_INFLUENCES * verts_num);
+  if (armature_def_nr != -1) {
+    skin->armature_weights.reinitialize(verts_num);
+  }
+
+  threading::parallel_for(IndexRange(verts_num), 4096, [&](const IndexRange range) {
+    for (const int vert : range) {
+      const MDeformVert &dvert = dverts[vert];
+      int influences_num = 0;
+      bool use_generic = false;
+      for (const MDeformWeight &dw : Span(dvert.dw, dvert.totweight)) {
+        if (dw.def_nr >= group_is_deform.size() || !group_is_deform[dw.def_nr]) {
+          continue;
+        }
+        if (influences_num == SKIN_MAX_INFLUENCES) {
+          use_generic = true;
+          break;
+        }
+        /* Zero weights are kept, since they still prevent the envelope fallback. */
+        skin->groups[influences_num * verts_num + vert] = dw.def_nr;
+        skin->weights[influences_num * verts_num + vert] = dw.weight;
+        influences_num++;
+      }
+      skin->use_generic[vert] = use_generic || influences_num == 0;
+      for (const int slot : IndexRange(influences_num, SKIN_MAX_INFLUENCES - influences_num)) {
+        skin->groups[slot * verts_num + vert] = 0;
+        skin->weights[slot * verts_num + vert] = 0.0f;
+      }
+      if (armature_def_nr != -1) {
+        skin->armature_weights[vert] = BKE_defvert_find_weight(&dvert, armature_def_nr);
+      }
+    }
+  });
+
+  return skin;
+}
+
+/**
+ * Get the compiled weights for the mesh, or null when they can't be used for this deformation.
+ */
+static std::shared_ptr<const ArmatureSkinWeights> skin_weights_ensure(
+    const ArmatureUserdata &data)
+{
+  const Mesh *mesh = data.me_target;
+  if (mesh == nullptr || !data.use_dverts || data.vert_deform_mats != nullptr ||
+      data.vert_coords_prev != nullptr || data.dverts_len != mesh->verts_num)
+  {
+    return nullptr;
+  }
+
+  Array<bool> group_is_deform(data.defbase_len, false);
+  for (const int group : IndexRange(data.defbase_len)) {
+    const bPoseChannel *pchan = data.pchan_from_defbase[group];
+    if (pchan == nullptr) {
+      continue;
+    }
+    const Bone *bone = pchan->bone;
+    if (bone->flag & BONE_MULT_VG_ENV) {
+      return nullptr;
+    }
+    if (bone->segments > 1 && pchan->runtime.bbone_segments == bone->segments) {
+      return nullptr;
+    }
+    group_is_deform[group] = true;
+  }
+
+  const int layer_index = CustomData_get_layer_index(&mesh->vert_data, CD_MDEFORMVERT);
+  if (layer_index == -1) {
+    return nullptr;
+  }
+  const ImplicitSharingInfo *sharing_info = mesh->vert_data.layers[layer_index].sharing_info;
+  if (sharing_info == nullptr) {
+    return nullptr;
+  }
+
+  ArmatureSkinWeightsCache &cache = *mesh->runtime->armature_skin_weights_cache;
+  std::scoped_lock lock(cache.mutex);
+  if (!cache.data || !skin_weights_is_up_to_date(*cache.data,
+                                                  sharing_info,
+                                                  mesh->verts_num,
+                                                  data.armature_def_nr,
+                                                  group_is_deform))
+  {
+    cache.data = skin_weights_build(
+        Span(data.dverts, data.dverts_len), sharing_info, data.armature_def_nr, group_is_deform);
+  }
+  return cache.data;
+}
+
+static float skin_armature_weight(const ArmatureUserdata &data,
+                                  const ArmatureSkinWeights &skin,
+                                  const int vert)
+{
+  if (skin.armature_weights.is_empty()) {
+    return 1.0f;
+  }
+  const float weight = skin.armature_weights[vert];
+  return data.invert_vgroup ? 1.0f - weight : weight;
+}
+
+static void skin_deform_batch_linear(const ArmatureUserdata &data,
+                                     const ArmatureSkinWeights &skin,
+                                     const Span<float4x4> bone_mats,
+                                     const IndexRange batch)
+{
+  const float4x4 premat(data.premat);
+  const float4x4 postmat(data.postmat);
+  MutableSpan<float3> positions(reinterpret_cast<float3 *>(data.vert_coords), skin.verts_num);
+
+  std::array<float3, SKIN_BATCH_SIZE> co;
+  std::array<float3, SKIN_BATCH_SIZE> offset;
+  std::array<float, SKIN_BATCH_SIZE> contrib;
+
+  for (const int i : IndexRange(batch.size())) {
+    co[i] = math::transform_point(premat, positions[batch[i]]);
+    offset[i] = float3(0.0f);
+    contrib[i] = 0.0f;
+  }
+
+  for (const int slot : IndexRange(SKIN_MAX_INFLUENCES)) {
+    const int *groups = &skin.groups[slot * skin.verts_num + batch.start()];
+    const float *weights = &skin.weights[slot * skin.verts_num + batch.start()];
+    for (const int i : IndexRange(batch.size())) {
+      const float weight = weights[i];
+      if (weight == 0.0f) {
+        continue;
+      }
+      offset[i] += (math::transform_point(bone_mats[groups[i]], co[i]) - co[i]) * weight;
+      contrib[i] += weight;
+    }
+  }
+
+  for (const int i : IndexRange(batch.size())) {
+    const int vert = batch[i];
+    if (skin.use_generic[vert]) {
+      armature_vert_task_with_dvert(&data, vert, &data.dverts[vert]);
+      continue;
+    }
+    const float armature_weight = skin_armature_weight(data, skin, vert);
+    if (armature_weight == 0.0f) {
+      continue;
+    }
+    /* Actually should be EPSILON? weight values and contrib can be like 10e-39 small. */
+    if (contrib[i] > 0.0001f) {
+      co[i] += offset[i] * (armature_weight / contrib[i]);
+    }
+    positions[vert] = math::transform_point(postmat, co[i]);
+  }
+}
+
+static void skin_deform_batch_dual_quat(const ArmatureUserdata &data,
+                                        const ArmatureSkinWeights &skin,
+                                        const Span<const DualQuat *> bone_dquats,
+                                        const IndexRange batch)
+{
+  MutableSpan<float3> positions(reinterpret_cast<float3 *>(data.vert_coords), skin.verts_num);
+
+  for (const int i : IndexRange(batch.size())) {
+    const int vert = batch[i];
+    if (skin.use_generic[vert]) {
+      armature_vert_task_with_dvert(&data, vert, &data.dverts[vert]);
+      continue;
+    }
+    const float armature_weight = skin_armature_weight(data, skin, vert);
+    if (armature_weight == 0.0f) {
+      continue;
+    }
+
+    float *co = positions[vert];
+    mul_m4_v3(data.premat, co);
+
+    DualQuat dq = {};
+    float contrib = 0.0f;
+    for (const int slot : IndexRange(SKIN_MAX_INFLUENCES)) {
+      const float weight = skin.weights[slot * skin.verts_num + vert];
+      if (weight == 0.0f) {
+        continue;
+      }
+      const int group = skin.groups[slot * skin.verts_num + vert];
+      add_weighted_dq_dq_pivot(&dq, bone_dquats[group], co, weight, false);
+      contrib += weight;
+    }
+
+    if (contrib > 0.0001f) {
+      normalize_dq(&dq, contrib);
+      if (armature_weight != 1.0f) {
+        float dco[3];
+        copy_v3_v3(dco, co);
+        mul_v3m3_dq(dco, nullptr, &dq);
+        sub_v3_v3(dco, co);
+        madd_v3_v3fl(co, dco, armature_weight);
+      }
+      else {
+        mul_v3m3_dq(co, nullptr, &dq);
+      }
+    }
+
+    mul_m4_v3(data.postmat, co);
+  }
+}
+
+/**
+ * Deform the mesh positions using compiled weights. Returns false when the generic code path has
+ * to be used instead.
+ */
+static bool armature_deform_with_skin_weights(const ArmatureUserdata &data)
+{
+  const std::shared_ptr<const ArmatureSkinWeights> skin = skin_weights_ensure(data);
+  if (!skin) {
+    return false;
+  }
+
+  Array<float4x4> bone_mats;
+  Array<const DualQuat *> bone_dquats;
+  if (data.use_quaternion) {
+    bone_dquats.reinitialize(data.defbase_len);
+  }
+  else {
+    bone_mats.reinitialize(data.defbase_len);
+  }
+  for (const int group : IndexRange(data.defbase_len)) {
+    const bPoseChannel *pchan = data.pchan_from_defbase[group];
+    if (data.use_quaternion) {
+      bone_dquats[group] = pchan ? &pchan->runtime.deform_dual_quat : nullptr;
+    }
+    else {
+      bone_mats[group] = pchan ? float4x4(pchan->chan_mat) : float4x4::identity();
+    }
+  }
+
+  threading::parallel_for(IndexRange(skin->verts_num), 4096, [&](const IndexRange range) {
+    for (int64_t start = range.start(); start < range.one_after_last(); start += SKIN_BATCH_SIZE)
+    {
+      const IndexRange batch(start,
+                             std::min<int64_t>(SKIN_BATCH_SIZE, range.one_after_last() - start));
+      if (data.use_quaternion) {
+        skin_deform_batch_dual_quat(data, *skin, bone_dquats, batch);
+      }
+      else {
+        skin_deform_batch_linear(data, *skin, bone_mats, batch);
+      }
+    }
+  });
+  return true;
+}
+
+}  // namespace blender::bke
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Armature Deform Coordinates
+ * \{ */
+
 static void armature_deform_coords_impl(const Object *ob_arm,
                                         const Object *ob_target,
                                         const ListBase *defbase,
@@ -592,7 +926,7 @@ static void armature_deform_coords_impl(const Object *ob_arm,
           em_target->bm->vpool, &data, armature_vert_task_editmesh_no_dvert, &settings);
     }
   }
-  else {
+  else if (!blender::bke::armature_deform_with_skin_weights(data)) {
     TaskParallelSettings settings;
     BLI_parallel_range_settings_defaults(&settings);
     settings.min_iter_per_thread = 32;
@@ -0,0 +1,184 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "BKE_action.hh"
+#include "BKE_armature.hh"
+#include "BKE_deform.hh"
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_main.hh"
+#include "BKE_mesh.hh"
+#include "BKE_mesh_types.hh"
+#include "BKE_object.hh"
+#include "BKE_object_types.hh"
+
+#include "BLI_array.hh"
+#include "BLI_listbase.h"
+#include "BLI_math_matrix.h"
+#include "BLI_math_matrix.hh"
+#include "BLI_math_rotation.h"
+#include "BLI_string.h"
+
+#include "DNA_armature_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+
+#include "CLG_log.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "testing/testing.h"
+
+namespace blender::bke::tests {
+
+static constexpr int BONES_NUM = 8;
+static constexpr int VERTS_NUM = 10000;
+
+class ArmatureDeformTest : public testing::Test {
+ protected:
+  Main *bmain;
+  Object *ob_arm;
+  Object *ob_mesh;
+  Mesh *mesh;
+  Array<float3> positions;
+
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    CLG_exit();
+  }
+
+  void SetUp() override
+  {
+    bmain = BKE_main_new();
+
+    bArmature *arm = BKE_id_new<bArmature>(bmain, "Armature");
+    for (const int i : IndexRange(BONES_NUM)) {
+      Bone *bone = MEM_callocN<Bone>(__func__);
+      SNPRINTF(bone->name, "Bone%d", i);
+      bone->segments = 1;
+      unit_m4(bone->arm_mat);
+      bone->arm_mat[3][0] = float(i);
+      BLI_addtail(&arm->bonebase, bone);
+    }
+
+    ob_arm = BKE_object_add_only_object(bmain, OB_ARMATURE, "Armature");
+    ob_arm->data = arm;
+    BKE_pose_rebuild(bmain, ob_arm, arm, false);
+    ob_arm->runtime->object_to_world = math::from_location<float4x4>(float3(0.5f, 0.0f, -1.0f));
+
+    /* Give every bone a different rotation and translation. */
+    int i = 0;
+    LISTBASE_FOREACH_INDEX (bPoseChannel *, pchan, &ob_arm->pose->chanbase, i) {
+      float rot[3][3];
+      const float axis[3] = {1.0f, float(i), 0.5f};
+      axis_angle_to_mat3(rot, axis, 0.3f * float(i + 1));
+      copy_m4_m3(pchan->chan_mat, rot);
+      pchan->chan_mat[3][0] = 0.1f * float(i);
+      pchan->chan_mat[3][2] = -0.2f * float(i);
+      mat4_to_dquat(&pchan->runtime.deform_dual_quat, pchan->bone->arm_mat, pchan->chan_mat);
+    }
+
+    mesh = BKE_id_new<Mesh>(bmain, "Mesh");
+    ob_mesh = BKE_object_add_only_object(bmain, OB_MESH, "Mesh");
+    ob_mesh->data = mesh;
+    for (const int bone : IndexRange(BONES_NUM)) {
+      BKE_object_defgroup_new(ob_mesh, "Bone" + std::to_string(bone));
+    }
+    BKE_object_defgroup_new(ob_mesh, "Modifier");
+    const int modifier_group = BONES_NUM;
+
+    /* Vertices with zero to six influences, to cover both vertices in the compiled table and ones
+     * that use the generic code path. */
+    mesh->verts_num = VERTS_NUM;
+    MutableSpan<MDeformVert> dverts = mesh->deform_verts_for_write();
+    positions.reinitialize(VERTS_NUM);
+    for (const int vert : IndexRange(VERTS_NUM)) {
+      positions[vert] = float3(float(vert % 100) * 0.05f, float(vert / 100) * 0.05f, 0.2f);
+      const int influences_num = vert % 7;
+      for (const int influence : IndexRange(influences_num)) {
+        BKE_defvert_add_index_notest(&dverts[vert],
+                                     (vert + influence) % BONES_NUM,
+                                     0.1f + 0.15f * float((vert + influence) % 5));
+      }
+      BKE_defvert_add_index_notest(&dverts[vert], modifier_group, float(vert % 11) / 10.0f);
+    }
+  }
+
+  void TearDown() override
+  {
+    BKE_main_free(bmain);
+  }
+
+  /** Deform the positions, with and without the compiled skin weights. */
+  void deform_and_compare(const int deformflag, const char *defgrp_name)
+  {
+    Array<float3> result_compiled = positions;
+    BKE_armature_deform_coords_with_mesh(ob_arm,
+                                         ob_mesh,
+                                         reinterpret_cast<float(*)[3]>(result_compiled.data()),
+                                         nullptr,
+                                         VERTS_NUM,
+                                         deformflag,
+                                         nullptr,
+                                         defgrp_name,
+                                         mesh);
+    EXPECT_TRUE(bool(mesh->runtime->armature_skin_weights_cache->data));
+
+    /* Requesting deform matrices always uses the generic code path. */
+    Array<float3> result_generic = positions;
+    Array<float3x3> deform_mats(VERTS_NUM, float3x3::identity());
+    BKE_armature_deform_coords_with_mesh(ob_arm,
+                                         ob_mesh,
+                                         reinterpret_cast<float(*)[3]>(result_generic.data()),
+                                         reinterpret_cast<float(*)[3][3]>(deform_mats.data()),
+                                         VERTS_NUM,
+                                         deformflag,
+                                         nullptr,
+                                         defgrp_name,
+                                         mesh);
+
+    for (const int vert : IndexRange(VERTS_NUM)) {
+      EXPECT_V3_NEAR(result_compiled[vert], result_generic[vert], 1e-4f);
+    }
+  }
+};
+
+TEST_F(ArmatureDeformTest, CompiledWeightsLinearBlend)
+{
+  deform_and_compare(ARM_DEF_VGROUP, "");
+}
+
+TEST_F(ArmatureDeformTest, CompiledWeightsDualQuaternion)
+{
+  deform_and_compare(ARM_DEF_VGROUP | ARM_DEF_QUATERNION, "");
+}
+
+TEST_F(ArmatureDeformTest, CompiledWeightsModifierGroup)
+{
+  deform_and_compare(ARM_DEF_VGROUP, "Modifier");
+  deform_and_compare(ARM_DEF_VGROUP | ARM_DEF_QUATERNION | ARM_DEF_INVERT_VGROUP, "Modifier");
+}
+
+TEST_F(ArmatureDeformTest, CompiledWeightsUpdateOnWeightChange)
+{
+  deform_and_compare(ARM_DEF_VGROUP, "");
+
+  /* Writing to the weights has to invalidate the compiled table. */
+  MutableSpan<MDeformVert> dverts = mesh->deform_verts_for_write();
+  for (MDeformVert &dvert : dverts) {
+    for (MDeformWeight &dw : MutableSpan(dvert.dw, dvert.totweight)) {
+      dw.weight = 1.0f - dw.weight;
+    }
+  }
+  deform_and_compare(ARM_DEF_VGROUP, "");
+}
+
+}  // namespace blender::bke::tests
@@ -19,6 +19,7 @@
 
 #include "BLI_array_utils.hh"
 #include "BLI_color.hh"
+#include "BLI_implicit_sharing_key.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_span.hh"
 
@@ -1166,4 +1167,31 @@ void fill_attribute_range_default(MutableAttributeAccessor attributes,
   });
 }
 
+bool attributes_add_to_key(ImplicitSharingKey &key,
+                           const AttributeAccessor attributes,
+                           const FunctionRef<bool(const AttributeIter &iter)> skip_fn)
+{
+  bool success = true;
+  attributes.foreach_attribute([&](const AttributeIter &iter) {
+    if (skip_fn && skip_fn(iter)) {
+      return;
+    }
+    const GAttributeReader attribute = iter.get();
+    /* Empty attributes are not allocated, other attributes without sharing info are e.g. vertex
+     * groups, which are not stored as separate arrays. */
+    if (attribute.sharing_info == nullptr && !attribute.varray.is_empty()) {
+      success = false;
+      iter.stop();
+      return;
+    }
+    key.strings.append(iter.name);
+    key.words.append(uint64_t(iter.domain));
+    key.words.append(uint64_t(iter.data_type));
+    if (attribute.sharing_info) {
+      key.add_shared_data(*attribute.sharing_info);
+    }
+  });
+  return success;
+}
+
 }  // namespace blender::bke
@@ -18,6 +18,7 @@
 #include "BLI_endian_switch.h"
 #include "BLI_listbase.h"
 #include "BLI_math_matrix_types.hh"
+#include "BLI_mmap.h"
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
 
@@ -27,10 +28,16 @@
 #include "RNA_access.hh"
 #include "RNA_enum_types.hh"
 
+#include <array>
+#include <fcntl.h>
 #include <fmt/format.h>
 #include <sstream>
 #include <xxhash.h>
 
+#ifndef WIN32
+#  include <unistd.h>
+#endif
+
 #ifdef WITH_OPENVDB
 #  include <openvdb/io/Stream.h>
 #  include <openvdb/openvdb.h>
@@ -88,8 +95,114 @@ bool BlobReader::read_as_stream(const BlobSlice &slice, FunctionRef<bool(std::is
   return true;
 }
 
+std::optional<ImplicitSharingInfoAndData> BlobReader::map(const BlobSlice & /*slice*/,
+                                                          const int64_t /*alignment*/) const
+{
+  return std::nullopt;
+}
+
+#ifndef WIN32
+
+/**
+ * A blob file that is mapped into memory. Every array that references it has its own sharing info
+ * which keeps the file mapped, so that arrays can still be identified by their sharing info.
+ */
+class MappedBlobFile : NonCopyable, NonMovable {
+ private:
+  BLI_mmap_file *file_;
+
+ public:
+  MappedBlobFile(BLI_mmap_file *file) : file_(file) {}
+
+  ~MappedBlobFile()
+  {
+    BLI_mmap_free(file_);
+  }
+
+  static std::shared_ptr<MappedBlobFile> open(const char *path)
+  {
+    const int file = BLI_open(path, O_BINARY | O_RDONLY, 0);
+    if (file == -1) {
+      return {};
+    }
+    /* Copy-on-write is used because the data might be modified in place once it's loaded. */
+    BLI_mmap_file *mmap_file = BLI_mmap_open_copy_on_write(file);
+    close(file);
+    if (mmap_file == nullptr) {
+      return {};
+    }
+    return std::make_shared<MappedBlobFile>(mmap_file);
+  }
+
+  const char *data() const
+  {
+    return static_cast<const char *>(BLI_mmap_get_pointer(file_));
+  }
+
+  int64_t size() const
+  {
+    return int64_t(BLI_mmap_get_length(file_));
+  }
+
+  /**
+   * Access every page in the range once, so that IO errors are detected before the data is
+   * referenced directly. After an error, the mapped memory only contains zeros.
+   */
+  bool load(const IndexRange range) const
+  {
+    const volatile char *data = this->data();
+    const int64_t page_size = int64_t(sysconf(_SC_PAGESIZE));
+    for (int64_t i = range.start(); i < range.one_after_last(); i += page_size) {
+      data[i];
+    }
+    data[range.last()];
+    return !BLI_mmap_any_io_error(file_);
+  }
+};
+
+#endif
+
 DiskBlobReader::DiskBlobReader(std::string blobs_dir) : blobs_dir_(std::move(blobs_dir)) {}
 
+std::optional<ImplicitSharingInfoAndData> DiskBlobReader::map(const BlobSlice &slice,
+                                                              const int64_t alignment) const
+{
+#ifdef WIN32
+  /* Mapped files can't be replaced on Windows, which would make it impossible to bake again while
+   * the previously baked data is still used. */
+  UNUSED_VARS(slice, alignment);
+  return std::nullopt;
+#else
+  if (slice.range.is_empty()) {
+    return std::nullopt;
+  }
+
+  char blob_path[FILE_MAX];
+  BLI_path_join(blob_path, sizeof(blob_path), blobs_dir_.c_str(), slice.name.c_str());
+
+  std::shared_ptr<MappedBlobFile> file;
+  {
+    std::lock_guard lock{mutex_};
+    file = mapped_files_.lookup_or_add_cb_as(blob_path,
+                                             [&]() { return MappedBlobFile::open(blob_path); });
+  }
+  if (!file || slice.range.one_after_last() > file->size()) {
+    return std::nullopt;
+  }
+  const char *data = file->data() + slice.range.start();
+  if (uintptr_t(data) % uintptr_t(alignment) != 0) {
+    /* Data written by older versions is not aligned. */
+    return std::nullopt;
+  }
+  if (!file->load(slice.range)) {
+    /* Reading through the stream reports the error. */
+    return std::nullopt;
+  }
+  return ImplicitSharingInfoAndData{
+      new ImplicitSharedValue<std::shared_ptr<MappedBlobFile>>(std::move(file)), data};
+#endif
+}
+
 [[nodiscard]] bool DiskBlobReader::read(const BlobSlice &slice, void *r_data) const
 {
   if (slice.range.is_empty()) {
@@ -123,9 +236,22 @@ BlobSlice DiskBlobWriter::write(const void *data, const int64_t size)
     char blob_path[FILE_MAX];
     BLI_path_join(blob_path, sizeof(blob_path), blob_dir_.c_str(), blob_name_.c_str());
     BLI_file_ensure_parent_dir_exists(blob_path);
+    /* Remove the file instead of overwriting it, because a previous version of it may still be
+     * mapped into memory. */
+    if (BLI_exists(blob_path)) {
+      BLI_delete(blob_path, false, false);
+    }
     blob_stream_.open(blob_path, std::ios::out | std::ios::binary);
   }
 
+  const int64_t padding = (alignment - current_offset_ % alignment) % alignment;
+  if (padding > 0) {
+    const std::array<char, alignment> zeros{};
+    blob_stream_.write(zeros.data(), padding);
+    current_offset_ += padding;
+    total_written_size_ += padding;
+  }
+
   const int64_t old_offset = current_offset_;
   blob_stream_.write(static_cast<const char *>(data), size);
   current_offset_ += size;
@@ -464,6 +590,29 @@ static std::shared_ptr<DictionaryValue> write_blob_simple_gspan(BlobWriter &blob
   return false;
 }
 
+/**
+ * Access the stored data directly if possible, which avoids copying it.
+ */
+static std::optional<ImplicitSharingInfoAndData> map_blob_simple_gspan(
+    const BlobReader &blob_reader,
+    const DictionaryValue &io_data,
+    const CPPType &cpp_type,
+    const int64_t size)
+{
+  const std::optional<BlobSlice> slice = BlobSlice::deserialize(io_data);
+  if (!slice) {
+    return std::nullopt;
+  }
+  if (slice->range.size() != cpp_type.size * size) {
+    return std::nullopt;
+  }
+  const StringRefNull stored_endian = io_data.lookup_str("endian").value_or("little");
+  if (stored_endian != get_endian_io_name(ENDIAN_ORDER)) {
+    return std::nullopt;
+  }
+  return blob_reader.map(*slice, cpp_type.alignment);
+}
+
 static std::shared_ptr<DictionaryValue> write_blob_shared_simple_gspan(
     BlobWriter &blob_writer,
     BlobWriteSharing &blob_sharing,
@@ -485,6 +634,11 @@ static std::shared_ptr<DictionaryValue> write_blob_shared_simple_gspan(
   const char *func = __func__;
   const std::optional<ImplicitSharingInfoAndData> sharing_info_and_data = blob_sharing.read_shared(
       io_data, [&]() -> std::optional<ImplicitSharingInfoAndData> {
+        if (std::optional<ImplicitSharingInfoAndData> mapped_data = map_blob_simple_gspan(
+                blob_reader, io_data, cpp_type, size))
+        {
+          return mapped_data;
+        }
         void *data_mem = MEM_mallocN_aligned(size * cpp_type.size, cpp_type.alignment, func);
         if (!read_blob_simple_gspan(blob_reader, io_data, {cpp_type, data_mem, size})) {
           MEM_freeN(data_mem);
@@ -0,0 +1,132 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "BKE_bake_items_serialize.hh"
+
+#include "BLI_array.hh"
+#include "BLI_fileops.hh"
+#include "BLI_implicit_sharing.hh"
+#include "BLI_path_utils.hh"
+#include "BLI_system.h"
+#include "BLI_task.hh"
+#include "BLI_tempfile.h"
+
+#include "testing/testing.h"
+
+#include BLI_SYSTEM_PID_H
+
+namespace blender::bke::bake::tests {
+
+class DiskBlobTest : public testing::Test {
+ protected:
+  std::string blobs_dir;
+
+  void SetUp() override
+  {
+    char temp_dir[FILE_MAX];
+    BLI_temp_directory_path_get(temp_dir, sizeof(temp_dir));
+    blobs_dir = std::string(temp_dir) + SEP_STR + "blender_bake_blob_test_" +
+                std::to_string(getpid());
+  }
+
+  void TearDown() override
+  {
+    if (BLI_exists(blobs_dir.c_str())) {
+      BLI_delete(blobs_dir.c_str(), true, true);
+    }
+  }
+};
+
+static Array<int> test_array(const int size, const int offset)
+{
+  Array<int> array(size);
+  for (const int i : array.index_range()) {
+    array[i] = i * 3 + offset;
+  }
+  return array;
+}
+
+TEST_F(DiskBlobTest, ReadWrittenArrays)
+{
+  const Array<int> array_a = test_array(5, 0);
+  const Array<int> array_b = test_array(1000, 7);
+  const Array<char> array_c(3, 'x');
+
+  BlobSlice slice_a, slice_b, slice_c;
+  {
+    /* The file is closed when the writer is destructed. */
+    DiskBlobWriter writer(blobs_dir, "test");
+    slice_a = writer.write(array_a.data(), array_a.as_span().size_in_bytes());
+    slice_c = writer.write(array_c.data(), array_c.as_span().size_in_bytes());
+    slice_b = writer.write(array_b.data(), array_b.as_span().size_in_bytes());
+  }
+  EXPECT_EQ(slice_a.range.start() % DiskBlobWriter::alignment, 0);
+  EXPECT_EQ(slice_b.range.start() % DiskBlobWriter::alignment, 0);
+  EXPECT_EQ(slice_c.range.start() % DiskBlobWriter::alignment, 0);
+
+  DiskBlobReader reader(blobs_dir);
+
+  Array<int> read_b(array_b.size());
+  EXPECT_TRUE(reader.read(slice_b, read_b.data()));
+  EXPECT_EQ_ARRAY(array_b.data(), read_b.data(), array_b.size());
+  Array<char> read_c(array_c.size());
+  EXPECT_TRUE(reader.read(slice_c, read_c.data()));
+  EXPECT_EQ_ARRAY(array_c.data(), read_c.data(), array_c.size());
+
+  const std::optional<ImplicitSharingInfoAndData> mapped_a = reader.map(slice_a, alignof(int));
+  const std::optional<ImplicitSharingInfoAndData> mapped_b = reader.map(slice_b, alignof(int));
+#ifdef WIN32
+  /* Files are never mapped on Windows. */
+  EXPECT_FALSE(mapped_a.has_value());
+  EXPECT_FALSE(mapped_b.has_value());
+#else
+  ASSERT_TRUE(mapped_a.has_value());
+  ASSERT_TRUE(mapped_b.has_value());
+  EXPECT_EQ(uintptr_t(mapped_b->data) % alignof(int), 0);
+  EXPECT_EQ_ARRAY(array_a.data(), static_cast<const int *>(mapped_a->data), array_a.size());
+  EXPECT_EQ_ARRAY(array_b.data(), static_cast<const int *>(mapped_b->data), array_b.size());
+  /* Arrays from the same file still have separate sharing info. */
+  EXPECT_NE(mapped_a->sharing_info, mapped_b->sharing_info);
+
+  /* Baking again replaces the file, but data that is still mapped stays valid. */
+  {
+    DiskBlobWriter writer(blobs_dir, "test");
+    const Array<int> new_array = test_array(2000, 1);
+    writer.write(new_array.data(), new_array.as_span().size_in_bytes());
+  }
+  EXPECT_EQ_ARRAY(array_b.data(), static_cast<const int *>(mapped_b->data), array_b.size());
+
+  mapped_a->sharing_info->remove_user_and_delete_if_last();
+  mapped_b->sharing_info->remove_user_and_delete_if_last();
+#endif
+
+  /* Empty slices are never mapped. */
+  EXPECT_FALSE(reader.map({slice_a.name, {0, 0}}, alignof(int)).has_value());
+}
+
+#ifndef WIN32
+TEST_F(DiskBlobTest, MapOnMultipleThreads)
+{
+  const Array<int> array = test_array(10000, 3);
+  BlobSlice slice;
+  {
+    DiskBlobWriter writer(blobs_dir, "test");
+    slice = writer.write(array.data(), array.as_span().size_in_bytes());
+  }
+
+  /* Files are mapped and freed concurrently, like when bakes are loaded during depsgraph
+   * evaluation. Every reader maps the file separately. */
+  threading::parallel_for(IndexRange(200), 1, [&](const IndexRange range) {
+    for ([[maybe_unused]] const int i : range) {
+      DiskBlobReader reader(blobs_dir);
+      const std::optional<ImplicitSharingInfoAndData> mapped = reader.map(slice, alignof(int));
+      ASSERT_TRUE(mapped.has_value());
+      EXPECT_EQ_ARRAY(array.data(), static_cast<const int *>(mapped->data), array.size());
+      mapped->sharing_info->remove_user_and_delete_if_last();
+    }
+  });
+}
+#endif
+
+}  // namespace blender::bke::bake::tests
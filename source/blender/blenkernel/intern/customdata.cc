@@ -78,7 +78,7 @@ using blender::Span;
 using blender::StringRef;
 using blender::Vector;
 
-/* number of layers to add when growing a CustomData object */
+/* Minimum number of layers to add when growing a CustomData object. */
 #define CUSTOMDATA_GROW 5
 
 /* ensure typemap size is ok */
@@ -2375,6 +2375,26 @@ static void free_layer_data(const eCustomDataType type, const void *data, const
   MEM_freeN(const_cast<void *>(data));
 }
 
+static void customData_resize(CustomData *data, const int grow_amount)
+{
+  data->layers = static_cast<CustomDataLayer *>(
+      MEM_reallocN(data->layers, (data->maxlayer + grow_amount) * sizeof(CustomDataLayer)));
+  data->maxlayer += grow_amount;
+}
+
+/**
+ * Make sure the layer array has room for at least `layers_num` layers. The capacity grows
+ * geometrically, so adding layers one at a time doesn't reallocate the array every few layers.
+ */
+static void customData_reserve(CustomData *data, const int layers_num)
+{
+  if (layers_num <= data->maxlayer) {
+    return;
+  }
+  const int new_maxlayer = std::max({layers_num, data->maxlayer * 2, CUSTOMDATA_GROW});
+  customData_resize(data, new_maxlayer - data->maxlayer);
+}
+
 static bool customdata_merge_internal(const CustomData *source,
                                       CustomData *dest,
                                       const eCustomDataMask mask,
@@ -2391,6 +2411,9 @@ static bool customdata_merge_internal(const CustomData *source,
   int current_type_layer_count = 0;
   int max_current_type_layer_count = -1;
 
+  /* Allocate the layer array once for all layers that may be added. */
+  customData_reserve(dest, dest->totlayer + source->totlayer);
+
   for (int i = 0; i < source->totlayer; i++) {
     const CustomDataLayer &src_layer = source->layers[i];
     const eCustomDataType type = eCustomDataType(src_layer.type);
@@ -2994,13 +3017,6 @@ bool CustomData_layer_is_anonymous(const CustomData *data, eCustomDataType type,
   return blender::bke::attribute_name_is_anonymous(data->layers[layer_index].name);
 }
 
-static void customData_resize(CustomData *data, const int grow_amount)
-{
-  data->layers = static_cast<CustomDataLayer *>(
-      MEM_reallocN(data->layers, (data->maxlayer + grow_amount) * sizeof(CustomDataLayer)));
-  data->maxlayer += grow_amount;
-}
-
 static CustomDataLayer *customData_add_layer__internal(
     CustomData *data,
     const eCustomDataType type,
@@ -3022,9 +3038,7 @@ static CustomDataLayer *customData_add_layer__internal(
   }
 
   int index = data->totlayer;
-  if (index >= data->maxlayer) {
-    customData_resize(data, CUSTOMDATA_GROW);
-  }
+  customData_reserve(data, data->totlayer + 1);
 
   data->totlayer++;
 
@@ -3236,8 +3250,10 @@ bool CustomData_free_layer(CustomData *data, const eCustomDataType type, const i
     }
   }
 
-  if (data->totlayer <= data->maxlayer - CUSTOMDATA_GROW) {
-    customData_resize(data, -CUSTOMDATA_GROW);
+  /* Only shrink once the array is mostly unused, so that alternately adding and removing a layer
+   * doesn't reallocate the array every time. */
+  if (data->maxlayer > CUSTOMDATA_GROW && data->totlayer <= data->maxlayer / 4) {
+    customData_resize(data, data->maxlayer / 2 - data->maxlayer);
   }
 
   customData_update_offsets(data);
@@ -3793,7 +3809,8 @@ bool CustomData_bmesh_merge_layout(const CustomData *source,
     return false;
   }
 
-  const BMCustomDataCopyMap map = CustomData_bmesh_copy_map_calc(destold, *dest);
+  /* The old blocks are discarded with their pool below, so move their data instead of copying. */
+  const BMCustomDataMoveMap map = CustomData_bmesh_move_map_calc(destold, *dest);
 
   int iter_type;
   int totelem;
@@ -3830,8 +3847,7 @@ bool CustomData_bmesh_merge_layout(const CustomData *source,
     /* Ensure all current elements follow new customdata layout. */
     BM_ITER_MESH (h, &iter, bm, iter_type) {
       void *tmp = nullptr;
-      CustomData_bmesh_copy_block(*dest, map, h->data, &tmp);
-      CustomData_bmesh_free_block(&destold, &h->data);
+      CustomData_bmesh_move_block(*dest, map, h->data, &tmp);
       h->data = tmp;
     }
   }
@@ -3845,8 +3861,7 @@ bool CustomData_bmesh_merge_layout(const CustomData *source,
     BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
       BM_ITER_ELEM (l, &liter, f, BM_LOOPS_OF_FACE) {
         void *tmp = nullptr;
-        CustomData_bmesh_copy_block(*dest, map, l->head.data, &tmp);
-        CustomData_bmesh_free_block(&destold, &l->head.data);
+        CustomData_bmesh_move_block(*dest, map, l->head.data, &tmp);
         l->head.data = tmp;
       }
     }
@@ -4015,6 +4030,51 @@ void CustomData_bmesh_copy_block(CustomData &dst_data,
   }
 }
 
+BMCustomDataMoveMap CustomData_bmesh_move_map_calc(const CustomData &src, const CustomData &dst)
+{
+  BMCustomDataMoveMap map;
+  for (const CustomDataLayer &layer_dst : Span(dst.layers, dst.totlayer)) {
+    const eCustomDataType type = eCustomDataType(layer_dst.type);
+    const LayerTypeInfo &type_info = *layerType_getInfo(type);
+
+    const int src_offset = CustomData_get_offset_named(&src, type, layer_dst.name);
+    if (src_offset == -1) {
+      if (type_info.set_default_value) {
+        map.copy.defaults.append({type_info.set_default_value, layer_dst.offset});
+      }
+      else {
+        map.copy.trivial_defaults.append({type_info.size, layer_dst.offset});
+      }
+    }
+    else {
+      /* Also for types with a copy callback: ownership of their data moves to the new block. */
+      map.copy.trivial_copies.append({type_info.size, src_offset, layer_dst.offset});
+    }
+  }
+  for (const CustomDataLayer &layer_src : Span(src.layers, src.totlayer)) {
+    const eCustomDataType type = eCustomDataType(layer_src.type);
+    const LayerTypeInfo &type_info = *layerType_getInfo(type);
+    if (type_info.free && CustomData_get_offset_named(&dst, type, layer_src.name) == -1) {
+      map.free_src.append({type_info.free, layer_src.offset});
+    }
+  }
+  return map;
+}
+
+void CustomData_bmesh_move_block(CustomData &dst_data,
+                                 const BMCustomDataMoveMap &map,
+                                 void *src_block,
+                                 void **dst_block)
+{
+  BLI_assert(*dst_block == nullptr);
+  if (src_block) {
+    for (const BMCustomDataMoveMap::FreeSrc &info : map.free_src) {
+      info.fn(POINTER_OFFSET(src_block, info.src_offset), 1);
+    }
+  }
+  CustomData_bmesh_copy_block(dst_data, map.copy, src_block, dst_block);
+}
+
 void CustomData_bmesh_copy_block(CustomData &data, void *src_block, void **dst_block)
 {
   if (*dst_block) {
@@ -13,9 +13,12 @@
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
 
+#include "BLI_implicit_sharing_key.hh"
 #include "BLI_listbase.h"
 #include "BLI_math_base.h"
 #include "BLI_math_matrix.h"
+#include "BLI_memory_cache.hh"
+#include "BLI_memory_counter.hh"
 #include "BLI_string.h"
 #include "BLI_utildefines.h"
 
@@ -1308,6 +1311,134 @@ void BKE_object_data_transfer_layout(Depsgraph *depsgraph,
   }
 }
 
+/* Geometry map cache.
+ *
+ * Computing the mapping between the meshes is usually the most expensive part of the transfer.
+ * The Data Transfer modifier is often re-evaluated while neither mesh changed its geometry, e.g.
+ * when animating the mix factor or a modifier after it. In that case, the maps are reused from
+ * the global memory cache (see #BLI_memory_cache.hh). */
+
+namespace blender::bke {
+
+/**
+ * Identifies a map by the settings it is computed with and the data of both meshes. The arrays
+ * are identified by their sharing data, so any change to the geometry of the meshes creates a
+ * different key.
+ */
+class MeshRemapCacheKey : public ImplicitSharingKey {
+ public:
+  std::unique_ptr<GenericKey> to_storable() const override
+  {
+    return std::make_unique<MeshRemapCacheKey>(*this);
+  }
+};
+
+class CachedMeshRemap : public memory_cache::CachedValue {
+ public:
+  MeshPairRemap map = {0};
+  int64_t sources_num = 0;
+
+  ~CachedMeshRemap() override
+  {
+    BKE_mesh_remap_free(&this->map);
+  }
+
+  void count_memory(MemoryCounter &memory) const override
+  {
+    memory.add(int64_t(this->map.items_num) * int64_t(sizeof(MeshPairRemapItem)));
+    memory.add(this->sources_num * int64_t(sizeof(int) + sizeof(float)));
+  }
+};
+
+static uint64_t float_word(const float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+/**
+ * Returns false if the mesh has data that can't be identified by its sharing data. Vertex groups
+ * are ignored, they are not used to compute the maps.
+ */
+static bool add_mesh(MeshRemapCacheKey &key, const Mesh &mesh)
+{
+  if (mesh.runtime->wrapper_type != ME_WRAPPER_TYPE_MDATA) {
+    return false;
+  }
+  key.words.extend({uint64_t(mesh.verts_num),
+                    uint64_t(mesh.edges_num),
+                    uint64_t(mesh.faces_num),
+                    uint64_t(mesh.corners_num)});
+  if (!key.add_array(mesh.face_offset_indices != nullptr,
+                     mesh.runtime->face_offsets_sharing_info))
+  {
+    return false;
+  }
+  return attributes_add_to_key(key, mesh.attributes(), [&](const AttributeIter &iter) {
+    return bool(
+        BLI_findstring(&mesh.vertex_group_names, iter.name.c_str(), offsetof(bDeformGroup, name)));
+  });
+}
+
+/**
+ * Identify both meshes before anything is transferred, the transfer itself changes the data of
+ * the destination mesh.
+ */
+static std::optional<MeshRemapCacheKey> data_transfer_meshes_key(const Mesh &me_src,
+                                                                 const Mesh &me_dst)
+{
+  MeshRemapCacheKey key;
+  if (!add_mesh(key, me_src) || !add_mesh(key, me_dst)) {
+    return std::nullopt;
+  }
+  return key;
+}
+
+/**
+ * Compute the map with \a compute_fn, or reuse a cached map computed for the same meshes with the
+ * same settings. The cached map is kept alive by \a r_cached, \a r_map only references it.
+ *
+ * \param meshes_key: Identifies both meshes, the map is not cached when this is null.
+ */
+static void data_transfer_geom_map_calc(const MeshRemapCacheKey *meshes_key,
+                                        const SpaceTransform *space_transform,
+                                        const Span<uint64_t> settings,
+                                        std::shared_ptr<const CachedMeshRemap> &r_cached,
+                                        MeshPairRemap *r_map,
+                                        const FunctionRef<void(MeshPairRemap *map)> compute_fn)
+{
+  if (meshes_key == nullptr) {
+    compute_fn(r_map);
+    return;
+  }
+
+  MeshRemapCacheKey key = *meshes_key;
+  key.words.extend(settings);
+  if (space_transform) {
+    for (const float value : Span(&space_transform->local2target[0][0], 16)) {
+      key.words.append(float_word(value));
+    }
+    for (const float value : Span(&space_transform->target2local[0][0], 16)) {
+      key.words.append(float_word(value));
+    }
+  }
+  r_cached = memory_cache::get<CachedMeshRemap>(key, [&]() {
+    auto cached = std::make_unique<CachedMeshRemap>();
+    compute_fn(&cached->map);
+    for (const MeshPairRemapItem &item : Span(cached->map.items, cached->map.items_num)) {
+      cached->sources_num += item.sources_num;
+    }
+    return cached;
+  });
+  /* The map doesn't own its memory, see #BKE_mesh_remap_free. */
+  r_map->items_num = r_cached->map.items_num;
+  r_map->items = r_cached->map.items;
+  r_map->mem = nullptr;
+}
+
+}  // namespace blender::bke
+
 bool BKE_object_data_transfer_ex(Depsgraph *depsgraph,
                                  Object *ob_src,
                                  Object *ob_dst,
@@ -1347,6 +1478,9 @@ bool BKE_object_data_transfer_ex(Depsgraph *depsgraph,
 
   MeshPairRemap geom_map[DATAMAX] = {{0}};
   bool geom_map_init[DATAMAX] = {false};
+  /* Owns the maps when they are shared with the cache. */
+  std::shared_ptr<const blender::bke::CachedMeshRemap> cached_geom_map[DATAMAX];
+  using blender::bke::float_word;
   ListBase lay_map = {nullptr};
   bool changed = false;
   bool is_modifier = false;
@@ -1398,6 +1532,12 @@ bool BKE_object_data_transfer_ex(Depsgraph *depsgraph,
         space_transform);
   }
 
+  /* Only modifiers are evaluated repeatedly with the same meshes, the operator transfers once. */
+  std::optional<blender::bke::MeshRemapCacheKey> meshes_key;
+  if (is_modifier) {
+    meshes_key = blender::bke::data_transfer_meshes_key(*me_src, *me_dst);
+  }
+
   /* Check all possible data types.
    * Note item mappings and destination mix weights are cached. */
   for (int i = 0; i < DT_TYPE_MAX; i++) {
@@ -1421,7 +1561,7 @@ bool BKE_object_data_transfer_ex(Depsgraph *depsgraph,
     }
 
     if (DT_DATATYPE_IS_VERT(dtdata_type)) {
-      blender::MutableSpan<blender::float3> positions_dst = me_dst->vert_positions_for_write();
+      const blender::Span<blender::float3> positions_dst = me_dst->vert_positions();
       const int num_verts_dst = me_dst->verts_num;
 
       if (!geom_map_init[VDATA]) {
@@ -1456,16 +1596,24 @@ bool BKE_object_data_transfer_ex(Depsgraph *depsgraph,
           continue;
         }
 
-        BKE_mesh_remap_calc_verts_from_mesh(
-            map_vert_mode,
+        blender::bke::data_transfer_geom_map_calc(
+            meshes_key ? &*meshes_key : nullptr,
             space_transform,
-            max_distance,
-            ray_radius,
-            reinterpret_cast<const float(*)[3]>(positions_dst.data()),
-            num_verts_dst,
-            me_src,
-            me_dst,
-            &geom_map[VDATA]);
+            {VDATA, uint64_t(map_vert_mode), float_word(max_distance), float_word(ray_radius)},
+            cached_geom_map[VDATA],
+            &geom_map[VDATA],
+            [&](MeshPairRemap *map) {
+              BKE_mesh_remap_calc_verts_from_mesh(
+                  map_vert_mode,
+                  space_transform,
+                  max_distance,
+                  ray_radius,
+                  reinterpret_cast<const float(*)[3]>(positions_dst.data()),
+                  num_verts_dst,
+                  me_src,
+                  me_dst,
+                  map);
+            });
         geom_map_init[VDATA] = true;
       }
 
@@ -1502,7 +1650,7 @@ bool BKE_object_data_transfer_ex(Depsgraph *depsgraph,
       }
     }
     if (DT_DATATYPE_IS_EDGE(dtdata_type)) {
-      blender::MutableSpan<blender::float3> positions_dst = me_dst->vert_positions_for_write();
+      const blender::Span<blender::float3> positions_dst = me_dst->vert_positions();
 
       const int num_verts_dst = me_dst->verts_num;
       const blender::Span<blender::int2> edges_dst = me_dst->edges();
@@ -1532,18 +1680,26 @@ bool BKE_object_data_transfer_ex(Depsgraph *depsgraph,
           continue;
         }
 
-        BKE_mesh_remap_calc_edges_from_mesh(
-            map_edge_mode,
+        blender::bke::data_transfer_geom_map_calc(
+            meshes_key ? &*meshes_key : nullptr,
             space_transform,
-            max_distance,
-            ray_radius,
-            reinterpret_cast<const float(*)[3]>(positions_dst.data()),
-            num_verts_dst,
-            edges_dst.data(),
-            edges_dst.size(),
-            me_src,
-            me_dst,
-            &geom_map[EDATA]);
+            {EDATA, uint64_t(map_edge_mode), float_word(max_distance), float_word(ray_radius)},
+            cached_geom_map[EDATA],
+            &geom_map[EDATA],
+            [&](MeshPairRemap *map) {
+              BKE_mesh_remap_calc_edges_from_mesh(
+                  map_edge_mode,
+                  space_transform,
+                  max_distance,
+                  ray_radius,
+                  reinterpret_cast<const float(*)[3]>(positions_dst.data()),
+                  num_verts_dst,
+                  edges_dst.data(),
+                  edges_dst.size(),
+                  me_src,
+                  me_dst,
+                  map);
+            });
         geom_map_init[EDATA] = true;
       }
 
@@ -1618,21 +1774,34 @@ bool BKE_object_data_transfer_ex(Depsgraph *depsgraph,
           continue;
         }
 
-        BKE_mesh_remap_calc_loops_from_mesh(
-            map_loop_mode,
+        blender::bke::data_transfer_geom_map_calc(
+            meshes_key ? &*meshes_key : nullptr,
             space_transform,
-            max_distance,
-            ray_radius,
-            me_dst,
-            reinterpret_cast<const float(*)[3]>(positions_dst.data()),
-            num_verts_dst,
-            corner_verts_dst.data(),
-            corner_verts_dst.size(),
-            faces_dst,
-            me_src,
-            island_callback,
-            islands_handling_precision,
-            &geom_map[LDATA]);
+            {LDATA,
+             uint64_t(map_loop_mode),
+             float_word(max_distance),
+             float_word(ray_radius),
+             float_word(islands_handling_precision),
+             uint64_t(uintptr_t(island_callback))},
+            cached_geom_map[LDATA],
+            &geom_map[LDATA],
+            [&](MeshPairRemap *map) {
+              BKE_mesh_remap_calc_loops_from_mesh(
+                  map_loop_mode,
+                  space_transform,
+                  max_distance,
+                  ray_radius,
+                  me_dst,
+                  reinterpret_cast<const float(*)[3]>(positions_dst.data()),
+                  num_verts_dst,
+                  corner_verts_dst.data(),
+                  corner_verts_dst.size(),
+                  faces_dst,
+                  me_src,
+                  island_callback,
+                  islands_handling_precision,
+                  map);
+            });
         geom_map_init[LDATA] = true;
       }
 
@@ -1704,18 +1873,26 @@ bool BKE_object_data_transfer_ex(Depsgraph *depsgraph,
           continue;
         }
 
-        BKE_mesh_remap_calc_faces_from_mesh(
-            map_face_mode,
+        blender::bke::data_transfer_geom_map_calc(
+            meshes_key ? &*meshes_key : nullptr,
             space_transform,
-            max_distance,
-            ray_radius,
-            me_dst,
-            reinterpret_cast<const float(*)[3]>(positions_dst.data()),
-            num_verts_dst,
-            corner_verts_dst.data(),
-            faces_dst,
-            me_src,
-            &geom_map[PDATA]);
+            {PDATA, uint64_t(map_face_mode), float_word(max_distance), float_word(ray_radius)},
+            cached_geom_map[PDATA],
+            &geom_map[PDATA],
+            [&](MeshPairRemap *map) {
+              BKE_mesh_remap_calc_faces_from_mesh(
+                  map_face_mode,
+                  space_transform,
+                  max_distance,
+                  ray_radius,
+                  me_dst,
+                  reinterpret_cast<const float(*)[3]>(positions_dst.data()),
+                  num_verts_dst,
+                  corner_verts_dst.data(),
+                  faces_dst,
+                  me_src,
+                  map);
+            });
         geom_map_init[PDATA] = true;
       }
 
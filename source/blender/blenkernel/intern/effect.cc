@@ -126,12 +126,18 @@ void BKE_partdeflect_free(PartDeflect *pd)
 
 /******************** EFFECTOR RELATIONS ***********************/
 
-static void precalculate_effector(Depsgraph *depsgraph, EffectorCache *eff)
+static uint effector_random_seed(Depsgraph *depsgraph, const PartDeflect *pd)
 {
   float ctime = DEG_get_ctime(depsgraph);
   uint cfra = uint(ctime >= 0 ? ctime : -ctime);
+  return pd->seed + cfra;
+}
 
-  eff->rng = BLI_rng_new(eff->pd->seed + cfra);
+static void precalculate_effector(Depsgraph *depsgraph, EffectorCache *eff)
+{
+  float ctime = DEG_get_ctime(depsgraph);
+
+  eff->rng = BLI_rng_new(effector_random_seed(depsgraph, eff->pd));
 
   if (eff->pd->forcefield == PFIELD_GUIDE && eff->ob->type == OB_CURVES_LEGACY) {
     Curve *cu = static_cast<Curve *>(eff->ob->data);
@@ -375,6 +381,23 @@ void BKE_effectors_free(ListBase *lb)
   }
 }
 
+bool BKE_effectors_use_random(const ListBase *effectors)
+{
+  LISTBASE_FOREACH (const EffectorCache *, eff, effectors) {
+    if (eff->pd->f_noise > 0.0f) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void BKE_effectors_reset_random(ListBase *effectors)
+{
+  LISTBASE_FOREACH (EffectorCache *, eff, effectors) {
+    BLI_rng_seed(eff->rng, effector_random_seed(eff->depsgraph, eff->pd));
+  }
+}
+
 void pd_point_from_particle(ParticleSimulationData *sim,
                             ParticleData *pa,
                             ParticleKey *state,
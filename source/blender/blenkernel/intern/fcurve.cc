@@ -2005,9 +2005,28 @@ static float fcurve_eval_keyframes_extrapolate(const FCurve *fcu,
   return endpoint_bezt->vec[1][1] - (fac * dx);
 }
 
+/**
+ * Check whether the segment that ends at the keyframe with the given index contains the
+ * evaluation time, with enough distance to both keyframes that the binary search would not treat
+ * either of them as an exact match. In that case the binary search would return the same index.
+ */
+static bool fcurve_segment_hint_is_valid(const FCurve *fcu,
+                                         const BezTriple *bezts,
+                                         const float evaltime,
+                                         const float threshold,
+                                         const int segment_hint)
+{
+  if (segment_hint <= 0 || segment_hint >= int(fcu->totvert)) {
+    return false;
+  }
+  return evaltime - bezts[segment_hint - 1].vec[1][0] > threshold &&
+         bezts[segment_hint].vec[1][0] - evaltime > threshold;
+}
+
 static float fcurve_eval_keyframes_interpolate(const FCurve *fcu,
                                                const BezTriple *bezts,
-                                               float evaltime)
+                                               float evaltime,
+                                               int *segment_hint)
 {
   const float eps = 1.e-8f;
   uint a;
@@ -2025,7 +2044,18 @@ static float fcurve_eval_keyframes_interpolate(const FCurve *fcu,
    *   Weird errors, like selecting the wrong keyframe range (see #39207), occur.
    *   This lower bound was established in b888a32eee8147b028464336ad2404d8155c64dd.
    */
-  a = BKE_fcurve_bezt_binarysearch_index_ex(bezts, evaltime, fcu->totvert, 0.0001, &exact);
+  const float threshold = 0.0001f;
+  if (segment_hint && fcurve_segment_hint_is_valid(fcu, bezts, evaltime, threshold, *segment_hint))
+  {
+    /* Consecutive evaluations usually stay in the same segment, skip the search. */
+    a = uint(*segment_hint);
+  }
+  else {
+    a = BKE_fcurve_bezt_binarysearch_index_ex(bezts, evaltime, fcu->totvert, threshold, &exact);
+    if (segment_hint) {
+      *segment_hint = int(a);
+    }
+  }
   const BezTriple *bezt = bezts + a;
 
   if (exact) {
@@ -2269,7 +2299,10 @@ static float fcurve_eval_keyframes_interpolate(const FCurve *fcu,
 }
 
 /* Calculate F-Curve value for 'evaltime' using #BezTriple keyframes. */
-static float fcurve_eval_keyframes(const FCurve *fcu, const BezTriple *bezts, float evaltime)
+static float fcurve_eval_keyframes(const FCurve *fcu,
+                                   const BezTriple *bezts,
+                                   float evaltime,
+                                   int *segment_hint)
 {
   if (evaltime <= bezts->vec[1][0]) {
     return fcurve_eval_keyframes_extrapolate(fcu, bezts, evaltime, 0, +1);
@@ -2280,7 +2313,7 @@ static float fcurve_eval_keyframes(const FCurve *fcu, const BezTriple *bezts, fl
     return fcurve_eval_keyframes_extrapolate(fcu, bezts, evaltime, fcu->totvert - 1, -1);
   }
 
-  return fcurve_eval_keyframes_interpolate(fcu, bezts, evaltime);
+  return fcurve_eval_keyframes_interpolate(fcu, bezts, evaltime, segment_hint);
 }
 
 /* Calculate F-Curve value for 'evaltime' using #FPoint samples. */
@@ -2328,7 +2361,10 @@ static float fcurve_eval_samples(const FCurve *fcu, const FPoint *fpts, float ev
 /* Evaluate and return the value of the given F-Curve at the specified frame ("evaltime")
  * NOTE: this is also used for drivers.
  */
-static float evaluate_fcurve_ex(const FCurve *fcu, float evaltime, float cvalue)
+static float evaluate_fcurve_ex(const FCurve *fcu,
+                                float evaltime,
+                                float cvalue,
+                                int *segment_hint = nullptr)
 {
   /* Evaluate modifiers which modify time to evaluate the base curve at. */
   FModifiersStackStorage storage;
@@ -2344,7 +2380,7 @@ static float evaluate_fcurve_ex(const FCurve *fcu, float evaltime, float cvalue)
    *   F-Curve modifier on the stack requested the curve to be evaluated at.
    */
   if (fcu->bezt) {
-    cvalue = fcurve_eval_keyframes(fcu, fcu->bezt, devaltime);
+    cvalue = fcurve_eval_keyframes(fcu, fcu->bezt, devaltime, segment_hint);
   }
   else if (fcu->fpt) {
     cvalue = fcurve_eval_samples(fcu, fcu->fpt, devaltime);
@@ -2455,6 +2491,23 @@ float calculate_fcurve(PathResolvedRNA *anim_rna,
   return curval;
 }
 
+float calculate_fcurve_with_segment_hint(PathResolvedRNA *anim_rna,
+                                         FCurve *fcu,
+                                         const AnimationEvalContext *anim_eval_context,
+                                         int &segment_hint)
+{
+  if (fcu->driver) {
+    return calculate_fcurve(anim_rna, fcu, anim_eval_context);
+  }
+  if (BKE_fcurve_is_empty(fcu)) {
+    return 0.0f;
+  }
+
+  const float curval = evaluate_fcurve_ex(fcu, anim_eval_context->eval_time, 0.0f, &segment_hint);
+  fcu->curval = curval; /* Debug display only, not thread safe! */
+  return curval;
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -24,6 +24,7 @@
 #include "BLI_string_utf8.h"
 #include "BLI_string_utils.hh"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "BLT_translation.hh"
 
@@ -50,10 +51,29 @@
 #endif
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstring>
 
 #ifdef WITH_PYTHON
-static blender::Mutex python_driver_lock;
+/**
+ * Python drivers can only be evaluated by one thread at a time. Rather than every depsgraph thread
+ * acquiring the GIL for its own driver, threads add their drivers to this queue, and one of the
+ * waiting threads evaluates everything queued so far with a single GIL acquisition. On rigs with
+ * many Python drivers this removes most of the GIL hand-over between threads.
+ */
+struct PythonDriverRequest {
+  BPy_DriverExecItem item;
+  bool is_done = false;
+};
+
+static struct {
+  /* Not a #blender::Mutex, which doesn't work with condition variables. */
+  std::mutex mutex;
+  std::condition_variable cond;
+  blender::Vector<PythonDriverRequest *> requests;
+  /** True while a thread is evaluating a batch of drivers. */
+  bool is_evaluating = false;
+} python_driver_queue;
 #endif
 
 static CLG_LogRef LOG = {"bke.fcurve"};
@@ -1374,6 +1394,49 @@ static void evaluate_driver_min_max(const AnimationEvalContext *anim_eval_contex
   driver->curval = value;
 }
 
+#ifdef WITH_PYTHON
+static float evaluate_driver_python_queued(PathResolvedRNA *anim_rna,
+                                           ChannelDriver *driver,
+                                           ChannelDriver *driver_orig,
+                                           const AnimationEvalContext *anim_eval_context)
+{
+  PythonDriverRequest request;
+  request.item = {anim_rna, driver, driver_orig, anim_eval_context, 0.0f};
+
+  std::unique_lock lock(python_driver_queue.mutex);
+  python_driver_queue.requests.append(&request);
+
+  while (!request.is_done) {
+    if (python_driver_queue.is_evaluating) {
+      python_driver_queue.cond.wait(lock);
+      continue;
+    }
+
+    /* Evaluate all queued drivers, including the one of this thread. Requests added while the
+     * batch is evaluated are handled by the next batch. */
+    blender::Vector<PythonDriverRequest *> batch = std::move(python_driver_queue.requests);
+    python_driver_queue.requests.clear();
+    python_driver_queue.is_evaluating = true;
+    lock.unlock();
+
+    blender::Vector<BPy_DriverExecItem *> items(batch.size());
+    for (const int64_t i : batch.index_range()) {
+      items[i] = &batch[i]->item;
+    }
+    BPY_driver_exec_batch(items);
+
+    lock.lock();
+    for (PythonDriverRequest *batch_request : batch) {
+      batch_request->is_done = true;
+    }
+    python_driver_queue.is_evaluating = false;
+    python_driver_queue.cond.notify_all();
+  }
+
+  return request.item.result;
+}
+#endif /* WITH_PYTHON */
+
 static void evaluate_driver_python(PathResolvedRNA *anim_rna,
                                    ChannelDriver *driver,
                                    ChannelDriver *driver_orig,
@@ -1392,9 +1455,8 @@ static void evaluate_driver_python(PathResolvedRNA *anim_rna,
 #ifdef WITH_PYTHON
     /* This evaluates the expression using Python, and returns its result:
      * - on errors it reports, then returns 0.0f. */
-    std::scoped_lock lock(python_driver_lock);
-
-    driver->curval = BPY_driver_exec(anim_rna, driver, driver_orig, anim_eval_context);
+    driver->curval = evaluate_driver_python_queued(
+        anim_rna, driver, driver_orig, anim_eval_context);
 
 #else  /* WITH_PYTHON */
     UNUSED_VARS(anim_rna, anim_eval_context);
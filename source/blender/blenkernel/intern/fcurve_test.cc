@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 #include "testing/testing.h"
 
+#include "BKE_animsys.h"
 #include "BKE_fcurve.hh"
 
 #include "ANIM_fcurve.hh"
@@ -131,6 +132,46 @@ TEST(evaluate_fcurve, InterpolationBezier)
   BKE_fcurve_free(fcu);
 }
 
+TEST(evaluate_fcurve, SegmentHint)
+{
+  FCurve *fcu = BKE_fcurve_create();
+
+  const KeyframeSettings settings = get_keyframe_settings(false);
+  insert_vert_fcurve(fcu, {1.0f, 7.0f}, settings, INSERTKEY_NOFLAGS);
+  insert_vert_fcurve(fcu, {2.0f, 13.0f}, settings, INSERTKEY_NOFLAGS);
+  insert_vert_fcurve(fcu, {3.0f, 19.0f}, settings, INSERTKEY_NOFLAGS);
+  insert_vert_fcurve(fcu, {4.0f, 11.0f}, settings, INSERTKEY_NOFLAGS);
+
+  AnimationEvalContext anim_eval_context = {nullptr, 0.0f};
+  int segment_hint = 0;
+  /* Step forward and backward through the curve, the hint must never change the result. */
+  for (const float frame : {0.5f, 1.25f, 1.5f, 2.0f, 2.75f, 3.5f, 3.5f, 1.75f, 2.0f - 0.00008f, 4.5f})
+  {
+    anim_eval_context.eval_time = frame;
+    const float expected = evaluate_fcurve(fcu, frame);
+    EXPECT_NEAR(
+        calculate_fcurve_with_segment_hint(nullptr, fcu, &anim_eval_context, segment_hint),
+        expected,
+        EPSILON)
+        << "at frame " << frame;
+  }
+
+  /* The hint is updated to the segment that contains the last interpolated frame. */
+  anim_eval_context.eval_time = 3.5f;
+  calculate_fcurve_with_segment_hint(nullptr, fcu, &anim_eval_context, segment_hint);
+  EXPECT_EQ(segment_hint, 3);
+
+  /* An invalid hint falls back to searching the keyframes. */
+  segment_hint = 47;
+  anim_eval_context.eval_time = 1.5f;
+  EXPECT_NEAR(calculate_fcurve_with_segment_hint(nullptr, fcu, &anim_eval_context, segment_hint),
+              evaluate_fcurve(fcu, 1.5f),
+              EPSILON);
+  EXPECT_EQ(segment_hint, 1);
+
+  BKE_fcurve_free(fcu);
+}
+
 TEST(evaluate_fcurve, InterpolationBounce)
 {
   FCurve *fcu = BKE_fcurve_create();
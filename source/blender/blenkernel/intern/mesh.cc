@@ -172,6 +172,8 @@ static void mesh_copy_data(Main *bmain,
   mesh_dst->runtime->bvh_cache_loose_edges_no_hidden =
       mesh_src->runtime->bvh_cache_loose_edges_no_hidden;
   mesh_dst->runtime->max_material_index = mesh_src->runtime->max_material_index;
+  mesh_dst->runtime->uv_tangents_cache = mesh_src->runtime->uv_tangents_cache;
+  mesh_dst->runtime->armature_skin_weights_cache = mesh_src->runtime->armature_skin_weights_cache;
   if (mesh_src->runtime->bake_materials) {
     mesh_dst->runtime->bake_materials = std::make_unique<blender::bke::bake::BakeMaterialsList>(
         *mesh_src->runtime->bake_materials);
@@ -8,6 +8,8 @@
  * Functions for mapping data between meshes.
  */
 
+#include <mutex>
+
 #include "CLG_log.h"
 
 #include "MEM_guardedalloc.h"
@@ -15,6 +17,8 @@
 #include "BLI_array.hh"
 #include "BLI_astar.h"
 #include "BLI_bit_vector.hh"
+#include "BLI_enumerable_thread_specific.hh"
+#include "BLI_function_ref.hh"
 #include "BLI_index_mask.hh"
 #include "BLI_math_geom.h"
 #include "BLI_math_matrix.h"
@@ -24,6 +28,7 @@
 #include "BLI_memarena.h"
 #include "BLI_polyfill_2d.h"
 #include "BLI_rand.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "DNA_modifier_enums.h"
@@ -71,6 +76,17 @@ static bool mesh_remap_bvhtree_query_nearest(blender::bke::BVHTreeFromMesh *tree
   return false;
 }
 
+/**
+ * Forget the result of the previous query, so that it's not used as starting point of the next
+ * one. In parallel loops the previous element depends on how the elements are split into ranges,
+ * so using it would make the result depend on the scheduling when several items are equally near.
+ */
+static void mesh_remap_bvhtree_nearest_reset(BVHTreeNearest *nearest, const float max_dist_sq)
+{
+  nearest->index = -1;
+  nearest->dist_sq = max_dist_sq;
+}
+
 static bool mesh_remap_bvhtree_query_raycast(blender::bke::BVHTreeFromMesh *treedata,
                                              BVHTreeRayHit *rayhit,
                                              const float co[3],
@@ -357,6 +373,31 @@ void BKE_mesh_remap_item_define_invalid(MeshPairRemap *map, const int index)
   mesh_remap_item_define(map, index, FLT_MAX, 0, 0, nullptr, nullptr);
 }
 
+/**
+ * Define the items of \a r_map for the given range of destination elements in parallel. The items
+ * array is shared because every item is defined only once, but each thread allocates the source
+ * indices and weights from its own arena, which is merged into the arena of the map at the end.
+ */
+static void mesh_remap_items_define_parallel(
+    MeshPairRemap *r_map,
+    const blender::IndexRange range,
+    const int64_t grain_size,
+    const blender::FunctionRef<void(blender::IndexRange range, MeshPairRemap *map)> fn)
+{
+  using namespace blender;
+  threading::EnumerableThreadSpecific<MemArena *> arenas(
+      []() { return BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, "mesh_remap_items_define"); });
+  threading::parallel_for(range, grain_size, [&](const IndexRange sub_range) {
+    MeshPairRemap local_map = *r_map;
+    local_map.mem = arenas.local();
+    fn(sub_range, &local_map);
+  });
+  for (MemArena *arena : arenas) {
+    BLI_memarena_merge(r_map->mem, arena);
+    BLI_memarena_free(arena);
+  }
+}
+
 static int mesh_remap_interp_face_data_get(const blender::IndexRange face,
                                            const blender::Span<int> corner_verts,
                                            const blender::Span<blender::float3> positions_src,
@@ -445,6 +486,9 @@ struct IslandResult {
 /* Will be enough in 99% of cases. */
 #define MREMAP_DEFAULT_BUFSIZE 32
 
+/* Destination elements per task, each one needs at least one BVH query. */
+#define MREMAP_GRAIN_SIZE 256
+
 void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
                                          const SpaceTransform *space_transform,
                                          const float max_dist,
@@ -455,9 +499,10 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
                                          Mesh *me_dst,
                                          MeshPairRemap *r_map)
 {
+  using namespace blender;
   const float full_weight = 1.0f;
   const float max_dist_sq = max_dist * max_dist;
-  int i;
+  const IndexRange verts_dst(numverts_dst);
 
   BLI_assert(mode & MREMAP_MODE_VERT);
 
@@ -465,198 +510,221 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
 
   if (mode == MREMAP_MODE_TOPOLOGY) {
     BLI_assert(numverts_dst == me_src->verts_num);
-    for (i = 0; i < numverts_dst; i++) {
-      mesh_remap_item_define(r_map, i, FLT_MAX, 0, 1, &i, &full_weight);
-    }
+    mesh_remap_items_define_parallel(
+        r_map, verts_dst, MREMAP_GRAIN_SIZE, [&](const IndexRange range, MeshPairRemap *map) {
+          for (const int64_t elem_dst : range) {
+            const int i = int(elem_dst);
+            mesh_remap_item_define(map, i, FLT_MAX, 0, 1, &i, &full_weight);
+          }
+        });
   }
   else {
-    blender::bke::BVHTreeFromMesh treedata{};
-    BVHTreeNearest nearest = {0};
-    BVHTreeRayHit rayhit = {0};
-    float hit_dist;
-    float tmp_co[3], tmp_no[3];
+    bke::BVHTreeFromMesh treedata{};
 
     if (mode == MREMAP_MODE_VERT_NEAREST) {
       treedata = me_src->bvh_verts();
-      nearest.index = -1;
 
-      for (i = 0; i < numverts_dst; i++) {
-        copy_v3_v3(tmp_co, vert_positions_dst[i]);
+      mesh_remap_items_define_parallel(
+          r_map, verts_dst, MREMAP_GRAIN_SIZE, [&](const IndexRange range, MeshPairRemap *map) {
+            BVHTreeNearest nearest = {0};
+            float hit_dist;
+            float tmp_co[3];
 
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-        }
+            for (const int64_t elem_dst : range) {
+              const int i = int(elem_dst);
+              mesh_remap_bvhtree_nearest_reset(&nearest, max_dist_sq);
+              copy_v3_v3(tmp_co, vert_positions_dst[i]);
 
-        if (mesh_remap_bvhtree_query_nearest(&treedata, &nearest, tmp_co, max_dist_sq, &hit_dist))
-        {
-          mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &nearest.index, &full_weight);
-        }
-        else {
-          /* No source for this dest vertex! */
-          BKE_mesh_remap_item_define_invalid(r_map, i);
-        }
-      }
+              /* Convert the vertex to tree coordinates, if needed. */
+              if (space_transform) {
+                BLI_space_transform_apply(space_transform, tmp_co);
+              }
+
+              if (mesh_remap_bvhtree_query_nearest(
+                      &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist))
+              {
+                mesh_remap_item_define(map, i, hit_dist, 0, 1, &nearest.index, &full_weight);
+              }
+              else {
+                /* No source for this dest vertex! */
+                BKE_mesh_remap_item_define_invalid(map, i);
+              }
+            }
+          });
     }
     else if (ELEM(mode, MREMAP_MODE_VERT_EDGE_NEAREST, MREMAP_MODE_VERT_EDGEINTERP_NEAREST)) {
-      const blender::Span<blender::int2> edges_src = me_src->edges();
-      const blender::Span<blender::float3> positions_src = me_src->vert_positions();
+      const Span<int2> edges_src = me_src->edges();
+      const Span<float3> positions_src = me_src->vert_positions();
 
       treedata = me_src->bvh_edges();
-      nearest.index = -1;
 
-      for (i = 0; i < numverts_dst; i++) {
-        copy_v3_v3(tmp_co, vert_positions_dst[i]);
+      mesh_remap_items_define_parallel(
+          r_map, verts_dst, MREMAP_GRAIN_SIZE, [&](const IndexRange range, MeshPairRemap *map) {
+            BVHTreeNearest nearest = {0};
+            float hit_dist;
+            float tmp_co[3];
 
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-        }
+            for (const int64_t elem_dst : range) {
+              const int i = int(elem_dst);
+              mesh_remap_bvhtree_nearest_reset(&nearest, max_dist_sq);
+              copy_v3_v3(tmp_co, vert_positions_dst[i]);
 
-        if (mesh_remap_bvhtree_query_nearest(&treedata, &nearest, tmp_co, max_dist_sq, &hit_dist))
-        {
-          const blender::int2 &edge = edges_src[nearest.index];
-          const float *v1cos = positions_src[edge[0]];
-          const float *v2cos = positions_src[edge[1]];
-
-          if (mode == MREMAP_MODE_VERT_EDGE_NEAREST) {
-            const float dist_v1 = len_squared_v3v3(tmp_co, v1cos);
-            const float dist_v2 = len_squared_v3v3(tmp_co, v2cos);
-            const int index = (dist_v1 > dist_v2) ? edge[1] : edge[0];
-            mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &index, &full_weight);
-          }
-          else if (mode == MREMAP_MODE_VERT_EDGEINTERP_NEAREST) {
-            int indices[2];
-            float weights[2];
+              /* Convert the vertex to tree coordinates, if needed. */
+              if (space_transform) {
+                BLI_space_transform_apply(space_transform, tmp_co);
+              }
 
-            indices[0] = edge[0];
-            indices[1] = edge[1];
+              if (mesh_remap_bvhtree_query_nearest(
+                      &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist))
+              {
+                const int2 &edge = edges_src[nearest.index];
+                const float *v1cos = positions_src[edge[0]];
+                const float *v2cos = positions_src[edge[1]];
+
+                if (mode == MREMAP_MODE_VERT_EDGE_NEAREST) {
+                  const float dist_v1 = len_squared_v3v3(tmp_co, v1cos);
+                  const float dist_v2 = len_squared_v3v3(tmp_co, v2cos);
+                  const int index = (dist_v1 > dist_v2) ? edge[1] : edge[0];
+                  mesh_remap_item_define(map, i, hit_dist, 0, 1, &index, &full_weight);
+                }
+                else if (mode == MREMAP_MODE_VERT_EDGEINTERP_NEAREST) {
+                  int indices[2];
+                  float weights[2];
 
-            /* Weight is inverse of point factor here... */
-            weights[0] = line_point_factor_v3(tmp_co, v2cos, v1cos);
-            CLAMP(weights[0], 0.0f, 1.0f);
-            weights[1] = 1.0f - weights[0];
+                  indices[0] = edge[0];
+                  indices[1] = edge[1];
 
-            mesh_remap_item_define(r_map, i, hit_dist, 0, 2, indices, weights);
-          }
-        }
-        else {
-          /* No source for this dest vertex! */
-          BKE_mesh_remap_item_define_invalid(r_map, i);
-        }
-      }
+                  /* Weight is inverse of point factor here... */
+                  weights[0] = line_point_factor_v3(tmp_co, v2cos, v1cos);
+                  CLAMP(weights[0], 0.0f, 1.0f);
+                  weights[1] = 1.0f - weights[0];
+
+                  mesh_remap_item_define(map, i, hit_dist, 0, 2, indices, weights);
+                }
+              }
+              else {
+                /* No source for this dest vertex! */
+                BKE_mesh_remap_item_define_invalid(map, i);
+              }
+            }
+          });
     }
     else if (ELEM(mode,
                   MREMAP_MODE_VERT_FACE_NEAREST,
                   MREMAP_MODE_VERT_POLYINTERP_NEAREST,
                   MREMAP_MODE_VERT_POLYINTERP_VNORPROJ))
     {
-      const blender::OffsetIndices faces_src = me_src->faces();
-      const blender::Span<int> corner_verts_src = me_src->corner_verts();
-      const blender::Span<blender::float3> positions_src = me_src->vert_positions();
-      const blender::Span<blender::float3> vert_normals_dst = me_dst->vert_normals();
-      const blender::Span<int> tri_faces = me_src->corner_tri_faces();
-
-      size_t tmp_buff_size = MREMAP_DEFAULT_BUFSIZE;
-      float(*vcos)[3] = MEM_malloc_arrayN<float[3]>(tmp_buff_size, __func__);
-      int *indices = MEM_malloc_arrayN<int>(tmp_buff_size, __func__);
-      float *weights = MEM_malloc_arrayN<float>(tmp_buff_size, __func__);
+      const OffsetIndices faces_src = me_src->faces();
+      const Span<int> corner_verts_src = me_src->corner_verts();
+      const Span<float3> positions_src = me_src->vert_positions();
+      const Span<float3> vert_normals_dst = me_dst->vert_normals();
+      const Span<int> tri_faces = me_src->corner_tri_faces();
 
       treedata = me_src->bvh_corner_tris();
 
-      if (mode == MREMAP_MODE_VERT_POLYINTERP_VNORPROJ) {
-        for (i = 0; i < numverts_dst; i++) {
-          copy_v3_v3(tmp_co, vert_positions_dst[i]);
-          copy_v3_v3(tmp_no, vert_normals_dst[i]);
+      mesh_remap_items_define_parallel(
+          r_map, verts_dst, MREMAP_GRAIN_SIZE, [&](const IndexRange range, MeshPairRemap *map) {
+            BVHTreeNearest nearest = {0};
+            BVHTreeRayHit rayhit = {0};
+            float hit_dist;
+            float tmp_co[3], tmp_no[3];
 
-          /* Convert the vertex to tree coordinates, if needed. */
-          if (space_transform) {
-            BLI_space_transform_apply(space_transform, tmp_co);
-            BLI_space_transform_apply_normal(space_transform, tmp_no);
-          }
+            size_t tmp_buff_size = MREMAP_DEFAULT_BUFSIZE;
+            float(*vcos)[3] = MEM_malloc_arrayN<float[3]>(tmp_buff_size, __func__);
+            int *indices = MEM_malloc_arrayN<int>(tmp_buff_size, __func__);
+            float *weights = MEM_malloc_arrayN<float>(tmp_buff_size, __func__);
 
-          if (mesh_remap_bvhtree_query_raycast(
-                  &treedata, &rayhit, tmp_co, tmp_no, ray_radius, max_dist, &hit_dist))
-          {
-            const int face_index = tri_faces[rayhit.index];
-            const int sources_num = mesh_remap_interp_face_data_get(faces_src[face_index],
-                                                                    corner_verts_src,
-                                                                    positions_src,
-                                                                    rayhit.co,
-                                                                    &tmp_buff_size,
-                                                                    &vcos,
-                                                                    false,
-                                                                    &indices,
-                                                                    &weights,
-                                                                    true,
-                                                                    nullptr);
-
-            mesh_remap_item_define(r_map, i, hit_dist, 0, sources_num, indices, weights);
-          }
-          else {
-            /* No source for this dest vertex! */
-            BKE_mesh_remap_item_define_invalid(r_map, i);
-          }
-        }
-      }
-      else {
-        nearest.index = -1;
+            for (const int64_t elem_dst : range) {
+              const int i = int(elem_dst);
+              mesh_remap_bvhtree_nearest_reset(&nearest, max_dist_sq);
+              copy_v3_v3(tmp_co, vert_positions_dst[i]);
 
-        for (i = 0; i < numverts_dst; i++) {
-          copy_v3_v3(tmp_co, vert_positions_dst[i]);
+              if (mode == MREMAP_MODE_VERT_POLYINTERP_VNORPROJ) {
+                copy_v3_v3(tmp_no, vert_normals_dst[i]);
 
-          /* Convert the vertex to tree coordinates, if needed. */
-          if (space_transform) {
-            BLI_space_transform_apply(space_transform, tmp_co);
-          }
+                /* Convert the vertex to tree coordinates, if needed. */
+                if (space_transform) {
+                  BLI_space_transform_apply(space_transform, tmp_co);
+                  BLI_space_transform_apply_normal(space_transform, tmp_no);
+                }
 
-          if (mesh_remap_bvhtree_query_nearest(
-                  &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist))
-          {
-            const int face_index = tri_faces[nearest.index];
-
-            if (mode == MREMAP_MODE_VERT_FACE_NEAREST) {
-              int index;
-              mesh_remap_interp_face_data_get(faces_src[face_index],
-                                              corner_verts_src,
-                                              positions_src,
-                                              nearest.co,
-                                              &tmp_buff_size,
-                                              &vcos,
-                                              false,
-                                              &indices,
-                                              &weights,
-                                              false,
-                                              &index);
+                if (mesh_remap_bvhtree_query_raycast(
+                        &treedata, &rayhit, tmp_co, tmp_no, ray_radius, max_dist, &hit_dist))
+                {
+                  const int face_index = tri_faces[rayhit.index];
+                  const int sources_num = mesh_remap_interp_face_data_get(faces_src[face_index],
+                                                                          corner_verts_src,
+                                                                          positions_src,
+                                                                          rayhit.co,
+                                                                          &tmp_buff_size,
+                                                                          &vcos,
+                                                                          false,
+                                                                          &indices,
+                                                                          &weights,
+                                                                          true,
+                                                                          nullptr);
+
+                  mesh_remap_item_define(map, i, hit_dist, 0, sources_num, indices, weights);
+                }
+                else {
+                  /* No source for this dest vertex! */
+                  BKE_mesh_remap_item_define_invalid(map, i);
+                }
+                continue;
+              }
 
-              mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &index, &full_weight);
-            }
-            else if (mode == MREMAP_MODE_VERT_POLYINTERP_NEAREST) {
-              const int sources_num = mesh_remap_interp_face_data_get(faces_src[face_index],
-                                                                      corner_verts_src,
-                                                                      positions_src,
-                                                                      nearest.co,
-                                                                      &tmp_buff_size,
-                                                                      &vcos,
-                                                                      false,
-                                                                      &indices,
-                                                                      &weights,
-                                                                      true,
-                                                                      nullptr);
-
-              mesh_remap_item_define(r_map, i, hit_dist, 0, sources_num, indices, weights);
+              /* Convert the vertex to tree coordinates, if needed. */
+              if (space_transform) {
+                BLI_space_transform_apply(space_transform, tmp_co);
+              }
+
+              if (mesh_remap_bvhtree_query_nearest(
+                      &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist))
+              {
+                const int face_index = tri_faces[nearest.index];
+
+                if (mode == MREMAP_MODE_VERT_FACE_NEAREST) {
+                  int index;
+                  mesh_remap_interp_face_data_get(faces_src[face_index],
+                                                  corner_verts_src,
+                                                  positions_src,
+                                                  nearest.co,
+                                                  &tmp_buff_size,
+                                                  &vcos,
+                                                  false,
+                                                  &indices,
+                                                  &weights,
+                                                  false,
+                                                  &index);
+
+                  mesh_remap_item_define(map, i, hit_dist, 0, 1, &index, &full_weight);
+                }
+                else if (mode == MREMAP_MODE_VERT_POLYINTERP_NEAREST) {
+                  const int sources_num = mesh_remap_interp_face_data_get(faces_src[face_index],
+                                                                          corner_verts_src,
+                                                                          positions_src,
+                                                                          nearest.co,
+                                                                          &tmp_buff_size,
+                                                                          &vcos,
+                                                                          false,
+                                                                          &indices,
+                                                                          &weights,
+                                                                          true,
+                                                                          nullptr);
+
+                  mesh_remap_item_define(map, i, hit_dist, 0, sources_num, indices, weights);
+                }
+              }
+              else {
+                /* No source for this dest vertex! */
+                BKE_mesh_remap_item_define_invalid(map, i);
+              }
             }
-          }
-          else {
-            /* No source for this dest vertex! */
-            BKE_mesh_remap_item_define_invalid(r_map, i);
-          }
-        }
-      }
 
-      MEM_freeN(vcos);
-      MEM_freeN(indices);
-      MEM_freeN(weights);
+            MEM_freeN(vcos);
+            MEM_freeN(indices);
+            MEM_freeN(weights);
+          });
     }
     else {
       CLOG_WARN(&LOG, "Unsupported mesh-to-mesh vertex mapping mode (%d)!", mode);
@@ -1223,17 +1291,20 @@ void BKE_mesh_remap_calc_loops_from_mesh(const int mode,
   if (mode == MREMAP_MODE_TOPOLOGY) {
     /* In topology mapping, we assume meshes are identical, islands included! */
     BLI_assert(numloops_dst == me_src->corners_num);
-    for (int i = 0; i < numloops_dst; i++) {
-      mesh_remap_item_define(r_map, i, FLT_MAX, 0, 1, &i, &full_weight);
-    }
+    mesh_remap_items_define_parallel(
+        r_map,
+        IndexRange(numloops_dst),
+        MREMAP_GRAIN_SIZE,
+        [&](const IndexRange range, MeshPairRemap *map) {
+          for (const int64_t elem_dst : range) {
+            const int i = int(elem_dst);
+            mesh_remap_item_define(map, i, FLT_MAX, 0, 1, &i, &full_weight);
+          }
+        });
   }
   else {
     Array<blender::bke::BVHTreeFromMesh> treedata;
-    BVHTreeNearest nearest = {0};
-    BVHTreeRayHit rayhit = {0};
     int num_trees = 0;
-    float hit_dist;
-    float tmp_co[3], tmp_no[3];
 
     const bool use_from_vert = (mode & MREMAP_USE_VERT);
 
@@ -1241,7 +1312,6 @@ void BKE_mesh_remap_calc_loops_from_mesh(const int mode,
     bool use_islands = false;
 
     BLI_AStarGraph *as_graphdata = nullptr;
-    BLI_AStarSolution as_solution = {0};
     const int isld_steps_src = (islands_precision_src ?
                                     max_ii(int(ASTAR_STEPS_MAX * islands_precision_src + 0.499f),
                                            1) :
@@ -1264,6 +1334,7 @@ void BKE_mesh_remap_calc_loops_from_mesh(const int mode,
 
     MeshElemMap *face_to_corner_tri_map_src = nullptr;
     int *face_to_corner_tri_map_src_buff = nullptr;
+    std::mutex face_to_corner_tri_map_src_mutex;
 
     /* Unlike above, those are one-to-one mappings, simpler! */
     blender::Span<int> loop_to_face_map_src;
@@ -1277,22 +1348,6 @@ void BKE_mesh_remap_calc_loops_from_mesh(const int mode,
     blender::Span<blender::int3> corner_tris_src;
     blender::Span<int> tri_faces_src;
 
-    size_t buff_size_interp = MREMAP_DEFAULT_BUFSIZE;
-    float(*vcos_interp)[3] = nullptr;
-    int *indices_interp = nullptr;
-    float *weights_interp = nullptr;
-
-    int tindex, pidx_dst, lidx_dst, plidx_dst, pidx_src, lidx_src, plidx_src;
-
-    IslandResult **islands_res;
-    size_t islands_res_buff_size = MREMAP_DEFAULT_BUFSIZE;
-
-    if (!use_from_vert) {
-      vcos_interp = MEM_malloc_arrayN<float[3]>(buff_size_interp, __func__);
-      indices_interp = MEM_malloc_arrayN<int>(buff_size_interp, __func__);
-      weights_interp = MEM_malloc_arrayN<float>(buff_size_interp, __func__);
-    }
-
     {
       const bool need_lnors_src = (mode & MREMAP_USE_LOOP) && (mode & MREMAP_USE_NORMAL);
       const bool need_lnors_dst = need_lnors_src || (mode & MREMAP_USE_NORPROJ);
@@ -1331,10 +1386,12 @@ void BKE_mesh_remap_calc_loops_from_mesh(const int mode,
     if (use_from_vert) {
       loop_to_face_map_src = me_src->corner_to_face_map();
       face_cents_src.reinitialize(faces_src.size());
-      for (const int64_t i : faces_src.index_range()) {
-        face_cents_src[i] = blender::bke::mesh::face_center_calc(
-            positions_src, corner_verts_src.slice(faces_src[i]));
-      }
+      threading::parallel_for(faces_src.index_range(), 4096, [&](const IndexRange range) {
+        for (const int64_t i : range) {
+          face_cents_src[i] = blender::bke::mesh::face_center_calc(
+              positions_src, corner_verts_src.slice(faces_src[i]));
+        }
+      });
     }
 
     /* Island makes things slightly more complex here.
@@ -1384,7 +1441,7 @@ void BKE_mesh_remap_calc_loops_from_mesh(const int mode,
 
     /* Build our AStar graphs. */
     if (isld_steps_src) {
-      for (tindex = 0; tindex < num_trees; tindex++) {
+      for (int tindex = 0; tindex < num_trees; tindex++) {
         mesh_island_to_astar_graph(use_islands ? &island_store : nullptr,
                                    tindex,
                                    positions_src,
@@ -1402,7 +1459,7 @@ void BKE_mesh_remap_calc_loops_from_mesh(const int mode,
       if (use_islands) {
         blender::BitVector<> verts_active(num_verts_src);
 
-        for (tindex = 0; tindex < num_trees; tindex++) {
+        for (int tindex = 0; tindex < num_trees; tindex++) {
           MeshElemMap *isld = island_store.islands[tindex];
           verts_active.fill(false);
           for (int i = 0; i < isld->count; i++) {
@@ -1428,7 +1485,7 @@ void BKE_mesh_remap_calc_loops_from_mesh(const int mode,
         tri_faces_src = me_src->corner_tri_faces();
         blender::BitVector<> faces_active(corner_tris_src.size());
 
-        for (tindex = 0; tindex < num_trees; tindex++) {
+        for (int tindex = 0; tindex < num_trees; tindex++) {
           faces_active.fill(false);
           for (const int64_t i : faces_src.index_range()) {
             const blender::IndexRange face = faces_src[i];
@@ -1451,181 +1508,232 @@ void BKE_mesh_remap_calc_loops_from_mesh(const int mode,
       }
     }
 
-    /* And check each dest face! */
-    islands_res = MEM_malloc_arrayN<IslandResult *>(size_t(num_trees), __func__);
-    for (tindex = 0; tindex < num_trees; tindex++) {
-      islands_res[tindex] = MEM_malloc_arrayN<IslandResult>(islands_res_buff_size, __func__);
-    }
     const blender::Span<int> tri_faces = me_src->corner_tri_faces();
 
-    for (pidx_dst = 0; pidx_dst < faces_dst.size(); pidx_dst++) {
-      const blender::IndexRange face_dst = faces_dst[pidx_dst];
-      float pnor_dst[3];
-
-      /* Only in use_from_vert case, we may need faces' centers as fallback
-       * in case we cannot decide which corner to use from normals only. */
-      blender::float3 pcent_dst;
-      bool pcent_dst_valid = false;
+    /* And check each dest face! */
+    const auto define_face_items_fn = [&](const IndexRange range, MeshPairRemap *map) {
+      BVHTreeNearest nearest = {0};
+      BVHTreeRayHit rayhit = {0};
+      float hit_dist;
+      float tmp_co[3], tmp_no[3];
+      int tindex, lidx_dst, plidx_dst, pidx_src, lidx_src, plidx_src;
+      BLI_AStarSolution as_solution = {0};
+
+      size_t buff_size_interp = MREMAP_DEFAULT_BUFSIZE;
+      float(*vcos_interp)[3] = nullptr;
+      int *indices_interp = nullptr;
+      float *weights_interp = nullptr;
+      if (!use_from_vert) {
+        vcos_interp = MEM_malloc_arrayN<float[3]>(buff_size_interp, __func__);
+        indices_interp = MEM_malloc_arrayN<int>(buff_size_interp, __func__);
+        weights_interp = MEM_malloc_arrayN<float>(buff_size_interp, __func__);
+      }
 
-      if (mode == MREMAP_MODE_LOOP_NEAREST_POLYNOR) {
-        copy_v3_v3(pnor_dst, face_normals_dst[pidx_dst]);
-        if (space_transform) {
-          BLI_space_transform_apply_normal(space_transform, pnor_dst);
-        }
+      size_t islands_res_buff_size = MREMAP_DEFAULT_BUFSIZE;
+      IslandResult **islands_res = MEM_malloc_arrayN<IslandResult *>(size_t(num_trees), __func__);
+      for (tindex = 0; tindex < num_trees; tindex++) {
+        islands_res[tindex] = MEM_malloc_arrayN<IslandResult>(islands_res_buff_size, __func__);
       }
 
-      if (size_t(face_dst.size()) > islands_res_buff_size) {
-        islands_res_buff_size = size_t(face_dst.size()) + MREMAP_DEFAULT_BUFSIZE;
-        for (tindex = 0; tindex < num_trees; tindex++) {
-          islands_res[tindex] = static_cast<IslandResult *>(
-              MEM_reallocN(islands_res[tindex], sizeof(**islands_res) * islands_res_buff_size));
+      for (const int64_t face_dst_index : range) {
+        const int pidx_dst = int(face_dst_index);
+        const blender::IndexRange face_dst = faces_dst[pidx_dst];
+        float pnor_dst[3];
+
+        /* Only in use_from_vert case, we may need faces' centers as fallback
+         * in case we cannot decide which corner to use from normals only. */
+        blender::float3 pcent_dst;
+        bool pcent_dst_valid = false;
+
+        if (mode == MREMAP_MODE_LOOP_NEAREST_POLYNOR) {
+          copy_v3_v3(pnor_dst, face_normals_dst[pidx_dst]);
+          if (space_transform) {
+            BLI_space_transform_apply_normal(space_transform, pnor_dst);
+          }
         }
-      }
 
-      for (tindex = 0; tindex < num_trees; tindex++) {
-        blender::bke::BVHTreeFromMesh *tdata = &treedata[tindex];
+        if (size_t(face_dst.size()) > islands_res_buff_size) {
+          islands_res_buff_size = size_t(face_dst.size()) + MREMAP_DEFAULT_BUFSIZE;
+          for (tindex = 0; tindex < num_trees; tindex++) {
+            islands_res[tindex] = static_cast<IslandResult *>(
+                MEM_reallocN(islands_res[tindex], sizeof(**islands_res) * islands_res_buff_size));
+          }
+        }
 
-        for (plidx_dst = 0; plidx_dst < face_dst.size(); plidx_dst++) {
-          const int vert_dst = corner_verts_dst[face_dst.start() + plidx_dst];
-          if (use_from_vert) {
-            blender::Span<int> vert_to_refelem_map_src;
+        for (tindex = 0; tindex < num_trees; tindex++) {
+          blender::bke::BVHTreeFromMesh *tdata = &treedata[tindex];
 
-            copy_v3_v3(tmp_co, vert_positions_dst[vert_dst]);
-            nearest.index = -1;
+          for (plidx_dst = 0; plidx_dst < face_dst.size(); plidx_dst++) {
+            const int vert_dst = corner_verts_dst[face_dst.start() + plidx_dst];
+            if (use_from_vert) {
+              blender::Span<int> vert_to_refelem_map_src;
 
-            /* Convert the vertex to tree coordinates, if needed. */
-            if (space_transform) {
-              BLI_space_transform_apply(space_transform, tmp_co);
-            }
+              copy_v3_v3(tmp_co, vert_positions_dst[vert_dst]);
+              nearest.index = -1;
 
-            if (mesh_remap_bvhtree_query_nearest(tdata, &nearest, tmp_co, max_dist_sq, &hit_dist))
-            {
-              float(*nor_dst)[3];
-              blender::Span<blender::float3> nors_src;
-              float best_nor_dot = -2.0f;
-              float best_sqdist_fallback = FLT_MAX;
-              int best_index_src = -1;
-
-              if (mode == MREMAP_MODE_LOOP_NEAREST_LOOPNOR) {
-                copy_v3_v3(tmp_no, loop_normals_dst[plidx_dst + face_dst.start()]);
-                if (space_transform) {
-                  BLI_space_transform_apply_normal(space_transform, tmp_no);
-                }
-                nor_dst = &tmp_no;
-                nors_src = loop_normals_src;
-                vert_to_refelem_map_src = vert_to_corner_map_src[nearest.index];
-              }
-              else { /* if (mode == MREMAP_MODE_LOOP_NEAREST_POLYNOR) { */
-                nor_dst = &pnor_dst;
-                nors_src = face_normals_src;
-                vert_to_refelem_map_src = vert_to_face_map_src[nearest.index];
+              /* Convert the vertex to tree coordinates, if needed. */
+              if (space_transform) {
+                BLI_space_transform_apply(space_transform, tmp_co);
               }
 
-              for (const int index_src : vert_to_refelem_map_src) {
-                BLI_assert(index_src != -1);
-                const float dot = dot_v3v3(nors_src[index_src], *nor_dst);
-
-                pidx_src = ((mode == MREMAP_MODE_LOOP_NEAREST_LOOPNOR) ?
-                                loop_to_face_map_src[index_src] :
-                                index_src);
-                /* WARNING! This is not the *real* lidx_src in case of POLYNOR, we only use it
-                 *          to check we stay on current island (all loops from a given face are
-                 *          on same island!). */
-                lidx_src = ((mode == MREMAP_MODE_LOOP_NEAREST_LOOPNOR) ?
-                                index_src :
-                                int(faces_src[pidx_src].start()));
-
-                /* A same vert may be at the boundary of several islands! Hence, we have to ensure
-                 * face/loop we are currently considering *belongs* to current island! */
-                if (use_islands && island_store.items_to_islands[lidx_src] != tindex) {
-                  continue;
+              if (mesh_remap_bvhtree_query_nearest(
+                      tdata, &nearest, tmp_co, max_dist_sq, &hit_dist))
+              {
+                float(*nor_dst)[3];
+                blender::Span<blender::float3> nors_src;
+                float best_nor_dot = -2.0f;
+                float best_sqdist_fallback = FLT_MAX;
+                int best_index_src = -1;
+
+                if (mode == MREMAP_MODE_LOOP_NEAREST_LOOPNOR) {
+                  copy_v3_v3(tmp_no, loop_normals_dst[plidx_dst + face_dst.start()]);
+                  if (space_transform) {
+                    BLI_space_transform_apply_normal(space_transform, tmp_no);
+                  }
+                  nor_dst = &tmp_no;
+                  nors_src = loop_normals_src;
+                  vert_to_refelem_map_src = vert_to_corner_map_src[nearest.index];
+                }
+                else { /* if (mode == MREMAP_MODE_LOOP_NEAREST_POLYNOR) { */
+                  nor_dst = &pnor_dst;
+                  nors_src = face_normals_src;
+                  vert_to_refelem_map_src = vert_to_face_map_src[nearest.index];
                 }
 
-                if (dot > best_nor_dot - 1e-6f) {
-                  /* We need something as fallback decision in case dest normal matches several
-                   * source normals (see #44522), using distance between faces' centers here. */
-                  float *pcent_src;
-                  float sqdist;
-
-                  if (!pcent_dst_valid) {
-                    pcent_dst = blender::bke::mesh::face_center_calc(
-                        {reinterpret_cast<const blender::float3 *>(vert_positions_dst),
-                         numverts_dst},
-                        blender::Span(corner_verts_dst, numloops_dst).slice(face_dst));
-                    pcent_dst_valid = true;
+                for (const int index_src : vert_to_refelem_map_src) {
+                  BLI_assert(index_src != -1);
+                  const float dot = dot_v3v3(nors_src[index_src], *nor_dst);
+
+                  pidx_src = ((mode == MREMAP_MODE_LOOP_NEAREST_LOOPNOR) ?
+                                  loop_to_face_map_src[index_src] :
+                                  index_src);
+                  /* WARNING! This is not the *real* lidx_src in case of POLYNOR, we only use it
+                   *          to check we stay on current island (all loops from a given face are
+                   *          on same island!). */
+                  lidx_src = ((mode == MREMAP_MODE_LOOP_NEAREST_LOOPNOR) ?
+                                  index_src :
+                                  int(faces_src[pidx_src].start()));
+
+                  /* A same vert may be at the boundary of several islands! Hence, we have to
+                   * ensure face/loop we are currently considering *belongs* to current island! */
+                  if (use_islands && island_store.items_to_islands[lidx_src] != tindex) {
+                    continue;
                   }
-                  pcent_src = face_cents_src[pidx_src];
-                  sqdist = len_squared_v3v3(pcent_dst, pcent_src);
 
-                  if ((dot > best_nor_dot + 1e-6f) || (sqdist < best_sqdist_fallback)) {
-                    best_nor_dot = dot;
-                    best_sqdist_fallback = sqdist;
-                    best_index_src = index_src;
+                  if (dot > best_nor_dot - 1e-6f) {
+                    /* We need something as fallback decision in case dest normal matches several
+                     * source normals (see #44522), using distance between faces' centers here. */
+                    float *pcent_src;
+                    float sqdist;
+
+                    if (!pcent_dst_valid) {
+                      pcent_dst = blender::bke::mesh::face_center_calc(
+                          {reinterpret_cast<const blender::float3 *>(vert_positions_dst),
+                           numverts_dst},
+                          blender::Span(corner_verts_dst, numloops_dst).slice(face_dst));
+                      pcent_dst_valid = true;
+                    }
+                    pcent_src = face_cents_src[pidx_src];
+                    sqdist = len_squared_v3v3(pcent_dst, pcent_src);
+
+                    if ((dot > best_nor_dot + 1e-6f) || (sqdist < best_sqdist_fallback)) {
+                      best_nor_dot = dot;
+                      best_sqdist_fallback = sqdist;
+                      best_index_src = index_src;
+                    }
                   }
                 }
-              }
-              if (best_index_src == -1) {
-                /* We found no item to map back from closest vertex... */
-                best_nor_dot = -1.0f;
-                hit_dist = FLT_MAX;
-              }
-              else if (mode == MREMAP_MODE_LOOP_NEAREST_POLYNOR) {
-                /* Our best_index_src is a face one for now!
-                 * Have to find its loop matching our closest vertex. */
-                const blender::IndexRange face_src = faces_src[best_index_src];
-                for (plidx_src = 0; plidx_src < face_src.size(); plidx_src++) {
-                  const int vert_src = corner_verts_src[face_src.start() + plidx_src];
-                  if (vert_src == nearest.index) {
-                    best_index_src = plidx_src + int(face_src.start());
-                    break;
+                if (best_index_src == -1) {
+                  /* We found no item to map back from closest vertex... */
+                  best_nor_dot = -1.0f;
+                  hit_dist = FLT_MAX;
+                }
+                else if (mode == MREMAP_MODE_LOOP_NEAREST_POLYNOR) {
+                  /* Our best_index_src is a face one for now!
+                   * Have to find its loop matching our closest vertex. */
+                  const blender::IndexRange face_src = faces_src[best_index_src];
+                  for (plidx_src = 0; plidx_src < face_src.size(); plidx_src++) {
+                    const int vert_src = corner_verts_src[face_src.start() + plidx_src];
+                    if (vert_src == nearest.index) {
+                      best_index_src = plidx_src + int(face_src.start());
+                      break;
+                    }
                   }
                 }
+                best_nor_dot = (best_nor_dot + 1.0f) * 0.5f;
+                islands_res[tindex][plidx_dst].factor = hit_dist ? (best_nor_dot / hit_dist) :
+                                                                   1e18f;
+                islands_res[tindex][plidx_dst].hit_dist = hit_dist;
+                islands_res[tindex][plidx_dst].index_src = best_index_src;
+              }
+              else {
+                /* No source for this dest loop! */
+                islands_res[tindex][plidx_dst].factor = 0.0f;
+                islands_res[tindex][plidx_dst].hit_dist = FLT_MAX;
+                islands_res[tindex][plidx_dst].index_src = -1;
               }
-              best_nor_dot = (best_nor_dot + 1.0f) * 0.5f;
-              islands_res[tindex][plidx_dst].factor = hit_dist ? (best_nor_dot / hit_dist) : 1e18f;
-              islands_res[tindex][plidx_dst].hit_dist = hit_dist;
-              islands_res[tindex][plidx_dst].index_src = best_index_src;
-            }
-            else {
-              /* No source for this dest loop! */
-              islands_res[tindex][plidx_dst].factor = 0.0f;
-              islands_res[tindex][plidx_dst].hit_dist = FLT_MAX;
-              islands_res[tindex][plidx_dst].index_src = -1;
             }
-          }
-          else if (mode & MREMAP_USE_NORPROJ) {
-            int n = (ray_radius > 0.0f) ? MREMAP_RAYCAST_APPROXIMATE_NR : 1;
-            float w = 1.0f;
+            else if (mode & MREMAP_USE_NORPROJ) {
+              int n = (ray_radius > 0.0f) ? MREMAP_RAYCAST_APPROXIMATE_NR : 1;
+              float w = 1.0f;
 
-            copy_v3_v3(tmp_co, vert_positions_dst[vert_dst]);
-            copy_v3_v3(tmp_no, loop_normals_dst[plidx_dst + face_dst.start()]);
+              copy_v3_v3(tmp_co, vert_positions_dst[vert_dst]);
+              copy_v3_v3(tmp_no, loop_normals_dst[plidx_dst + face_dst.start()]);
 
-            /* We do our transform here, since we may do several raycast/nearest queries. */
-            if (space_transform) {
-              BLI_space_transform_apply(space_transform, tmp_co);
-              BLI_space_transform_apply_normal(space_transform, tmp_no);
-            }
+              /* We do our transform here, since we may do several raycast/nearest queries. */
+              if (space_transform) {
+                BLI_space_transform_apply(space_transform, tmp_co);
+                BLI_space_transform_apply_normal(space_transform, tmp_no);
+              }
 
-            while (n--) {
-              if (mesh_remap_bvhtree_query_raycast(
-                      tdata, &rayhit, tmp_co, tmp_no, ray_radius / w, max_dist, &hit_dist))
-              {
-                islands_res[tindex][plidx_dst].factor = (hit_dist ? (1.0f / hit_dist) : 1e18f) * w;
-                islands_res[tindex][plidx_dst].hit_dist = hit_dist;
-                islands_res[tindex][plidx_dst].index_src = tri_faces[rayhit.index];
-                copy_v3_v3(islands_res[tindex][plidx_dst].hit_point, rayhit.co);
-                break;
+              while (n--) {
+                if (mesh_remap_bvhtree_query_raycast(
+                        tdata, &rayhit, tmp_co, tmp_no, ray_radius / w, max_dist, &hit_dist))
+                {
+                  islands_res[tindex][plidx_dst].factor = (hit_dist ? (1.0f / hit_dist) : 1e18f) *
+                                                          w;
+                  islands_res[tindex][plidx_dst].hit_dist = hit_dist;
+                  islands_res[tindex][plidx_dst].index_src = tri_faces[rayhit.index];
+                  copy_v3_v3(islands_res[tindex][plidx_dst].hit_point, rayhit.co);
+                  break;
+                }
+                /* Next iteration will get bigger radius but smaller weight! */
+                w /= MREMAP_RAYCAST_APPROXIMATE_FAC;
+              }
+              if (n == -1) {
+                /* Fallback to 'nearest' hit here, loops usually comes in 'face group', not good to
+                 * have only part of one dest face's loops to map to source.
+                 * Note that since we give this a null weight, if whole weight for a given face
+                 * is null, it means none of its loop mapped to this source island,
+                 * hence we can skip it later.
+                 */
+                copy_v3_v3(tmp_co, vert_positions_dst[vert_dst]);
+                nearest.index = -1;
+
+                /* Convert the vertex to tree coordinates, if needed. */
+                if (space_transform) {
+                  BLI_space_transform_apply(space_transform, tmp_co);
+                }
+
+                /* In any case, this fallback nearest hit should have no weight at all
+                 * in 'best island' decision! */
+                islands_res[tindex][plidx_dst].factor = 0.0f;
+
+                if (mesh_remap_bvhtree_query_nearest(
+                        tdata, &nearest, tmp_co, max_dist_sq, &hit_dist))
+                {
+                  islands_res[tindex][plidx_dst].hit_dist = hit_dist;
+                  islands_res[tindex][plidx_dst].index_src = tri_faces[nearest.index];
+                  copy_v3_v3(islands_res[tindex][plidx_dst].hit_point, nearest.co);
+                }
+                else {
+                  /* No source for this dest loop! */
+                  islands_res[tindex][plidx_dst].hit_dist = FLT_MAX;
+                  islands_res[tindex][plidx_dst].index_src = -1;
+                }
               }
-              /* Next iteration will get bigger radius but smaller weight! */
-              w /= MREMAP_RAYCAST_APPROXIMATE_FAC;
             }
-            if (n == -1) {
-              /* Fallback to 'nearest' hit here, loops usually comes in 'face group', not good to
-               * have only part of one dest face's loops to map to source.
-               * Note that since we give this a null weight, if whole weight for a given face
-               * is null, it means none of its loop mapped to this source island,
-               * hence we can skip it later.
-               */
+            else { /* Nearest face either to use all its loops/verts or just closest one. */
               copy_v3_v3(tmp_co, vert_positions_dst[vert_dst]);
               nearest.index = -1;
 
@@ -1634,357 +1742,352 @@ void BKE_mesh_remap_calc_loops_from_mesh(const int mode,
                 BLI_space_transform_apply(space_transform, tmp_co);
               }
 
-              /* In any case, this fallback nearest hit should have no weight at all
-               * in 'best island' decision! */
-              islands_res[tindex][plidx_dst].factor = 0.0f;
-
               if (mesh_remap_bvhtree_query_nearest(
                       tdata, &nearest, tmp_co, max_dist_sq, &hit_dist))
               {
+                islands_res[tindex][plidx_dst].factor = hit_dist ? (1.0f / hit_dist) : 1e18f;
                 islands_res[tindex][plidx_dst].hit_dist = hit_dist;
                 islands_res[tindex][plidx_dst].index_src = tri_faces[nearest.index];
                 copy_v3_v3(islands_res[tindex][plidx_dst].hit_point, nearest.co);
               }
               else {
                 /* No source for this dest loop! */
+                islands_res[tindex][plidx_dst].factor = 0.0f;
                 islands_res[tindex][plidx_dst].hit_dist = FLT_MAX;
                 islands_res[tindex][plidx_dst].index_src = -1;
               }
             }
           }
-          else { /* Nearest face either to use all its loops/verts or just closest one. */
-            copy_v3_v3(tmp_co, vert_positions_dst[vert_dst]);
-            nearest.index = -1;
+        }
 
-            /* Convert the vertex to tree coordinates, if needed. */
-            if (space_transform) {
-              BLI_space_transform_apply(space_transform, tmp_co);
-            }
+        /* And now, find best island to use! */
+        /* We have to first select the 'best source island' for given dst face and its loops.
+         * Then, we have to check that face does not 'spread' across some island's limits
+         * (like inner seams for UVs, etc.).
+         * Note we only still partially support that kind of situation here, i.e.
+         * Faces spreading over actual cracks
+         * (like a narrow space without faces on src, splitting a 'tube-like' geometry).
+         * That kind of situation should be relatively rare, though.
+         */
+        /* XXX This block in itself is big and complex enough to be a separate function but...
+         *     it uses a bunch of locale vars.
+         *     Not worth sending all that through parameters (for now at least). */
+        {
+          BLI_AStarGraph *as_graph = nullptr;
+          int *face_island_index_map = nullptr;
+          int pidx_src_prev = -1;
 
-            if (mesh_remap_bvhtree_query_nearest(tdata, &nearest, tmp_co, max_dist_sq, &hit_dist))
-            {
-              islands_res[tindex][plidx_dst].factor = hit_dist ? (1.0f / hit_dist) : 1e18f;
-              islands_res[tindex][plidx_dst].hit_dist = hit_dist;
-              islands_res[tindex][plidx_dst].index_src = tri_faces[nearest.index];
-              copy_v3_v3(islands_res[tindex][plidx_dst].hit_point, nearest.co);
-            }
-            else {
-              /* No source for this dest loop! */
-              islands_res[tindex][plidx_dst].factor = 0.0f;
-              islands_res[tindex][plidx_dst].hit_dist = FLT_MAX;
-              islands_res[tindex][plidx_dst].index_src = -1;
-            }
-          }
-        }
-      }
+          MeshElemMap *best_island = nullptr;
+          float best_island_fac = 0.0f;
+          int best_island_index = -1;
 
-      /* And now, find best island to use! */
-      /* We have to first select the 'best source island' for given dst face and its loops.
-       * Then, we have to check that face does not 'spread' across some island's limits
-       * (like inner seams for UVs, etc.).
-       * Note we only still partially support that kind of situation here, i.e.
-       * Faces spreading over actual cracks
-       * (like a narrow space without faces on src, splitting a 'tube-like' geometry).
-       * That kind of situation should be relatively rare, though.
-       */
-      /* XXX This block in itself is big and complex enough to be a separate function but...
-       *     it uses a bunch of locale vars.
-       *     Not worth sending all that through parameters (for now at least). */
-      {
-        BLI_AStarGraph *as_graph = nullptr;
-        int *face_island_index_map = nullptr;
-        int pidx_src_prev = -1;
-
-        MeshElemMap *best_island = nullptr;
-        float best_island_fac = 0.0f;
-        int best_island_index = -1;
+          for (tindex = 0; tindex < num_trees; tindex++) {
+            float island_fac = 0.0f;
 
-        for (tindex = 0; tindex < num_trees; tindex++) {
-          float island_fac = 0.0f;
+            for (plidx_dst = 0; plidx_dst < face_dst.size(); plidx_dst++) {
+              island_fac += islands_res[tindex][plidx_dst].factor;
+            }
+            island_fac /= float(face_dst.size());
 
-          for (plidx_dst = 0; plidx_dst < face_dst.size(); plidx_dst++) {
-            island_fac += islands_res[tindex][plidx_dst].factor;
+            if (island_fac > best_island_fac) {
+              best_island_fac = island_fac;
+              best_island_index = tindex;
+            }
           }
-          island_fac /= float(face_dst.size());
 
-          if (island_fac > best_island_fac) {
-            best_island_fac = island_fac;
-            best_island_index = tindex;
+          if (best_island_index != -1 && isld_steps_src) {
+            best_island = use_islands ? island_store.islands[best_island_index] : nullptr;
+            as_graph = &as_graphdata[best_island_index];
+            face_island_index_map = (int *)as_graph->custom_data;
+            BLI_astar_solution_init(as_graph, &as_solution, nullptr);
           }
-        }
 
-        if (best_island_index != -1 && isld_steps_src) {
-          best_island = use_islands ? island_store.islands[best_island_index] : nullptr;
-          as_graph = &as_graphdata[best_island_index];
-          face_island_index_map = (int *)as_graph->custom_data;
-          BLI_astar_solution_init(as_graph, &as_solution, nullptr);
-        }
-
-        for (plidx_dst = 0; plidx_dst < face_dst.size(); plidx_dst++) {
-          IslandResult *isld_res;
-          lidx_dst = plidx_dst + int(face_dst.start());
+          for (plidx_dst = 0; plidx_dst < face_dst.size(); plidx_dst++) {
+            IslandResult *isld_res;
+            lidx_dst = plidx_dst + int(face_dst.start());
 
-          if (best_island_index == -1) {
-            /* No source for any loops of our dest face in any source islands. */
-            BKE_mesh_remap_item_define_invalid(r_map, lidx_dst);
-            continue;
-          }
+            if (best_island_index == -1) {
+              /* No source for any loops of our dest face in any source islands. */
+              BKE_mesh_remap_item_define_invalid(map, lidx_dst);
+              continue;
+            }
 
-          as_solution.custom_data = POINTER_FROM_INT(false);
-
-          isld_res = &islands_res[best_island_index][plidx_dst];
-          if (use_from_vert) {
-            /* Indices stored in islands_res are those of loops, one per dest loop. */
-            lidx_src = isld_res->index_src;
-            if (lidx_src >= 0) {
-              pidx_src = loop_to_face_map_src[lidx_src];
-              /* If prev and curr face are the same, no need to do anything more!!! */
-              if (!ELEM(pidx_src_prev, -1, pidx_src) && isld_steps_src) {
-                int pidx_isld_src, pidx_isld_src_prev;
-                if (face_island_index_map) {
-                  pidx_isld_src = face_island_index_map[pidx_src];
-                  pidx_isld_src_prev = face_island_index_map[pidx_src_prev];
-                }
-                else {
-                  pidx_isld_src = pidx_src;
-                  pidx_isld_src_prev = pidx_src_prev;
-                }
+            as_solution.custom_data = POINTER_FROM_INT(false);
+
+            isld_res = &islands_res[best_island_index][plidx_dst];
+            if (use_from_vert) {
+              /* Indices stored in islands_res are those of loops, one per dest loop. */
+              lidx_src = isld_res->index_src;
+              if (lidx_src >= 0) {
+                pidx_src = loop_to_face_map_src[lidx_src];
+                /* If prev and curr face are the same, no need to do anything more!!! */
+                if (!ELEM(pidx_src_prev, -1, pidx_src) && isld_steps_src) {
+                  int pidx_isld_src, pidx_isld_src_prev;
+                  if (face_island_index_map) {
+                    pidx_isld_src = face_island_index_map[pidx_src];
+                    pidx_isld_src_prev = face_island_index_map[pidx_src_prev];
+                  }
+                  else {
+                    pidx_isld_src = pidx_src;
+                    pidx_isld_src_prev = pidx_src_prev;
+                  }
 
-                BLI_astar_graph_solve(as_graph,
-                                      pidx_isld_src_prev,
-                                      pidx_isld_src,
-                                      mesh_remap_calc_loops_astar_f_cost,
-                                      &as_solution,
-                                      isld_steps_src);
-                if (POINTER_AS_INT(as_solution.custom_data) && (as_solution.steps > 0)) {
-                  /* Find first 'cutting edge' on path, and bring back lidx_src on face just
-                   * before that edge.
-                   * Note we could try to be much smarter, g.g. Storing a whole face's indices,
-                   * and making decision (on which side of cutting edge(s!) to be) on the end,
-                   * but this is one more level of complexity, better to first see if
-                   * simple solution works!
-                   */
-                  int last_valid_pidx_isld_src = -1;
-                  /* Note we go backward here, from dest to src face. */
-                  for (int i = as_solution.steps - 1; i--;) {
-                    BLI_AStarGNLink *as_link = as_solution.prev_links[pidx_isld_src];
-                    const int eidx = POINTER_AS_INT(as_link->custom_data);
-                    pidx_isld_src = as_solution.prev_nodes[pidx_isld_src];
-                    BLI_assert(pidx_isld_src != -1);
-                    if (eidx != -1) {
-                      /* we are 'crossing' a cutting edge. */
-                      last_valid_pidx_isld_src = pidx_isld_src;
+                  BLI_astar_graph_solve(as_graph,
+                                        pidx_isld_src_prev,
+                                        pidx_isld_src,
+                                        mesh_remap_calc_loops_astar_f_cost,
+                                        &as_solution,
+                                        isld_steps_src);
+                  if (POINTER_AS_INT(as_solution.custom_data) && (as_solution.steps > 0)) {
+                    /* Find first 'cutting edge' on path, and bring back lidx_src on face just
+                     * before that edge.
+                     * Note we could try to be much smarter, g.g. Storing a whole face's indices,
+                     * and making decision (on which side of cutting edge(s!) to be) on the end,
+                     * but this is one more level of complexity, better to first see if
+                     * simple solution works!
+                     */
+                    int last_valid_pidx_isld_src = -1;
+                    /* Note we go backward here, from dest to src face. */
+                    for (int i = as_solution.steps - 1; i--;) {
+                      BLI_AStarGNLink *as_link = as_solution.prev_links[pidx_isld_src];
+                      const int eidx = POINTER_AS_INT(as_link->custom_data);
+                      pidx_isld_src = as_solution.prev_nodes[pidx_isld_src];
+                      BLI_assert(pidx_isld_src != -1);
+                      if (eidx != -1) {
+                        /* we are 'crossing' a cutting edge. */
+                        last_valid_pidx_isld_src = pidx_isld_src;
+                      }
                     }
-                  }
-                  if (last_valid_pidx_isld_src != -1) {
-                    /* Find a new valid loop in that new face (nearest one for now).
-                     * Note we could be much more subtle here, again that's for later... */
-                    float best_dist_sq = FLT_MAX;
+                    if (last_valid_pidx_isld_src != -1) {
+                      /* Find a new valid loop in that new face (nearest one for now).
+                       * Note we could be much more subtle here, again that's for later... */
+                      float best_dist_sq = FLT_MAX;
 
-                    copy_v3_v3(tmp_co, vert_positions_dst[corner_verts_dst[lidx_dst]]);
+                      copy_v3_v3(tmp_co, vert_positions_dst[corner_verts_dst[lidx_dst]]);
 
-                    /* We do our transform here,
-                     * since we may do several raycast/nearest queries. */
-                    if (space_transform) {
-                      BLI_space_transform_apply(space_transform, tmp_co);
-                    }
+                      /* We do our transform here,
+                       * since we may do several raycast/nearest queries. */
+                      if (space_transform) {
+                        BLI_space_transform_apply(space_transform, tmp_co);
+                      }
 
-                    pidx_src = (use_islands ? best_island->indices[last_valid_pidx_isld_src] :
-                                              last_valid_pidx_isld_src);
-                    const blender::IndexRange face_src = faces_src[pidx_src];
-                    for (const int64_t corner : face_src) {
-                      const int vert_src = corner_verts_src[corner];
-                      const float dist_sq = len_squared_v3v3(positions_src[vert_src], tmp_co);
-                      if (dist_sq < best_dist_sq) {
-                        best_dist_sq = dist_sq;
-                        lidx_src = int(corner);
+                      pidx_src = (use_islands ? best_island->indices[last_valid_pidx_isld_src] :
+                                                last_valid_pidx_isld_src);
+                      const blender::IndexRange face_src = faces_src[pidx_src];
+                      for (const int64_t corner : face_src) {
+                        const int vert_src = corner_verts_src[corner];
+                        const float dist_sq = len_squared_v3v3(positions_src[vert_src], tmp_co);
+                        if (dist_sq < best_dist_sq) {
+                          best_dist_sq = dist_sq;
+                          lidx_src = int(corner);
+                        }
                       }
                     }
                   }
                 }
+                mesh_remap_item_define(map,
+                                       lidx_dst,
+                                       isld_res->hit_dist,
+                                       best_island_index,
+                                       1,
+                                       &lidx_src,
+                                       &full_weight);
+                pidx_src_prev = pidx_src;
+              }
+              else {
+                /* No source for this loop in this island. */
+                /* TODO: would probably be better to get a source
+                 * at all cost in best island anyway? */
+                mesh_remap_item_define(
+                    map, lidx_dst, FLT_MAX, best_island_index, 0, nullptr, nullptr);
               }
-              mesh_remap_item_define(r_map,
-                                     lidx_dst,
-                                     isld_res->hit_dist,
-                                     best_island_index,
-                                     1,
-                                     &lidx_src,
-                                     &full_weight);
-              pidx_src_prev = pidx_src;
             }
             else {
-              /* No source for this loop in this island. */
-              /* TODO: would probably be better to get a source
-               * at all cost in best island anyway? */
-              mesh_remap_item_define(
-                  r_map, lidx_dst, FLT_MAX, best_island_index, 0, nullptr, nullptr);
-            }
-          }
-          else {
-            /* Else, we use source face, indices stored in islands_res are those of faces. */
-            pidx_src = isld_res->index_src;
-            if (pidx_src >= 0) {
-              float *hit_co = isld_res->hit_point;
-              int best_loop_index_src;
-
-              const blender::IndexRange face_src = faces_src[pidx_src];
-              /* If prev and curr face are the same, no need to do anything more!!! */
-              if (!ELEM(pidx_src_prev, -1, pidx_src) && isld_steps_src) {
-                int pidx_isld_src, pidx_isld_src_prev;
-                if (face_island_index_map) {
-                  pidx_isld_src = face_island_index_map[pidx_src];
-                  pidx_isld_src_prev = face_island_index_map[pidx_src_prev];
-                }
-                else {
-                  pidx_isld_src = pidx_src;
-                  pidx_isld_src_prev = pidx_src_prev;
-                }
-
-                BLI_astar_graph_solve(as_graph,
-                                      pidx_isld_src_prev,
-                                      pidx_isld_src,
-                                      mesh_remap_calc_loops_astar_f_cost,
-                                      &as_solution,
-                                      isld_steps_src);
-                if (POINTER_AS_INT(as_solution.custom_data) && (as_solution.steps > 0)) {
-                  /* Find first 'cutting edge' on path, and bring back lidx_src on face just
-                   * before that edge.
-                   * Note we could try to be much smarter: e.g. Storing a whole face's indices,
-                   * and making decision (one which side of cutting edge(s)!) to be on the end,
-                   * but this is one more level of complexity, better to first see if
-                   * simple solution works!
-                   */
-                  int last_valid_pidx_isld_src = -1;
-                  /* Note we go backward here, from dest to src face. */
-                  for (int i = as_solution.steps - 1; i--;) {
-                    BLI_AStarGNLink *as_link = as_solution.prev_links[pidx_isld_src];
-                    int eidx = POINTER_AS_INT(as_link->custom_data);
-
-                    pidx_isld_src = as_solution.prev_nodes[pidx_isld_src];
-                    BLI_assert(pidx_isld_src != -1);
-                    if (eidx != -1) {
-                      /* we are 'crossing' a cutting edge. */
-                      last_valid_pidx_isld_src = pidx_isld_src;
-                    }
+              /* Else, we use source face, indices stored in islands_res are those of faces. */
+              pidx_src = isld_res->index_src;
+              if (pidx_src >= 0) {
+                float *hit_co = isld_res->hit_point;
+                int best_loop_index_src;
+
+                const blender::IndexRange face_src = faces_src[pidx_src];
+                /* If prev and curr face are the same, no need to do anything more!!! */
+                if (!ELEM(pidx_src_prev, -1, pidx_src) && isld_steps_src) {
+                  int pidx_isld_src, pidx_isld_src_prev;
+                  if (face_island_index_map) {
+                    pidx_isld_src = face_island_index_map[pidx_src];
+                    pidx_isld_src_prev = face_island_index_map[pidx_src_prev];
+                  }
+                  else {
+                    pidx_isld_src = pidx_src;
+                    pidx_isld_src_prev = pidx_src_prev;
                   }
-                  if (last_valid_pidx_isld_src != -1) {
-                    /* Find a new valid loop in that new face (nearest point on face for now).
-                     * Note we could be much more subtle here, again that's for later... */
-                    float best_dist_sq = FLT_MAX;
-                    int j;
-
-                    const int vert_dst = corner_verts_dst[lidx_dst];
-                    copy_v3_v3(tmp_co, vert_positions_dst[vert_dst]);
-
-                    /* We do our transform here,
-                     * since we may do several raycast/nearest queries. */
-                    if (space_transform) {
-                      BLI_space_transform_apply(space_transform, tmp_co);
-                    }
-
-                    pidx_src = (use_islands ? best_island->indices[last_valid_pidx_isld_src] :
-                                              last_valid_pidx_isld_src);
 
-                    /* Create that one on demand. */
-                    if (face_to_corner_tri_map_src == nullptr) {
-                      BKE_mesh_origindex_map_create_corner_tri(&face_to_corner_tri_map_src,
-                                                               &face_to_corner_tri_map_src_buff,
-                                                               faces_src,
-                                                               tri_faces_src.data(),
-                                                               int(tri_faces_src.size()));
+                  BLI_astar_graph_solve(as_graph,
+                                        pidx_isld_src_prev,
+                                        pidx_isld_src,
+                                        mesh_remap_calc_loops_astar_f_cost,
+                                        &as_solution,
+                                        isld_steps_src);
+                  if (POINTER_AS_INT(as_solution.custom_data) && (as_solution.steps > 0)) {
+                    /* Find first 'cutting edge' on path, and bring back lidx_src on face just
+                     * before that edge.
+                     * Note we could try to be much smarter: e.g. Storing a whole face's indices,
+                     * and making decision (one which side of cutting edge(s)!) to be on the end,
+                     * but this is one more level of complexity, better to first see if
+                     * simple solution works!
+                     */
+                    int last_valid_pidx_isld_src = -1;
+                    /* Note we go backward here, from dest to src face. */
+                    for (int i = as_solution.steps - 1; i--;) {
+                      BLI_AStarGNLink *as_link = as_solution.prev_links[pidx_isld_src];
+                      int eidx = POINTER_AS_INT(as_link->custom_data);
+
+                      pidx_isld_src = as_solution.prev_nodes[pidx_isld_src];
+                      BLI_assert(pidx_isld_src != -1);
+                      if (eidx != -1) {
+                        /* we are 'crossing' a cutting edge. */
+                        last_valid_pidx_isld_src = pidx_isld_src;
+                      }
                     }
+                    if (last_valid_pidx_isld_src != -1) {
+                      /* Find a new valid loop in that new face (nearest point on face for now).
+                       * Note we could be much more subtle here, again that's for later... */
+                      float best_dist_sq = FLT_MAX;
+                      int j;
+
+                      const int vert_dst = corner_verts_dst[lidx_dst];
+                      copy_v3_v3(tmp_co, vert_positions_dst[vert_dst]);
+
+                      /* We do our transform here,
+                       * since we may do several raycast/nearest queries. */
+                      if (space_transform) {
+                        BLI_space_transform_apply(space_transform, tmp_co);
+                      }
+
+                      pidx_src = (use_islands ? best_island->indices[last_valid_pidx_isld_src] :
+                                                last_valid_pidx_isld_src);
+
+                      /* Create that one on demand. */
+                      {
+                        std::lock_guard lock{face_to_corner_tri_map_src_mutex};
+                        if (face_to_corner_tri_map_src == nullptr) {
+                          BKE_mesh_origindex_map_create_corner_tri(
+                              &face_to_corner_tri_map_src,
+                              &face_to_corner_tri_map_src_buff,
+                              faces_src,
+                              tri_faces_src.data(),
+                              int(tri_faces_src.size()));
+                        }
+                      }
 
-                    for (j = face_to_corner_tri_map_src[pidx_src].count; j--;) {
-                      float h[3];
-                      const blender::int3 &tri =
-                          corner_tris_src[face_to_corner_tri_map_src[pidx_src].indices[j]];
-                      float dist_sq;
-
-                      closest_on_tri_to_point_v3(h,
-                                                 tmp_co,
-                                                 positions_src[corner_verts_src[tri[0]]],
-                                                 positions_src[corner_verts_src[tri[1]]],
-                                                 positions_src[corner_verts_src[tri[2]]]);
-                      dist_sq = len_squared_v3v3(tmp_co, h);
-                      if (dist_sq < best_dist_sq) {
-                        copy_v3_v3(hit_co, h);
-                        best_dist_sq = dist_sq;
+                      for (j = face_to_corner_tri_map_src[pidx_src].count; j--;) {
+                        float h[3];
+                        const blender::int3 &tri =
+                            corner_tris_src[face_to_corner_tri_map_src[pidx_src].indices[j]];
+                        float dist_sq;
+
+                        closest_on_tri_to_point_v3(h,
+                                                   tmp_co,
+                                                   positions_src[corner_verts_src[tri[0]]],
+                                                   positions_src[corner_verts_src[tri[1]]],
+                                                   positions_src[corner_verts_src[tri[2]]]);
+                        dist_sq = len_squared_v3v3(tmp_co, h);
+                        if (dist_sq < best_dist_sq) {
+                          copy_v3_v3(hit_co, h);
+                          best_dist_sq = dist_sq;
+                        }
                       }
                     }
                   }
                 }
-              }
 
-              if (mode == MREMAP_MODE_LOOP_POLY_NEAREST) {
-                mesh_remap_interp_face_data_get(face_src,
-                                                corner_verts_src,
-                                                positions_src,
-                                                hit_co,
-                                                &buff_size_interp,
-                                                &vcos_interp,
-                                                true,
-                                                &indices_interp,
-                                                &weights_interp,
-                                                false,
-                                                &best_loop_index_src);
-
-                mesh_remap_item_define(r_map,
-                                       lidx_dst,
-                                       isld_res->hit_dist,
-                                       best_island_index,
-                                       1,
-                                       &best_loop_index_src,
-                                       &full_weight);
+                if (mode == MREMAP_MODE_LOOP_POLY_NEAREST) {
+                  mesh_remap_interp_face_data_get(face_src,
+                                                  corner_verts_src,
+                                                  positions_src,
+                                                  hit_co,
+                                                  &buff_size_interp,
+                                                  &vcos_interp,
+                                                  true,
+                                                  &indices_interp,
+                                                  &weights_interp,
+                                                  false,
+                                                  &best_loop_index_src);
+
+                  mesh_remap_item_define(map,
+                                         lidx_dst,
+                                         isld_res->hit_dist,
+                                         best_island_index,
+                                         1,
+                                         &best_loop_index_src,
+                                         &full_weight);
+                }
+                else {
+                  const int sources_num = mesh_remap_interp_face_data_get(face_src,
+                                                                          corner_verts_src,
+                                                                          positions_src,
+                                                                          hit_co,
+                                                                          &buff_size_interp,
+                                                                          &vcos_interp,
+                                                                          true,
+                                                                          &indices_interp,
+                                                                          &weights_interp,
+                                                                          true,
+                                                                          nullptr);
+
+                  mesh_remap_item_define(map,
+                                         lidx_dst,
+                                         isld_res->hit_dist,
+                                         best_island_index,
+                                         sources_num,
+                                         indices_interp,
+                                         weights_interp);
+                }
+
+                pidx_src_prev = pidx_src;
               }
               else {
-                const int sources_num = mesh_remap_interp_face_data_get(face_src,
-                                                                        corner_verts_src,
-                                                                        positions_src,
-                                                                        hit_co,
-                                                                        &buff_size_interp,
-                                                                        &vcos_interp,
-                                                                        true,
-                                                                        &indices_interp,
-                                                                        &weights_interp,
-                                                                        true,
-                                                                        nullptr);
-
-                mesh_remap_item_define(r_map,
-                                       lidx_dst,
-                                       isld_res->hit_dist,
-                                       best_island_index,
-                                       sources_num,
-                                       indices_interp,
-                                       weights_interp);
+                /* No source for this loop in this island. */
+                /* TODO: would probably be better to get a source
+                 * at all cost in best island anyway? */
+                mesh_remap_item_define(
+                    map, lidx_dst, FLT_MAX, best_island_index, 0, nullptr, nullptr);
               }
-
-              pidx_src_prev = pidx_src;
-            }
-            else {
-              /* No source for this loop in this island. */
-              /* TODO: would probably be better to get a source
-               * at all cost in best island anyway? */
-              mesh_remap_item_define(
-                  r_map, lidx_dst, FLT_MAX, best_island_index, 0, nullptr, nullptr);
             }
           }
+
+          BLI_astar_solution_clear(&as_solution);
         }
+      }
 
-        BLI_astar_solution_clear(&as_solution);
+      for (tindex = 0; tindex < num_trees; tindex++) {
+        MEM_freeN(islands_res[tindex]);
       }
-    }
+      MEM_freeN(islands_res);
+      if (isld_steps_src) {
+        BLI_astar_solution_free(&as_solution);
+      }
+      if (vcos_interp) {
+        MEM_freeN(vcos_interp);
+      }
+      if (indices_interp) {
+        MEM_freeN(indices_interp);
+      }
+      if (weights_interp) {
+        MEM_freeN(weights_interp);
+      }
+    };
+    mesh_remap_items_define_parallel(
+        r_map, faces_dst.index_range(), MREMAP_GRAIN_SIZE, define_face_items_fn);
 
-    for (tindex = 0; tindex < num_trees; tindex++) {
-      MEM_freeN(islands_res[tindex]);
+    for (int tindex = 0; tindex < num_trees; tindex++) {
       if (isld_steps_src) {
         BLI_astar_graph_free(&as_graphdata[tindex]);
       }
     }
-    MEM_freeN(islands_res);
     BKE_mesh_loop_islands_free(&island_store);
     if (isld_steps_src) {
       MEM_freeN(as_graphdata);
-      BLI_astar_solution_free(&as_solution);
     }
 
     if (face_to_corner_tri_map_src) {
@@ -1993,15 +2096,6 @@ void BKE_mesh_remap_calc_loops_from_mesh(const int mode,
     if (face_to_corner_tri_map_src_buff) {
       MEM_freeN(face_to_corner_tri_map_src_buff);
     }
-    if (vcos_interp) {
-      MEM_freeN(vcos_interp);
-    }
-    if (indices_interp) {
-      MEM_freeN(indices_interp);
-    }
-    if (weights_interp) {
-      MEM_freeN(weights_interp);
-    }
   }
 }
 
@@ -2020,7 +2114,6 @@ void BKE_mesh_remap_calc_faces_from_mesh(const int mode,
   const float full_weight = 1.0f;
   const float max_dist_sq = max_dist * max_dist;
   blender::Span<blender::float3> face_normals_dst;
-  blender::float3 tmp_co, tmp_no;
 
   BLI_assert(mode & MREMAP_MODE_POLY);
 
@@ -2032,77 +2125,105 @@ void BKE_mesh_remap_calc_faces_from_mesh(const int mode,
 
   if (mode == MREMAP_MODE_TOPOLOGY) {
     BLI_assert(faces_dst.size() == me_src->faces_num);
-    for (const int64_t i : faces_dst.index_range()) {
-      const int index = int(i);
-      mesh_remap_item_define(r_map, int(i), FLT_MAX, 0, 1, &index, &full_weight);
-    }
+    mesh_remap_items_define_parallel(
+        r_map,
+        faces_dst.index_range(),
+        MREMAP_GRAIN_SIZE,
+        [&](const blender::IndexRange range, MeshPairRemap *map) {
+          for (const int64_t elem_dst : range) {
+            const int i = int(elem_dst);
+            mesh_remap_item_define(map, i, FLT_MAX, 0, 1, &i, &full_weight);
+          }
+        });
   }
   else {
-    BVHTreeNearest nearest = {0};
-    BVHTreeRayHit rayhit = {0};
-    float hit_dist;
     const blender::Span<int> tri_faces = me_src->corner_tri_faces();
 
     blender::bke::BVHTreeFromMesh treedata = me_src->bvh_corner_tris();
 
     if (mode == MREMAP_MODE_POLY_NEAREST) {
-      nearest.index = -1;
+      mesh_remap_items_define_parallel(
+          r_map,
+          faces_dst.index_range(),
+          MREMAP_GRAIN_SIZE,
+          [&](const blender::IndexRange range, MeshPairRemap *map) {
+            BVHTreeNearest nearest = {0};
+            float hit_dist;
+
+            for (const int64_t elem_dst : range) {
+              const int i = int(elem_dst);
+              mesh_remap_bvhtree_nearest_reset(&nearest, max_dist_sq);
+              const blender::IndexRange face = faces_dst[i];
+              blender::float3 tmp_co = blender::bke::mesh::face_center_calc(
+                  {reinterpret_cast<const blender::float3 *>(vert_positions_dst), numverts_dst},
+                  {&corner_verts_dst[face.start()], face.size()});
 
-      for (const int64_t i : faces_dst.index_range()) {
-        const blender::IndexRange face = faces_dst[i];
-        tmp_co = blender::bke::mesh::face_center_calc(
-            {reinterpret_cast<const blender::float3 *>(vert_positions_dst), numverts_dst},
-            {&corner_verts_dst[face.start()], face.size()});
-
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-        }
+              /* Convert the vertex to tree coordinates, if needed. */
+              if (space_transform) {
+                BLI_space_transform_apply(space_transform, tmp_co);
+              }
 
-        if (mesh_remap_bvhtree_query_nearest(&treedata, &nearest, tmp_co, max_dist_sq, &hit_dist))
-        {
-          const int face_index = tri_faces[nearest.index];
-          mesh_remap_item_define(r_map, int(i), hit_dist, 0, 1, &face_index, &full_weight);
-        }
-        else {
-          /* No source for this dest face! */
-          BKE_mesh_remap_item_define_invalid(r_map, int(i));
-        }
-      }
+              if (mesh_remap_bvhtree_query_nearest(
+                      &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist))
+              {
+                const int face_index = tri_faces[nearest.index];
+                mesh_remap_item_define(map, i, hit_dist, 0, 1, &face_index, &full_weight);
+              }
+              else {
+                /* No source for this dest face! */
+                BKE_mesh_remap_item_define_invalid(map, i);
+              }
+            }
+          });
     }
     else if (mode == MREMAP_MODE_POLY_NOR) {
-      for (const int64_t i : faces_dst.index_range()) {
-        const blender::IndexRange face = faces_dst[i];
+      mesh_remap_items_define_parallel(
+          r_map,
+          faces_dst.index_range(),
+          MREMAP_GRAIN_SIZE,
+          [&](const blender::IndexRange range, MeshPairRemap *map) {
+            BVHTreeRayHit rayhit = {0};
+            float hit_dist;
+
+            for (const int64_t elem_dst : range) {
+              const int i = int(elem_dst);
+              const blender::IndexRange face = faces_dst[i];
+
+              blender::float3 tmp_co = blender::bke::mesh::face_center_calc(
+                  {reinterpret_cast<const blender::float3 *>(vert_positions_dst), numverts_dst},
+                  {&corner_verts_dst[face.start()], face.size()});
+              blender::float3 tmp_no = face_normals_dst[i];
 
-        tmp_co = blender::bke::mesh::face_center_calc(
-            {reinterpret_cast<const blender::float3 *>(vert_positions_dst), numverts_dst},
-            {&corner_verts_dst[face.start()], face.size()});
-        copy_v3_v3(tmp_no, face_normals_dst[i]);
-
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-          BLI_space_transform_apply_normal(space_transform, tmp_no);
-        }
+              /* Convert the vertex to tree coordinates, if needed. */
+              if (space_transform) {
+                BLI_space_transform_apply(space_transform, tmp_co);
+                BLI_space_transform_apply_normal(space_transform, tmp_no);
+              }
 
-        if (mesh_remap_bvhtree_query_raycast(
-                &treedata, &rayhit, tmp_co, tmp_no, ray_radius, max_dist, &hit_dist))
-        {
-          const int face_index = tri_faces[rayhit.index];
-          mesh_remap_item_define(r_map, int(i), hit_dist, 0, 1, &face_index, &full_weight);
-        }
-        else {
-          /* No source for this dest face! */
-          BKE_mesh_remap_item_define_invalid(r_map, int(i));
-        }
-      }
+              if (mesh_remap_bvhtree_query_raycast(
+                      &treedata, &rayhit, tmp_co, tmp_no, ray_radius, max_dist, &hit_dist))
+              {
+                const int face_index = tri_faces[rayhit.index];
+                mesh_remap_item_define(map, i, hit_dist, 0, 1, &face_index, &full_weight);
+              }
+              else {
+                /* No source for this dest face! */
+                BKE_mesh_remap_item_define_invalid(map, i);
+              }
+            }
+          });
     }
     else if (mode == MREMAP_MODE_POLY_POLYINTERP_PNORPROJ) {
       /* We cast our rays randomly, with a pseudo-even distribution
        * (since we spread across tessellated triangles,
-       * with additional weighting based on each triangle's relative area). */
+       * with additional weighting based on each triangle's relative area).
+       * The random sequence continues from one face to the next, so faces are handled in order. */
       RNG *rng = BLI_rng_new(0);
 
+      BVHTreeRayHit rayhit = {0};
+      float hit_dist;
+      blender::float3 tmp_co, tmp_no;
+
       const size_t numfaces_src = size_t(me_src->faces_num);
 
       /* Here it's simpler to just allocate for all faces :/ */
@@ -2287,5 +2408,6 @@ void BKE_mesh_remap_calc_faces_from_mesh(const int mode,
 #undef MREMAP_RAYCAST_TRI_SAMPLES_MIN
 #undef MREMAP_RAYCAST_TRI_SAMPLES_MAX
 #undef MREMAP_DEFAULT_BUFSIZE
+#undef MREMAP_GRAIN_SIZE
 
 /** \} */
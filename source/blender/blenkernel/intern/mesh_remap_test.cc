@@ -0,0 +1,335 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cfloat>
+#include <cmath>
+
+#include "BLI_function_ref.hh"
+#include "BLI_math_vector_types.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_modifier_enums.h"
+
+#include "BKE_attribute.hh"
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.h"
+#include "BKE_mesh.hh"
+#include "BKE_mesh_mapping.hh"
+#include "BKE_mesh_remap.hh"
+
+#include "CLG_log.h"
+
+#ifdef WITH_TBB
+#  include <tbb/task_arena.h>
+#endif
+
+namespace blender::bke::tests {
+
+class MeshRemapTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    CLG_exit();
+  }
+};
+
+/**
+ * A wavy grid of quads in the XY plane, with a UV seam through the middle that splits it into two
+ * islands.
+ */
+static Mesh *create_grid_mesh(const int size, const float offset)
+{
+  const int verts_x = size + 1;
+  const int horizontal_edges_num = size * verts_x;
+  Mesh *mesh = BKE_mesh_new_nomain(
+      verts_x * verts_x, 2 * horizontal_edges_num, size * size, 4 * size * size);
+  const auto vert = [&](const int x, const int y) { return y * verts_x + x; };
+  const auto horizontal_edge = [&](const int x, const int y) { return y * size + x; };
+  const auto vertical_edge = [&](const int x, const int y) {
+    return horizontal_edges_num + x * size + y;
+  };
+
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  for (const int y : IndexRange(verts_x)) {
+    for (const int x : IndexRange(verts_x)) {
+      positions[vert(x, y)] = float3(float(x) / size + offset,
+                                     float(y) / size + offset,
+                                     0.1f * std::sin(float(x) * 0.7f) * std::cos(float(y) * 0.3f));
+    }
+  }
+
+  MutableSpan<int2> edges = mesh->edges_for_write();
+  for (const int y : IndexRange(verts_x)) {
+    for (const int x : IndexRange(size)) {
+      edges[horizontal_edge(x, y)] = int2(vert(x, y), vert(x + 1, y));
+    }
+  }
+  for (const int x : IndexRange(verts_x)) {
+    for (const int y : IndexRange(size)) {
+      edges[vertical_edge(x, y)] = int2(vert(x, y), vert(x, y + 1));
+    }
+  }
+
+  MutableSpan<int> face_offsets = mesh->face_offsets_for_write();
+  MutableSpan<int> corner_verts = mesh->corner_verts_for_write();
+  MutableSpan<int> corner_edges = mesh->corner_edges_for_write();
+  for (const int y : IndexRange(size)) {
+    for (const int x : IndexRange(size)) {
+      const int face = y * size + x;
+      face_offsets[face] = face * 4;
+      corner_verts.slice(face * 4, 4).copy_from(
+          {vert(x, y), vert(x + 1, y), vert(x + 1, y + 1), vert(x, y + 1)});
+      corner_edges.slice(face * 4, 4).copy_from({horizontal_edge(x, y),
+                                                 vertical_edge(x + 1, y),
+                                                 horizontal_edge(x, y + 1),
+                                                 vertical_edge(x, y)});
+    }
+  }
+  face_offsets.last() = corner_verts.size();
+
+  SpanAttributeWriter<bool> uv_seams =
+      mesh->attributes_for_write().lookup_or_add_for_write_span<bool>("uv_seam", AttrDomain::Edge);
+  for (const int y : IndexRange(size)) {
+    uv_seams.span[vertical_edge(size / 2, y)] = true;
+  }
+  uv_seams.finish();
+  return mesh;
+}
+
+/** Compute the map with a single thread, which defines the items in order with a single arena. */
+static void run_single_threaded(const FunctionRef<void()> fn)
+{
+#ifdef WITH_TBB
+  tbb::task_arena arena(1);
+  arena.execute([&]() { fn(); });
+#else
+  fn();
+#endif
+}
+
+static void expect_maps_equal(const MeshPairRemap &expected, const MeshPairRemap &actual)
+{
+  ASSERT_EQ(expected.items_num, actual.items_num);
+  for (const int i : IndexRange(expected.items_num)) {
+    const MeshPairRemapItem &item_expected = expected.items[i];
+    const MeshPairRemapItem &item_actual = actual.items[i];
+    ASSERT_EQ(item_expected.sources_num, item_actual.sources_num) << "Item " << i;
+    EXPECT_EQ(item_expected.island, item_actual.island) << "Item " << i;
+    if (item_expected.sources_num > 0) {
+      EXPECT_EQ_ARRAY(
+          item_expected.indices_src, item_actual.indices_src, item_expected.sources_num);
+      EXPECT_EQ_ARRAY(
+          item_expected.weights_src, item_actual.weights_src, item_expected.sources_num);
+    }
+  }
+}
+
+/**
+ * Compute a map on all threads and with a single thread and check that the results are the same.
+ */
+static void test_matches_single_threaded(const FunctionRef<void(MeshPairRemap *r_map)> calc_fn)
+{
+  MeshPairRemap serial_map = {};
+  run_single_threaded([&]() { calc_fn(&serial_map); });
+  MeshPairRemap parallel_map = {};
+  calc_fn(&parallel_map);
+  /* Catch modes that don't find anything, they would trivially match. */
+  int mapped_items_num = 0;
+  for (const int i : IndexRange(serial_map.items_num)) {
+    mapped_items_num += serial_map.items[i].sources_num > 0;
+  }
+  EXPECT_GT(mapped_items_num, serial_map.items_num / 2);
+  expect_maps_equal(serial_map, parallel_map);
+  BKE_mesh_remap_free(&serial_map);
+  BKE_mesh_remap_free(&parallel_map);
+}
+
+struct RemapMeshes {
+  Mesh *src;
+  Mesh *dst;
+  const float (*dst_positions)[3];
+
+  RemapMeshes()
+  {
+    /* Enough destination elements to be split into many tasks. */
+    src = create_grid_mesh(48, 0.0f);
+    dst = create_grid_mesh(41, 0.013f);
+    dst_positions = reinterpret_cast<const float(*)[3]>(dst->vert_positions().data());
+  }
+
+  ~RemapMeshes()
+  {
+    BKE_id_free(nullptr, src);
+    BKE_id_free(nullptr, dst);
+  }
+};
+
+TEST_F(MeshRemapTest, VertsMatchSingleThreaded)
+{
+  RemapMeshes meshes;
+  for (const int mode : {MREMAP_MODE_VERT_NEAREST,
+                         MREMAP_MODE_VERT_EDGE_NEAREST,
+                         MREMAP_MODE_VERT_EDGEINTERP_NEAREST,
+                         MREMAP_MODE_VERT_FACE_NEAREST,
+                         MREMAP_MODE_VERT_POLYINTERP_NEAREST,
+                         MREMAP_MODE_VERT_POLYINTERP_VNORPROJ})
+  {
+    SCOPED_TRACE(mode);
+    test_matches_single_threaded([&](MeshPairRemap *r_map) {
+      BKE_mesh_remap_calc_verts_from_mesh(mode,
+                                          nullptr,
+                                          FLT_MAX,
+                                          0.0f,
+                                          meshes.dst_positions,
+                                          meshes.dst->verts_num,
+                                          meshes.src,
+                                          meshes.dst,
+                                          r_map);
+    });
+  }
+}
+
+TEST_F(MeshRemapTest, EdgesMatchSingleThreaded)
+{
+  RemapMeshes meshes;
+  for (const int mode : {MREMAP_MODE_EDGE_VERT_NEAREST,
+                         MREMAP_MODE_EDGE_NEAREST,
+                         MREMAP_MODE_EDGE_POLY_NEAREST,
+                         MREMAP_MODE_EDGE_EDGEINTERP_VNORPROJ})
+  {
+    SCOPED_TRACE(mode);
+    test_matches_single_threaded([&](MeshPairRemap *r_map) {
+      BKE_mesh_remap_calc_edges_from_mesh(mode,
+                                          nullptr,
+                                          FLT_MAX,
+                                          0.0f,
+                                          meshes.dst_positions,
+                                          meshes.dst->verts_num,
+                                          meshes.dst->edges().data(),
+                                          meshes.dst->edges_num,
+                                          meshes.src,
+                                          meshes.dst,
+                                          r_map);
+    });
+  }
+}
+
+TEST_F(MeshRemapTest, LoopsMatchSingleThreaded)
+{
+  RemapMeshes meshes;
+  for (const int mode : {MREMAP_MODE_LOOP_NEAREST_LOOPNOR,
+                         MREMAP_MODE_LOOP_NEAREST_POLYNOR,
+                         MREMAP_MODE_LOOP_POLY_NEAREST,
+                         MREMAP_MODE_LOOP_POLYINTERP_NEAREST,
+                         MREMAP_MODE_LOOP_POLYINTERP_LNORPROJ})
+  {
+    /* Without islands, and with the islands split by the UV seam. */
+    for (const MeshRemapIslandsCalc islands_fn :
+         {MeshRemapIslandsCalc(nullptr), BKE_mesh_calc_islands_loop_face_edgeseam})
+    {
+      SCOPED_TRACE(mode);
+      SCOPED_TRACE(islands_fn ? "Islands" : "No islands");
+      test_matches_single_threaded([&](MeshPairRemap *r_map) {
+        BKE_mesh_remap_calc_loops_from_mesh(mode,
+                                            nullptr,
+                                            FLT_MAX,
+                                            0.0f,
+                                            meshes.dst,
+                                            meshes.dst_positions,
+                                            meshes.dst->verts_num,
+                                            meshes.dst->corner_verts().data(),
+                                            meshes.dst->corners_num,
+                                            meshes.dst->faces(),
+                                            meshes.src,
+                                            islands_fn,
+                                            0.5f,
+                                            r_map);
+      });
+    }
+  }
+}
+
+TEST_F(MeshRemapTest, FacesMatchSingleThreaded)
+{
+  RemapMeshes meshes;
+  for (const int mode :
+       {MREMAP_MODE_POLY_NEAREST, MREMAP_MODE_POLY_NOR, MREMAP_MODE_POLY_POLYINTERP_PNORPROJ})
+  {
+    SCOPED_TRACE(mode);
+    test_matches_single_threaded([&](MeshPairRemap *r_map) {
+      BKE_mesh_remap_calc_faces_from_mesh(mode,
+                                          nullptr,
+                                          FLT_MAX,
+                                          0.0f,
+                                          meshes.dst,
+                                          meshes.dst_positions,
+                                          meshes.dst->verts_num,
+                                          meshes.dst->corner_verts().data(),
+                                          meshes.dst->faces(),
+                                          meshes.src,
+                                          r_map);
+    });
+  }
+}
+
+TEST_F(MeshRemapTest, TopologyMatchesSingleThreaded)
+{
+  RemapMeshes meshes;
+  /* Topology mapping expects the same topology on both meshes. */
+  Mesh *dst = create_grid_mesh(48, 0.013f);
+  const float (*dst_positions)[3] = reinterpret_cast<const float(*)[3]>(
+      dst->vert_positions().data());
+  test_matches_single_threaded([&](MeshPairRemap *r_map) {
+    BKE_mesh_remap_calc_verts_from_mesh(MREMAP_MODE_TOPOLOGY,
+                                        nullptr,
+                                        FLT_MAX,
+                                        0.0f,
+                                        dst_positions,
+                                        dst->verts_num,
+                                        meshes.src,
+                                        dst,
+                                        r_map);
+  });
+  test_matches_single_threaded([&](MeshPairRemap *r_map) {
+    BKE_mesh_remap_calc_loops_from_mesh(MREMAP_MODE_TOPOLOGY,
+                                        nullptr,
+                                        FLT_MAX,
+                                        0.0f,
+                                        dst,
+                                        dst_positions,
+                                        dst->verts_num,
+                                        dst->corner_verts().data(),
+                                        dst->corners_num,
+                                        dst->faces(),
+                                        meshes.src,
+                                        nullptr,
+                                        0.0f,
+                                        r_map);
+  });
+  test_matches_single_threaded([&](MeshPairRemap *r_map) {
+    BKE_mesh_remap_calc_faces_from_mesh(MREMAP_MODE_TOPOLOGY,
+                                        nullptr,
+                                        FLT_MAX,
+                                        0.0f,
+                                        dst,
+                                        dst_positions,
+                                        dst->verts_num,
+                                        dst->corner_verts().data(),
+                                        dst->faces(),
+                                        meshes.src,
+                                        r_map);
+  });
+  BKE_id_free(nullptr, dst);
+}
+
+}  // namespace blender::bke::tests
@@ -43,6 +43,12 @@
 #  include "quadriflow_capi.hpp"
 #endif
 
+// #define DEBUG_REMESH_TIME
+
+#ifdef DEBUG_REMESH_TIME
+#  include "BLI_timeit.hh"
+#endif
+
 using blender::Array;
 using blender::float3;
 using blender::IndexRange;
@@ -176,17 +182,30 @@ static openvdb::FloatGrid::Ptr remesh_voxel_level_set_create(
   std::vector<openvdb::Vec3s> points(mesh->verts_num);
   std::vector<openvdb::Vec3I> triangles(corner_tris.size());
 
-  for (const int i : IndexRange(mesh->verts_num)) {
-    const float3 &co = positions[i];
-    points[i] = openvdb::Vec3s(co.x, co.y, co.z);
-  }
+  {
+#  ifdef DEBUG_REMESH_TIME
+    SCOPED_TIMER("remesh_voxel_level_set_input");
+#  endif
+    blender::threading::parallel_for(positions.index_range(), 4096, [&](const IndexRange range) {
+      for (const int i : range) {
+        const float3 &co = positions[i];
+        points[i] = openvdb::Vec3s(co.x, co.y, co.z);
+      }
+    });
 
-  for (const int i : IndexRange(corner_tris.size())) {
-    const int3 &tri = corner_tris[i];
-    triangles[i] = openvdb::Vec3I(
-        corner_verts[tri[0]], corner_verts[tri[1]], corner_verts[tri[2]]);
+    blender::threading::parallel_for(corner_tris.index_range(), 4096, [&](const IndexRange range) {
+      for (const int i : range) {
+        const int3 &tri = corner_tris[i];
+        triangles[i] = openvdb::Vec3I(
+            corner_verts[tri[0]], corner_verts[tri[1]], corner_verts[tri[2]]);
+      }
+    });
   }
 
+  /* The conversion itself is multi-threaded within OpenVDB. */
+#  ifdef DEBUG_REMESH_TIME
+  SCOPED_TIMER("remesh_voxel_mesh_to_level_set");
+#  endif
   openvdb::FloatGrid::Ptr grid = openvdb::tools::meshToLevelSet<openvdb::FloatGrid>(
       *transform, points, triangles, 1.0f);
 
@@ -203,8 +222,17 @@ static Mesh *remesh_voxel_volume_to_mesh(const openvdb::FloatGrid::Ptr level_set
   std::vector<openvdb::Vec3s> vertices;
   std::vector<openvdb::Vec4I> quads;
   std::vector<openvdb::Vec3I> tris;
-  openvdb::tools::volumeToMesh<openvdb::FloatGrid>(
-      *level_set_grid, vertices, tris, quads, isovalue, adaptivity, relax_disoriented_triangles);
+  {
+#  ifdef DEBUG_REMESH_TIME
+    SCOPED_TIMER("remesh_voxel_volume_to_mesh");
+#  endif
+    openvdb::tools::volumeToMesh<openvdb::FloatGrid>(
+        *level_set_grid, vertices, tris, quads, isovalue, adaptivity, relax_disoriented_triangles);
+  }
+
+#  ifdef DEBUG_REMESH_TIME
+  SCOPED_TIMER("remesh_voxel_mesh_create");
+#  endif
 
   Mesh *mesh = BKE_mesh_new_nomain(
       vertices.size(), 0, quads.size() + tris.size(), quads.size() * 4 + tris.size() * 3);
@@ -219,24 +247,30 @@ static Mesh *remesh_voxel_volume_to_mesh(const openvdb::FloatGrid::Ptr level_set
         3, triangle_loop_start, face_offsets.drop_front(quads.size()));
   }
 
-  for (const int i : vert_positions.index_range()) {
-    vert_positions[i] = float3(vertices[i].x(), vertices[i].y(), vertices[i].z());
-  }
+  threading::parallel_for(vert_positions.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      vert_positions[i] = float3(vertices[i].x(), vertices[i].y(), vertices[i].z());
+    }
+  });
 
-  for (const int i : IndexRange(quads.size())) {
-    const int loopstart = i * 4;
-    mesh_corner_verts[loopstart] = quads[i][0];
-    mesh_corner_verts[loopstart + 1] = quads[i][3];
-    mesh_corner_verts[loopstart + 2] = quads[i][2];
-    mesh_corner_verts[loopstart + 3] = quads[i][1];
-  }
+  threading::parallel_for(IndexRange(quads.size()), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      const int loopstart = i * 4;
+      mesh_corner_verts[loopstart] = quads[i][0];
+      mesh_corner_verts[loopstart + 1] = quads[i][3];
+      mesh_corner_verts[loopstart + 2] = quads[i][2];
+      mesh_corner_verts[loopstart + 3] = quads[i][1];
+    }
+  });
 
-  for (const int i : IndexRange(tris.size())) {
-    const int loopstart = triangle_loop_start + i * 3;
-    mesh_corner_verts[loopstart] = tris[i][2];
-    mesh_corner_verts[loopstart + 1] = tris[i][1];
-    mesh_corner_verts[loopstart + 2] = tris[i][0];
-  }
+  threading::parallel_for(IndexRange(tris.size()), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      const int loopstart = triangle_loop_start + i * 3;
+      mesh_corner_verts[loopstart] = tris[i][2];
+      mesh_corner_verts[loopstart + 1] = tris[i][1];
+      mesh_corner_verts[loopstart + 2] = tris[i][0];
+    }
+  });
 
   mesh_calc_edges(*mesh, false, false);
 
@@ -494,11 +528,22 @@ static void gather_attributes(const Span<StringRef> ids,
                               const Span<int> index_map,
                               MutableAttributeAccessor dst_attributes)
 {
+  /* Adding attributes isn't thread-safe, but once they exist, all of them (e.g. mask, face sets
+   * and color attributes) can be filled at the same time. */
+  Vector<GVArraySpan> srcs;
+  Vector<GSpanAttributeWriter> dsts;
   for (const StringRef id : ids) {
-    const GVArraySpan src = *src_attributes.lookup(id, domain);
+    GVArraySpan src = *src_attributes.lookup(id, domain);
     const eCustomDataType type = cpp_type_to_custom_data_type(src.type());
-    GSpanAttributeWriter dst = dst_attributes.lookup_or_add_for_write_only_span(id, domain, type);
-    attribute_math::gather(src, index_map, dst.span);
+    dsts.append(dst_attributes.lookup_or_add_for_write_only_span(id, domain, type));
+    srcs.append(std::move(src));
+  }
+  threading::parallel_for(ids.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      attribute_math::gather(srcs[i], index_map, dsts[i].span);
+    }
+  });
+  for (GSpanAttributeWriter &dst : dsts) {
     dst.finish();
   }
 }
@@ -540,6 +585,10 @@ void mesh_remesh_reproject_attributes(const Mesh &src, Mesh &dst)
     return;
   }
 
+#ifdef DEBUG_REMESH_TIME
+  SCOPED_TIMER_AVERAGED(__func__);
+#endif
+
   const Span<float3> src_positions = src.vert_positions();
   const OffsetIndices src_faces = src.faces();
   const Span<int> src_corner_verts = src.corner_verts();
@@ -331,6 +331,7 @@ void BKE_mesh_runtime_clear_geometry(Mesh *mesh)
   mesh->runtime->corner_tris_cache.data.tag_dirty();
   mesh->runtime->corner_tri_faces_cache.tag_dirty();
   mesh->runtime->shrinkwrap_boundary_cache.tag_dirty();
+  mesh->runtime->uv_tangents_cache.tag_dirty();
   mesh->runtime->max_material_index.tag_dirty();
   mesh->runtime->subsurf_face_dot_tags.clear_and_shrink();
   mesh->runtime->subsurf_optimal_display_edges.clear_and_shrink();
@@ -365,6 +366,7 @@ void Mesh::tag_edges_split()
   this->runtime->subsurf_face_dot_tags.clear_and_shrink();
   this->runtime->subsurf_optimal_display_edges.clear_and_shrink();
   this->runtime->shrinkwrap_boundary_cache.tag_dirty();
+  this->runtime->uv_tangents_cache.tag_dirty();
 }
 
 void Mesh::tag_sharpness_changed()
@@ -372,6 +374,7 @@ void Mesh::tag_sharpness_changed()
   this->runtime->vert_normals_cache.tag_dirty();
   this->runtime->face_normals_cache.tag_dirty();
   this->runtime->corner_normals_cache.tag_dirty();
+  this->runtime->uv_tangents_cache.tag_dirty();
 }
 
 void Mesh::tag_custom_normals_changed()
@@ -379,6 +382,7 @@ void Mesh::tag_custom_normals_changed()
   this->runtime->vert_normals_cache.tag_dirty();
   this->runtime->face_normals_cache.tag_dirty();
   this->runtime->corner_normals_cache.tag_dirty();
+  this->runtime->uv_tangents_cache.tag_dirty();
 }
 
 void Mesh::tag_face_winding_changed()
@@ -390,6 +394,7 @@ void Mesh::tag_face_winding_changed()
   this->runtime->corner_normals_cache.tag_dirty();
   this->runtime->vert_to_corner_map_cache.tag_dirty();
   this->runtime->shrinkwrap_boundary_cache.tag_dirty();
+  this->runtime->uv_tangents_cache.tag_dirty();
 }
 
 void Mesh::tag_positions_changed()
@@ -409,6 +414,7 @@ void Mesh::tag_positions_changed_no_normals()
   this->runtime->corner_tris_cache.tag_dirty();
   this->runtime->bounds_cache.tag_dirty();
   this->runtime->shrinkwrap_boundary_cache.tag_dirty();
+  this->runtime->uv_tangents_cache.tag_dirty();
 }
 
 void Mesh::tag_positions_changed_uniformly()
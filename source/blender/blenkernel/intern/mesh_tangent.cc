@@ -14,12 +14,14 @@
 #include "BLI_math_vector.h"
 #include "BLI_string.h"
 #include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "BKE_attribute.hh"
 #include "BKE_customdata.hh"
 #include "BKE_mesh.hh"
 #include "BKE_mesh_tangent.hh"
+#include "BKE_mesh_types.hh"
 #include "BKE_report.hh"
 
 #include "mikktspace.hh"
@@ -28,6 +30,7 @@
 
 using blender::float2;
 using blender::float3;
+using blender::float4;
 using blender::int3;
 using blender::OffsetIndices;
 using blender::Span;
@@ -311,6 +314,128 @@ static void DM_calc_loop_tangents_thread(TaskPool *__restrict /*pool*/, void *ta
   mikk.genTangSpace();
 }
 
+#ifdef USE_TRI_DETECT_QUADS
+/**
+ * Map 'fake' face indices to #corner_tris, quads point to the first triangle of the quad.
+ * Empty when every face is a triangle.
+ */
+static blender::Vector<int> face_as_quad_map_calc(const OffsetIndices<int> faces,
+                                                  const Span<int3> corner_tris,
+                                                  const Span<int> corner_tri_faces)
+{
+  blender::Vector<int> face_as_quad_map;
+  if (corner_tris.size() == faces.size()) {
+    return face_as_quad_map;
+  }
+  /* Over allocate, since we don't know how many ngon or quads we have. */
+  face_as_quad_map.reserve(corner_tris.size());
+  for (int j = 0; j < int(corner_tris.size()); j++) {
+    face_as_quad_map.append(j);
+    /* step over all quads */
+    if (faces[corner_tri_faces[j]].size() == 4) {
+      j++; /* Skips the next corner_tri. */
+    }
+  }
+  return face_as_quad_map;
+}
+#endif
+
+static void calc_uv_map_tangents(const Mesh &mesh,
+                                 const Span<float2> uv_map,
+                                 blender::MutableSpan<float4> r_tangents)
+{
+  const Span<int3> corner_tris = mesh.corner_tris();
+  if (corner_tris.is_empty()) {
+    return;
+  }
+  const Span<int> corner_tri_faces = mesh.corner_tri_faces();
+  const blender::bke::AttributeAccessor attributes = mesh.attributes();
+  const blender::VArraySpan sharp_faces = *attributes.lookup<bool>(
+      "sharp_face", blender::bke::AttrDomain::Face);
+
+  SGLSLMeshToTangent mesh2tangent{};
+  mesh2tangent.numTessFaces = int(corner_tris.size());
+#ifdef USE_TRI_DETECT_QUADS
+  const blender::Vector<int> face_as_quad_map = face_as_quad_map_calc(
+      mesh.faces(), corner_tris, corner_tri_faces);
+  mesh2tangent.face_as_quad_map = face_as_quad_map.is_empty() ? nullptr : face_as_quad_map.data();
+  mesh2tangent.num_face_as_quad_map = face_as_quad_map.is_empty() ? int(corner_tris.size()) :
+                                                                    int(face_as_quad_map.size());
+#endif
+  mesh2tangent.positions = mesh.vert_positions();
+  mesh2tangent.vert_normals = mesh.vert_normals();
+  mesh2tangent.faces = mesh.faces();
+  mesh2tangent.corner_verts = mesh.corner_verts().data();
+  mesh2tangent.corner_tris = corner_tris.data();
+  mesh2tangent.tri_faces = corner_tri_faces.data();
+  mesh2tangent.sharp_faces = sharp_faces;
+  mesh2tangent.face_normals = mesh.face_normals();
+  /* Face and vertex normals give the same result without computing corner normals. */
+  if (mesh.normals_domain() == blender::bke::MeshNormalDomain::Corner) {
+    mesh2tangent.corner_normals = mesh.corner_normals();
+  }
+  mesh2tangent.mloopuv = uv_map.data();
+  mesh2tangent.tangent = reinterpret_cast<float(*)[4]>(r_tangents.data());
+
+  mikk::Mikktspace<SGLSLMeshToTangent> mikk(mesh2tangent);
+  mikk.genTangSpace();
+}
+
+namespace blender::bke::mesh {
+
+ImplicitSharingPtrAndData uv_map_tangents_get(const Mesh &mesh, const StringRef uv_map_name)
+{
+  const int layer_index = CustomData_get_named_layer_index(
+      &mesh.corner_data, CD_PROP_FLOAT2, uv_map_name);
+  if (layer_index == -1) {
+    return {};
+  }
+  const CustomDataLayer &layer = mesh.corner_data.layers[layer_index];
+  const Span<float2> uv_map(static_cast<const float2 *>(layer.data), mesh.corners_num);
+
+  auto calc_tangents = [&]() {
+    float4 *tangents = MEM_calloc_arrayN<float4>(size_t(mesh.corners_num), __func__);
+    calc_uv_map_tangents(mesh, uv_map, {tangents, mesh.corners_num});
+    return ImplicitSharingPtrAndData(
+        ImplicitSharingPtr<>(implicit_sharing::info_for_mem_free(tangents)), tangents);
+  };
+
+  const ImplicitSharingInfo *uv_sharing_info = layer.sharing_info;
+  if (uv_sharing_info == nullptr) {
+    return calc_tangents();
+  }
+
+  mesh.runtime->uv_tangents_cache.ensure([](UVTangentsCache &r_data) { r_data.uv_maps.clear(); });
+  const UVTangentsCache &cache = mesh.runtime->uv_tangents_cache.data();
+  {
+    std::scoped_lock lock(cache.mutex);
+    for (const UVTangentsCache::UVMapTangents &uv_map_tangents : cache.uv_maps) {
+      if (uv_map_tangents.uv_map_name == uv_map_name &&
+          uv_map_tangents.uv_sharing_info.get() == uv_sharing_info &&
+          uv_map_tangents.uv_version == uv_sharing_info->version())
+      {
+        return uv_map_tangents.tangents;
+      }
+    }
+  }
+
+  /* Computed without holding the lock, so that different UV maps are computed in parallel. */
+  ImplicitSharingPtrAndData tangents = calc_tangents();
+
+  std::scoped_lock lock(cache.mutex);
+  cache.uv_maps.remove_if([&](const UVTangentsCache::UVMapTangents &uv_map_tangents) {
+    return uv_map_tangents.uv_map_name == uv_map_name;
+  });
+  uv_sharing_info->add_weak_user();
+  cache.uv_maps.append({uv_map_name,
+                        WeakImplicitSharingPtr(uv_sharing_info),
+                        uv_sharing_info->version(),
+                        tangents});
+  return tangents;
+}
+
+}  // namespace blender::bke::mesh
+
 void BKE_mesh_add_loop_tangent_named_layer_for_uv(const CustomData *uv_data,
                                                   CustomData *tan_data,
                                                   int numLoopData,
@@ -399,24 +524,29 @@ void BKE_mesh_calc_loop_tangent_step_0(const CustomData *loopData,
   }
 }
 
-void BKE_mesh_calc_loop_tangent_ex(const Span<float3> vert_positions,
-                                   const OffsetIndices<int> faces,
-                                   const Span<int> corner_verts,
-                                   const Span<int3> corner_tris,
-                                   const Span<int> corner_tri_faces,
-                                   const Span<bool> sharp_faces,
-                                   const CustomData *loopdata,
-                                   bool calc_active_tangent,
-                                   const char (*tangent_names)[MAX_CUSTOMDATA_LAYER_NAME],
-                                   int tangent_names_len,
-                                   const Span<float3> vert_normals,
-                                   const Span<float3> face_normals,
-                                   const Span<float3> corner_normals,
-                                   const Span<float3> vert_orco,
-                                   /* result */
-                                   CustomData *loopdata_out,
-                                   const uint loopdata_out_len,
-                                   short *tangent_mask_curr_p)
+/**
+ * \param mesh: When not null, the other arguments are the data of this mesh. Tangents of UV maps
+ * are then taken from its cache instead of being computed.
+ */
+static void calc_loop_tangents(const Mesh *mesh,
+                               const Span<float3> vert_positions,
+                               const OffsetIndices<int> faces,
+                               const Span<int> corner_verts,
+                               const Span<int3> corner_tris,
+                               const Span<int> corner_tri_faces,
+                               const Span<bool> sharp_faces,
+                               const CustomData *loopdata,
+                               bool calc_active_tangent,
+                               const char (*tangent_names)[MAX_CUSTOMDATA_LAYER_NAME],
+                               int tangent_names_len,
+                               const Span<float3> vert_normals,
+                               const Span<float3> face_normals,
+                               const Span<float3> corner_normals,
+                               const Span<float3> vert_orco,
+                               /* result */
+                               CustomData *loopdata_out,
+                               const uint loopdata_out_len,
+                               short *tangent_mask_curr_p)
 {
   int act_uv_n = -1;
   int ren_uv_n = -1;
@@ -463,28 +593,15 @@ void BKE_mesh_calc_loop_tangent_ex(const Span<float3> vert_positions,
     }
 
 #ifdef USE_TRI_DETECT_QUADS
-    int num_face_as_quad_map;
-    int *face_as_quad_map = nullptr;
-
     /* map faces to quads */
-    if (corner_tris.size() != faces.size()) {
-      /* Over allocate, since we don't know how many ngon or quads we have. */
-
-      /* Map fake face index to corner_tris. */
-      face_as_quad_map = MEM_malloc_arrayN<int>(size_t(corner_tris.size()), __func__);
-      int k, j;
-      for (k = 0, j = 0; j < int(corner_tris.size()); k++, j++) {
-        face_as_quad_map[k] = j;
-        /* step over all quads */
-        if (faces[corner_tri_faces[j]].size() == 4) {
-          j++; /* Skips the next corner_tri. */
-        }
-      }
-      num_face_as_quad_map = k;
-    }
-    else {
-      num_face_as_quad_map = int(corner_tris.size());
-    }
+    const blender::Vector<int> face_as_quad_map_data = face_as_quad_map_calc(
+        faces, corner_tris, corner_tri_faces);
+    const int *face_as_quad_map = face_as_quad_map_data.is_empty() ?
+                                      nullptr :
+                                      face_as_quad_map_data.data();
+    const int num_face_as_quad_map = face_as_quad_map_data.is_empty() ?
+                                         int(corner_tris.size()) :
+                                         int(face_as_quad_map_data.size());
 #endif
 
     /* Calculation */
@@ -494,6 +611,7 @@ void BKE_mesh_calc_loop_tangent_ex(const Span<float3> vert_positions,
       tangent_mask_curr = 0;
       /* Calculate tangent layers */
       SGLSLMeshToTangent data_array[MAX_MTFACE];
+      blender::Vector<int, MAX_MTFACE> cached_layer_indices;
       const int tangent_layer_num = CustomData_number_of_layers(loopdata_out, CD_TANGENT);
       for (int n = 0; n < tangent_layer_num; n++) {
         int index = CustomData_get_layer_index_n(loopdata_out, CD_TANGENT, n);
@@ -539,9 +657,20 @@ void BKE_mesh_calc_loop_tangent_ex(const Span<float3> vert_positions,
         }
 
         mesh2tangent->tangent = static_cast<float(*)[4]>(loopdata_out->layers[index].data);
+        if (mesh && mesh2tangent->mloopuv) {
+          cached_layer_indices.append(index);
+          continue;
+        }
         BLI_task_pool_push(task_pool, DM_calc_loop_tangents_thread, mesh2tangent, false, nullptr);
       }
 
+      blender::threading::parallel_for_each(cached_layer_indices, [&](const int index) {
+        const CustomDataLayer &layer = loopdata_out->layers[index];
+        const blender::ImplicitSharingPtrAndData tangents =
+            blender::bke::mesh::uv_map_tangents_get(*mesh, layer.name);
+        memcpy(layer.data, tangents.data, sizeof(float4) * loopdata_out_len);
+      });
+
       BLI_assert(tangent_mask_curr == tangent_mask);
       BLI_task_pool_work_and_wait(task_pool);
       BLI_task_pool_free(task_pool);
@@ -549,13 +678,6 @@ void BKE_mesh_calc_loop_tangent_ex(const Span<float3> vert_positions,
     else {
       tangent_mask_curr = tangent_mask;
     }
-#ifdef USE_TRI_DETECT_QUADS
-    if (face_as_quad_map) {
-      MEM_freeN(face_as_quad_map);
-    }
-#  undef USE_TRI_DETECT_QUADS
-
-#endif
 
     *tangent_mask_curr_p = tangent_mask_curr;
 
@@ -577,39 +699,99 @@ void BKE_mesh_calc_loop_tangent_ex(const Span<float3> vert_positions,
   }
 }
 
+void BKE_mesh_calc_loop_tangent_ex(const Span<float3> vert_positions,
+                                   const OffsetIndices<int> faces,
+                                   const Span<int> corner_verts,
+                                   const Span<int3> corner_tris,
+                                   const Span<int> corner_tri_faces,
+                                   const Span<bool> sharp_faces,
+                                   const CustomData *loopdata,
+                                   bool calc_active_tangent,
+                                   const char (*tangent_names)[MAX_CUSTOMDATA_LAYER_NAME],
+                                   int tangent_names_len,
+                                   const Span<float3> vert_normals,
+                                   const Span<float3> face_normals,
+                                   const Span<float3> corner_normals,
+                                   const Span<float3> vert_orco,
+                                   /* result */
+                                   CustomData *loopdata_out,
+                                   const uint loopdata_out_len,
+                                   short *tangent_mask_curr_p)
+{
+  calc_loop_tangents(nullptr,
+                     vert_positions,
+                     faces,
+                     corner_verts,
+                     corner_tris,
+                     corner_tri_faces,
+                     sharp_faces,
+                     loopdata,
+                     calc_active_tangent,
+                     tangent_names,
+                     tangent_names_len,
+                     vert_normals,
+                     face_normals,
+                     corner_normals,
+                     vert_orco,
+                     loopdata_out,
+                     loopdata_out_len,
+                     tangent_mask_curr_p);
+}
+
+void BKE_mesh_calc_loop_tangents_cached(const Mesh &mesh,
+                                        bool calc_active_tangent,
+                                        const char (*tangent_names)[MAX_CUSTOMDATA_LAYER_NAME],
+                                        int tangent_names_len,
+                                        const Span<float3> vert_orco,
+                                        /* result */
+                                        CustomData *loopdata_out,
+                                        const uint loopdata_out_len,
+                                        short *tangent_mask_curr_p)
+{
+  using namespace blender;
+  using namespace blender::bke;
+  const bke::AttributeAccessor attributes = mesh.attributes();
+  const VArraySpan sharp_face = *attributes.lookup<bool>("sharp_face", AttrDomain::Face);
+  calc_loop_tangents(&mesh,
+                     mesh.vert_positions(),
+                     mesh.faces(),
+                     mesh.corner_verts(),
+                     mesh.corner_tris(),
+                     mesh.corner_tri_faces(),
+                     sharp_face,
+                     &mesh.corner_data,
+                     calc_active_tangent,
+                     tangent_names,
+                     tangent_names_len,
+                     mesh.vert_normals(),
+                     mesh.face_normals(),
+                     mesh.corner_normals(),
+                     vert_orco,
+                     loopdata_out,
+                     loopdata_out_len,
+                     tangent_mask_curr_p);
+}
+
 void BKE_mesh_calc_loop_tangents(Mesh *mesh_eval,
                                  bool calc_active_tangent,
                                  const char (*tangent_names)[MAX_CUSTOMDATA_LAYER_NAME],
                                  int tangent_names_len)
 {
-  /* TODO(@ideasman42): store in Mesh.runtime to avoid recalculation. */
-  using namespace blender;
-  using namespace blender::bke;
-  const Span<int3> corner_tris = mesh_eval->corner_tris();
-  const bke::AttributeAccessor attributes = mesh_eval->attributes();
-  const VArraySpan sharp_face = *attributes.lookup<bool>("sharp_face", AttrDomain::Face);
   const float3 *orco = static_cast<const float3 *>(
       CustomData_get_layer(&mesh_eval->vert_data, CD_ORCO));
   short tangent_mask = 0;
-  BKE_mesh_calc_loop_tangent_ex(mesh_eval->vert_positions(),
-                                mesh_eval->faces(),
-                                mesh_eval->corner_verts(),
-                                corner_tris,
-                                mesh_eval->corner_tri_faces(),
-                                sharp_face,
-                                &mesh_eval->corner_data,
-                                calc_active_tangent,
-                                tangent_names,
-                                tangent_names_len,
-                                mesh_eval->vert_normals(),
-                                mesh_eval->face_normals(),
-                                mesh_eval->corner_normals(),
-                                /* may be nullptr */
-                                orco ? Span(orco, mesh_eval->verts_num) : Span<float3>(),
-                                /* result */
-                                &mesh_eval->corner_data,
-                                uint(mesh_eval->corners_num),
-                                &tangent_mask);
+  BKE_mesh_calc_loop_tangents_cached(*mesh_eval,
+                                     calc_active_tangent,
+                                     tangent_names,
+                                     tangent_names_len,
+                                     /* may be nullptr */
+                                     orco ? Span(orco, mesh_eval->verts_num) : Span<float3>(),
+                                     /* result */
+                                     &mesh_eval->corner_data,
+                                     uint(mesh_eval->corners_num),
+                                     &tangent_mask);
 }
 
+#undef USE_TRI_DETECT_QUADS
+
 /** \} */
@@ -0,0 +1,94 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_math_vector.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "BKE_attribute.hh"
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.h"
+#include "BKE_mesh.hh"
+#include "BKE_mesh_tangent.hh"
+
+#include "CLG_log.h"
+
+namespace blender::bke::tests {
+
+class MeshTangentTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    CLG_exit();
+  }
+};
+
+/** A unit quad in the XY plane, with a UV map that matches the positions. */
+static Mesh *create_quad_mesh()
+{
+  Mesh *mesh = BKE_mesh_new_nomain(4, 4, 1, 4);
+  mesh->vert_positions_for_write().copy_from(
+      {float3(0, 0, 0), float3(1, 0, 0), float3(1, 1, 0), float3(0, 1, 0)});
+  mesh->edges_for_write().copy_from({int2(0, 1), int2(1, 2), int2(2, 3), int2(3, 0)});
+  mesh->face_offsets_for_write().copy_from({0, 4});
+  mesh->corner_verts_for_write().copy_from({0, 1, 2, 3});
+  mesh->corner_edges_for_write().copy_from({0, 1, 2, 3});
+  SpanAttributeWriter<float2> uv_map =
+      mesh->attributes_for_write().lookup_or_add_for_write_only_span<float2>("UVMap",
+                                                                             AttrDomain::Corner);
+  uv_map.span.copy_from({float2(0, 0), float2(1, 0), float2(1, 1), float2(0, 1)});
+  uv_map.finish();
+  return mesh;
+}
+
+static float3 first_tangent(const ImplicitSharingPtrAndData &tangents)
+{
+  return float3(static_cast<const float4 *>(tangents.data)[0]);
+}
+
+TEST_F(MeshTangentTest, UVMapTangentsCache)
+{
+  Mesh *mesh = create_quad_mesh();
+  EXPECT_EQ(mesh::uv_map_tangents_get(*mesh, "Missing").data, nullptr);
+
+  const ImplicitSharingPtrAndData tangents = mesh::uv_map_tangents_get(*mesh, "UVMap");
+  ASSERT_NE(tangents.data, nullptr);
+  EXPECT_V3_NEAR(first_tangent(tangents), float3(1, 0, 0), 1e-5f);
+  /* The tangents are cached until the mesh or the UV map changes. */
+  EXPECT_EQ(mesh::uv_map_tangents_get(*mesh, "UVMap").data, tangents.data);
+
+  /* Rotate the quad by 90 degrees around the Z axis. */
+  for (float3 &position : mesh->vert_positions_for_write()) {
+    position = float3(-position.y, position.x, position.z);
+  }
+  mesh->tag_positions_changed();
+  const ImplicitSharingPtrAndData rotated_tangents = mesh::uv_map_tangents_get(*mesh, "UVMap");
+  ASSERT_NE(rotated_tangents.data, tangents.data);
+  EXPECT_V3_NEAR(first_tangent(rotated_tangents), float3(0, 1, 0), 1e-5f);
+
+  /* Mirror the UV map horizontally, without tagging the mesh. */
+  SpanAttributeWriter<float2> uv_map = mesh->attributes_for_write().lookup_for_write_span<float2>(
+      "UVMap");
+  for (float2 &uv : uv_map.span) {
+    uv.x = 1.0f - uv.x;
+  }
+  uv_map.finish();
+  const ImplicitSharingPtrAndData mirrored_tangents = mesh::uv_map_tangents_get(*mesh, "UVMap");
+  ASSERT_NE(mirrored_tangents.data, rotated_tangents.data);
+  EXPECT_V3_NEAR(first_tangent(mirrored_tangents), float3(0, -1, 0), 1e-5f);
+  EXPECT_EQ(mesh::uv_map_tangents_get(*mesh, "UVMap").data, mirrored_tangents.data);
+
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::bke::tests
@@ -35,14 +35,17 @@
 #include "DNA_scene_types.h"
 #include "DNA_space_types.h"
 
+#include "BLI_array.hh"
 #include "BLI_fileops.h"
 #include "BLI_listbase.h"
 #include "BLI_math_rotation.h"
 #include "BLI_math_vector.h"
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
+#include "BLI_task.hh"
 #include "BLI_time.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "BLT_translation.hh"
 
@@ -69,10 +72,6 @@
 
 #include "BIK_api.h"
 
-#ifdef WITH_BULLET
-#  include "RBI_api.h"
-#endif
-
 #ifdef WITH_LZO
 #  ifdef WITH_SYSTEM_LZO
 #    include <lzo/lzo1x.h>
@@ -89,6 +88,10 @@
 #  include "LzmaLib.h"
 #endif
 
+#include <zstd.h>
+
+#define PTCACHE_ZSTD_COMPRESSION_LEVEL 3
+
 #define PTCACHE_DATA_FROM(data, type, from) \
   if (data[type]) { \
     memcpy(data[type], from, ptcache_data_size[type]); \
@@ -771,10 +774,7 @@ static int ptcache_rigidbody_write(int index, void *rb_v, void **data, int /*cfr
     RigidBodyOb *rbo = ob->rigidbody_object;
 
     if (rbo->type == RBO_TYPE_ACTIVE && rbo->shared->physics_object != nullptr) {
-#ifdef WITH_BULLET
-      RB_body_get_position(static_cast<rbRigidBody *>(rbo->shared->physics_object), rbo->pos);
-      RB_body_get_orientation(static_cast<rbRigidBody *>(rbo->shared->physics_object), rbo->orn);
-#endif
+      /* The simulated transforms of all bodies are copied to the objects before writing. */
       PTCACHE_DATA_FROM(data, BPHYS_DATA_LOCATION, rbo->pos);
       PTCACHE_DATA_FROM(data, BPHYS_DATA_ROTATION, rbo->orn);
     }
@@ -1503,10 +1503,104 @@ static void ptcache_file_close(PTCacheFile *pf)
   }
 }
 
-static int ptcache_file_compressed_read(PTCacheFile *pf, uchar *result, uint len)
+/**
+ * Split 32-bit words into four planes of bytes. Neighboring floats mostly share their sign and
+ * exponent bytes, which compress much better when they are stored next to each other. Trailing
+ * bytes that don't fill a word are copied unchanged.
+ */
+static void ptcache_bytes_shuffle(const uchar *in, const uint len, uchar *out)
+{
+  const uint words_num = len / 4;
+  for (uint word = 0; word < words_num; word++) {
+    for (uint byte = 0; byte < 4; byte++) {
+      out[byte * words_num + word] = in[word * 4 + byte];
+    }
+  }
+  memcpy(out + words_num * 4, in + words_num * 4, len - words_num * 4);
+}
+
+static void ptcache_bytes_unshuffle(const uchar *in, const uint len, uchar *out)
+{
+  const uint words_num = len / 4;
+  for (uint word = 0; word < words_num; word++) {
+    for (uint byte = 0; byte < 4; byte++) {
+      out[word * 4 + byte] = in[byte * words_num + word];
+    }
+  }
+  memcpy(out + words_num * 4, in + words_num * 4, len - words_num * 4);
+}
+
+/**
+ * \return Compressed data, empty when compression does not reduce the size.
+ *
+ * \note The data is compressed losslessly. Optionally quantizing positions and velocities first
+ * would reduce the size further, that is left for later since it needs a per-cache tolerance.
+ */
+static blender::Vector<uchar> ptcache_zstd_compress(const blender::Span<uchar> in)
+{
+  blender::Array<uchar> shuffled(in.size(), blender::NoInitialization());
+  ptcache_bytes_shuffle(in.data(), uint(in.size()), shuffled.data());
+
+  blender::Vector<uchar> out(ZSTD_compressBound(in.size()));
+  const size_t out_len = ZSTD_compress(
+      out.data(), out.size(), shuffled.data(), in.size(), PTCACHE_ZSTD_COMPRESSION_LEVEL);
+  if (ZSTD_isError(out_len) || out_len >= size_t(in.size())) {
+    return {};
+  }
+  out.resize(out_len);
+  return out;
+}
+
+static bool ptcache_zstd_decompress(const blender::Span<uchar> in,
+                                    const blender::MutableSpan<uchar> result)
+{
+  blender::Array<uchar> shuffled(result.size(), blender::NoInitialization());
+  const size_t out_len = ZSTD_decompress(shuffled.data(), result.size(), in.data(), in.size());
+  if (ZSTD_isError(out_len) || out_len != size_t(result.size())) {
+    return false;
+  }
+  ptcache_bytes_unshuffle(shuffled.data(), uint(result.size()), result.data());
+  return true;
+}
+
+/**
+ * Write arrays with #PTCACHE_COMPRESS_ZSTD. The arrays are compressed in parallel, the blocks are
+ * then written in order, with the same layout as #ptcache_file_compressed_write.
+ */
+static void ptcache_file_zstd_write(PTCacheFile *pf,
+                                    const blender::Span<blender::Span<uchar>> arrays)
+{
+  using namespace blender;
+  Array<Vector<uchar>> compressed_arrays(arrays.size());
+  threading::parallel_for(arrays.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      compressed_arrays[i] = ptcache_zstd_compress(arrays[i]);
+    }
+  });
+
+  for (const int64_t i : arrays.index_range()) {
+    const Span<uchar> compressed_array = compressed_arrays[i];
+    const uchar compressed = compressed_array.is_empty() ? PTCACHE_COMPRESS_NO :
+                                                           PTCACHE_COMPRESS_ZSTD;
+    ptcache_file_write(pf, &compressed, 1, sizeof(uchar));
+    if (compressed) {
+      const uint size = uint(compressed_array.size());
+      ptcache_file_write(pf, &size, 1, sizeof(uint));
+      ptcache_file_write(pf, compressed_array.data(), size, sizeof(uchar));
+    }
+    else {
+      ptcache_file_write(pf, arrays[i].data(), uint(arrays[i].size()), sizeof(uchar));
+    }
+  }
+}
+
+/** Read one block written by #ptcache_file_compressed_write, after its compression type. */
+static int ptcache_file_compressed_block_read(PTCacheFile *pf,
+                                              const uchar compressed,
+                                              uchar *result,
+                                              uint len)
 {
   int r = 0;
-  uchar compressed = 0;
   size_t in_len;
 #ifdef WITH_LZO
   size_t out_len = len;
@@ -1514,7 +1608,6 @@ static int ptcache_file_compressed_read(PTCacheFile *pf, uchar *result, uint len
   uchar *in;
   uchar *props = MEM_calloc_arrayN<uchar>(16, "tmp");
 
-  ptcache_file_read(pf, &compressed, 1, sizeof(uchar));
   if (compressed) {
     uint size;
     ptcache_file_read(pf, &size, 1, sizeof(uint));
@@ -1540,6 +1633,9 @@ static int ptcache_file_compressed_read(PTCacheFile *pf, uchar *result, uint len
         r = LzmaUncompress(result, &leno, in, &leni, props, sizeOfIt);
       }
 #endif
+      if (compressed == PTCACHE_COMPRESS_ZSTD) {
+        r = !ptcache_zstd_decompress({in, int64_t(in_len)}, {result, len});
+      }
       MEM_freeN(in);
     }
   }
@@ -1551,9 +1647,63 @@ static int ptcache_file_compressed_read(PTCacheFile *pf, uchar *result, uint len
 
   return r;
 }
+static int ptcache_file_compressed_read(PTCacheFile *pf, uchar *result, uint len)
+{
+  uchar compressed = 0;
+  ptcache_file_read(pf, &compressed, 1, sizeof(uchar));
+  return ptcache_file_compressed_block_read(pf, compressed, result, len);
+}
+/**
+ * Read consecutive blocks written by #ptcache_file_compressed_write or #ptcache_file_zstd_write.
+ * Zstd blocks are read in order and decompressed in parallel afterwards.
+ */
+static bool ptcache_file_compressed_read_arrays(
+    PTCacheFile *pf, const blender::Span<blender::MutableSpan<uchar>> results)
+{
+  using namespace blender;
+  struct ZstdBlock {
+    MutableSpan<uchar> result;
+    Array<uchar> data;
+  };
+  Vector<ZstdBlock> zstd_blocks;
+
+  for (const MutableSpan<uchar> result : results) {
+    uchar compressed = 0;
+    if (!ptcache_file_read(pf, &compressed, 1, sizeof(uchar))) {
+      return false;
+    }
+    if (compressed != PTCACHE_COMPRESS_ZSTD) {
+      ptcache_file_compressed_block_read(pf, compressed, result.data(), uint(result.size()));
+      continue;
+    }
+    uint size = 0;
+    if (!ptcache_file_read(pf, &size, 1, sizeof(uint))) {
+      return false;
+    }
+    Array<uchar> data(size, NoInitialization());
+    if (!ptcache_file_read(pf, data.data(), size, sizeof(uchar))) {
+      return false;
+    }
+    zstd_blocks.append({result, std::move(data)});
+  }
+
+  Array<bool> success(zstd_blocks.size());
+  threading::parallel_for(zstd_blocks.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      success[i] = ptcache_zstd_decompress(zstd_blocks[i].data, zstd_blocks[i].result);
+    }
+  });
+  return !success.as_span().contains(false);
+}
 static int ptcache_file_compressed_write(
     PTCacheFile *pf, uchar *in, uint in_len, uchar *out, int mode)
 {
+  if (mode == PTCACHE_COMPRESS_ZSTD) {
+    const blender::Span<uchar> array(in, in_len);
+    ptcache_file_zstd_write(pf, {array});
+    return 0;
+  }
+
   int r = 0;
   uchar compressed = 0;
   size_t out_len = 0;
@@ -1961,12 +2111,16 @@ static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
     ptcache_data_alloc(pm);
 
     if (pf->flag & PTCACHE_TYPEFLAG_COMPRESS) {
+      blender::Vector<blender::MutableSpan<uchar>, BPHYS_TOT_DATA> arrays;
       for (i = 0; i < BPHYS_TOT_DATA; i++) {
         uint out_len = pm->totpoint * ptcache_data_size[i];
         if (pf->data_types & (1 << i)) {
-          ptcache_file_compressed_read(pf, (uchar *)(pm->data[i]), out_len);
+          arrays.append({(uchar *)(pm->data[i]), out_len});
         }
       }
+      if (!ptcache_file_compressed_read_arrays(pf, arrays)) {
+        error = 1;
+      }
     }
     else {
       void *cur[BPHYS_TOT_DATA];
@@ -2057,7 +2211,16 @@ static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
   }
 
   if (!error) {
-    if (pid->cache->compression) {
+    if (pid->cache->compression == PTCACHE_COMPRESS_ZSTD) {
+      blender::Vector<blender::Span<uchar>, BPHYS_TOT_DATA> arrays;
+      for (i = 0; i < BPHYS_TOT_DATA; i++) {
+        if (pm->data[i]) {
+          arrays.append({(uchar *)(pm->data[i]), pm->totpoint * ptcache_data_size[i]});
+        }
+      }
+      ptcache_file_zstd_write(pf, arrays);
+    }
+    else if (pid->cache->compression) {
       for (i = 0; i < BPHYS_TOT_DATA; i++) {
         if (pm->data[i]) {
           uint in_len = pm->totpoint * ptcache_data_size[i];
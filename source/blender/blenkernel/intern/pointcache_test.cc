@@ -0,0 +1,154 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_fileops.h"
+#include "BLI_math_vector_types.hh"
+#include "BLI_path_utils.hh"
+#include "BLI_string.h"
+#include "BLI_system.h"
+#include "BLI_tempfile.h"
+
+#include "DNA_object_types.h"
+#include "DNA_pointcache_types.h"
+#include "DNA_rigidbody_types.h"
+
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_pointcache.h"
+
+#include "CLG_log.h"
+
+#include BLI_SYSTEM_PID_H
+
+namespace blender::bke::tests {
+
+class PointCacheTest : public testing::Test {
+ protected:
+  std::string cache_dir;
+
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    CLG_exit();
+  }
+
+  void SetUp() override
+  {
+    char temp_dir[FILE_MAX];
+    BLI_temp_directory_path_get(temp_dir, sizeof(temp_dir));
+    cache_dir = std::string(temp_dir) + SEP_STR + "blender_pointcache_test_" +
+                std::to_string(getpid());
+  }
+
+  void TearDown() override
+  {
+    if (BLI_exists(cache_dir.c_str())) {
+      BLI_delete(cache_dir.c_str(), true, true);
+    }
+  }
+};
+
+struct TestPoints {
+  Array<float3> positions;
+  Array<float4> rotations;
+};
+
+static int test_points_num(void *calldata, int /*cfra*/)
+{
+  return int(static_cast<TestPoints *>(calldata)->positions.size());
+}
+
+static int test_point_write(int index, void *calldata, void **data, int /*cfra*/)
+{
+  const TestPoints &points = *static_cast<TestPoints *>(calldata);
+  memcpy(data[BPHYS_DATA_LOCATION], &points.positions[index], sizeof(float3));
+  memcpy(data[BPHYS_DATA_ROTATION], &points.rotations[index], sizeof(float4));
+  return 1;
+}
+
+static void test_point_read(
+    int index, void *calldata, void **data, float /*cfra*/, const float * /*old_data*/)
+{
+  TestPoints &points = *static_cast<TestPoints *>(calldata);
+  memcpy(&points.positions[index], data[BPHYS_DATA_LOCATION], sizeof(float3));
+  memcpy(&points.rotations[index], data[BPHYS_DATA_ROTATION], sizeof(float4));
+}
+
+static TestPoints test_points_create(const int size)
+{
+  TestPoints points{Array<float3>(size), Array<float4>(size)};
+  for (const int i : IndexRange(size)) {
+    points.positions[i] = float3(float(i) * 0.01f, float(i % 7), -float(i) * 0.5f);
+    points.rotations[i] = float4(1.0f, float(i) * 0.001f, 0.0f, 0.25f);
+  }
+  return points;
+}
+
+/**
+ * Write a single frame to an external disk cache and read it back.
+ * \return The size of the written file.
+ */
+static size_t write_and_read_frame(const std::string &cache_dir,
+                                   const int compression,
+                                   TestPoints &points)
+{
+  Object *object = BKE_id_new_nomain<Object>("Object");
+  RigidBodyWorld_Shared shared{};
+  RigidBodyWorld rbw{};
+  rbw.shared = &shared;
+  PointCache *cache = BKE_ptcache_add(&shared.ptcaches);
+  shared.pointcache = cache;
+  cache->flag |= PTCACHE_DISK_CACHE | PTCACHE_EXTERNAL;
+  cache->compression = compression;
+  cache->index = 0;
+  STRNCPY(cache->path, cache_dir.c_str());
+  STRNCPY(cache->name, "test");
+
+  PTCacheID pid;
+  BKE_ptcache_id_from_rigidbody(&pid, object, &rbw);
+  pid.calldata = &points;
+  pid.totpoint = pid.totwrite = test_points_num;
+  pid.write_point = test_point_write;
+  pid.read_point = test_point_read;
+  pid.interpolate_point = nullptr;
+
+  EXPECT_TRUE(BKE_ptcache_write(&pid, 1));
+  const TestPoints written = points;
+  points.positions.fill(float3(0.0f));
+  points.rotations.fill(float4(0.0f));
+
+  EXPECT_EQ(BKE_ptcache_read(&pid, 1.0f, false), PTCACHE_READ_EXACT);
+  EXPECT_EQ_ARRAY(written.positions.data(), points.positions.data(), points.positions.size());
+  EXPECT_EQ_ARRAY(written.rotations.data(), points.rotations.data(), points.rotations.size());
+
+  const std::string filepath = cache_dir + SEP_STR + "test_000001_00.bphys";
+  const size_t file_size = BLI_file_size(filepath.c_str());
+
+  BKE_ptcache_id_clear(&pid, PTCACHE_CLEAR_ALL, 0);
+  BKE_ptcache_free_list(&shared.ptcaches);
+  BKE_id_free(nullptr, object);
+  return file_size;
+}
+
+TEST_F(PointCacheTest, ZstdRoundTrip)
+{
+  TestPoints points = test_points_create(1000);
+  const size_t uncompressed_size = write_and_read_frame(cache_dir, PTCACHE_COMPRESS_NO, points);
+  const size_t compressed_size = write_and_read_frame(cache_dir, PTCACHE_COMPRESS_ZSTD, points);
+  EXPECT_LT(compressed_size, uncompressed_size);
+
+  /* Arrays that don't get smaller are stored uncompressed. */
+  TestPoints single_point = test_points_create(1);
+  write_and_read_frame(cache_dir, PTCACHE_COMPRESS_ZSTD, single_point);
+}
+
+}  // namespace blender::bke::tests
@@ -17,11 +17,15 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_listbase.h"
 #include "BLI_math_matrix.h"
 #include "BLI_math_rotation.h"
 #include "BLI_math_vector.h"
+#include "BLI_math_vector_types.hh"
 #include "BLI_mutex.hh"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
 
 #ifdef WITH_BULLET
 #  include "RBI_api.h"
@@ -1659,16 +1663,13 @@ static void rigidbody_update_sim_world(Scene *scene, RigidBodyWorld *rbw)
   rigidbody_update_ob_array(rbw);
 }
 
-static void rigidbody_update_sim_ob(Depsgraph *depsgraph, Object *ob, RigidBodyOb *rbo)
+static void rigidbody_update_sim_ob(ViewLayer *view_layer, Object *ob, RigidBodyOb *rbo)
 {
   /* only update if rigid body exists */
   if (rbo->shared->physics_object == nullptr) {
     return;
   }
 
-  const Scene *scene = DEG_get_input_scene(depsgraph);
-  ViewLayer *view_layer = DEG_get_input_view_layer(depsgraph);
-  BKE_view_layer_synced_ensure(scene, view_layer);
   Base *base = BKE_view_layer_base_find(view_layer, ob);
   const bool is_selected = base ? (base->flag & BASE_SELECTED) != 0 : false;
 
@@ -1759,6 +1760,10 @@ static void rigidbody_update_simulation(Depsgraph *depsgraph,
     FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
   }
 
+  /* Sync the view layer once, the selection state is needed for every object below. */
+  ViewLayer *view_layer = DEG_get_input_view_layer(depsgraph);
+  BKE_view_layer_synced_ensure(DEG_get_input_scene(depsgraph), view_layer);
+
   /* update objects */
   FOREACH_COLLECTION_OBJECT_RECURSIVE_BEGIN (rbw->group, ob) {
     if (ob->type == OB_MESH) {
@@ -1784,18 +1789,15 @@ static void rigidbody_update_simulation(Depsgraph *depsgraph,
         /* perform simulation data updates as tagged */
         /* refresh object... */
         if (rebuild) {
-          /* World has been rebuilt so rebuild object */
-          /* TODO(Sybren): rigidbody_validate_sim_object() can call rigidbody_validate_sim_shape(),
-           * but neither resets the RBO_FLAG_NEEDS_RESHAPE flag nor
-           * calls RB_body_set_collision_shape().
-           * This results in the collision shape being created twice, which is unnecessary. */
+          /* World has been rebuilt so rebuild object. This always creates a new collision shape
+           * from the current mesh, so a pending reshape is already taken care of. */
           rigidbody_validate_sim_object(rbw, ob, true);
         }
         else if (rbo->flag & RBO_FLAG_NEEDS_VALIDATE) {
           rigidbody_validate_sim_object(rbw, ob, false);
         }
         /* refresh shape... */
-        if (rbo->flag & RBO_FLAG_NEEDS_RESHAPE) {
+        if (!rebuild && (rbo->flag & RBO_FLAG_NEEDS_RESHAPE)) {
           /* mesh/shape data changed, so force shape refresh */
           rigidbody_validate_sim_shape(rbw, ob, true);
           /* now tell RB sim about it */
@@ -1811,7 +1813,7 @@ static void rigidbody_update_simulation(Depsgraph *depsgraph,
       rbo->flag &= ~(RBO_FLAG_NEEDS_VALIDATE | RBO_FLAG_NEEDS_RESHAPE);
 
       /* update simulation object... */
-      rigidbody_update_sim_ob(depsgraph, ob, rbo);
+      rigidbody_update_sim_ob(view_layer, ob, rbo);
     }
   }
   FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
@@ -1855,21 +1857,33 @@ static void rigidbody_update_simulation(Depsgraph *depsgraph,
   FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
 }
 
+/**
+ * Transforms of the kinematic bodies at the start and at the end of a frame, stored as separate
+ * arrays so that the transforms of all bodies can be interpolated and passed to the simulation in
+ * one pass per substep.
+ */
 struct KinematicSubstepData {
-  RigidBodyOb *rbo;
-  float old_pos[3];
-  float new_pos[3];
-  float old_rot[4];
-  float new_rot[4];
-  bool scale_changed;
-  float old_scale[3];
-  float new_scale[3];
+  blender::Vector<RigidBodyOb *> rbos;
+  blender::Vector<rbRigidBody *> bodies;
+  blender::Vector<blender::float3> old_positions;
+  blender::Vector<blender::float3> new_positions;
+  blender::Vector<blender::float4> old_rotations;
+  blender::Vector<blender::float4> new_rotations;
+  blender::Vector<blender::float3> old_scales;
+  blender::Vector<blender::float3> new_scales;
+  /** Indices of the bodies whose scale changes, the collision shapes of others are not updated. */
+  blender::Vector<int> scale_changed_indices;
+
+  /** Interpolated transforms of the current substep. */
+  blender::Array<blender::float3> positions;
+  blender::Array<blender::float4> rotations;
 };
 
-static ListBase rigidbody_create_substep_data(RigidBodyWorld *rbw)
+static KinematicSubstepData rigidbody_create_substep_data(RigidBodyWorld *rbw)
 {
+  using namespace blender;
   /* Objects that we want to update substep location/rotation for. */
-  ListBase substep_targets = {nullptr, nullptr};
+  KinematicSubstepData data;
 
   FOREACH_COLLECTION_OBJECT_RECURSIVE_BEGIN (rbw->group, ob) {
     RigidBodyOb *rbo = ob->rigidbody_object;
@@ -1879,61 +1893,71 @@ static ListBase rigidbody_create_substep_data(RigidBodyWorld *rbw)
     }
 
     if (rbo->flag & RBO_FLAG_KINEMATIC) {
-      float loc[3], rot[4], scale[3];
+      rbRigidBody *body = static_cast<rbRigidBody *>(rbo->shared->physics_object);
+      float3 loc, scale;
+      float4 rot;
 
-      KinematicSubstepData *data = MEM_callocN<KinematicSubstepData>("RigidBody Substep data");
-
-      data->rbo = rbo;
-
-      RB_body_get_position(static_cast<rbRigidBody *>(rbo->shared->physics_object), loc);
-      RB_body_get_orientation(static_cast<rbRigidBody *>(rbo->shared->physics_object), rot);
-      RB_body_get_scale(static_cast<rbRigidBody *>(rbo->shared->physics_object), scale);
-
-      copy_v3_v3(data->old_pos, loc);
-      copy_v4_v4(data->old_rot, rot);
-      copy_v3_v3(data->old_scale, scale);
+      RB_body_get_scale(body, scale);
+      data.old_scales.append(scale);
 
       mat4_decompose(loc, rot, scale, ob->object_to_world().ptr());
+      data.new_positions.append(loc);
+      data.new_rotations.append(rot);
+      data.new_scales.append(scale);
 
-      copy_v3_v3(data->new_pos, loc);
-      copy_v4_v4(data->new_rot, rot);
-      copy_v3_v3(data->new_scale, scale);
+      data.rbos.append(rbo);
+      data.bodies.append(body);
+    }
+  }
+  FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
 
-      data->scale_changed = !compare_size_v3v3(data->old_scale, data->new_scale, 0.001f);
+  const int bodies_num = data.bodies.size();
+  data.old_positions.resize(bodies_num);
+  data.old_rotations.resize(bodies_num);
+  RB_bodies_get_loc_rot(data.bodies.data(),
+                        bodies_num,
+                        reinterpret_cast<float(*)[3]>(data.old_positions.data()),
+                        reinterpret_cast<float(*)[4]>(data.old_rotations.data()));
 
-      LinkData *ob_link = BLI_genericNodeN(data);
-      BLI_addtail(&substep_targets, ob_link);
+  for (const int i : IndexRange(bodies_num)) {
+    if (!compare_size_v3v3(data.old_scales[i], data.new_scales[i], 0.001f)) {
+      data.scale_changed_indices.append(i);
     }
   }
-  FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
 
-  return substep_targets;
+  data.positions.reinitialize(bodies_num);
+  data.rotations.reinitialize(bodies_num);
+  return data;
 }
 
-static void rigidbody_update_kinematic_obj_substep(ListBase *substep_targets, float interp_fac)
+static void rigidbody_update_kinematic_obj_substep(KinematicSubstepData &data, float interp_fac)
 {
-  LISTBASE_FOREACH (LinkData *, link, substep_targets) {
-    KinematicSubstepData *data = static_cast<KinematicSubstepData *>(link->data);
-    RigidBodyOb *rbo = data->rbo;
-
-    float loc[3], rot[4];
-
-    interp_v3_v3v3(loc, data->old_pos, data->new_pos, interp_fac);
-    interp_qt_qtqt(rot, data->old_rot, data->new_rot, interp_fac);
-
-    RB_body_activate(static_cast<rbRigidBody *>(rbo->shared->physics_object));
-    RB_body_set_loc_rot(static_cast<rbRigidBody *>(rbo->shared->physics_object), loc, rot);
+  using namespace blender;
+  const int bodies_num = data.bodies.size();
+  if (bodies_num == 0) {
+    return;
+  }
 
-    if (!data->scale_changed) {
-      /* Avoid having to rebuild the collision shape AABBs if scale didn't change. */
-      continue;
+  threading::parallel_for(IndexRange(bodies_num), 1024, [&](const IndexRange range) {
+    for (const int i : range) {
+      interp_v3_v3v3(data.positions[i], data.old_positions[i], data.new_positions[i], interp_fac);
+      interp_qt_qtqt(data.rotations[i], data.old_rotations[i], data.new_rotations[i], interp_fac);
     }
+  });
+  RB_bodies_set_loc_rot(data.bodies.data(),
+                        bodies_num,
+                        reinterpret_cast<const float(*)[3]>(data.positions.data()),
+                        reinterpret_cast<const float(*)[4]>(data.rotations.data()));
+
+  /* Avoid having to rebuild the collision shape AABBs of bodies whose scale didn't change. */
+  for (const int i : data.scale_changed_indices) {
+    RigidBodyOb *rbo = data.rbos[i];
 
     float scale[3];
 
-    interp_v3_v3v3(scale, data->old_scale, data->new_scale, interp_fac);
+    interp_v3_v3v3(scale, data.old_scales[i], data.new_scales[i], interp_fac);
 
-    RB_body_set_scale(static_cast<rbRigidBody *>(rbo->shared->physics_object), scale);
+    RB_body_set_scale(data.bodies[i], scale);
 
     /* compensate for embedded convex hull collision margin */
     if (!(rbo->flag & RBO_FLAG_USE_MARGIN) && rbo->shape == RB_SHAPE_CONVEXH) {
@@ -1947,6 +1971,10 @@ static void rigidbody_update_external_forces(Depsgraph *depsgraph,
                                              Scene *scene,
                                              RigidBodyWorld *rbw)
 {
+  using namespace blender;
+
+  /* Gather the bodies that need an effector update. */
+  Vector<Object *> objects;
   FOREACH_COLLECTION_OBJECT_RECURSIVE_BEGIN (rbw->group, ob) {
     /* only update if rigid body exists */
     RigidBodyOb *rbo = ob->rigidbody_object;
@@ -1956,71 +1984,103 @@ static void rigidbody_update_external_forces(Depsgraph *depsgraph,
 
     /* update influence of effectors - but don't do it on an effector */
     /* only dynamic bodies need effector update */
+    /* NOTE: passive objects don't need to be updated since they don't move */
     if (rbo->type == RBO_TYPE_ACTIVE &&
         ((ob->pd == nullptr) || (ob->pd->forcefield == PFIELD_NULL)))
     {
-      EffectorWeights *effector_weights = rbw->effector_weights;
-      EffectedPoint epoint;
-      ListBase *effectors;
+      objects.append(ob);
+    }
+  }
+  FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
 
-      /* get effectors present in the group specified by effector_weights */
-      effectors = BKE_effectors_create(depsgraph, ob, nullptr, effector_weights, false);
-      if (effectors) {
-        float eff_force[3] = {0.0f, 0.0f, 0.0f};
-        float eff_loc[3], eff_vel[3];
+  if (objects.is_empty()) {
+    return;
+  }
 
-        /* create dummy 'point' which represents last known position of object as result of sim
-         */
-        /* XXX: this can create some inaccuracies with sim position,
-         * but is probably better than using un-simulated values? */
-        RB_body_get_position(static_cast<rbRigidBody *>(rbo->shared->physics_object), eff_loc);
-        RB_body_get_linear_velocity(static_cast<rbRigidBody *>(rbo->shared->physics_object),
-                                    eff_vel);
-
-        pd_point_from_loc(scene, eff_loc, eff_vel, 0, &epoint);
-
-        /* Calculate net force of effectors, and apply to sim object:
-         * - we use 'central force' since apply force requires a "relative position"
-         *   which we don't have... */
-        BKE_effectors_apply(
-            effectors, nullptr, effector_weights, &epoint, eff_force, nullptr, nullptr);
-        if (G.f & G_DEBUG) {
-          printf("\tapplying force (%f,%f,%f) to '%s'\n",
-                 eff_force[0],
-                 eff_force[1],
-                 eff_force[2],
-                 ob->id.name + 2);
-        }
-        /* activate object in case it is deactivated */
-        if (!is_zero_v3(eff_force)) {
-          RB_body_activate(static_cast<rbRigidBody *>(rbo->shared->physics_object));
-        }
-        if ((rbo->flag & RBO_FLAG_DISABLED) == 0) {
-          RB_body_apply_central_force(static_cast<rbRigidBody *>(rbo->shared->physics_object),
-                                      eff_force);
-        }
-      }
-      else if (G.f & G_DEBUG) {
+  /* get effectors present in the group specified by effector_weights */
+  /* Effectors are never evaluated for the bodies gathered above, so there is no need to exclude
+   * each body from its own list: the same effectors apply to all of them. */
+  EffectorWeights *effector_weights = rbw->effector_weights;
+  ListBase *effectors = BKE_effectors_create(depsgraph, nullptr, nullptr, effector_weights, false);
+  if (effectors == nullptr) {
+    if (G.f & G_DEBUG) {
+      for (const Object *ob : objects) {
         printf("\tno forces to apply to '%s'\n", ob->id.name + 2);
       }
+    }
+    return;
+  }
 
-      /* cleanup */
-      BKE_effectors_free(effectors);
+  /* Evaluate the forces of all bodies first, and only apply them to the simulation after that, in
+   * a single pass. */
+  Array<float3> forces(objects.size());
+  const bool use_random = BKE_effectors_use_random(effectors);
+  auto calc_force = [&](const int i) {
+    if (use_random) {
+      /* Every body gets the noise it would get with effectors created for it alone. */
+      BKE_effectors_reset_random(effectors);
+    }
+    rbRigidBody *body = static_cast<rbRigidBody *>(
+        objects[i]->rigidbody_object->shared->physics_object);
+    EffectedPoint epoint;
+    float eff_loc[3], eff_vel[3];
+
+    /* create dummy 'point' which represents last known position of object as result of sim */
+    /* XXX: this can create some inaccuracies with sim position,
+     * but is probably better than using un-simulated values? */
+    RB_body_get_position(body, eff_loc);
+    RB_body_get_linear_velocity(body, eff_vel);
+
+    pd_point_from_loc(scene, eff_loc, eff_vel, 0, &epoint);
+
+    /* Calculate net force of effectors, and apply to sim object:
+     * - we use 'central force' since apply force requires a "relative position"
+     *   which we don't have... */
+    forces[i] = float3(0.0f);
+    BKE_effectors_apply(
+        effectors, nullptr, effector_weights, &epoint, forces[i], nullptr, nullptr);
+  };
+
+  if (use_random) {
+    /* The random number generators of the effectors are shared, so noise has to be evaluated
+     * serially to be deterministic. */
+    for (const int i : objects.index_range()) {
+      calc_force(i);
     }
-    /* NOTE: passive objects don't need to be updated since they don't move */
   }
-  FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
-}
+  else {
+    threading::parallel_for(objects.index_range(), 256, [&](const IndexRange range) {
+      for (const int i : range) {
+        calc_force(i);
+      }
+    });
+  }
 
-static void rigidbody_free_substep_data(ListBase *substep_targets)
-{
-  LISTBASE_FOREACH (LinkData *, link, substep_targets) {
-    KinematicSubstepData *data = static_cast<KinematicSubstepData *>(link->data);
-    MEM_freeN(data);
+  for (const int i : objects.index_range()) {
+    Object *ob = objects[i];
+    RigidBodyOb *rbo = ob->rigidbody_object;
+    rbRigidBody *body = static_cast<rbRigidBody *>(rbo->shared->physics_object);
+    const float3 &eff_force = forces[i];
+    if (G.f & G_DEBUG) {
+      printf("\tapplying force (%f,%f,%f) to '%s'\n",
+             eff_force[0],
+             eff_force[1],
+             eff_force[2],
+             ob->id.name + 2);
+    }
+    /* activate object in case it is deactivated */
+    if (!is_zero_v3(eff_force)) {
+      RB_body_activate(body);
+    }
+    if ((rbo->flag & RBO_FLAG_DISABLED) == 0) {
+      RB_body_apply_central_force(body, eff_force);
+    }
   }
 
-  BLI_freelistN(substep_targets);
+  /* cleanup */
+  BKE_effectors_free(effectors);
 }
+
 static void rigidbody_update_simulation_post_step(Depsgraph *depsgraph, RigidBodyWorld *rbw)
 {
   const Scene *scene = DEG_get_input_scene(depsgraph);
@@ -2046,6 +2106,35 @@ static void rigidbody_update_simulation_post_step(Depsgraph *depsgraph, RigidBod
   FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
 }
 
+/**
+ * Read the simulated transforms of all active bodies in one pass, so that the point cache can be
+ * filled from the #RigidBodyOb data without accessing the simulation for every point.
+ */
+static void rigidbody_sync_sim_transforms_to_objects(RigidBodyWorld *rbw)
+{
+  using namespace blender;
+  Vector<RigidBodyOb *> rbos;
+  Vector<rbRigidBody *> bodies;
+  for (const int i : IndexRange(rbw->numbodies)) {
+    RigidBodyOb *rbo = rbw->objects[i]->rigidbody_object;
+    if (rbo && rbo->type == RBO_TYPE_ACTIVE && rbo->shared->physics_object != nullptr) {
+      rbos.append(rbo);
+      bodies.append(static_cast<rbRigidBody *>(rbo->shared->physics_object));
+    }
+  }
+
+  Array<float3> positions(bodies.size());
+  Array<float4> rotations(bodies.size());
+  RB_bodies_get_loc_rot(bodies.data(),
+                        bodies.size(),
+                        reinterpret_cast<float(*)[3]>(positions.data()),
+                        reinterpret_cast<float(*)[4]>(rotations.data()));
+  for (const int i : rbos.index_range()) {
+    copy_v3_v3(rbos[i]->pos, positions[i]);
+    copy_v4_v4(rbos[i]->orn, rotations[i]);
+  }
+}
+
 bool BKE_rigidbody_check_sim_running(RigidBodyWorld *rbw, float ctime)
 {
   return (rbw && (rbw->flag & RBW_FLAG_MUTED) == 0 && ctime > rbw->shared->pointcache->startframe);
@@ -2250,6 +2339,7 @@ void BKE_rigidbody_do_simulation(Depsgraph *depsgraph, Scene *scene, float ctime
   if (compare_ff_relative(ctime, rbw->ltime + 1, FLT_EPSILON, 64)) {
     /* write cache for first frame when on second frame */
     if (rbw->ltime == startframe && (cache->flag & PTCACHE_OUTDATED || cache->last_exact == 0)) {
+      rigidbody_sync_sim_transforms_to_objects(rbw);
       BKE_ptcache_write(&pid, startframe);
     }
 
@@ -2259,7 +2349,7 @@ void BKE_rigidbody_do_simulation(Depsgraph *depsgraph, Scene *scene, float ctime
 
     const float substep = timestep / rbw->substeps_per_frame;
 
-    ListBase kinematic_substep_targets = rigidbody_create_substep_data(rbw);
+    KinematicSubstepData kinematic_substep_data = rigidbody_create_substep_data(rbw);
 
     const float interp_step = 1.0f / rbw->substeps_per_frame;
     float cur_interp_val = interp_step;
@@ -2269,13 +2359,13 @@ void BKE_rigidbody_do_simulation(Depsgraph *depsgraph, Scene *scene, float ctime
 
     for (int i = 0; i < rbw->substeps_per_frame; i++) {
       rigidbody_update_external_forces(depsgraph, scene, rbw);
-      rigidbody_update_kinematic_obj_substep(&kinematic_substep_targets, cur_interp_val);
+      rigidbody_update_kinematic_obj_substep(kinematic_substep_data, cur_interp_val);
       RB_dworld_step_simulation(rbw->shared->runtime->physics_world, substep, 0, substep);
       cur_interp_val += interp_step;
     }
-    rigidbody_free_substep_data(&kinematic_substep_targets);
 
     rigidbody_update_simulation_post_step(depsgraph, rbw);
+    rigidbody_sync_sim_transforms_to_objects(rbw);
 
     /* write cache for current frame */
     BKE_ptcache_validate(cache, int(ctime));
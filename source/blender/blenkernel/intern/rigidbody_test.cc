@@ -0,0 +1,104 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "tests/blendfile_loading_base_test.h"
+
+#include "BLI_array.hh"
+#include "BLI_math_base.h"
+#include "BLI_math_matrix_types.hh"
+
+#include "DNA_object_force_types.h"
+#include "DNA_object_types.h"
+#include "DNA_rigidbody_types.h"
+#include "DNA_scene_types.h"
+
+#include "BKE_collection.hh"
+#include "BKE_effect.h"
+#include "BKE_layer.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_main.hh"
+#include "BKE_mesh.h"
+#include "BKE_object.hh"
+#include "BKE_rigidbody.h"
+#include "BKE_scene.hh"
+
+#include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_build.hh"
+#include "DEG_depsgraph_query.hh"
+
+#ifdef WITH_BULLET
+
+namespace blender::bke::tests {
+
+class RigidBodyTest : public BlendfileLoadingBaseTest {};
+
+static Array<float3> simulate_frames(Depsgraph *depsgraph,
+                                     Scene *scene,
+                                     const Span<Object *> bodies,
+                                     const int frames_num)
+{
+  /* Start again from the first frame, with an empty cache. */
+  BKE_rigidbody_cache_reset(scene->rigidbody_world);
+  for (const int frame : IndexRange(1, frames_num)) {
+    DEG_evaluate_on_framechange(depsgraph, float(frame));
+  }
+
+  Array<float3> positions(bodies.size());
+  for (const int i : bodies.index_range()) {
+    positions[i] = DEG_get_evaluated(depsgraph, bodies[i])->object_to_world().location();
+  }
+  return positions;
+}
+
+TEST_F(RigidBodyTest, NoisyWindDeterministic)
+{
+  Main *bmain = BKE_main_new();
+  Scene *scene = BKE_scene_add(bmain, "Scene");
+  ViewLayer *view_layer = BKE_view_layer_default_view(scene);
+
+  /* Enough bodies to evaluate the effector forces on multiple threads. */
+  Mesh *mesh = BKE_mesh_add(bmain, "Mesh");
+  Vector<Object *> bodies;
+  for (const int i : IndexRange(1000)) {
+    Object *body = BKE_object_add_only_object(bmain, OB_MESH, "Body");
+    body->data = mesh;
+    id_us_plus(&mesh->id);
+    body->loc[0] = float(i % 32) * 2.0f;
+    body->loc[1] = float(i / 32) * 2.0f;
+    BKE_collection_object_add(bmain, scene->master_collection, body);
+    ASSERT_TRUE(BKE_rigidbody_add_object(bmain, scene, body, RBO_TYPE_ACTIVE, nullptr));
+    body->rigidbody_object->shape = RB_SHAPE_SPHERE;
+    bodies.append(body);
+  }
+
+  /* Wind along the X axis, with noise. */
+  Object *wind = BKE_object_add_only_object(bmain, OB_EMPTY, "Wind");
+  wind->pd = BKE_partdeflect_new(PFIELD_WIND);
+  wind->pd->f_strength = 20.0f;
+  wind->pd->f_noise = 5.0f;
+  wind->rot[1] = float(M_PI_2);
+  BKE_collection_object_add(bmain, scene->master_collection, wind);
+
+  BKE_view_layer_synced_ensure(scene, view_layer);
+  depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_VIEWPORT);
+  DEG_graph_build_from_view_layer(depsgraph);
+  DEG_make_active(depsgraph);
+
+  const Array<float3> positions = simulate_frames(depsgraph, scene, bodies, 10);
+  for (const int i : bodies.index_range()) {
+    /* The wind pushed the body away from its start position. */
+    EXPECT_GT(positions[i].x, bodies[i]->loc[0]);
+  }
+
+  /* Simulating the same frames again gives exactly the same result. */
+  const Array<float3> positions_again = simulate_frames(depsgraph, scene, bodies, 10);
+  EXPECT_EQ_ARRAY(positions.data(), positions_again.data(), positions.size());
+
+  depsgraph_free();
+  BKE_main_free(bmain);
+}
+
+}  // namespace blender::bke::tests
+
+#endif
@@ -6,13 +6,20 @@
  * \ingroup bke
  */
 
+#include <optional>
+
 #include "BKE_subdiv_eval.hh"
 
+#include "BLI_implicit_sharing_key.hh"
 #include "BLI_math_vector.h"
+#include "BLI_memory_cache.hh"
+#include "BLI_memory_counter.hh"
 #include "BLI_task.h"
 
+#include "BKE_attribute.hh"
 #include "BKE_customdata.hh"
 #include "BKE_mesh.hh"
+#include "BKE_mesh_types.hh"
 #include "BKE_subdiv.hh"
 
 #include "MEM_guardedalloc.h"
@@ -215,6 +222,108 @@ static void get_mesh_evaluator_settings(OpenSubdiv_EvaluatorSettings *settings,
                               (CustomData_has_layer(&mesh->vert_data, CD_CLOTH_ORCO) ? 3 : 0);
 }
 
+/* --------------------------------------------------------------------
+ * Shared refinement.
+ *
+ * Refining the topology and creating the stencil and patch tables is the most expensive part of
+ * creating an evaluator, but it only depends on the topology. The tables are stored in the global
+ * memory cache, so that evaluators for deformed copies of the same mesh and for later evaluations
+ * of a mesh with animated positions can reuse them.
+ */
+
+/**
+ * Identifies the topology by the subdivision settings and the sharing data of the arrays used by
+ * the converter (see #converter_init_for_mesh). Meshes only share refinement when their topology
+ * arrays are shared, comparing the topology itself would be almost as expensive as refining it.
+ */
+class EvaluatorTablesKey : public ImplicitSharingKey {
+ public:
+  std::unique_ptr<GenericKey> to_storable() const override
+  {
+    return std::make_unique<EvaluatorTablesKey>(*this);
+  }
+};
+
+class CachedEvaluatorTables : public memory_cache::CachedValue {
+ public:
+  std::unique_ptr<opensubdiv::EvaluatorTables> tables;
+
+  void count_memory(MemoryCounter &memory) const override
+  {
+    if (this->tables) {
+      memory.add(int64_t(this->tables->memory_size()));
+    }
+  }
+};
+
+static std::optional<EvaluatorTablesKey> evaluator_tables_key_create(const Subdiv &subdiv,
+                                                                     const Mesh &mesh)
+{
+  const Settings &settings = subdiv.settings;
+  EvaluatorTablesKey key;
+  key.words.extend({uint64_t(settings.is_simple),
+                    uint64_t(settings.is_adaptive),
+                    uint64_t(settings.level),
+                    uint64_t(settings.use_creases),
+                    uint64_t(settings.vtx_boundary_interpolation),
+                    uint64_t(settings.fvar_linear_interpolation),
+                    uint64_t(mesh.verts_num),
+                    uint64_t(mesh.edges_num),
+                    uint64_t(mesh.faces_num),
+                    uint64_t(mesh.corners_num)});
+  if (!key.add_array(mesh.face_offset_indices != nullptr,
+                     mesh.runtime->face_offsets_sharing_info)) {
+    return std::nullopt;
+  }
+  const AttributeAccessor attributes = mesh.attributes();
+  Vector<StringRef, 4> attribute_names = {".edge_verts", ".corner_vert", ".corner_edge"};
+  if (settings.use_creases) {
+    attribute_names.extend({"crease_vert", "crease_edge"});
+  }
+  for (const StringRef name : attribute_names) {
+    const GAttributeReader attribute = attributes.lookup(name);
+    if (!attribute) {
+      key.words.append(0);
+    }
+    else if (!key.add_array(!attribute.varray.is_empty(), attribute.sharing_info)) {
+      return std::nullopt;
+    }
+  }
+  /* All UV maps are used for face-varying channels. */
+  for (const CustomDataLayer &layer : Span(mesh.corner_data.layers, mesh.corner_data.totlayer)) {
+    if (layer.type != CD_PROP_FLOAT2) {
+      continue;
+    }
+    if (!key.add_array(layer.data != nullptr, layer.sharing_info)) {
+      return std::nullopt;
+    }
+  }
+  return key;
+}
+
+/**
+ * Create the CPU evaluator of the subdivision surface from cached refinement tables. Returns
+ * false when the tables for this mesh can't be shared, the evaluator is created as usual then.
+ */
+static bool create_evaluator_from_cached_tables(Subdiv *subdiv, const Mesh *mesh)
+{
+  const std::optional<EvaluatorTablesKey> key = evaluator_tables_key_create(*subdiv, *mesh);
+  if (!key) {
+    return false;
+  }
+  const std::shared_ptr<const CachedEvaluatorTables> cached =
+      memory_cache::get<CachedEvaluatorTables>(*key, [&]() {
+        auto value = std::make_unique<CachedEvaluatorTables>();
+        value->tables.reset(opensubdiv::EvaluatorTables::create(subdiv->topology_refiner));
+        return value;
+      });
+  if (cached->tables) {
+    subdiv->evaluator = openSubdiv_createEvaluatorFromTables(
+        *cached->tables, OPENSUBDIV_EVALUATOR_CPU, nullptr);
+  }
+  return subdiv->evaluator != nullptr;
+}
+
 #endif
 
 bool eval_begin_from_mesh(Subdiv *subdiv,
@@ -226,6 +335,11 @@ bool eval_begin_from_mesh(Subdiv *subdiv,
 #ifdef WITH_OPENSUBDIV
   OpenSubdiv_EvaluatorSettings settings = {0};
   get_mesh_evaluator_settings(&settings, mesh);
+  if (subdiv->evaluator == nullptr && subdiv->topology_refiner != nullptr &&
+      evaluator_type == SUBDIV_EVALUATOR_TYPE_CPU)
+  {
+    create_evaluator_from_cached_tables(subdiv, mesh);
+  }
   if (!eval_begin(subdiv, evaluator_type, evaluator_cache, &settings)) {
     return false;
   }
@@ -4,6 +4,8 @@
 
 #include "BKE_subdiv_modifier.hh"
 
+#include <cfloat>
+
 #include "MEM_guardedalloc.h"
 
 #include "DNA_mesh_types.h"
@@ -11,6 +13,9 @@
 #include "DNA_object_types.h"
 #include "DNA_userdef_types.h"
 
+#include "BLI_math_matrix.hh"
+#include "BLI_task.hh"
+
 #include "BKE_attribute.hh"
 #include "BKE_mesh.hh"
 #include "BKE_modifier.hh"
@@ -143,6 +148,42 @@ subdiv::Subdiv *BKE_subsurf_modifier_subdiv_descriptor_ensure(SubsurfRuntimeData
              runtime_data->subdiv_cpu, &runtime_data->settings, mesh);
 }
 
+int BKE_subsurf_modifier_adaptive_level_get(const blender::Span<blender::float3> positions,
+                                            const blender::Span<blender::int2> edges,
+                                            const blender::float4x4 &object_to_clip,
+                                            const blender::int2 &resolution,
+                                            const float pixel_size,
+                                            const int requested_levels)
+{
+  using namespace blender;
+  const float2 half_resolution = float2(resolution) * 0.5f;
+  const float max_edge_length = threading::parallel_reduce(
+      edges.index_range(),
+      4096,
+      0.0f,
+      [&](const IndexRange range, float max_length) {
+        for (const int edge : range) {
+          const float4 a = object_to_clip * float4(positions[edges[edge][0]], 1.0f);
+          const float4 b = object_to_clip * float4(positions[edges[edge][1]], 1.0f);
+          if (a.w <= 0.0f || b.w <= 0.0f) {
+            /* The edge crosses the camera plane, keep the requested level. */
+            return FLT_MAX;
+          }
+          const float2 a_pixel = float2(a) / a.w * half_resolution;
+          const float2 b_pixel = float2(b) / b.w * half_resolution;
+          max_length = std::max(max_length, math::distance(a_pixel, b_pixel));
+        }
+        return max_length;
+      },
+      [](const float a, const float b) { return std::max(a, b); });
+
+  /* Every level halves the edge length. Keep at least one level, so that small objects still get
+   * a smooth shape and the draw code never sees a resolution without inner vertices. */
+  const float ratio = max_edge_length / pixel_size;
+  const int level = ratio > 2.0f ? int(std::ceil(std::log2(ratio))) : 1;
+  return std::min(level, requested_levels);
+}
+
 int BKE_subsurf_modifier_eval_required_mode(bool is_final_render, bool is_edit_mode)
 {
   if (is_final_render) {
@@ -0,0 +1,80 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_math_matrix.hh"
+
+#include "BKE_subdiv_modifier.hh"
+
+namespace blender::bke::tests {
+
+/* Looking down the negative Z axis, with a 90 degree field of view. An edge of length one at a
+ * distance of one covers half of the image. */
+static const float4x4 object_to_clip = math::projection::perspective(
+    -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, 100.0f);
+static const int2 resolution(1000, 1000);
+
+static int adaptive_level_get(const Span<float3> positions,
+                              const Span<int2> edges,
+                              const int requested_levels)
+{
+  return BKE_subsurf_modifier_adaptive_level_get(
+      positions, edges, object_to_clip, resolution, 1.0f, requested_levels);
+}
+
+TEST(subsurf_modifier, adaptive_level_near)
+{
+  /* The edge is 500 pixels long, so nine levels are needed to get to a single pixel. */
+  const Array<float3> positions = {float3(0.0f, 0.0f, -1.0f), float3(1.0f, 0.0f, -1.0f)};
+  const Array<int2> edges = {int2(0, 1)};
+  EXPECT_EQ(adaptive_level_get(positions, edges, 12), 9);
+  /* The requested level is never exceeded. */
+  EXPECT_EQ(adaptive_level_get(positions, edges, 6), 6);
+  EXPECT_EQ(adaptive_level_get(positions, edges, 0), 0);
+}
+
+TEST(subsurf_modifier, adaptive_level_far)
+{
+  /* The edge is 5 pixels long. */
+  const Array<float3> positions = {float3(0.0f, 0.0f, -100.0f), float3(1.0f, 0.0f, -100.0f)};
+  const Array<int2> edges = {int2(0, 1)};
+  EXPECT_EQ(adaptive_level_get(positions, edges, 6), 3);
+
+  /* Edges shorter than a pixel still get one level. */
+  const Array<float3> tiny_positions = {float3(0.0f, 0.0f, -1000.0f),
+                                        float3(1.0f, 0.0f, -1000.0f)};
+  EXPECT_EQ(adaptive_level_get(tiny_positions, edges, 6), 1);
+  EXPECT_EQ(BKE_subsurf_modifier_adaptive_level_get(
+                positions, edges, object_to_clip, resolution, 100.0f, 6),
+            1);
+}
+
+TEST(subsurf_modifier, adaptive_level_longest_edge)
+{
+  /* The longest projected edge decides, even when most edges are far away. */
+  const Array<float3> positions = {float3(0.0f, 0.0f, -100.0f),
+                                   float3(1.0f, 0.0f, -100.0f),
+                                   float3(0.0f, 1.0f, -100.0f),
+                                   float3(0.0f, 0.0f, -1.0f),
+                                   float3(0.0f, 1.0f, -1.0f)};
+  const Array<int2> edges = {int2(0, 1), int2(0, 2), int2(3, 4), int2(1, 2)};
+  EXPECT_EQ(adaptive_level_get(positions, edges, 12), 9);
+  EXPECT_EQ(adaptive_level_get(positions, edges.as_span().take_front(2), 12), 3);
+}
+
+TEST(subsurf_modifier, adaptive_level_behind_camera)
+{
+  /* Edges crossing the camera plane or behind the camera keep the requested level. */
+  const Array<float3> positions = {float3(0.0f, 0.0f, -100.0f),
+                                   float3(1.0f, 0.0f, -100.0f),
+                                   float3(0.0f, 0.0f, 1.0f),
+                                   float3(1.0f, 0.0f, 1.0f)};
+  EXPECT_EQ(adaptive_level_get(positions, Array<int2>{int2(0, 1), int2(1, 2)}, 5), 5);
+  EXPECT_EQ(adaptive_level_get(positions, Array<int2>{int2(2, 3)}, 4), 4);
+  EXPECT_EQ(adaptive_level_get(positions, Array<int2>{int2(0, 1)}, 5), 3);
+}
+
+}  // namespace blender::bke::tests
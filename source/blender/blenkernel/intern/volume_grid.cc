@@ -60,6 +60,15 @@ VolumeGridData::VolumeGridData(std::function<LazyLoadedGrid()> lazy_load_grid,
   tree_access_token_ = std::make_shared<AccessToken>(*this);
 }
 
+VolumeGridData::VolumeGridData(std::shared_ptr<const LazyGridSource> source,
+                               std::shared_ptr<openvdb::GridBase> meta_data_and_transform_grid)
+    : VolumeGridData([source]() { return source->compute(); },
+                     std::move(meta_data_and_transform_grid))
+{
+  BLI_assert(grid_);
+  lazy_source_ = std::move(source);
+}
+
 VolumeGridData::~VolumeGridData() = default;
 
 void VolumeGridData::delete_self()
@@ -176,6 +185,12 @@ bool VolumeGridData::is_reloadable() const
   return bool(lazy_load_grid_);
 }
 
+std::shared_ptr<const LazyGridSource> VolumeGridData::lazy_source() const
+{
+  std::lock_guard lock{mutex_};
+  return lazy_source_;
+}
+
 bool VolumeGridData::is_loaded() const
 {
   std::lock_guard lock{mutex_};
@@ -250,6 +265,7 @@ void VolumeGridData::ensure_grid_loaded() const
     error_message_.clear();
     try {
       loaded_grid = lazy_load_grid_();
+      error_message_ = std::move(loaded_grid.error_message);
     }
     catch (const openvdb::IoError &e) {
       error_message_ = e.what();
@@ -300,6 +316,12 @@ void VolumeGridData::ensure_grid_loaded() const
   tree_loaded_ = true;
   transform_loaded_ = true;
   meta_data_loaded_ = true;
+
+  if (lazy_source_) {
+    /* A computed tree can't be reloaded, so it must not be unloaded either. */
+    lazy_load_grid_ = {};
+    lazy_source_.reset();
+  }
 }
 
 GVolumeGrid::GVolumeGrid(std::shared_ptr<openvdb::GridBase> grid)
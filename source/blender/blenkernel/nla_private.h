@@ -78,6 +78,9 @@ typedef struct NlaEvalChannelSnapshot {
    */
   NlaValidMask remap_domain;
 
+  /** Next unused snapshot of the same channel, see #NlaEvalChannel::free_snapshots. */
+  struct NlaEvalChannelSnapshot *next_free;
+
   int length;   /* Number of values in the property. */
   bool is_base; /* Base snapshot of the channel. */
 
@@ -112,6 +115,9 @@ typedef struct NlaEvalChannel {
   /* Associated with the RNA property's value(s), marks which elements are affected by NLA. */
   NlaValidMask domain;
 
+  /* Freed snapshots of this channel, reused by the next strip instead of allocating again. */
+  NlaEvalChannelSnapshot *free_snapshots;
+
   /* Base set of values. */
   NlaEvalChannelSnapshot base_snapshot;
   /* Memory over-allocated to provide space for base_snapshot.values. */
@@ -134,6 +140,11 @@ typedef struct NlaEvalData {
   GHash *path_hash;
   GHash *key_hash;
 
+  /* Channel of every F-Curve per action slot, to avoid hashing paths on every evaluation. */
+  struct NlaEvalActionChannelsMap *action_channels;
+  /* Some channels can't be reused by later evaluations, see #nlaevalchan_verify. */
+  bool has_uncacheable_channels;
+
   /* Base snapshot. */
   int num_channels;
   NlaEvalSnapshot base_snapshot;
@@ -292,3 +303,9 @@ void nlasnapshot_blend_strip_no_blend(PointerRNA *ptr,
                                       NlaEvalStrip *nes,
                                       NlaEvalSnapshot *snapshot,
                                       const struct AnimationEvalContext *anim_eval_context);
+
+/**
+ * Free NLA evaluation data that was kept in #blender::bke::AnimDataRuntime to be reused by later
+ * evaluations, including the #NlaEvalData itself.
+ */
+void nlaeval_cache_free(NlaEvalData *nlaeval);
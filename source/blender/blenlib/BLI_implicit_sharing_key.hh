@@ -0,0 +1,50 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ */
+
+#include <string>
+
+#include "BLI_generic_key.hh"
+#include "BLI_implicit_sharing_ptr.hh"
+#include "BLI_vector.hh"
+
+namespace blender {
+
+/**
+ * A #GenericKey that identifies data by plain words and strings. Implicitly shared arrays are
+ * identified by the address and version of their #ImplicitSharingInfo, which is much cheaper than
+ * comparing their values. This makes it a good key for caching data derived from e.g. meshes.
+ *
+ * Keys are only equal when they have the same type, so subclasses can be used for different
+ * caches. Subclasses that store more data have to extend #hash and #equal_to.
+ */
+class ImplicitSharingKey : public GenericKey {
+ public:
+  Vector<uint64_t> words;
+  Vector<std::string> strings;
+  /**
+   * The sharing data referenced in #words. The weak users keep the #ImplicitSharingInfo alive
+   * (but not the data itself), so its address can't be reused by newer data while the key exists.
+   */
+  Vector<WeakImplicitSharingPtr> shared_data;
+
+  uint64_t hash() const override;
+  bool equal_to(const GenericKey &other) const override;
+
+  /** Identify data by its sharing info. */
+  void add_shared_data(const ImplicitSharingInfo &sharing_info);
+
+  /**
+   * Identify an array by its sharing info. Returns false if the array is allocated but has no
+   * sharing info, so that it could only be identified by its values.
+   */
+  [[nodiscard]] bool add_array(bool is_allocated, const ImplicitSharingInfo *sharing_info);
+};
+
+}  // namespace blender
@@ -0,0 +1,32 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ */
+
+#include <cstddef>
+
+namespace blender::math {
+
+/**
+ * Elementary functions evaluated on arrays of floats.
+ *
+ * The standard library functions are called for every element separately, which prevents the
+ * compiler from vectorizing loops that use them. These functions process four values at once when
+ * SSE2 is available (emulated with NEON on ARM). The polynomial approximations are accurate to a
+ * few ULP in the common input range. Elements outside of that range (e.g. very large angles or
+ * arguments that overflow) fall back to the standard library, so the results never differ from
+ * it by more than that.
+ *
+ * The source and destination arrays may be the same.
+ */
+
+void sin_array(const float *src, float *dst, size_t length);
+void cos_array(const float *src, float *dst, size_t length);
+void exp_array(const float *src, float *dst, size_t length);
+
+}  // namespace blender::math
@@ -21,6 +21,10 @@ typedef struct BLI_mmap_file BLI_mmap_file;
  * May return NULL if the operation fails.
  * Note that this seeks to the end of the file to determine its length. */
 BLI_mmap_file *BLI_mmap_open(int fd) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+/* Like #BLI_mmap_open, but the mapped memory may also be written to. Changes are private to the
+ * process and never written back to the file (copy-on-write). The mapping stays valid when the
+ * file descriptor is closed. */
+BLI_mmap_file *BLI_mmap_open_copy_on_write(int fd) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
 
 /* Reads length bytes from file at the given offset into dest.
  * Returns whether the operation was successful (may fail when reading beyond the file
@@ -30,5 +34,9 @@ bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length
 
 void *BLI_mmap_get_pointer(BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
 size_t BLI_mmap_get_length(const BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
+/* Whether an IO error occurred while accessing the mapped memory. Code that uses the pointer from
+ * #BLI_mmap_get_pointer directly instead of #BLI_mmap_read has to check this itself, because the
+ * memory is replaced with zeros after an error. */
+bool BLI_mmap_any_io_error(const BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
 
 void BLI_mmap_free(BLI_mmap_file *file) ATTR_NONNULL(1);
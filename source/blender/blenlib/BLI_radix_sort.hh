@@ -0,0 +1,29 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ *
+ * Parallel LSD radix sort of indices by 32 bit keys. For large arrays this is significantly
+ * faster than comparison based sorting like #parallel_sort, because it only needs a fixed number
+ * of passes over the data. Small arrays are sorted with a comparison sort instead.
+ */
+
+#include "BLI_span.hh"
+
+namespace blender {
+
+/**
+ * Sort the \a indices by the keys at those indices, i.e. so that `keys[indices[i]]` is ascending.
+ * The sort is stable, indices with equal keys keep their relative order.
+ *
+ * Floats are ordered by their value, with positive and negative zero being equal. NaN values with
+ * the sign bit set are sorted before all other values, other NaN values after all other values.
+ */
+void radix_sort_indices(Span<float> keys, MutableSpan<int> indices);
+void radix_sort_indices(Span<int> keys, MutableSpan<int> indices);
+
+}  // namespace blender
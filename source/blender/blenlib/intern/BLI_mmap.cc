@@ -8,9 +8,10 @@
 
 #include "BLI_mmap.h"
 #include "BLI_fileops.h"
-#include "BLI_listbase.h"
+#include "BLI_mutex.hh"
 #include "MEM_guardedalloc.h"
 
+#include <atomic>
 #include <cstring>
 
 #ifndef WIN32
@@ -36,12 +37,20 @@ struct BLI_mmap_file {
   /* Flag to indicate IO errors. Needs to be volatile since it's being set from
    * within the signal handler, which is not part of the normal execution flow. */
   volatile bool io_error;
+
+  /* The mapped memory may be written to, see #BLI_mmap_open_copy_on_write. */
+  bool copy_on_write;
+
+#ifndef WIN32
+  /* Slot that makes the file known to the SIGBUS handler. */
+  struct MmapSlot *slot;
+#endif
 };
 
 #ifndef WIN32
 /* When using memory-mapped files, any IO errors will result in a SIGBUS signal.
  * Therefore, we need to catch that signal and stop reading the file in question.
- * To do so, we keep a list of all current FileDatas that use memory-mapped files,
+ * To do so, we keep track of all current FileDatas that use memory-mapped files,
  * and if a SIGBUS is caught, we check if the failed address is inside one of the
  * mapped regions.
  * If it is, we set a flag to indicate a failed read and remap the memory in
@@ -50,13 +59,33 @@ struct BLI_mmap_file {
  * set after it's done reading.
  * If the error occurred outside of a memory-mapped region, we call the previous
  * handler if one was configured and abort the process otherwise.
+ *
+ * Files may be mapped and freed from any thread. Registering and unregistering files is protected
+ * by a mutex, but the signal handler can't lock it. Instead, the files are stored in slots that
+ * are read with atomics. Blocks of slots are only ever appended and are never freed, so the
+ * handler can always walk them safely.
  */
 
+struct MmapSlot {
+  std::atomic<BLI_mmap_file *> file;
+  /* The mapped range is stored in the slot as well, so that the handler never has to read from
+   * a file that is being freed on another thread. */
+  std::atomic<const char *> begin;
+  std::atomic<const char *> end;
+};
+
+struct MmapSlotBlock {
+  MmapSlot slots[64];
+  std::atomic<MmapSlotBlock *> next;
+};
+
 static struct error_handler_data {
-  ListBase open_mmaps;
-  char configured;
+  /* Protects the handler setup and assigning slots. */
+  blender::Mutex mutex;
+  std::atomic<MmapSlotBlock *> first_block;
+  bool configured;
   void (*next_handler)(int, siginfo_t *, void *);
-} error_handler = {{nullptr}};
+} error_handler;
 
 static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
 {
@@ -65,16 +94,36 @@ static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
 
   const char *error_addr = (const char *)siginfo->si_addr;
   /* Find the file that this error belongs to. */
-  LISTBASE_FOREACH (LinkData *, link, &error_handler.open_mmaps) {
-    BLI_mmap_file *file = static_cast<BLI_mmap_file *>(link->data);
+  for (MmapSlotBlock *block = error_handler.first_block.load(std::memory_order_acquire); block;
+       block = block->next.load(std::memory_order_acquire))
+  {
+    for (MmapSlot &slot : block->slots) {
+      BLI_mmap_file *file = slot.file.load(std::memory_order_acquire);
+      if (file == nullptr) {
+        continue;
+      }
+      /* Is the address where the error occurred in this file's mapped range? */
+      if (error_addr < slot.begin.load(std::memory_order_relaxed) ||
+          error_addr >= slot.end.load(std::memory_order_relaxed))
+      {
+        continue;
+      }
+      /* The slot may have been reused while the range was read. A file that is still in the slot
+       * is being read by the faulting thread, so it can't be freed in the meantime. */
+      if (slot.file.load(std::memory_order_acquire) != file) {
+        continue;
+      }
 
-    /* Is the address where the error occurred in this file's mapped range? */
-    if (error_addr >= file->memory && error_addr < file->memory + file->length) {
       file->io_error = true;
 
       /* Replace the mapped memory with zeroes. */
-      const void *mapped_memory = mmap(
-          file->memory, file->length, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+      const int protection = file->copy_on_write ? (PROT_READ | PROT_WRITE) : PROT_READ;
+      const void *mapped_memory = mmap(file->memory,
+                                       file->length,
+                                       protection,
+                                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
+                                       -1,
+                                       0);
       if (mapped_memory == MAP_FAILED) {
         fprintf(stderr, "SIGBUS handler: Error replacing mapped file with zeros\n");
       }
@@ -96,6 +145,7 @@ static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
 /* Ensures that the error handler is set up and ready. */
 static bool sigbus_handler_setup()
 {
+  std::lock_guard lock{error_handler.mutex};
   if (!error_handler.configured) {
     struct sigaction newact = {{nullptr}}, oldact = {{nullptr}};
 
@@ -109,28 +159,51 @@ static bool sigbus_handler_setup()
     /* Remember the previously configured handler to fall back to it if the error
      * does not belong to any of the mapped files. */
     error_handler.next_handler = oldact.sa_sigaction;
-    error_handler.configured = 1;
+    error_handler.configured = true;
   }
 
   return true;
 }
 
-/* Adds a file to the list that the error handler checks. */
+/* Adds a file to the slots that the error handler checks. */
 static void sigbus_handler_add(BLI_mmap_file *file)
 {
-  BLI_addtail(&error_handler.open_mmaps, BLI_genericNodeN(file));
+  std::lock_guard lock{error_handler.mutex};
+  /* Files are only assigned to slots while the mutex is locked, so relaxed loads are enough. */
+  std::atomic<MmapSlotBlock *> *next_block = &error_handler.first_block;
+  while (MmapSlotBlock *block = next_block->load(std::memory_order_relaxed)) {
+    for (MmapSlot &slot : block->slots) {
+      if (slot.file.load(std::memory_order_relaxed) == nullptr) {
+        slot.begin.store(file->memory, std::memory_order_relaxed);
+        slot.end.store(file->memory + file->length, std::memory_order_relaxed);
+        slot.file.store(file, std::memory_order_release);
+        file->slot = &slot;
+        return;
+      }
+    }
+    next_block = &block->next;
+  }
+  /* All slots are used, append a new block. It is never freed, because the handler might still
+   * read from it. */
+  MmapSlotBlock *block = new MmapSlotBlock();
+  MmapSlot &slot = block->slots[0];
+  slot.begin.store(file->memory, std::memory_order_relaxed);
+  slot.end.store(file->memory + file->length, std::memory_order_relaxed);
+  slot.file.store(file, std::memory_order_relaxed);
+  file->slot = &slot;
+  next_block->store(block, std::memory_order_release);
 }
 
-/* Removes a file from the list that the error handler checks. */
+/* Removes a file from the slots that the error handler checks. */
 static void sigbus_handler_remove(BLI_mmap_file *file)
 {
-  LinkData *link = static_cast<LinkData *>(
-      BLI_findptr(&error_handler.open_mmaps, file, offsetof(LinkData, data)));
-  BLI_freelinkN(&error_handler.open_mmaps, link);
+  std::lock_guard lock{error_handler.mutex};
+  file->slot->file.store(nullptr, std::memory_order_release);
+  file->slot = nullptr;
 }
 #endif
 
-BLI_mmap_file *BLI_mmap_open(int fd)
+static BLI_mmap_file *mmap_open_ex(const int fd, const bool copy_on_write)
 {
   void *memory, *handle = nullptr;
   const size_t length = BLI_lseek(fd, 0, SEEK_END);
@@ -145,7 +218,8 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   }
 
   /* Map the given file to memory. */
-  memory = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  const int protection = copy_on_write ? (PROT_READ | PROT_WRITE) : PROT_READ;
+  memory = mmap(nullptr, length, protection, MAP_PRIVATE, fd, 0);
   if (memory == MAP_FAILED) {
     return nullptr;
   }
@@ -155,11 +229,12 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   /* Memory mapping on Windows is a two-step process - first we create a mapping,
    * then we create a view into that mapping.
    * In our case, one view that spans the entire file is enough. */
-  handle = CreateFileMapping(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  handle = CreateFileMapping(
+      file_handle, nullptr, copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
   if (handle == nullptr) {
     return nullptr;
   }
-  memory = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+  memory = MapViewOfFile(handle, copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
   if (memory == nullptr) {
     CloseHandle(handle);
     return nullptr;
@@ -171,6 +246,7 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   file->memory = static_cast<char *>(memory);
   file->handle = handle;
   file->length = length;
+  file->copy_on_write = copy_on_write;
 
 #ifndef WIN32
   /* Register the file with the error handler. */
@@ -180,6 +256,16 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   return file;
 }
 
+BLI_mmap_file *BLI_mmap_open(int fd)
+{
+  return mmap_open_ex(fd, false);
+}
+
+BLI_mmap_file *BLI_mmap_open_copy_on_write(int fd)
+{
+  return mmap_open_ex(fd, true);
+}
+
 bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length)
 {
   /* If a previous read has already failed or we try to read past the end,
@@ -219,11 +305,18 @@ size_t BLI_mmap_get_length(const BLI_mmap_file *file)
   return file->length;
 }
 
+bool BLI_mmap_any_io_error(const BLI_mmap_file *file)
+{
+  return file->io_error;
+}
+
 void BLI_mmap_free(BLI_mmap_file *file)
 {
 #ifndef WIN32
-  munmap((void *)file->memory, file->length);
+  /* Unregister first, so that the range isn't matched anymore once it's unmapped and possibly
+   * reused by another mapping. */
   sigbus_handler_remove(file);
+  munmap((void *)file->memory, file->length);
 #else
   UnmapViewOfFile(file->memory);
   CloseHandle(file->handle);
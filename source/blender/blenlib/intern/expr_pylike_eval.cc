@@ -14,14 +14,19 @@
  *  - Literals:
  *      floating point and decimal integer.
  *  - Constants:
- *      pi, True, False
+ *      pi, e, tau, True, False
  *  - Operators:
- *      +, -, *, /, ==, !=, <, <=, >, >=, and, or, not, ternary if
+ *      +, -, *, /, //, %, **, ==, !=, <, <=, >, >=, and, or, not, ternary if
  *  - Functions:
  *      min, max, radians, degrees,
- *      abs, fabs, floor, ceil, trunc, int,
+ *      abs, fabs, floor, ceil, trunc, int, float, bool,
  *      sin, cos, tan, asin, acos, atan, atan2,
- *      exp, log, sqrt, pow, fmod
+ *      sinh, cosh, tanh, asinh, acosh, atanh,
+ *      exp, expm1, log, log1p, log2, log10, sqrt, pow, fmod,
+ *      hypot, copysign, lerp, clamp, smoothstep
+ *
+ * The `//` and `%` operators follow the Python semantics for floating point values, i.e. the
+ * result of `%` has the sign of the divisor.
  *
  * The implementation has no global state and can be used multi-threaded.
  */
@@ -298,6 +303,46 @@ static double op_sub(double a, double b)
   return a - b;
 }
 
+/* Python float modulo, see `float_rem` in CPython. */
+static double op_mod(double a, double b)
+{
+  if (b == 0.0) {
+    /* Python raises ZeroDivisionError, report it the same way as a division. */
+    return 1.0 / b;
+  }
+  double mod = fmod(a, b);
+  if (mod) {
+    if ((b < 0.0) != (mod < 0.0)) {
+      mod += b;
+    }
+  }
+  else {
+    mod = copysign(0.0, b);
+  }
+  return mod;
+}
+
+/* Python float floor division, see `float_floor_div` in CPython. */
+static double op_floordiv(double a, double b)
+{
+  if (b == 0.0) {
+    return 1.0 / b;
+  }
+  double mod = fmod(a, b);
+  double div = (a - mod) / b;
+  if (mod && ((b < 0.0) != (mod < 0.0))) {
+    div -= 1.0;
+  }
+  if (div) {
+    double floordiv = floor(div);
+    if (div - floordiv > 0.5) {
+      floordiv += 1.0;
+    }
+    return floordiv;
+  }
+  return copysign(0.0, a / b);
+}
+
 static double op_radians(double arg)
 {
   return arg * M_PI / 180.0;
@@ -308,11 +353,21 @@ static double op_degrees(double arg)
   return arg * 180.0 / M_PI;
 }
 
-static double op_log2(double a, double b)
+static double op_log_base(double a, double b)
 {
   return log(a) / log(b);
 }
 
+static double op_float(double arg)
+{
+  return arg;
+}
+
+static double op_bool(double arg)
+{
+  return arg ? 1.0 : 0.0;
+}
+
 static double op_lerp(double a, double b, double x)
 {
   return a * (1.0 - x) + b * x;
@@ -378,7 +433,13 @@ struct BuiltinConstDef {
 };
 
 static BuiltinConstDef builtin_consts[] = {
-    {"pi", M_PI}, {"True", 1.0}, {"False", 0.0}, {nullptr, 0.0}};
+    {"pi", M_PI},
+    {"e", M_E},
+    {"tau", 2.0 * M_PI},
+    {"True", 1.0},
+    {"False", 0.0},
+    {nullptr, 0.0},
+};
 
 struct BuiltinOpDef {
   const char *name;
@@ -419,6 +480,8 @@ static BuiltinOpDef builtin_ops[] = {
     {"trunc", UnaryOpFunc(trunc)},
     {"round", UnaryOpFunc(round)},
     {"int", UnaryOpFunc(trunc)},
+    {"float", UnaryOpFunc(op_float)},
+    {"bool", UnaryOpFunc(op_bool)},
     {"sin", UnaryOpFunc(sin)},
     {"cos", UnaryOpFunc(cos)},
     {"tan", UnaryOpFunc(tan)},
@@ -426,9 +489,21 @@ static BuiltinOpDef builtin_ops[] = {
     {"acos", UnaryOpFunc(acos)},
     {"atan", UnaryOpFunc(atan)},
     {"atan2", BinaryOpFunc(atan2)},
+    {"sinh", UnaryOpFunc(sinh)},
+    {"cosh", UnaryOpFunc(cosh)},
+    {"tanh", UnaryOpFunc(tanh)},
+    {"asinh", UnaryOpFunc(asinh)},
+    {"acosh", UnaryOpFunc(acosh)},
+    {"atanh", UnaryOpFunc(atanh)},
+    {"hypot", BinaryOpFunc(hypot)},
+    {"copysign", BinaryOpFunc(copysign)},
     {"exp", UnaryOpFunc(exp)},
     {"log", UnaryOpFunc(log)},
-    {"log", BinaryOpFunc(op_log2)},
+    {"log", BinaryOpFunc(op_log_base)},
+    {"log1p", UnaryOpFunc(log1p)},
+    {"log2", UnaryOpFunc(log2)},
+    {"log10", UnaryOpFunc(log10)},
+    {"expm1", UnaryOpFunc(expm1)},
     {"sqrt", UnaryOpFunc(sqrt)},
     {"pow", BinaryOpFunc(pow)},
     {"fmod", BinaryOpFunc(fmod)},
@@ -466,6 +541,8 @@ static BuiltinOpDef builtin_ops[] = {
 #define TOKEN_NOT MAKE_CHAR2('N', 'O')
 #define TOKEN_IF MAKE_CHAR2('I', 'F')
 #define TOKEN_ELSE MAKE_CHAR2('E', 'L')
+#define TOKEN_POW MAKE_CHAR2('*', '*')
+#define TOKEN_FLOORDIV MAKE_CHAR2('/', '/')
 
 static const char *token_eq_characters = "!=><";
 static const char *token_characters = "~`!@#$%^&*+-=/\\?:;<>(){}[]|.,\"'";
@@ -670,6 +747,13 @@ static bool parse_next_token(ExprParseState *state)
     return (end == out);
   }
 
+  /* ** and // tokens */
+  if (state->cur[0] == state->cur[1] && ELEM(state->cur[0], '*', '/')) {
+    state->token = MAKE_CHAR2(state->cur[0], state->cur[1]);
+    state->cur += 2;
+    return true;
+  }
+
   /* ?= tokens */
   if (state->cur[1] == '=' && strchr(token_eq_characters, state->cur[0])) {
     state->token = MAKE_CHAR2(state->cur[0], state->cur[1]);
@@ -749,19 +833,11 @@ static int parse_function_args(ExprParseState *state)
   }
 }
 
-static bool parse_unary(ExprParseState *state)
+static bool parse_primary(ExprParseState *state)
 {
   int i;
 
   switch (state->token) {
-    case '+':
-      return parse_next_token(state) && parse_unary(state);
-
-    case '-':
-      CHECK_ERROR(parse_next_token(state) && parse_unary(state));
-      parse_add_func(state, op_negate);
-      return true;
-
     case '(':
       return parse_next_token(state) && parse_expr(state) && state->token == ')' &&
              parse_next_token(state);
@@ -835,6 +911,38 @@ static bool parse_unary(ExprParseState *state)
   }
 }
 
+static bool parse_unary(ExprParseState *state);
+
+static bool parse_power(ExprParseState *state)
+{
+  CHECK_ERROR(parse_primary(state));
+
+  /* Exponentiation is right-associative and binds tighter than a unary operator on its left,
+   * but not on its right: `-2 ** -2` is `-(2 ** (-2))`. */
+  if (state->token == TOKEN_POW) {
+    CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+    parse_add_func(state, BinaryOpFunc(pow));
+  }
+
+  return true;
+}
+
+static bool parse_unary(ExprParseState *state)
+{
+  switch (state->token) {
+    case '+':
+      return parse_next_token(state) && parse_unary(state);
+
+    case '-':
+      CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+      parse_add_func(state, op_negate);
+      return true;
+
+    default:
+      return parse_power(state);
+  }
+}
+
 static bool parse_mul(ExprParseState *state)
 {
   CHECK_ERROR(parse_unary(state));
@@ -851,6 +959,16 @@ static bool parse_mul(ExprParseState *state)
         parse_add_func(state, op_div);
         break;
 
+      case TOKEN_FLOORDIV:
+        CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+        parse_add_func(state, op_floordiv);
+        break;
+
+      case '%':
+        CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+        parse_add_func(state, op_mod);
+        break;
+
       default:
         return true;
     }
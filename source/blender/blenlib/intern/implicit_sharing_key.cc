@@ -0,0 +1,56 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bli
+ */
+
+#include <typeinfo>
+
+#include "BLI_hash.hh"
+#include "BLI_implicit_sharing_key.hh"
+
+namespace blender {
+
+uint64_t ImplicitSharingKey::hash() const
+{
+  uint64_t hash = get_default_hash(this->words.size(), this->strings.size());
+  for (const uint64_t word : this->words) {
+    hash = get_default_hash(hash, word);
+  }
+  for (const std::string &str : this->strings) {
+    hash = get_default_hash(hash, str);
+  }
+  return hash;
+}
+
+bool ImplicitSharingKey::equal_to(const GenericKey &other) const
+{
+  if (typeid(*this) != typeid(other)) {
+    return false;
+  }
+  const ImplicitSharingKey &other_key = static_cast<const ImplicitSharingKey &>(other);
+  return this->words == other_key.words && this->strings == other_key.strings;
+}
+
+void ImplicitSharingKey::add_shared_data(const ImplicitSharingInfo &sharing_info)
+{
+  sharing_info.add_weak_user();
+  this->shared_data.append(WeakImplicitSharingPtr(&sharing_info));
+  this->words.append(uint64_t(uintptr_t(&sharing_info)));
+  this->words.append(uint64_t(sharing_info.version()));
+}
+
+bool ImplicitSharingKey::add_array(const bool is_allocated,
+                                   const ImplicitSharingInfo *sharing_info)
+{
+  if (sharing_info == nullptr) {
+    this->words.append(0);
+    return !is_allocated;
+  }
+  this->add_shared_data(*sharing_info);
+  return true;
+}
+
+}  // namespace blender
@@ -0,0 +1,263 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bli
+ *
+ * The polynomial approximations and range reductions are the ones from the Cephes math library
+ * (`sinf.c`, `cosf.c` and `expf.c`), which are also used by most SIMD math libraries.
+ */
+
+#include <cmath>
+
+#include "BLI_math_vectorized.hh"
+#include "BLI_simd.hh"
+
+namespace blender::math {
+
+#if BLI_HAVE_SSE2
+
+/* Range in which the trigonometric range reduction is accurate. */
+static constexpr float trig_max_input = 8192.0f;
+/* Range in which the exponent of the result of #exp_array can be represented exactly. */
+static constexpr float exp_min_input = -87.0f;
+static constexpr float exp_max_input = 88.0f;
+
+static constexpr float four_over_pi = 1.27323954473516f;
+/* Pi / 4 split into three parts for the extra precision in the range reduction. */
+static constexpr float pi_4_part_1 = 0.78515625f;
+static constexpr float pi_4_part_2 = 2.4187564849853515625e-4f;
+static constexpr float pi_4_part_3 = 3.77489497744594108e-8f;
+
+/**
+ * Reduce the absolute input value to the range [-pi/4, pi/4], returning the octant in \a r_octant
+ * (always an even number in [0, 6]).
+ */
+static inline __m128 trig_reduce(const __m128 abs_x, __m128i &r_octant)
+{
+  __m128i octant = _mm_cvttps_epi32(_mm_mul_ps(abs_x, _mm_set1_ps(four_over_pi)));
+  /* Round odd octants up, so that the reduced value is centered around zero. */
+  octant = _mm_add_epi32(octant, _mm_set1_epi32(1));
+  octant = _mm_and_si128(octant, _mm_set1_epi32(~1));
+  const __m128 y = _mm_cvtepi32_ps(octant);
+
+  __m128 x = abs_x;
+  x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(pi_4_part_1)));
+  x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(pi_4_part_2)));
+  x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(pi_4_part_3)));
+
+  r_octant = _mm_and_si128(octant, _mm_set1_epi32(7));
+  return x;
+}
+
+/** Approximation of `sin(x)` for x in [-pi/4, pi/4]. */
+static inline __m128 sin_poly(const __m128 x, const __m128 x2)
+{
+  __m128 y = _mm_set1_ps(-1.9515295891e-4f);
+  y = _mm_add_ps(_mm_mul_ps(y, x2), _mm_set1_ps(8.3321608736e-3f));
+  y = _mm_add_ps(_mm_mul_ps(y, x2), _mm_set1_ps(-1.6666654611e-1f));
+  return _mm_add_ps(_mm_mul_ps(_mm_mul_ps(y, x2), x), x);
+}
+
+/** Approximation of `cos(x)` for x in [-pi/4, pi/4]. */
+static inline __m128 cos_poly(const __m128 x2)
+{
+  __m128 y = _mm_set1_ps(2.443315711809948e-5f);
+  y = _mm_add_ps(_mm_mul_ps(y, x2), _mm_set1_ps(-1.388731625493765e-3f));
+  y = _mm_add_ps(_mm_mul_ps(y, x2), _mm_set1_ps(4.166664568298827e-2f));
+  y = _mm_mul_ps(_mm_mul_ps(y, x2), x2);
+  y = _mm_sub_ps(y, _mm_mul_ps(x2, _mm_set1_ps(0.5f)));
+  return _mm_add_ps(y, _mm_set1_ps(1.0f));
+}
+
+static inline __m128 select(const __m128 mask, const __m128 a, const __m128 b)
+{
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128 abs(const __m128 x)
+{
+  return _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+}
+
+/** True when all values are in the given range, false for NaN. */
+static inline bool all_in_range(const __m128 x, const float min, const float max)
+{
+  const __m128 in_range = _mm_and_ps(_mm_cmpge_ps(x, _mm_set1_ps(min)),
+                                     _mm_cmple_ps(x, _mm_set1_ps(max)));
+  return _mm_movemask_ps(in_range) == 0xF;
+}
+
+static inline __m128 sin4(const __m128 x)
+{
+  const __m128 sign = _mm_and_ps(x, _mm_set1_ps(-0.0f));
+  __m128i octant;
+  const __m128 r = trig_reduce(abs(x), octant);
+  const __m128 r2 = _mm_mul_ps(r, r);
+
+  const __m128 use_cos = _mm_castsi128_ps(
+      _mm_cmpeq_epi32(_mm_and_si128(octant, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+  const __m128 flip_sign = _mm_castsi128_ps(
+      _mm_slli_epi32(_mm_and_si128(octant, _mm_set1_epi32(4)), 29));
+
+  const __m128 y = select(use_cos, cos_poly(r2), sin_poly(r, r2));
+  return _mm_xor_ps(y, _mm_xor_ps(sign, flip_sign));
+}
+
+static inline __m128 cos4(const __m128 x)
+{
+  __m128i octant;
+  const __m128 r = trig_reduce(abs(x), octant);
+  const __m128 r2 = _mm_mul_ps(r, r);
+
+  const __m128 use_sin = _mm_castsi128_ps(
+      _mm_cmpeq_epi32(_mm_and_si128(octant, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+  /* The result is negative in the octants 2 and 4. */
+  const __m128i shifted_octant = _mm_sub_epi32(octant, _mm_set1_epi32(2));
+  const __m128 flip_sign = _mm_castsi128_ps(
+      _mm_slli_epi32(_mm_andnot_si128(shifted_octant, _mm_set1_epi32(4)), 29));
+
+  const __m128 y = select(use_sin, sin_poly(r, r2), cos_poly(r2));
+  return _mm_xor_ps(y, flip_sign);
+}
+
+static inline __m128 exp4(const __m128 x)
+{
+  /* Split into `2^n * e^r` with `r` in [-ln(2) / 2, ln(2) / 2]. */
+  const __m128 fx = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(1.44269504088896341f)),
+                               _mm_set1_ps(0.5f));
+  /* Floor without SSE4.1. */
+  __m128 n = _mm_cvtepi32_ps(_mm_cvttps_epi32(fx));
+  n = _mm_sub_ps(n, _mm_and_ps(_mm_cmpgt_ps(n, fx), _mm_set1_ps(1.0f)));
+
+  __m128 r = x;
+  r = _mm_sub_ps(r, _mm_mul_ps(n, _mm_set1_ps(0.693359375f)));
+  r = _mm_sub_ps(r, _mm_mul_ps(n, _mm_set1_ps(-2.12194440e-4f)));
+  const __m128 r2 = _mm_mul_ps(r, r);
+
+  __m128 y = _mm_set1_ps(1.9875691500e-4f);
+  y = _mm_add_ps(_mm_mul_ps(y, r), _mm_set1_ps(1.3981999507e-3f));
+  y = _mm_add_ps(_mm_mul_ps(y, r), _mm_set1_ps(8.3334519073e-3f));
+  y = _mm_add_ps(_mm_mul_ps(y, r), _mm_set1_ps(4.1665795894e-2f));
+  y = _mm_add_ps(_mm_mul_ps(y, r), _mm_set1_ps(1.6666665459e-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, r), _mm_set1_ps(5.0000001201e-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, r2), r);
+  y = _mm_add_ps(y, _mm_set1_ps(1.0f));
+
+  /* Construct `2^n` from its exponent bits. */
+  const __m128i exponent = _mm_slli_epi32(
+      _mm_add_epi32(_mm_cvttps_epi32(n), _mm_set1_epi32(127)), 23);
+  return _mm_mul_ps(y, _mm_castsi128_ps(exponent));
+}
+
+/**
+ * Apply the vectorized function to all values. Groups of four values with an element outside of
+ * the valid range are computed with the scalar function. The last values are padded, so that the
+ * result for a value doesn't depend on its position in the array.
+ */
+template<typename VectorFn, typename ScalarFn>
+static void apply_array(const float *src,
+                        float *dst,
+                        const size_t length,
+                        const float min_input,
+                        const float max_input,
+                        const VectorFn vector_fn,
+                        const ScalarFn scalar_fn)
+{
+  auto apply = [&](const __m128 x, float *r_dst) {
+    if (all_in_range(x, min_input, max_input)) {
+      _mm_storeu_ps(r_dst, vector_fn(x));
+      return;
+    }
+    /* The vectorized results of out of range values are meaningless but harmless. */
+    alignas(16) float values[4];
+    alignas(16) float results[4];
+    _mm_store_ps(values, x);
+    _mm_store_ps(results, vector_fn(x));
+    for (int i = 0; i < 4; i++) {
+      const float value = values[i];
+      r_dst[i] = (value >= min_input && value <= max_input) ? results[i] : scalar_fn(value);
+    }
+  };
+
+  size_t i = 0;
+  for (; i + 3 < length; i += 4) {
+    apply(_mm_loadu_ps(src + i), dst + i);
+  }
+  if (i < length) {
+    float tail_src[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    float tail_dst[4];
+    const size_t tail_size = length - i;
+    for (size_t j = 0; j < tail_size; j++) {
+      tail_src[j] = src[i + j];
+    }
+    apply(_mm_loadu_ps(tail_src), tail_dst);
+    for (size_t j = 0; j < tail_size; j++) {
+      dst[i + j] = tail_dst[j];
+    }
+  }
+}
+
+void sin_array(const float *src, float *dst, const size_t length)
+{
+  apply_array(
+      src,
+      dst,
+      length,
+      -trig_max_input,
+      trig_max_input,
+      [](const __m128 x) { return sin4(x); },
+      [](const float x) { return sinf(x); });
+}
+
+void cos_array(const float *src, float *dst, const size_t length)
+{
+  apply_array(
+      src,
+      dst,
+      length,
+      -trig_max_input,
+      trig_max_input,
+      [](const __m128 x) { return cos4(x); },
+      [](const float x) { return cosf(x); });
+}
+
+void exp_array(const float *src, float *dst, const size_t length)
+{
+  apply_array(
+      src,
+      dst,
+      length,
+      exp_min_input,
+      exp_max_input,
+      [](const __m128 x) { return exp4(x); },
+      [](const float x) { return expf(x); });
+}
+
+#else
+
+void sin_array(const float *src, float *dst, const size_t length)
+{
+  for (size_t i = 0; i < length; i++) {
+    dst[i] = sinf(src[i]);
+  }
+}
+
+void cos_array(const float *src, float *dst, const size_t length)
+{
+  for (size_t i = 0; i < length; i++) {
+    dst[i] = cosf(src[i]);
+  }
+}
+
+void exp_array(const float *src, float *dst, const size_t length)
+{
+  for (size_t i = 0; i < length; i++) {
+    dst[i] = expf(src[i]);
+  }
+}
+
+#endif
+
+}  // namespace blender::math
@@ -0,0 +1,178 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bli
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "BLI_array.hh"
+#include "BLI_array_utils.hh"
+#include "BLI_math_base.h"
+#include "BLI_radix_sort.hh"
+#include "BLI_task.hh"
+
+namespace blender {
+
+/** Below this size, the overhead of the radix sort passes is larger than its benefit. */
+static constexpr int64_t comparison_sort_max_size = 2048;
+/** Number of elements that are processed by one task in every pass. */
+static constexpr int64_t block_size = 1 << 16;
+
+static constexpr int digit_bits = 8;
+static constexpr int digits_num = 1 << digit_bits;
+static constexpr int passes_num = 32 / digit_bits;
+
+using DigitCounts = std::array<int, digits_num>;
+
+/** Map the key to an unsigned integer with the same order. */
+static uint32_t radix_key(const int value)
+{
+  return uint32_t(value) ^ 0x80000000u;
+}
+
+static uint32_t radix_key(float value)
+{
+  if (value == 0.0f) {
+    /* Make negative zero sort the same as positive zero. */
+    value = 0.0f;
+  }
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  /* Negative values are ordered in reverse by their remaining bits, so all bits are flipped. For
+   * positive values only the sign bit is set, to move them after the negative values. */
+  return bits ^ ((bits & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u);
+}
+
+static int get_digit(const uint32_t key, const int pass)
+{
+  return (key >> (pass * digit_bits)) & (digits_num - 1);
+}
+
+template<typename T>
+static void radix_sort_indices_impl(const Span<T> keys, MutableSpan<int> indices)
+{
+  const int64_t size = indices.size();
+  if (size < 2) {
+    return;
+  }
+  if (size <= comparison_sort_max_size) {
+    std::stable_sort(indices.begin(), indices.end(), [&](const int a, const int b) {
+      return radix_key(keys[a]) < radix_key(keys[b]);
+    });
+    return;
+  }
+
+  const int64_t blocks_num = divide_ceil_ul(size, block_size);
+  const IndexRange blocks_range(blocks_num);
+  const auto block_slice = [&](const int64_t block) {
+    return IndexRange::from_begin_size(block * block_size,
+                                       std::min(block_size, size - block * block_size));
+  };
+
+  /* Gather the keys once, so that the passes only access memory linearly. Also count the digits of
+   * all passes, to skip passes in which all keys have the same digit. */
+  Array<uint32_t> keys_a(size, NoInitialization());
+  Array<std::array<DigitCounts, passes_num>> initial_counts(blocks_num);
+  threading::parallel_for(blocks_range, 1, [&](const IndexRange range) {
+    for (const int64_t block : range) {
+      std::array<DigitCounts, passes_num> &counts = initial_counts[block];
+      for (DigitCounts &pass_counts : counts) {
+        pass_counts.fill(0);
+      }
+      for (const int64_t i : block_slice(block)) {
+        const uint32_t key = radix_key(keys[indices[i]]);
+        keys_a[i] = key;
+        for (const int pass : IndexRange(passes_num)) {
+          counts[pass][get_digit(key, pass)]++;
+        }
+      }
+    }
+  });
+
+  Array<uint32_t> keys_b(size, NoInitialization());
+  Array<int> indices_buffer(size, NoInitialization());
+  MutableSpan<uint32_t> src_keys = keys_a;
+  MutableSpan<uint32_t> dst_keys = keys_b;
+  MutableSpan<int> src_indices = indices;
+  MutableSpan<int> dst_indices = indices_buffer;
+
+  Array<DigitCounts> block_offsets(blocks_num);
+  bool initial_counts_valid = true;
+  for (const int pass : IndexRange(passes_num)) {
+    const int first_digit = get_digit(src_keys[0], pass);
+    int64_t first_digit_num = 0;
+    for (const int64_t block : blocks_range) {
+      first_digit_num += initial_counts[block][pass][first_digit];
+    }
+    if (first_digit_num == size) {
+      /* The order would not change. */
+      continue;
+    }
+
+    /* The counts are only valid for the blocks as long as the keys have not been reordered. */
+    if (initial_counts_valid) {
+      for (const int64_t block : blocks_range) {
+        block_offsets[block] = initial_counts[block][pass];
+      }
+    }
+    else {
+      threading::parallel_for(blocks_range, 1, [&](const IndexRange range) {
+        for (const int64_t block : range) {
+          DigitCounts &counts = block_offsets[block];
+          counts.fill(0);
+          for (const int64_t i : block_slice(block)) {
+            counts[get_digit(src_keys[i], pass)]++;
+          }
+        }
+      });
+    }
+
+    /* Each block writes the keys with a given digit after the keys with the same digit of the
+     * previous blocks, which keeps the sort stable. */
+    int offset = 0;
+    for (const int digit : IndexRange(digits_num)) {
+      for (const int64_t block : blocks_range) {
+        const int count = block_offsets[block][digit];
+        block_offsets[block][digit] = offset;
+        offset += count;
+      }
+    }
+
+    threading::parallel_for(blocks_range, 1, [&](const IndexRange range) {
+      for (const int64_t block : range) {
+        DigitCounts &offsets = block_offsets[block];
+        for (const int64_t i : block_slice(block)) {
+          const uint32_t key = src_keys[i];
+          const int dst_index = offsets[get_digit(key, pass)]++;
+          dst_keys[dst_index] = key;
+          dst_indices[dst_index] = src_indices[i];
+        }
+      }
+    });
+
+    std::swap(src_keys, dst_keys);
+    std::swap(src_indices, dst_indices);
+    initial_counts_valid = false;
+  }
+
+  if (src_indices.data() != indices.data()) {
+    array_utils::copy(src_indices.as_span(), indices);
+  }
+}
+
+void radix_sort_indices(const Span<float> keys, MutableSpan<int> indices)
+{
+  radix_sort_indices_impl(keys, indices);
+}
+
+void radix_sort_indices(const Span<int> keys, MutableSpan<int> indices)
+{
+  radix_sort_indices_impl(keys, indices);
+}
+
+}  // namespace blender
@@ -4,6 +4,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_implicit_sharing_key.hh"
 #include "BLI_implicit_sharing_ptr.hh"
 
 #include "testing/testing.h"
@@ -114,4 +115,53 @@ TEST(implicit_sharing, Version)
   EXPECT_LT(old_version, sharing_info->version());
 }
 
+class TestKeyA : public ImplicitSharingKey {
+ public:
+  std::unique_ptr<GenericKey> to_storable() const override
+  {
+    return std::make_unique<TestKeyA>(*this);
+  }
+};
+
+class TestKeyB : public ImplicitSharingKey {
+ public:
+  std::unique_ptr<GenericKey> to_storable() const override
+  {
+    return std::make_unique<TestKeyB>(*this);
+  }
+};
+
+TEST(implicit_sharing, Key)
+{
+  SharedDataContainer a;
+  TestKeyA key_1;
+  key_1.words.append(5);
+  key_1.add_shared_data(*a.sharing_info());
+  TestKeyA key_2;
+  key_2.words.append(5);
+  EXPECT_TRUE(key_2.add_array(true, a.sharing_info()));
+  EXPECT_EQ(key_1, key_2);
+  EXPECT_EQ(key_1.hash(), key_2.hash());
+
+  /* A stored copy of the key is still equal. */
+  const std::unique_ptr<GenericKey> stored_key = key_1.to_storable();
+  EXPECT_EQ(*stored_key, key_1);
+
+  /* Keys of different types are never equal. */
+  TestKeyB key_3;
+  key_3.words = key_1.words;
+  EXPECT_NE(key_1, key_3);
+
+  /* Changing the data changes the key. */
+  a.get_for_write();
+  TestKeyA key_4;
+  key_4.words.append(5);
+  key_4.add_shared_data(*a.sharing_info());
+  EXPECT_NE(key_1, key_4);
+
+  /* Allocated arrays can only be identified by their sharing info. */
+  EXPECT_TRUE(key_4.add_array(false, nullptr));
+  EXPECT_FALSE(key_4.add_array(true, nullptr));
+}
+
 }  // namespace blender::tests
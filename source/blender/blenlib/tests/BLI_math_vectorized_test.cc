@@ -0,0 +1,102 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_math_vectorized.hh"
+
+#include <cmath>
+#include <limits>
+
+namespace blender::tests {
+
+/* Allow a small absolute error for results close to zero, where the relative error of the range
+ * reduction is large but meaningless. */
+static void expect_close(const float result, const float expected)
+{
+  if (std::isnan(expected)) {
+    EXPECT_TRUE(std::isnan(result));
+    return;
+  }
+  if (std::isinf(expected)) {
+    EXPECT_EQ(result, expected);
+    return;
+  }
+  EXPECT_NEAR(result, expected, std::max(std::abs(expected) * 4e-7f, 1e-7f));
+}
+
+static Array<float> test_inputs()
+{
+  Array<float> values(10003);
+  for (const int i : values.index_range()) {
+    values[i] = (float(i) / values.size() - 0.5f) * 200.0f;
+  }
+  return values;
+}
+
+TEST(math_vectorized, sin_array)
+{
+  const Array<float> values = test_inputs();
+  Array<float> results(values.size());
+  math::sin_array(values.data(), results.data(), values.size());
+  for (const int i : values.index_range()) {
+    expect_close(results[i], sinf(values[i]));
+  }
+}
+
+TEST(math_vectorized, cos_array)
+{
+  const Array<float> values = test_inputs();
+  Array<float> results(values.size());
+  math::cos_array(values.data(), results.data(), values.size());
+  for (const int i : values.index_range()) {
+    expect_close(results[i], cosf(values[i]));
+  }
+}
+
+TEST(math_vectorized, exp_array)
+{
+  const Array<float> values = test_inputs();
+  Array<float> results(values.size());
+  math::exp_array(values.data(), results.data(), values.size());
+  for (const int i : values.index_range()) {
+    expect_close(results[i], expf(values[i]));
+  }
+}
+
+TEST(math_vectorized, special_values)
+{
+  const float inf = std::numeric_limits<float>::infinity();
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const Array<float> values = {0.0f, -0.0f, 1e9f, -1e9f, inf, -inf, nan, 100.0f, -100.0f};
+
+  Array<float> results(values.size());
+  math::sin_array(values.data(), results.data(), values.size());
+  for (const int i : values.index_range()) {
+    expect_close(results[i], sinf(values[i]));
+  }
+  EXPECT_TRUE(std::signbit(results[1]));
+
+  math::cos_array(values.data(), results.data(), values.size());
+  for (const int i : values.index_range()) {
+    expect_close(results[i], cosf(values[i]));
+  }
+
+  math::exp_array(values.data(), results.data(), values.size());
+  for (const int i : values.index_range()) {
+    expect_close(results[i], expf(values[i]));
+  }
+}
+
+TEST(math_vectorized, in_place)
+{
+  Array<float> values = {0.5f, 1.0f, 2.0f};
+  math::sin_array(values.data(), values.data(), values.size());
+  expect_close(values[0], sinf(0.5f));
+  expect_close(values[1], sinf(1.0f));
+  expect_close(values[2], sinf(2.0f));
+}
+
+}  // namespace blender::tests
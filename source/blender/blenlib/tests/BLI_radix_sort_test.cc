@@ -0,0 +1,98 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "BLI_array.hh"
+#include "BLI_array_utils.hh"
+#include "BLI_radix_sort.hh"
+#include "BLI_rand.hh"
+
+namespace blender::tests {
+
+template<typename T> static Array<int> stable_sorted_indices(const Span<T> keys)
+{
+  Array<int> indices(keys.size());
+  array_utils::fill_index_range<int>(indices);
+  std::stable_sort(indices.begin(), indices.end(), [&](const int a, const int b) {
+    return keys[a] < keys[b];
+  });
+  return indices;
+}
+
+template<typename T> static Array<int> radix_sorted_indices(const Span<T> keys)
+{
+  Array<int> indices(keys.size());
+  array_utils::fill_index_range<int>(indices);
+  radix_sort_indices(keys, indices);
+  return indices;
+}
+
+TEST(radix_sort, Empty)
+{
+  Array<int> indices;
+  radix_sort_indices(Span<float>(), indices);
+  EXPECT_TRUE(indices.is_empty());
+}
+
+TEST(radix_sort, SmallFloat)
+{
+  const Array<float> keys = {3.0f, -1.0f, 2.5f, -1.0f, 0.0f, -0.0f, 100.0f};
+  const Array<int> indices = radix_sorted_indices(keys.as_span());
+  EXPECT_EQ_ARRAY(Span({1, 3, 4, 5, 2, 0, 6}).data(), indices.data(), 7);
+}
+
+TEST(radix_sort, LargeFloat)
+{
+  RandomNumberGenerator rng(42);
+  Array<float> keys(300000);
+  for (float &key : keys) {
+    /* Use a small set of values to get many equal keys. */
+    key = float(rng.get_int32(1000) - 500) * 0.25f;
+  }
+  keys[10] = -0.0f;
+  keys[20] = std::numeric_limits<float>::infinity();
+  keys[30] = -std::numeric_limits<float>::infinity();
+  const Array<int> expected = stable_sorted_indices(keys.as_span());
+  const Array<int> indices = radix_sorted_indices(keys.as_span());
+  EXPECT_EQ_ARRAY(expected.data(), indices.data(), keys.size());
+}
+
+TEST(radix_sort, LargeInt)
+{
+  RandomNumberGenerator rng(7);
+  Array<int> keys(200000);
+  for (int &key : keys) {
+    key = rng.get_int32() - std::numeric_limits<int>::max() / 2;
+  }
+  keys[5] = std::numeric_limits<int>::min();
+  keys[6] = std::numeric_limits<int>::max();
+  const Array<int> expected = stable_sorted_indices(keys.as_span());
+  const Array<int> indices = radix_sorted_indices(keys.as_span());
+  EXPECT_EQ_ARRAY(expected.data(), indices.data(), keys.size());
+}
+
+TEST(radix_sort, SortedIndexSubset)
+{
+  /* Only every third index is sorted, and some digits are the same for all keys. */
+  Array<int> keys(100000);
+  for (const int i : keys.index_range()) {
+    keys[i] = (i * 7919) % 4096;
+  }
+  Array<int> indices(keys.size() / 3);
+  for (const int i : indices.index_range()) {
+    indices[i] = i * 3;
+  }
+  radix_sort_indices(keys.as_span(), indices);
+  for (const int i : indices.index_range().drop_front(1)) {
+    const int a = indices[i - 1];
+    const int b = indices[i];
+    EXPECT_TRUE(keys[a] < keys[b] || (keys[a] == keys[b] && a < b));
+  }
+}
+
+}  // namespace blender::tests
@@ -7,6 +7,8 @@
  */
 
 #define DNA_DEPRECATED_ALLOW
+/* Define macros in `DNA_genfile.h`. */
+#define DNA_GENFILE_VERSIONING_MACROS
 
 #include <fmt/format.h>
 
@@ -15,8 +17,13 @@
 #include "DNA_defaults.h"
 #include "DNA_light_types.h"
 #include "DNA_mesh_types.h"
+#include "DNA_modifier_types.h"
 #include "DNA_sequence_types.h"
 
+#include "DNA_genfile.h"
+
+#undef DNA_GENFILE_VERSIONING_MACROS
+
 #include "BLI_listbase.h"
 #include "BLI_math_vector.h"
 #include "BLI_set.hh"
@@ -5159,7 +5166,7 @@ static void version_set_default_bone_drawtype(Main *bmain)
   }
 }
 
-void blo_do_versions_450(FileData * /*fd*/, Library * /*lib*/, Main *bmain)
+void blo_do_versions_450(FileData *fd, Library * /*lib*/, Main *bmain)
 {
 
   if (!MAIN_VERSION_FILE_ATLEAST(bmain, 405, 2)) {
@@ -6068,6 +6075,22 @@ void blo_do_versions_450(FileData * /*fd*/, Library * /*lib*/, Main *bmain)
     FOREACH_NODETREE_END;
   }
 
+  if (!MAIN_VERSION_FILE_ATLEAST(bmain, 405, 81)) {
+    if (!DNA_struct_member_exists(
+            fd->filesdna, "SubsurfModifierData", "float", "adaptive_pixel_size"))
+    {
+      const SubsurfModifierData *default_smd = DNA_struct_default_get(SubsurfModifierData);
+      LISTBASE_FOREACH (Object *, object, &bmain->objects) {
+        LISTBASE_FOREACH (ModifierData *, md, &object->modifiers) {
+          if (md->type == eModifierType_Subsurf) {
+            SubsurfModifierData *smd = reinterpret_cast<SubsurfModifierData *>(md);
+            smd->adaptive_pixel_size = default_smd->adaptive_pixel_size;
+          }
+        }
+      }
+    }
+  }
+
   /* Always run this versioning (keep at the bottom of the function). Meshes are written with the
    * legacy format which always needs to be converted to the new format on file load. To be moved
    * to a subversion check in 5.0. */
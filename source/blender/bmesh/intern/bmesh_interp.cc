@@ -19,6 +19,7 @@
 #include "BLI_math_vector.h"
 #include "BLI_memarena.h"
 #include "BLI_task.h"
+#include "BLI_vector.hh"
 
 #include "BKE_attribute.h"
 #include "BKE_customdata.hh"
@@ -27,7 +28,9 @@
 #include "bmesh.hh"
 #include "intern/bmesh_private.hh"
 
+using blender::Span;
 using blender::StringRef;
+using blender::Vector;
 
 /* edge and vertex share, currently there's no need to have different logic */
 static void bm_data_interp_from_elem(CustomData *data_layer,
@@ -765,7 +768,9 @@ void BM_vert_interp_from_face(BMesh *bm, BMVert *v_dst, const BMFace *f_src)
 
 static void update_data_blocks(BMesh *bm, CustomData *olddata, CustomData *data)
 {
-  const BMCustomDataCopyMap cd_map = CustomData_bmesh_copy_map_calc(*olddata, *data);
+  /* The old blocks are discarded along with their memory pool, so their layer data can be moved
+   * to the new blocks instead of being copied and freed. */
+  const BMCustomDataMoveMap cd_map = CustomData_bmesh_move_map_calc(*olddata, *data);
 
   BMIter iter;
   BLI_mempool *oldpool = olddata->pool;
@@ -778,8 +783,7 @@ static void update_data_blocks(BMesh *bm, CustomData *olddata, CustomData *data)
 
     BM_ITER_MESH (eve, &iter, bm, BM_VERTS_OF_MESH) {
       block = nullptr;
-      CustomData_bmesh_copy_block(*data, cd_map, eve->head.data, &block);
-      CustomData_bmesh_free_block(olddata, &eve->head.data);
+      CustomData_bmesh_move_block(*data, cd_map, eve->head.data, &block);
       eve->head.data = block;
     }
   }
@@ -790,8 +794,7 @@ static void update_data_blocks(BMesh *bm, CustomData *olddata, CustomData *data)
 
     BM_ITER_MESH (eed, &iter, bm, BM_EDGES_OF_MESH) {
       block = nullptr;
-      CustomData_bmesh_copy_block(*data, cd_map, eed->head.data, &block);
-      CustomData_bmesh_free_block(olddata, &eed->head.data);
+      CustomData_bmesh_move_block(*data, cd_map, eed->head.data, &block);
       eed->head.data = block;
     }
   }
@@ -804,8 +807,7 @@ static void update_data_blocks(BMesh *bm, CustomData *olddata, CustomData *data)
     BM_ITER_MESH (efa, &iter, bm, BM_FACES_OF_MESH) {
       BM_ITER_ELEM (l, &liter, efa, BM_LOOPS_OF_FACE) {
         block = nullptr;
-        CustomData_bmesh_copy_block(*data, cd_map, l->head.data, &block);
-        CustomData_bmesh_free_block(olddata, &l->head.data);
+        CustomData_bmesh_move_block(*data, cd_map, l->head.data, &block);
         l->head.data = block;
       }
     }
@@ -817,8 +819,7 @@ static void update_data_blocks(BMesh *bm, CustomData *olddata, CustomData *data)
 
     BM_ITER_MESH (efa, &iter, bm, BM_FACES_OF_MESH) {
       block = nullptr;
-      CustomData_bmesh_copy_block(*data, cd_map, efa->head.data, &block);
-      CustomData_bmesh_free_block(olddata, &efa->head.data);
+      CustomData_bmesh_move_block(*data, cd_map, efa->head.data, &block);
       efa->head.data = block;
     }
   }
@@ -876,31 +877,52 @@ void BM_data_layer_ensure_named(BMesh *bm, CustomData *data, int type, const Str
   }
 }
 
+void BM_data_layers_ensure_named(BMesh *bm,
+                                 CustomData *data,
+                                 int type,
+                                 const Span<std::string> names)
+{
+  Vector<StringRef> missing_names;
+  for (const std::string &name : names) {
+    if (CustomData_get_named_layer_index(data, eCustomDataType(type), name) == -1) {
+      missing_names.append_non_duplicates(name);
+    }
+  }
+  if (missing_names.is_empty()) {
+    return;
+  }
+
+  CustomData olddata = *data;
+  olddata.layers = (olddata.layers) ?
+                       static_cast<CustomDataLayer *>(MEM_dupallocN(olddata.layers)) :
+                       nullptr;
+  /* The pool is now owned by `olddata` and must not be shared. */
+  data->pool = nullptr;
+
+  for (const StringRef name : missing_names) {
+    CustomData_add_layer_named(data, eCustomDataType(type), CD_SET_DEFAULT, 0, name);
+  }
+
+  /* Update the element blocks only once for all new layers. */
+  update_data_blocks(bm, &olddata, data);
+  if (olddata.layers) {
+    MEM_freeN(olddata.layers);
+  }
+}
+
 void BM_uv_map_attr_select_and_pin_ensure(BMesh *bm)
 {
   const int nr_uv_layers = CustomData_number_of_layers(&bm->ldata, CD_PROP_FLOAT2);
+  /* Gather the names first: adding layers invalidates the UV map names in the layer array. */
+  Vector<std::string> names;
   for (int l = 0; l < nr_uv_layers; l++) {
-    /* NOTE: you can't re-use the return-value of #CustomData_get_layer_name()
-     * because adding layers can invalidate that. */
+    const char *uv_map_name = CustomData_get_layer_name(&bm->ldata, CD_PROP_FLOAT2, l);
     char name[MAX_CUSTOMDATA_LAYER_NAME];
-    BM_data_layer_ensure_named(
-        bm,
-        &bm->ldata,
-        CD_PROP_BOOL,
-        BKE_uv_map_vert_select_name_get(CustomData_get_layer_name(&bm->ldata, CD_PROP_FLOAT2, l),
-                                        name));
-    BM_data_layer_ensure_named(
-        bm,
-        &bm->ldata,
-        CD_PROP_BOOL,
-        BKE_uv_map_edge_select_name_get(CustomData_get_layer_name(&bm->ldata, CD_PROP_FLOAT2, l),
-                                        name));
-    BM_data_layer_ensure_named(
-        bm,
-        &bm->ldata,
-        CD_PROP_BOOL,
-        BKE_uv_map_pin_name_get(CustomData_get_layer_name(&bm->ldata, CD_PROP_FLOAT2, l), name));
+    names.append_as(BKE_uv_map_vert_select_name_get(uv_map_name, name));
+    names.append_as(BKE_uv_map_edge_select_name_get(uv_map_name, name));
+    names.append_as(BKE_uv_map_pin_name_get(uv_map_name, name));
   }
+  BM_data_layers_ensure_named(bm, &bm->ldata, CD_PROP_BOOL, names);
 }
 
 void BM_uv_map_attr_vert_select_ensure(BMesh *bm, const StringRef uv_map_name)
@@ -8,6 +8,9 @@
  * \ingroup bmesh
  */
 
+#include <string>
+
+#include "BLI_span.hh"
 #include "BLI_string_ref.hh"
 
 #include "bmesh_class.hh"
@@ -65,6 +68,13 @@ void BM_data_interp_face_vert_edge(
 void BM_data_layer_add(BMesh *bm, CustomData *data, int type);
 void BM_data_layer_add_named(BMesh *bm, CustomData *data, int type, blender::StringRef name);
 void BM_data_layer_ensure_named(BMesh *bm, CustomData *data, int type, blender::StringRef name);
+/**
+ * Add all layers from \a names that don't exist yet, updating the element data blocks only once.
+ */
+void BM_data_layers_ensure_named(BMesh *bm,
+                                 CustomData *data,
+                                 int type,
+                                 blender::Span<std::string> names);
 bool BM_data_layer_has_named(const BMesh *bm,
                              const CustomData *data,
                              int type,
@@ -4,7 +4,13 @@
 
 #include "testing/testing.h"
 
+#include "DNA_meshdata_types.h"
+
 #include "BLI_math_vector.h"
+
+#include "BKE_customdata.hh"
+#include "BKE_deform.hh"
+
 #include "bmesh.hh"
 
 TEST(bmesh_core, BMVertCreate)
@@ -41,3 +47,37 @@ TEST(bmesh_core, BMVertCreate)
   EXPECT_EQ(BM_mesh_elem_count(bm, BM_VERT), 3);
   BM_mesh_free(bm);
 }
+
+TEST(bmesh_core, DataLayerAddRemoveKeepsData)
+{
+  BMeshCreateParams bmesh_create_params{};
+  BMesh *bm = BM_mesh_create(&bm_mesh_allocsize_default, &bmesh_create_params);
+  BM_data_layer_add(bm, &bm->vdata, CD_MDEFORMVERT);
+  BM_data_layer_add_named(bm, &bm->vdata, CD_PROP_FLOAT, "a");
+
+  const float co[3] = {0.0f, 0.0f, 0.0f};
+  BMVert *v = BM_vert_create(bm, co, nullptr, BM_CREATE_NOP);
+  int cd_dvert_offset = CustomData_get_offset(&bm->vdata, CD_MDEFORMVERT);
+  MDeformVert *dvert = static_cast<MDeformVert *>(BM_ELEM_CD_GET_VOID_P(v, cd_dvert_offset));
+  BKE_defvert_ensure_index(dvert, 2)->weight = 0.5f;
+  BM_ELEM_CD_SET_FLOAT(v, CustomData_get_offset_named(&bm->vdata, CD_PROP_FLOAT, "a"), 2.0f);
+
+  /* Adding several layers at once, including duplicates and existing layers. */
+  BM_data_layers_ensure_named(bm, &bm->vdata, CD_PROP_FLOAT, {"b", "a", "c", "b"});
+  EXPECT_EQ(CustomData_number_of_layers(&bm->vdata, CD_PROP_FLOAT), 3);
+  EXPECT_EQ(BM_ELEM_CD_GET_FLOAT(v, CustomData_get_offset_named(&bm->vdata, CD_PROP_FLOAT, "b")),
+            0.0f);
+
+  EXPECT_TRUE(BM_data_layer_free_named(bm, &bm->vdata, "b"));
+  EXPECT_EQ(BM_ELEM_CD_GET_FLOAT(v, CustomData_get_offset_named(&bm->vdata, CD_PROP_FLOAT, "a")),
+            2.0f);
+  cd_dvert_offset = CustomData_get_offset(&bm->vdata, CD_MDEFORMVERT);
+  dvert = static_cast<MDeformVert *>(BM_ELEM_CD_GET_VOID_P(v, cd_dvert_offset));
+  EXPECT_EQ(BKE_defvert_find_weight(dvert, 2), 0.5f);
+
+  /* Removing a layer that owns memory frees it. */
+  BM_data_layer_free(bm, &bm->vdata, CD_MDEFORMVERT);
+  EXPECT_EQ(BM_ELEM_CD_GET_FLOAT(v, CustomData_get_offset_named(&bm->vdata, CD_PROP_FLOAT, "a")),
+            2.0f);
+  BM_mesh_free(bm);
+}
@@ -0,0 +1,69 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Evaluation of many frames at once on independent copies of a dependency graph. This is meant
+ * for operations like motion path calculation or exporters, which need the evaluated state of a
+ * set of data-blocks at every frame of a range. Every copy evaluates a contiguous part of the
+ * range, so the frames are evaluated concurrently while each copy still benefits from
+ * incremental updates between consecutive frames.
+ *
+ * Only data that is not history dependent can be evaluated this way: simulations and point caches
+ * expect frames to be evaluated in order on a single graph. See #is_history_dependent.
+ */
+
+#include "BLI_function_ref.hh"
+#include "BLI_span.hh"
+
+#include "DEG_depsgraph.hh"
+
+namespace blender::deg::multi_frame {
+
+struct EvalParams {
+  Main *bmain = nullptr;
+  Scene *scene = nullptr;
+  ViewLayer *view_layer = nullptr;
+  eEvaluationMode mode = DAG_EVAL_VIEWPORT;
+
+  /**
+   * Called once for every copy of the graph to build its relations, for example with
+   * #DEG_graph_build_from_ids. Always called from the calling thread.
+   */
+  FunctionRef<void(Depsgraph &graph)> build_fn;
+
+  /**
+   * Upper bound for the memory used by all evaluated graph copies together, in bytes. The memory
+   * used by a single copy is measured after evaluating the first frame. Zero means the number of
+   * copies is only limited by #max_graphs.
+   */
+  int64_t memory_limit = 0;
+
+  /** Maximum number of graph copies. Zero uses the number of available threads. */
+  int max_graphs = 0;
+};
+
+/**
+ * Evaluate all given frames and call \a fn with a graph that has been evaluated at that frame.
+ * The callback is called from multiple threads at the same time, but never concurrently for the
+ * same graph. It must not modify original data that other frames depend on.
+ *
+ * \return False without evaluating anything when the built graph is history dependent. The frames
+ * then have to be evaluated in order on a single graph instead.
+ */
+[[nodiscard]] bool evaluate_frames(const EvalParams &params,
+                     Span<int> frames,
+                     FunctionRef<void(Depsgraph &graph, int frame)> fn);
+
+/**
+ * Check whether the evaluated state of any data-block in the graph depends on previously evaluated
+ * frames (point caches, rigid body simulation, simulation zones). Such graphs can't be evaluated
+ * with #evaluate_frames.
+ */
+bool is_history_dependent(const Depsgraph &graph);
+
+}  // namespace blender::deg::multi_frame
@@ -0,0 +1,161 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Evaluation of multiple frames on independent dependency graph copies.
+ */
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_listbase.h"
+#include "BLI_task.hh"
+#include "BLI_threads.h"
+#include "BLI_vector.hh"
+
+#include "BKE_node_runtime.hh"
+#include "BKE_pointcache.h"
+
+#include "DNA_modifier_types.h"
+#include "DNA_node_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_multi_frame.hh"
+
+#ifdef WITH_PYTHON
+#  include "BPY_extern.hh"
+#endif
+
+#include "intern/node/deg_node_id.hh"
+
+#include "depsgraph.hh"
+
+namespace blender::deg::multi_frame {
+
+static ::Depsgraph *graph_new(const EvalParams &params)
+{
+  ::Depsgraph *graph = DEG_graph_new(params.bmain, params.scene, params.view_layer, params.mode);
+  params.build_fn(*graph);
+  return graph;
+}
+
+static void evaluate_frame(::Depsgraph &graph,
+                           const int frame,
+                           const FunctionRef<void(::Depsgraph &graph, int frame)> fn)
+{
+  DEG_evaluate_on_framechange(&graph, float(frame));
+  fn(graph, frame);
+}
+
+bool evaluate_frames(const EvalParams &params,
+                     const Span<int> frames,
+                     const FunctionRef<void(::Depsgraph &graph, int frame)> fn)
+{
+  if (frames.is_empty()) {
+    return true;
+  }
+
+  /* Evaluate the first frame on the calling thread to measure how much memory a fully evaluated
+   * copy of the graph uses. */
+  const int64_t memory_before = int64_t(MEM_get_memory_in_use());
+  Vector<::Depsgraph *> graphs;
+  graphs.append(graph_new(params));
+  if (is_history_dependent(*graphs.first())) {
+    DEG_graph_free(graphs.first());
+    return false;
+  }
+  evaluate_frame(*graphs.first(), frames.first(), fn);
+  const int64_t graph_memory = std::max<int64_t>(int64_t(MEM_get_memory_in_use()) - memory_before,
+                                                 1);
+
+  const Span<int> remaining_frames = frames.drop_front(1);
+  int64_t graphs_num = params.max_graphs > 0 ? params.max_graphs : BLI_system_thread_count();
+  graphs_num = std::min<int64_t>(graphs_num, remaining_frames.size());
+  if (params.memory_limit > 0) {
+    graphs_num = std::min<int64_t>(graphs_num, params.memory_limit / graph_memory);
+  }
+  graphs_num = std::max<int64_t>(graphs_num, 1);
+
+  /* Building a graph may modify original data (e.g. tagging relations), so it is done on the
+   * calling thread. Only the evaluation happens in parallel. */
+  for ([[maybe_unused]] const int64_t i : IndexRange(1, graphs_num - 1)) {
+    graphs.append(graph_new(params));
+  }
+
+#ifdef WITH_PYTHON
+  /* The caller may hold the GIL, e.g. when called from an operator that runs in a script. Release
+   * it, otherwise evaluating Python drivers on the worker threads deadlocks. */
+  BPy_BEGIN_ALLOW_THREADS;
+#endif
+
+  /* Give every graph a contiguous range of frames, so it can benefit from incremental updates. */
+  threading::parallel_for(graphs.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t graph_index : range) {
+      const int64_t start = remaining_frames.size() * graph_index / graphs.size();
+      const int64_t end = remaining_frames.size() * (graph_index + 1) / graphs.size();
+      for (const int frame : remaining_frames.slice(start, end - start)) {
+        evaluate_frame(*graphs[graph_index], frame, fn);
+      }
+    }
+  });
+
+#ifdef WITH_PYTHON
+  BPy_END_ALLOW_THREADS;
+#endif
+
+  for (::Depsgraph *graph : graphs) {
+    DEG_graph_free(graph);
+  }
+  return true;
+}
+
+static bool object_is_history_dependent(Scene *scene, Object *object)
+{
+  if (BKE_ptcache_object_has(scene, object, 0)) {
+    return true;
+  }
+  LISTBASE_FOREACH (const ModifierData *, md, &object->modifiers) {
+    if (md->type != eModifierType_Nodes) {
+      continue;
+    }
+    const NodesModifierData *nmd = reinterpret_cast<const NodesModifierData *>(md);
+    if (nmd->node_group &&
+        (nmd->node_group->runtime->runtime_flag & NTREE_RUNTIME_FLAG_HAS_SIMULATION_ZONE))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool is_history_dependent(const ::Depsgraph &graph)
+{
+  const deg::Depsgraph &deg_graph = reinterpret_cast<const deg::Depsgraph &>(graph);
+  for (const IDNode *id_node : deg_graph.id_nodes) {
+    switch (id_node->id_type) {
+      case ID_SCE: {
+        const Scene *scene = reinterpret_cast<const Scene *>(id_node->id_orig);
+        if (scene->rigidbody_world != nullptr) {
+          return true;
+        }
+        break;
+      }
+      case ID_OB: {
+        Object *object = reinterpret_cast<Object *>(id_node->id_orig);
+        if (object_is_history_dependent(deg_graph.scene, object)) {
+          return true;
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  return false;
+}
+
+}  // namespace blender::deg::multi_frame
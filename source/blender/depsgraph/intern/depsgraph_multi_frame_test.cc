@@ -0,0 +1,176 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "tests/blendfile_loading_base_test.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_array.hh"
+#include "BLI_listbase.h"
+#include "BLI_math_matrix_types.hh"
+#include "BLI_string.h"
+#include "BLI_vector.hh"
+
+#include "BKE_anim_data.hh"
+#include "BKE_collection.hh"
+#include "BKE_fcurve.hh"
+#include "BKE_layer.hh"
+#include "BKE_main.hh"
+#include "BKE_mesh.h"
+#include "BKE_modifier.hh"
+#include "BKE_object.hh"
+#include "BKE_scene.hh"
+
+#include "DNA_anim_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_build.hh"
+#include "DEG_depsgraph_multi_frame.hh"
+#include "DEG_depsgraph_query.hh"
+
+#include <atomic>
+#include <fmt/format.h>
+
+namespace blender::deg::tests {
+
+class MultiFrameTest : public BlendfileLoadingBaseTest {
+ protected:
+  Main *bmain = nullptr;
+  Scene *scene = nullptr;
+  ViewLayer *view_layer = nullptr;
+  Vector<Object *> objects;
+
+  void SetUp() override
+  {
+    bmain = BKE_main_new();
+    scene = BKE_scene_add(bmain, "Scene");
+    view_layer = BKE_view_layer_default_view(scene);
+  }
+
+  void TearDown() override
+  {
+    BlendfileLoadingBaseTest::TearDown();
+    BKE_main_free(bmain);
+  }
+
+  /* Add an empty whose X location is driven by a simple expression of the frame. */
+  void add_animated_object(const int index)
+  {
+    Object *object = BKE_object_add_only_object(bmain, OB_EMPTY, "Empty");
+    BKE_collection_object_add(bmain, scene->master_collection, object);
+
+    AnimData *adt = BKE_animdata_ensure_id(&object->id);
+    FCurve *fcu = BKE_fcurve_create();
+    fcu->rna_path = BLI_strdup("location");
+    fcu->array_index = 0;
+    fcu->driver = MEM_callocN<ChannelDriver>(__func__);
+    fcu->driver->type = DRIVER_TYPE_PYTHON;
+    STRNCPY(fcu->driver->expression, fmt::format("frame * 0.5 + {}", index).c_str());
+    BLI_addtail(&adt->drivers, fcu);
+
+    objects.append(object);
+  }
+
+  Vector<ID *> object_ids() const
+  {
+    Vector<ID *> ids;
+    for (Object *object : objects) {
+      ids.append(&object->id);
+    }
+    return ids;
+  }
+
+  deg::multi_frame::EvalParams eval_params(const FunctionRef<void(Depsgraph &graph)> build_fn)
+  {
+    deg::multi_frame::EvalParams params;
+    params.bmain = bmain;
+    params.scene = scene;
+    params.view_layer = view_layer;
+    params.mode = DAG_EVAL_VIEWPORT;
+    params.build_fn = build_fn;
+    return params;
+  }
+};
+
+TEST_F(MultiFrameTest, MatchesSerialEvaluation)
+{
+  for (const int i : IndexRange(8)) {
+    add_animated_object(i);
+  }
+  BKE_view_layer_synced_ensure(scene, view_layer);
+
+  const IndexRange frames_range(1, 40);
+  Array<int> frames(frames_range.size());
+  for (const int i : frames_range.index_range()) {
+    frames[i] = frames_range[i];
+  }
+
+  /* Every frame is evaluated exactly once, so the results can be written without locking. */
+  Array<float3> parallel_positions(frames.size() * objects.size(), float3(0.0f));
+  std::atomic<int> frames_evaluated = 0;
+  const Vector<ID *> ids = object_ids();
+  const auto build_fn = [&](Depsgraph &graph) { DEG_graph_build_from_ids(&graph, ids); };
+  deg::multi_frame::EvalParams params = eval_params(build_fn);
+  params.max_graphs = 4;
+  EXPECT_TRUE(deg::multi_frame::evaluate_frames(
+      params, frames, [&](Depsgraph &graph, const int frame) {
+        const int frame_index = frame - frames_range.start();
+        for (const int i : objects.index_range()) {
+          const Object *object_eval = DEG_get_evaluated(&graph, objects[i]);
+          parallel_positions[frame_index * objects.size() + i] =
+              object_eval->object_to_world().location();
+        }
+        frames_evaluated++;
+      }));
+  EXPECT_EQ(frames_evaluated.load(), frames.size());
+
+  depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_VIEWPORT);
+  DEG_graph_build_from_view_layer(depsgraph);
+  Array<float3> serial_positions(frames.size() * objects.size());
+  for (const int frame_index : frames.index_range()) {
+    DEG_evaluate_on_framechange(depsgraph, float(frames[frame_index]));
+    for (const int i : objects.index_range()) {
+      const Object *object_eval = DEG_get_evaluated(depsgraph, objects[i]);
+      serial_positions[frame_index * objects.size() + i] =
+          object_eval->object_to_world().location();
+    }
+  }
+
+  EXPECT_EQ_ARRAY(
+      serial_positions.data(), parallel_positions.data(), int(serial_positions.size()));
+  /* Check that the drivers were evaluated at all. */
+  EXPECT_FLOAT_EQ(parallel_positions.last().x, float(frames.last()) * 0.5f + 7.0f);
+}
+
+TEST_F(MultiFrameTest, RejectsHistoryDependentGraph)
+{
+  add_animated_object(0);
+  Object *object = BKE_object_add_only_object(bmain, OB_MESH, "Cloth");
+  object->data = BKE_mesh_add(bmain, "Mesh");
+  BKE_collection_object_add(bmain, scene->master_collection, object);
+  objects.append(object);
+  /* The cloth simulation has a point cache, so every frame depends on the previous one. */
+  ModifierData *md = BKE_modifier_new(eModifierType_Cloth);
+  BLI_addtail(&object->modifiers, md);
+  BKE_modifiers_persistent_uid_init(*object, *md);
+  BKE_view_layer_synced_ensure(scene, view_layer);
+
+  const Array<int> frames = {1, 2, 3, 4};
+  bool callback_called = false;
+  const Vector<ID *> ids = object_ids();
+  const auto build_fn = [&](Depsgraph &graph) { DEG_graph_build_from_ids(&graph, ids); };
+  EXPECT_FALSE(deg::multi_frame::evaluate_frames(
+      eval_params(build_fn), frames, [&](Depsgraph & /*graph*/, const int /*frame*/) {
+        callback_called = true;
+      }));
+  EXPECT_FALSE(callback_called);
+}
+
+}  // namespace blender::deg::tests
@@ -117,23 +117,14 @@ static void extract_tan_init_common(const MeshRenderData &mr,
                                      &tangent_mask);
     }
     else {
-      BKE_mesh_calc_loop_tangent_ex(mr.vert_positions,
-                                    mr.faces,
-                                    mr.corner_verts,
-                                    mr.mesh->corner_tris(),
-                                    mr.mesh->corner_tri_faces(),
-                                    mr.sharp_faces,
-                                    cd_ldata,
-                                    calc_active_tangent,
-                                    r_tangent_names,
-                                    tan_len,
-                                    mr.mesh->vert_normals(),
-                                    mr.face_normals,
-                                    mr.corner_normals,
-                                    orco,
-                                    r_loop_data,
-                                    mr.corner_verts.size(),
-                                    &tangent_mask);
+      BKE_mesh_calc_loop_tangents_cached(*mr.mesh,
+                                         calc_active_tangent,
+                                         r_tangent_names,
+                                         tan_len,
+                                         orco,
+                                         r_loop_data,
+                                         mr.corner_verts.size(),
+                                         &tangent_mask);
     }
   }
 
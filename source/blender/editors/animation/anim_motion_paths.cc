@@ -10,11 +10,14 @@
 
 #include <cstdlib>
 
+#include "BLI_array_utils.hh"
 #include "BLI_listbase.h"
 #include "BLI_listbase_wrapper.hh"
 #include "BLI_math_matrix.h"
 #include "BLI_math_matrix.hh"
 #include "BLI_math_vector.h"
+#include "BLI_system.h"
+#include "BLI_threads.h"
 
 #include "DNA_anim_types.h"
 #include "DNA_armature_types.h"
@@ -27,6 +30,7 @@
 
 #include "DEG_depsgraph.hh"
 #include "DEG_depsgraph_build.hh"
+#include "DEG_depsgraph_multi_frame.hh"
 #include "DEG_depsgraph_query.hh"
 
 #include "GPU_batch.hh"
@@ -131,11 +135,14 @@ void animviz_free_motionpath_targets(blender::Vector<MPathTarget *> &targets)
 
 /* ........ */
 
-/* Perform baking for the targets on the current frame. */
+/* Perform baking for the targets on the current frame.
+ * When `update_eval_paths` is false, the motion paths of the evaluated objects are left untouched,
+ * which is required when baking from multiple threads on temporary dependency graphs. */
 static void motionpaths_calc_bake_targets(blender::Span<MPathTarget *> targets,
                                           int cframe,
                                           Depsgraph *depsgraph,
-                                          Object *camera)
+                                          Object *camera,
+                                          const bool update_eval_paths)
 {
   using namespace blender;
   /* For each target, check if it can be baked on the current frame. */
@@ -152,7 +159,7 @@ static void motionpaths_calc_bake_targets(blender::Span<MPathTarget *> targets,
     /* Get the relevant cache vert to write to. */
     bMotionPathVert *mpv = mpath->points + (cframe - mpath->start_frame);
 
-    Object *ob_eval = mpt->ob_eval;
+    Object *ob_eval = update_eval_paths ? mpt->ob_eval : DEG_get_evaluated(depsgraph, mpt->ob);
 
     /* Lookup evaluated pose channel, here because the depsgraph
      * evaluation can change them so they are not cached in mpt. */
@@ -196,6 +203,10 @@ static void motionpaths_calc_bake_targets(blender::Span<MPathTarget *> targets,
       mpv->flag &= ~MOTIONPATH_VERT_KEY;
     }
 
+    if (!update_eval_paths) {
+      continue;
+    }
+
     /* Incremental update on evaluated object if possible, for fast updating
      * while dragging in transform. */
     bMotionPath *mpath_eval = nullptr;
@@ -217,6 +228,46 @@ static void motionpaths_calc_bake_targets(blender::Span<MPathTarget *> targets,
   }
 }
 
+/* Only use temporary dependency graphs when there are enough frames to compensate for the cost of
+ * building and evaluating them from scratch. */
+#define MOTIONPATH_PARALLEL_MIN_FRAMES 32
+
+/* Bake the frame range on multiple temporary copies of the dependency graph at the same time.
+ * Returns false when the paths have to be calculated on the given dependency graph instead. */
+static bool motionpaths_calc_parallel(Depsgraph *depsgraph,
+                                      Main *bmain,
+                                      Scene *scene,
+                                      blender::Span<MPathTarget *> targets,
+                                      const int sfra,
+                                      const int efra)
+{
+  using namespace blender;
+  const int frames_num = efra - sfra + 1;
+  if (frames_num < MOTIONPATH_PARALLEL_MIN_FRAMES || BLI_system_thread_count() < 2) {
+    return false;
+  }
+  Array<ID *> ids(targets.size());
+  for (const int i : targets.index_range()) {
+    ids[i] = &targets[i]->ob->id;
+  }
+  Array<int> frames(frames_num);
+  array_utils::fill_index_range<int>(frames, sfra);
+
+  deg::multi_frame::EvalParams params;
+  params.bmain = bmain;
+  params.scene = scene;
+  params.view_layer = DEG_get_input_view_layer(depsgraph);
+  params.mode = DEG_get_mode(depsgraph);
+  params.build_fn = [&](Depsgraph &graph) { DEG_graph_build_from_ids(&graph, ids); };
+  /* Leave most of the memory to the rest of Blender. */
+  params.memory_limit = int64_t(BLI_system_memory_max_in_megabytes()) * 1024 * 1024 / 4;
+
+  Object *camera = scene->camera;
+  return deg::multi_frame::evaluate_frames(params, frames, [&](Depsgraph &graph, const int frame) {
+    motionpaths_calc_bake_targets(targets, frame, &graph, camera, false);
+  });
+}
+
 /* Get pointer to animviz settings for the given target. */
 static bAnimVizSettings *animviz_target_settings_get(const MPathTarget *mpt)
 {
@@ -526,18 +577,25 @@ void animviz_calc_motionpaths(Depsgraph *depsgraph,
             sfra,
             efra,
             efra - sfra + 1);
-  for (scene->r.cfra = sfra; scene->r.cfra <= efra; scene->r.cfra++) {
-    if (range == ANIMVIZ_CALC_RANGE_CURRENT_FRAME) {
-      /* For current frame, only update tagged. */
-      BKE_scene_graph_update_tagged(depsgraph, bmain);
-    }
-    else {
-      /* Update relevant data for new frame. */
-      motionpaths_calc_update_scene(depsgraph);
-    }
+  if (range != ANIMVIZ_CALC_RANGE_CURRENT_FRAME &&
+      motionpaths_calc_parallel(depsgraph, bmain, scene, targets, sfra, efra))
+  {
+    /* All frames have been baked on temporary dependency graphs. */
+  }
+  else {
+    for (scene->r.cfra = sfra; scene->r.cfra <= efra; scene->r.cfra++) {
+      if (range == ANIMVIZ_CALC_RANGE_CURRENT_FRAME) {
+        /* For current frame, only update tagged. */
+        BKE_scene_graph_update_tagged(depsgraph, bmain);
+      }
+      else {
+        /* Update relevant data for new frame. */
+        motionpaths_calc_update_scene(depsgraph);
+      }
 
-    /* Perform baking for targets. */
-    motionpaths_calc_bake_targets(targets, scene->r.cfra, depsgraph, scene->camera);
+      /* Perform baking for targets. */
+      motionpaths_calc_bake_targets(targets, scene->r.cfra, depsgraph, scene->camera, true);
+    }
   }
 
   /* Reset original environment. */
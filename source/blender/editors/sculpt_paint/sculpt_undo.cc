@@ -915,6 +915,7 @@ static void restore_list(bContext *C, Depsgraph *depsgraph, StepData &step_data)
          * `pbvh.tag_positions_changed`) won't recalculate the face corner normals.
          * We need to manually clear that cache. */
         mesh.runtime->corner_normals_cache.tag_dirty();
+        mesh.runtime->uv_tangents_cache.tag_dirty();
       }
       pbvh.update_bounds(*depsgraph, object);
       bke::pbvh::store_bounds_orig(pbvh);
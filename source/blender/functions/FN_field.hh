@@ -42,6 +42,10 @@
 
 #include "FN_multi_function.hh"
 
+namespace blender::fn::multi_function {
+class Procedure;
+}
+
 namespace blender::fn {
 
 class FieldInput;
@@ -490,6 +494,19 @@ Vector<GVArray> evaluate_fields(ResourceScope &scope,
                                 const FieldContext &context,
                                 Span<GVMutableArray> dst_varrays = {});
 
+/**
+ * Build a procedure that computes the given fields without evaluating them. This is useful when
+ * the same fields are computed for many small batches, because building the procedure is
+ * relatively expensive. The procedure has an input parameter for every distinct #FieldInput in
+ * the field tree, in the order of \a r_field_inputs, followed by one output per field.
+ *
+ * \param scope: Owns data that is referenced by the procedure.
+ */
+void build_procedure_for_fields(mf::Procedure &procedure,
+                                ResourceScope &scope,
+                                Span<GFieldRef> fields,
+                                Vector<std::reference_wrapper<const FieldInput>> &r_field_inputs);
+
 /* -------------------------------------------------------------------- */
 /** \name Utility functions for simple field creation and evaluation
  * \{ */
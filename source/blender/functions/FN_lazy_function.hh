@@ -250,6 +250,11 @@ class LazyFunction {
    * Allow executing the function even if previously requested values are not yet available.
    */
   bool allow_missing_requested_inputs_ = false;
+  /**
+   * The function is expected to finish so quickly that running it in parallel with other
+   * functions is not worth the scheduling overhead.
+   */
+  bool is_cheap_ = false;
 
  public:
   virtual ~LazyFunction() = default;
@@ -313,6 +318,15 @@ class LazyFunction {
     return allow_missing_requested_inputs_;
   }
 
+  /**
+   * If true, the graph executor may execute the function together with the function that uses its
+   * outputs instead of scheduling it separately (see #GraphExecutor::EagerRegion).
+   */
+  bool is_cheap() const
+  {
+    return is_cheap_;
+  }
+
  private:
   /**
    * Needs to be implemented by subclasses. This is separate from #execute so that additional
@@ -118,7 +118,43 @@ class GraphExecutor : public LazyFunction {
     int total_size;
   } init_buffer_info_;
 
+  /**
+   * A group of nodes whose only purpose is to compute inputs for the root node. All nodes in it
+   * always use all their inputs and all their outputs are only linked to other nodes in the
+   * region. Therefore, once the root node is executed, every node in the region has to be executed
+   * exactly once. That is done in a precomputed order with values stored in a single buffer, which
+   * avoids the per-node scheduling, locking and usage propagation. Since the nodes of a region are
+   * executed one after another on a single thread, only cheap nodes (see #LazyFunction::is_cheap)
+   * are added to regions, e.g. the nodes building fields. Other nodes can only be roots.
+   */
+  struct EagerRegion {
+    struct RegionNode {
+      const FunctionNode *node;
+      /**
+       * Offset of the value of every input in the region buffer, or -1 when the input is not
+       * linked to another node in the region.
+       */
+      Array<int> input_offsets;
+      /**
+       * Offsets of the values of all targets of every output. The value is computed in-place in
+       * the first target and copied to the others.
+       */
+      Array<Vector<int>> output_target_offsets;
+    };
+    const FunctionNode *root;
+    /** Offsets of the values of the root inputs, -1 for inputs not linked to the region. */
+    Array<int> root_input_offsets;
+    /** All nodes in the region except the root, in the order they are executed. */
+    Vector<RegionNode> nodes;
+    /** Inputs of nodes in the region that are linked to nodes outside of it. */
+    Vector<const InputSocket *> external_inputs;
+    int buffer_size = 0;
+    int buffer_alignment = 1;
+  };
+  Vector<EagerRegion> eager_regions_;
+
   friend class Executor;
+  friend class EagerRegionLFParams;
 
  public:
   GraphExecutor(const Graph &graph,
@@ -139,8 +175,16 @@ class GraphExecutor : public LazyFunction {
   std::string input_name(int index) const override;
   std::string output_name(int index) const override;
 
+  /**
+   * Nodes that are executed as part of the eager region of the given root node, in the order they
+   * are executed. This is mainly useful for testing.
+   */
+  Vector<const FunctionNode *> eager_region_nodes(const FunctionNode &root) const;
+
  private:
   void execute_impl(Params &params, const Context &context) const override;
+
+  void build_eager_regions();
 };
 
 }  // namespace blender::fn::lazy_function
@@ -262,6 +262,12 @@ class Procedure : NonCopyable, NonMovable {
   DummyInstruction &new_dummy_instruction();
   ReturnInstruction &new_return_instruction();
 
+  /**
+   * Remove a call or destruct instruction from the procedure. No other instruction may point to it
+   * anymore. The variables it references are not removed.
+   */
+  void remove_instruction(Instruction &instruction);
+
   void add_parameter(ParamType::InterfaceType interface_type, Variable &variable);
   Span<ConstParameter> params() const;
 
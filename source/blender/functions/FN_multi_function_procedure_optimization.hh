@@ -46,4 +46,21 @@ namespace blender::fn::multi_function::procedure_optimization {
  */
 void move_destructs_up(Procedure &procedure, Instruction &block_end_instr);
 
+/**
+ * The procedure executor runs every call instruction on all indices before it continues with the
+ * next instruction. For a long chain of cheap functions (e.g. math nodes), most of the time is
+ * then spent writing intermediate values to large arrays and reading them back.
+ *
+ * This optimization pass replaces runs of calls to element-wise functions (that only have single
+ * inputs and outputs) with a single call to a fused function. The fused function evaluates all
+ * the original functions on a small batch of indices before moving on to the next batch, so that
+ * intermediate values stay in the CPU cache. Intermediate variables that are destructed within the
+ * run don't have to be stored for all indices anymore.
+ *
+ * This should run after #move_destructs_up, because the fused run can only keep variables internal
+ * when they are destructed within the run. Like #move_destructs_up, it only works on the linear
+ * chain of instructions at the start of the procedure.
+ */
+void fuse_element_wise_calls(Procedure &procedure);
+
 }  // namespace blender::fn::multi_function::procedure_optimization
@@ -273,11 +273,22 @@ static void build_multi_function_procedure_for_fields(mf::Procedure &procedure,
   mf::ReturnInstruction &return_instr = builder.add_return();
 
   mf::procedure_optimization::move_destructs_up(procedure, return_instr);
+  mf::procedure_optimization::fuse_element_wise_calls(procedure);
 
   // std::cout << procedure.to_dot() << "\n";
   BLI_assert(procedure.validate());
 }
 
+void build_procedure_for_fields(mf::Procedure &procedure,
+                                ResourceScope &scope,
+                                const Span<GFieldRef> fields,
+                                Vector<std::reference_wrapper<const FieldInput>> &r_field_inputs)
+{
+  const FieldTreeInfo field_tree_info = preprocess_field_tree(fields);
+  build_multi_function_procedure_for_fields(procedure, scope, field_tree_info, fields);
+  r_field_inputs.extend(field_tree_info.deduplicated_field_inputs.as_span());
+}
+
 Vector<GVArray> evaluate_fields(ResourceScope &scope,
                                 Span<GFieldRef> fields_to_evaluate,
                                 const IndexMask &mask,
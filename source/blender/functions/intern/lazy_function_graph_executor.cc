@@ -41,10 +41,12 @@
  * starts again.
  */
 
+#include <algorithm>
 #include <atomic>
 
 #include "BLI_enumerable_thread_specific.hh"
 #include "BLI_function_ref.hh"
+#include "BLI_map.hh"
 #include "BLI_mutex.hh"
 #include "BLI_stack.hh"
 #include "BLI_task.h"
@@ -183,6 +185,16 @@ struct NodeState {
    * Custom storage of the node.
    */
   void *storage = nullptr;
+  /**
+   * Index into #GraphExecutor::eager_regions_ when this node is the root of a region that is
+   * computed as a whole right before the node is executed the first time.
+   */
+  int eager_region_index = -1;
+  /**
+   * Set for the other nodes in an eager region. Those are never scheduled on their own and their
+   * input states are protected by the lock of the root node.
+   */
+  const FunctionNode *eager_region_root = nullptr;
 };
 
 /**
@@ -212,6 +224,7 @@ struct LockedNode {
 
 class Executor;
 class GraphExecutorLFParams;
+class EagerRegionLFParams;
 
 /**
  * Keeps track of nodes that are currently scheduled on a thread. A node can only be scheduled by
@@ -328,6 +341,7 @@ class Executor {
   bool is_first_execution_ = true;
 
   friend GraphExecutorLFParams;
+  friend EagerRegionLFParams;
 
   /**
    * Data that is local to the current thread. It is passed around in many places to avoid
@@ -413,6 +427,7 @@ class Executor {
         }
       }
 
+      this->initialize_eager_regions();
       this->initialize_static_value_usages(side_effect_nodes);
       this->schedule_side_effect_nodes(side_effect_nodes, current_task, local_data);
     }
@@ -619,6 +634,65 @@ class Executor {
     }
   }
 
+  /**
+   * Enable the precomputed eager regions for this execution. Regions that contain nodes with side
+   * effects are skipped, because those nodes have to be scheduled independently of the root.
+   */
+  void initialize_eager_regions()
+  {
+    for (const int region_index : self_.eager_regions_.index_range()) {
+      const GraphExecutor::EagerRegion &region = self_.eager_regions_[region_index];
+      const bool has_side_effects = std::any_of(
+          region.nodes.begin(), region.nodes.end(), [&](const auto &region_node) {
+            return node_states_[region_node.node->index_in_graph()]->has_side_effects;
+          });
+      if (has_side_effects) {
+        continue;
+      }
+      node_states_[region.root->index_in_graph()]->eager_region_index = region_index;
+      for (const GraphExecutor::EagerRegion::RegionNode &region_node : region.nodes) {
+        node_states_[region_node.node->index_in_graph()]->eager_region_root = region.root;
+      }
+    }
+  }
+
+  const GraphExecutor::EagerRegion *get_eager_region(const NodeState &node_state) const
+  {
+    if (node_state.eager_region_index == -1) {
+      return nullptr;
+    }
+    return &self_.eager_regions_[node_state.eager_region_index];
+  }
+
+  /**
+   * Nodes in an eager region share the lock of the region root.
+   */
+  const Node &get_node_to_lock(const Node &node) const
+  {
+    const NodeState &node_state = *node_states_[node.index_in_graph()];
+    if (node_state.eager_region_root != nullptr) {
+      return *node_state.eager_region_root;
+    }
+    return node;
+  }
+
+  InputState &get_input_state(const InputSocket &socket)
+  {
+    return node_states_[socket.node().index_in_graph()]->inputs[socket.index()];
+  }
+
+  /**
+   * True when the input is computed by the eager region of its node instead of being requested.
+   */
+  bool is_computed_in_eager_region(const InputSocket &socket) const
+  {
+    const OutputSocket *origin = socket.origin();
+    if (origin == nullptr) {
+      return false;
+    }
+    return node_states_[origin->node().index_in_graph()]->eager_region_root != nullptr;
+  }
+
   void schedule_side_effect_nodes(const Span<const FunctionNode *> side_effect_nodes,
                                   CurrentTask &current_task,
                                   const LocalData &local_data)
@@ -833,6 +907,7 @@ class Executor {
     LinearAllocator<> &allocator = *local_data.allocator;
     Context local_context{context_->storage, context_->user_data, local_data.local_user_data};
     const LazyFunction &fn = node.function();
+    const GraphExecutor::EagerRegion *eager_region = this->get_eager_region(node_state);
 
     bool node_needs_execution = false;
     this->with_locked_node(
@@ -863,11 +938,20 @@ class Executor {
               const Input &fn_input = fn_inputs[input_index];
               if (fn_input.usage == ValueUsage::Used) {
                 const InputSocket &input_socket = node.input(input_index);
-                if (input_socket.origin() != nullptr) {
+                if (input_socket.origin() != nullptr &&
+                    !this->is_computed_in_eager_region(input_socket))
+                {
                   this->set_input_required(locked_node, input_socket);
                 }
               }
             }
+            if (eager_region != nullptr) {
+              /* The inputs computed by the region are not requested. Instead, everything that
+               * the region depends on is requested directly. */
+              for (const InputSocket *input_socket : eager_region->external_inputs) {
+                this->set_input_required(locked_node, *input_socket);
+              }
+            }
 
             node_state.always_used_inputs_requested = true;
           }
@@ -887,6 +971,18 @@ class Executor {
               }
             }
           }
+          if (eager_region != nullptr) {
+            for (const InputSocket *input_socket : eager_region->external_inputs) {
+              InputState &input_state = this->get_input_state(*input_socket);
+              if (input_state.was_ready_for_execution) {
+                continue;
+              }
+              if (input_state.value == nullptr) {
+                return;
+              }
+              input_state.was_ready_for_execution = true;
+            }
+          }
 
           node_needs_execution = true;
         });
@@ -915,6 +1011,12 @@ class Executor {
           input_state.was_ready_for_execution = true;
         }
 
+        if (eager_region != nullptr) {
+          /* Compute the remaining inputs. This is done only once, because the node keeps its
+           * inputs until it is finished. */
+          this->execute_eager_region(*eager_region, current_task, local_data);
+        }
+
         node_state.storage_and_defaults_initialized = true;
       }
 
@@ -994,17 +1096,31 @@ class Executor {
         return;
       }
     }
+    const GraphExecutor::EagerRegion *eager_region = this->get_eager_region(node_state);
+    if (eager_region != nullptr) {
+      for (const InputSocket *input_socket : eager_region->external_inputs) {
+        const InputState &input_state = this->get_input_state(*input_socket);
+        if (input_state.usage == ValueUsage::Used && !input_state.was_ready_for_execution) {
+          return;
+        }
+      }
+    }
 
     node_state.node_has_finished = true;
 
     for (const int input_index : node.inputs().index_range()) {
       const InputSocket &input_socket = node.input(input_index);
       InputState &input_state = node_state.inputs[input_index];
-      if (input_state.usage == ValueUsage::Maybe) {
-        this->set_input_unused(locked_node, input_socket);
-      }
-      else if (input_state.usage == ValueUsage::Used) {
+      if (this->is_computed_in_eager_region(input_socket)) {
+        /* Nodes in the region are not notified, they are never executed if the root is not. */
         this->destruct_input_value_if_exists(input_state, input_socket.type());
+        continue;
+      }
+      this->release_input_of_finished_node(locked_node, input_socket);
+    }
+    if (eager_region != nullptr) {
+      for (const InputSocket *input_socket : eager_region->external_inputs) {
+        this->release_input_of_finished_node(locked_node, *input_socket);
       }
     }
 
@@ -1017,6 +1133,17 @@ class Executor {
     }
   }
 
+  void release_input_of_finished_node(LockedNode &locked_node, const InputSocket &input_socket)
+  {
+    InputState &input_state = this->get_input_state(input_socket);
+    if (input_state.usage == ValueUsage::Maybe) {
+      this->set_input_unused(locked_node, input_socket);
+    }
+    else if (input_state.usage == ValueUsage::Used) {
+      this->destruct_input_value_if_exists(input_state, input_socket.type());
+    }
+  }
+
   void destruct_input_value_if_exists(InputState &input_state, const CPPType &type)
   {
     if (input_state.value != nullptr) {
@@ -1030,6 +1157,71 @@ class Executor {
                     CurrentTask &current_task,
                     const LocalData &local_data);
 
+  /**
+   * Execute all nodes of the region except for the root and pass the computed values to the root
+   * inputs. The caller has to make sure that all external inputs of the region are available.
+   */
+  void execute_eager_region(const GraphExecutor::EagerRegion &region,
+                            CurrentTask &current_task,
+                            const LocalData &local_data)
+  {
+    char *buffer = static_cast<char *>(
+        local_data.allocator->allocate(region.buffer_size, region.buffer_alignment));
+
+    lazy_threading::HintReceiver blocking_hint_receiver{
+        [&]() { this->handle_blocking_hint(current_task); }};
+    for (const GraphExecutor::EagerRegion::RegionNode &region_node : region.nodes) {
+      this->execute_eager_region_node(region_node, buffer, local_data);
+    }
+
+    NodeState &root_state = *node_states_[region.root->index_in_graph()];
+    for (const int input_index : region.root_input_offsets.index_range()) {
+      const int offset = region.root_input_offsets[input_index];
+      if (offset == -1) {
+        continue;
+      }
+      InputState &input_state = root_state.inputs[input_index];
+      BLI_assert(input_state.value == nullptr);
+      input_state.value = buffer + offset;
+      input_state.usage = ValueUsage::Used;
+      input_state.was_ready_for_execution = true;
+    }
+  }
+
+  void execute_eager_region_node(const GraphExecutor::EagerRegion::RegionNode &region_node,
+                                 char *buffer,
+                                 const LocalData &local_data);
+
+  void forward_value_in_eager_region(const OutputSocket &from_socket,
+                                     void *value,
+                                     const Span<int> target_offsets,
+                                     char *buffer,
+                                     const LocalData &local_data)
+  {
+    const CPPType &type = from_socket.type();
+    const Context local_context{
+        context_->storage, context_->user_data, local_data.local_user_data};
+    if (self_.logger_ != nullptr) {
+      self_.logger_->log_socket_value(from_socket, {type, value}, local_context);
+    }
+    if (target_offsets.is_empty()) {
+      type.destruct(value);
+      return;
+    }
+    /* The value has been computed in the buffer of the first target already. */
+    BLI_assert(value == buffer + target_offsets[0]);
+    for (const int offset : target_offsets.drop_front(1)) {
+      type.copy_construct(value, buffer + offset);
+    }
+    if (self_.logger_ != nullptr) {
+      const Span<const InputSocket *> targets = from_socket.targets();
+      for (const int i : targets.index_range()) {
+        self_.logger_->log_socket_value(
+            *targets[i], {type, buffer + target_offsets[i]}, local_context);
+      }
+    }
+  }
+
   void set_input_unused_during_execution(const Node &node,
                                          NodeState &node_state,
                                          const int input_index,
@@ -1045,9 +1237,8 @@ class Executor {
 
   void set_input_unused(LockedNode &locked_node, const InputSocket &input_socket)
   {
-    NodeState &node_state = locked_node.node_state;
-    const int input_index = input_socket.index();
-    InputState &input_state = node_state.inputs[input_index];
+    BLI_assert(&locked_node.node == &this->get_node_to_lock(input_socket.node()));
+    InputState &input_state = this->get_input_state(input_socket);
 
     BLI_assert(input_state.usage != ValueUsage::Used);
     if (input_state.usage == ValueUsage::Unused) {
@@ -1082,10 +1273,10 @@ class Executor {
 
   void *set_input_required(LockedNode &locked_node, const InputSocket &input_socket)
   {
-    BLI_assert(&locked_node.node == &input_socket.node());
+    /* The input may belong to another node in the eager region of the locked node. */
+    BLI_assert(&locked_node.node == &this->get_node_to_lock(input_socket.node()));
     NodeState &node_state = locked_node.node_state;
-    const int input_index = input_socket.index();
-    InputState &input_state = node_state.inputs[input_index];
+    InputState &input_state = this->get_input_state(input_socket);
 
     BLI_assert(input_state.usage != ValueUsage::Unused);
 
@@ -1160,8 +1351,13 @@ class Executor {
         }
         continue;
       }
+      const Node &node_to_lock = this->get_node_to_lock(target_node);
       this->with_locked_node(
-          target_node, node_state, current_task, local_data, [&](LockedNode &locked_node) {
+          node_to_lock,
+          *node_states_[node_to_lock.index_in_graph()],
+          current_task,
+          local_data,
+          [&](LockedNode &locked_node) {
             if (input_state.usage == ValueUsage::Unused) {
               return;
             }
@@ -1254,6 +1450,22 @@ class Executor {
     }
   }
 
+  /**
+   * This is run when the execution of a node calls `lazy_threading::send_hint` to indicate that the
+   * execution will take a while. In this case, other tasks waiting on this thread should be allowed
+   * to be picked up by another thread.
+   */
+  void handle_blocking_hint(CurrentTask &current_task)
+  {
+    if (!current_task.has_scheduled_nodes.load()) {
+      return;
+    }
+    if (!this->try_enable_multi_threading()) {
+      return;
+    }
+    this->push_all_scheduled_nodes_to_task_pool(current_task);
+  }
+
   /**
    * Allow other threads to steal all the nodes that are currently scheduled on this thread.
    */
@@ -1433,30 +1645,196 @@ inline void Executor::execute_node(const FunctionNode &node,
     self_.logger_->log_before_node_execute(node, node_params, fn_context);
   }
 
-  /* This is run when the execution of the node calls `lazy_threading::send_hint` to indicate that
-   * the execution will take a while. In this case, other tasks waiting on this thread should be
-   * allowed to be picked up by another thread. */
-  auto blocking_hint_fn = [&]() {
-    if (!current_task.has_scheduled_nodes.load()) {
-      return;
+  lazy_threading::HintReceiver blocking_hint_receiver{
+      [&]() { this->handle_blocking_hint(current_task); }};
+  if (self_.node_execute_wrapper_) {
+    self_.node_execute_wrapper_->execute_node(node, node_params, fn_context);
+  }
+  else {
+    fn.execute(node_params, fn_context);
+  }
+
+  if (self_.logger_ != nullptr) {
+    self_.logger_->log_after_node_execute(node, node_params, fn_context);
+  }
+}
+
+/**
+ * Parameters for nodes in an eager region. All inputs are available already and the outputs are
+ * written directly into the buffer of the region.
+ */
+class EagerRegionLFParams final : public Params {
+ private:
+  Executor &executor_;
+  const GraphExecutor::EagerRegion::RegionNode &region_node_;
+  NodeState &node_state_;
+  char *buffer_;
+  const Executor::LocalData &caller_local_data_;
+
+ public:
+  EagerRegionLFParams(const LazyFunction &fn,
+                      Executor &executor,
+                      const GraphExecutor::EagerRegion::RegionNode &region_node,
+                      NodeState &node_state,
+                      char *buffer,
+                      const Executor::LocalData &local_data)
+      : Params(fn, node_state.enabled_multi_threading),
+        executor_(executor),
+        region_node_(region_node),
+        node_state_(node_state),
+        buffer_(buffer),
+        caller_local_data_(local_data)
+  {
+  }
+
+ private:
+  Executor::LocalData get_local_data()
+  {
+    if (!node_state_.enabled_multi_threading) {
+      return caller_local_data_;
     }
-    if (!this->try_enable_multi_threading()) {
-      return;
+    return executor_.get_local_data();
+  }
+
+  void *try_get_input_data_ptr_impl(const int index) const override
+  {
+    return node_state_.inputs[index].value;
+  }
+
+  void *try_get_input_data_ptr_or_request_impl(const int index) override
+  {
+    return node_state_.inputs[index].value;
+  }
+
+  void *get_output_data_ptr_impl(const int index) override
+  {
+    OutputState &output_state = node_state_.outputs[index];
+    BLI_assert(!output_state.has_been_computed);
+    if (output_state.value == nullptr) {
+      const Span<int> target_offsets = region_node_.output_target_offsets[index];
+      if (target_offsets.is_empty()) {
+        const CPPType &type = region_node_.node->output(index).type();
+        output_state.value = this->get_local_data().allocator->allocate(type);
+      }
+      else {
+        output_state.value = buffer_ + target_offsets[0];
+      }
     }
-    this->push_all_scheduled_nodes_to_task_pool(current_task);
-  };
+    return output_state.value;
+  }
+
+  void output_set_impl(const int index) override
+  {
+    OutputState &output_state = node_state_.outputs[index];
+    BLI_assert(!output_state.has_been_computed);
+    BLI_assert(output_state.value != nullptr);
+    executor_.forward_value_in_eager_region(region_node_.node->output(index),
+                                            output_state.value,
+                                            region_node_.output_target_offsets[index],
+                                            buffer_,
+                                            this->get_local_data());
+    output_state.value = nullptr;
+    output_state.has_been_computed = true;
+  }
+
+  bool output_was_set_impl(const int index) const override
+  {
+    return node_state_.outputs[index].has_been_computed;
+  }
 
-  lazy_threading::HintReceiver blocking_hint_receiver{blocking_hint_fn};
+  ValueUsage get_output_usage_impl(const int index) const override
+  {
+    return node_state_.outputs[index].usage_for_execution;
+  }
+
+  void set_input_unused_impl(const int /*index*/) override
+  {
+    /* All inputs of nodes in an eager region are always used. */
+    BLI_assert_unreachable();
+  }
+
+  bool try_enable_multi_threading_impl() override
+  {
+    const bool success = executor_.try_enable_multi_threading();
+    if (success) {
+      node_state_.enabled_multi_threading = true;
+    }
+    return success;
+  }
+};
+
+void Executor::execute_eager_region_node(const GraphExecutor::EagerRegion::RegionNode &region_node,
+                                         char *buffer,
+                                         const LocalData &local_data)
+{
+  const FunctionNode &node = *region_node.node;
+  const LazyFunction &fn = node.function();
+  NodeState &node_state = *node_states_[node.index_in_graph()];
+  LinearAllocator<> &allocator = *local_data.allocator;
+  const Context local_context{context_->storage, context_->user_data, local_data.local_user_data};
+
+  for (const int input_index : node.inputs().index_range()) {
+    const InputSocket &input_socket = node.input(input_index);
+    InputState &input_state = node_state.inputs[input_index];
+    const int offset = region_node.input_offsets[input_index];
+    if (offset != -1) {
+      /* The value has been computed by another node in the region. */
+      input_state.value = buffer + offset;
+    }
+    else if (input_socket.origin() == nullptr) {
+      const CPPType &type = input_socket.type();
+      const void *default_value = input_socket.default_value();
+      BLI_assert(default_value != nullptr);
+      if (self_.logger_ != nullptr) {
+        self_.logger_->log_socket_value(input_socket, {type, default_value}, local_context);
+      }
+      input_state.value = allocator.allocate(type);
+      type.copy_construct(default_value, input_state.value);
+    }
+    BLI_assert(input_state.value != nullptr);
+    input_state.usage = ValueUsage::Used;
+    input_state.was_ready_for_execution = true;
+  }
+  for (const int output_index : node.outputs().index_range()) {
+    OutputState &output_state = node_state.outputs[output_index];
+    output_state.usage_for_execution = region_node.output_target_offsets[output_index].is_empty() ?
+                                           ValueUsage::Unused :
+                                           ValueUsage::Used;
+  }
+
+  node_state.storage = fn.init_storage(allocator);
+  EagerRegionLFParams node_params{fn, *this, region_node, node_state, buffer, local_data};
+  Context fn_context(node_state.storage, context_->user_data, local_data.local_user_data);
+  if (self_.logger_ != nullptr) {
+    self_.logger_->log_before_node_execute(node, node_params, fn_context);
+  }
   if (self_.node_execute_wrapper_) {
     self_.node_execute_wrapper_->execute_node(node, node_params, fn_context);
   }
   else {
     fn.execute(node_params, fn_context);
   }
-
   if (self_.logger_ != nullptr) {
     self_.logger_->log_after_node_execute(node, node_params, fn_context);
   }
+
+#ifndef NDEBUG
+  for (const int output_index : node.outputs().index_range()) {
+    const OutputState &output_state = node_state.outputs[output_index];
+    BLI_assert(output_state.has_been_computed ||
+               output_state.usage_for_execution == ValueUsage::Unused);
+  }
+#endif
+
+  if (node_state.storage != nullptr) {
+    fn.destruct_storage(node_state.storage);
+    node_state.storage = nullptr;
+  }
+  for (const int input_index : node.inputs().index_range()) {
+    this->destruct_input_value_if_exists(node_state.inputs[input_index],
+                                         node.input(input_index).type());
+  }
+  node_state.node_has_finished = true;
 }
 
 GraphExecutor::GraphExecutor(const Graph &graph,
@@ -1529,6 +1907,179 @@ GraphExecutor::GraphExecutor(const Graph &graph,
   }
 
   init_buffer_info_.total_size = offset;
+
+  this->build_eager_regions();
+}
+
+static bool node_uses_all_inputs(const Node &node)
+{
+  if (!node.is_function()) {
+    return false;
+  }
+  const LazyFunction &fn = static_cast<const FunctionNode &>(node).function();
+  if (fn.allow_missing_requested_inputs()) {
+    return false;
+  }
+  for (const Input &input : fn.inputs()) {
+    if (input.usage != ValueUsage::Used) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Sort the nodes so that every node comes after the nodes it depends on. Nodes that are part of a
+ * cycle are not included.
+ */
+static Vector<const Node *> sort_nodes_topologically(const Span<const Node *> nodes)
+{
+  Array<int> missing_origins_num(nodes.size(), 0);
+  Vector<const Node *> sorted_nodes;
+  for (const Node *node : nodes) {
+    for (const InputSocket *input_socket : node->inputs()) {
+      if (input_socket->origin() != nullptr) {
+        missing_origins_num[node->index_in_graph()]++;
+      }
+    }
+    if (missing_origins_num[node->index_in_graph()] == 0) {
+      sorted_nodes.append(node);
+    }
+  }
+  for (int i = 0; i < sorted_nodes.size(); i++) {
+    for (const OutputSocket *output_socket : sorted_nodes[i]->outputs()) {
+      for (const InputSocket *target_socket : output_socket->targets()) {
+        const Node &target_node = target_socket->node();
+        if (--missing_origins_num[target_node.index_in_graph()] == 0) {
+          sorted_nodes.append(&target_node);
+        }
+      }
+    }
+  }
+  return sorted_nodes;
+}
+
+void GraphExecutor::build_eager_regions()
+{
+  BLI_assert(graph_.node_indices_are_valid());
+  const Span<const Node *> nodes = graph_.nodes();
+  const Vector<const Node *> sorted_nodes = sort_nodes_topologically(nodes);
+
+  /* Find the region of every node, starting at the end of the graph. A node is added to a region
+   * when it is cheap, always uses all its inputs and all its outputs are only used by nodes in the
+   * same region. Nodes that use all inputs but are not in another region are roots. Expensive
+   * nodes are never added to a region, so that independent expensive branches can still be
+   * executed in parallel. */
+  Array<bool> uses_all_inputs(nodes.size(), false);
+  Array<const FunctionNode *> root_by_node(nodes.size(), nullptr);
+  for (int i = sorted_nodes.size() - 1; i >= 0; i--) {
+    const Node *node = sorted_nodes[i];
+    if (!node_uses_all_inputs(*node)) {
+      continue;
+    }
+    uses_all_inputs[node->index_in_graph()] = true;
+    if (!static_cast<const FunctionNode *>(node)->function().is_cheap()) {
+      continue;
+    }
+    const FunctionNode *root = nullptr;
+    const bool only_used_in_region = [&]() {
+      for (const OutputSocket *output_socket : node->outputs()) {
+        for (const InputSocket *target_socket : output_socket->targets()) {
+          const Node &target_node = target_socket->node();
+          const int target_index = target_node.index_in_graph();
+          if (!uses_all_inputs[target_index]) {
+            return false;
+          }
+          const FunctionNode *target_root = root_by_node[target_index] ?
+                                                root_by_node[target_index] :
+                                                static_cast<const FunctionNode *>(&target_node);
+          if (!ELEM(root, nullptr, target_root)) {
+            return false;
+          }
+          root = target_root;
+        }
+      }
+      return true;
+    }();
+    if (only_used_in_region) {
+      root_by_node[node->index_in_graph()] = root;
+    }
+  }
+
+  Map<const FunctionNode *, int> region_by_root;
+  for (const Node *node : sorted_nodes) {
+    const FunctionNode *root = root_by_node[node->index_in_graph()];
+    if (root == nullptr) {
+      continue;
+    }
+    const int region_index = region_by_root.lookup_or_add_cb(root, [&]() {
+      eager_regions_.append({});
+      eager_regions_.last().root = root;
+      return int(eager_regions_.size() - 1);
+    });
+    EagerRegion::RegionNode region_node;
+    region_node.node = static_cast<const FunctionNode *>(node);
+    eager_regions_[region_index].nodes.append(std::move(region_node));
+  }
+
+  /* Every input that is linked to another node in the region gets its own value in the buffer. */
+  for (EagerRegion &region : eager_regions_) {
+    Map<const InputSocket *, int> offset_by_input;
+    int offset = 0;
+    const auto init_input_offsets = [&](const Node &node, Array<int> &r_offsets) {
+      r_offsets.reinitialize(node.inputs().size());
+      for (const int input_index : node.inputs().index_range()) {
+        const InputSocket &input_socket = node.input(input_index);
+        const OutputSocket *origin = input_socket.origin();
+        r_offsets[input_index] = -1;
+        if (origin == nullptr) {
+          continue;
+        }
+        if (root_by_node[origin->node().index_in_graph()] != region.root) {
+          if (&node != region.root) {
+            region.external_inputs.append(&input_socket);
+          }
+          continue;
+        }
+        const CPPType &type = input_socket.type();
+        const int alignment = int(type.alignment);
+        offset = (offset + alignment - 1) & ~(alignment - 1);
+        r_offsets[input_index] = offset;
+        offset_by_input.add_new(&input_socket, offset);
+        offset += int(type.size);
+        region.buffer_alignment = std::max(region.buffer_alignment, alignment);
+      }
+    };
+    for (EagerRegion::RegionNode &region_node : region.nodes) {
+      init_input_offsets(*region_node.node, region_node.input_offsets);
+    }
+    init_input_offsets(*region.root, region.root_input_offsets);
+    region.buffer_size = offset;
+
+    for (EagerRegion::RegionNode &region_node : region.nodes) {
+      const Span<const OutputSocket *> outputs = region_node.node->outputs();
+      region_node.output_target_offsets.reinitialize(outputs.size());
+      for (const int output_index : outputs.index_range()) {
+        for (const InputSocket *target_socket : outputs[output_index]->targets()) {
+          region_node.output_target_offsets[output_index].append(
+              offset_by_input.lookup(target_socket));
+        }
+      }
+    }
+  }
+}
+
+Vector<const FunctionNode *> GraphExecutor::eager_region_nodes(const FunctionNode &root) const
+{
+  Vector<const FunctionNode *> nodes;
+  for (const EagerRegion &region : eager_regions_) {
+    if (region.root == &root) {
+      for (const EagerRegion::RegionNode &region_node : region.nodes) {
+        nodes.append(region_node.node);
+      }
+    }
+  }
+  return nodes;
 }
 
 void GraphExecutor::execute_impl(Params &params, const Context &context) const
@@ -228,6 +228,37 @@ ReturnInstruction &Procedure::new_return_instruction()
   return instruction;
 }
 
+void Procedure::remove_instruction(Instruction &instruction)
+{
+  BLI_assert(instruction.prev_.is_empty());
+  switch (instruction.type_) {
+    case InstructionType::Call: {
+      CallInstruction &call_instruction = static_cast<CallInstruction &>(instruction);
+      call_instruction.set_next(nullptr);
+      for (const int param_index : call_instruction.params_.index_range()) {
+        call_instruction.set_param_variable(param_index, nullptr);
+      }
+      call_instructions_.remove_first_occurrence_and_reorder(&call_instruction);
+      call_instruction.~CallInstruction();
+      break;
+    }
+    case InstructionType::Destruct: {
+      DestructInstruction &destruct_instruction = static_cast<DestructInstruction &>(instruction);
+      destruct_instruction.set_next(nullptr);
+      destruct_instruction.set_variable(nullptr);
+      destruct_instructions_.remove_first_occurrence_and_reorder(&destruct_instruction);
+      destruct_instruction.~DestructInstruction();
+      break;
+    }
+    case InstructionType::Branch:
+    case InstructionType::Dummy:
+    case InstructionType::Return: {
+      BLI_assert_unreachable();
+      break;
+    }
+  }
+}
+
 void Procedure::add_parameter(ParamType::InterfaceType interface_type, Variable &variable)
 {
   params_.append({interface_type, &variable});
@@ -2,6 +2,10 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include "BLI_array.hh"
+#include "BLI_set.hh"
+#include "BLI_vector_set.hh"
+
 #include "FN_multi_function_procedure_optimization.hh"
 
 namespace blender::fn::multi_function::procedure_optimization {
@@ -74,4 +78,538 @@ void move_destructs_up(Procedure &procedure, Instruction &block_end_instr)
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Fuse Element-Wise Calls
+ * \{ */
+
+/**
+ * Number of indices that are evaluated by all fused functions before continuing with the next
+ * batch. It should be small enough for the intermediate values to fit into the CPU cache, but
+ * large enough to amortize the cost of calling every function once per batch.
+ */
+static constexpr int64_t fused_batch_size = 512;
+
+struct FusedCall {
+  const MultiFunction *fn;
+  /** Fused variable passed to every parameter of the function, -1 for ignored outputs. */
+  Vector<int> variables;
+};
+
+/**
+ * Evaluates a chain of element-wise functions batch by batch. The first variables are the inputs
+ * of the fused function, all other variables are computed by exactly one of the calls.
+ */
+class FusedElementWiseFunction : public MultiFunction {
+ private:
+  Signature signature_;
+  int inputs_num_;
+  Vector<const CPPType *> variable_types_;
+  /** Fused variable of every output parameter. */
+  Vector<int> output_variables_;
+  Vector<FusedCall> calls_;
+  /**
+   * Index of the batch buffer of every variable. Variables that are not alive at the same time
+   * share a buffer.
+   */
+  Vector<int> variable_buffers_;
+  Vector<const CPPType *> buffer_types_;
+  /** Variables whose values are not used anymore after the call with the same index. */
+  Vector<Vector<int>> variables_to_destruct_;
+  ExecutionHints hints_;
+
+ public:
+  FusedElementWiseFunction(Vector<const CPPType *> variable_types,
+                           const int inputs_num,
+                           Vector<int> output_variables,
+                           Vector<FusedCall> calls)
+      : inputs_num_(inputs_num),
+        variable_types_(std::move(variable_types)),
+        output_variables_(std::move(output_variables)),
+        calls_(std::move(calls))
+  {
+    SignatureBuilder builder{"Fused Element-Wise", signature_};
+    for (const int variable : IndexRange(inputs_num_)) {
+      builder.single_input("Input", *variable_types_[variable]);
+    }
+    for (const int variable : output_variables_) {
+      builder.single_output("Output", *variable_types_[variable]);
+    }
+    this->set_signature(&signature_);
+
+    this->plan_buffers();
+
+    hints_.min_grain_size = ExecutionHints().min_grain_size;
+    for (const FusedCall &call : calls_) {
+      const ExecutionHints call_hints = call.fn->execution_hints();
+      hints_.min_grain_size = std::min(hints_.min_grain_size, call_hints.min_grain_size);
+      hints_.uniform_execution_time &= call_hints.uniform_execution_time;
+    }
+  }
+
+  void call(const IndexMask &mask, Params params, Context context) const override
+  {
+    AlignedBuffer<512, 64> local_buffer;
+    LinearAllocator<> allocator;
+    allocator.provide_buffer(local_buffer);
+
+    const int variables_num = variable_types_.size();
+    const int calls_num = calls_.size();
+
+    /* Values of variables that are the same for all indices, null for other variables. */
+    Array<void *, 16> single_values(variables_num, nullptr);
+    Array<const GVArray *, 16> inputs(inputs_num_);
+    for (const int variable : IndexRange(inputs_num_)) {
+      inputs[variable] = &params.readonly_single_input(variable);
+      if (inputs[variable]->is_single()) {
+        void *value = allocator.allocate(*variable_types_[variable]);
+        inputs[variable]->get_internal_single_to_uninitialized(value);
+        single_values[variable] = value;
+      }
+    }
+
+    /* Like in the procedure executor, functions whose inputs are all the same for every index are
+     * only evaluated once. */
+    Array<bool, 16> call_is_single(calls_num);
+    static const IndexMask one_mask(1);
+    for (const int call_i : IndexRange(calls_num)) {
+      const FusedCall &call = calls_[call_i];
+      call_is_single[call_i] = true;
+      for (const int param_index : call.fn->param_indices()) {
+        const int variable = call.variables[param_index];
+        if (call.fn->param_type(param_index).interface_type() == ParamType::Input &&
+            single_values[variable] == nullptr)
+        {
+          call_is_single[call_i] = false;
+          break;
+        }
+      }
+      if (!call_is_single[call_i]) {
+        continue;
+      }
+      ParamsBuilder call_params{*call.fn, &one_mask};
+      for (const int param_index : call.fn->param_indices()) {
+        const int variable = call.variables[param_index];
+        if (call.fn->param_type(param_index).interface_type() == ParamType::Input) {
+          call_params.add_readonly_single_input(
+              GPointer(*variable_types_[variable], single_values[variable]));
+        }
+        else if (variable == -1) {
+          call_params.add_ignored_single_output();
+        }
+        else {
+          void *value = allocator.allocate(*variable_types_[variable]);
+          call_params.add_uninitialized_single_output(
+              GMutableSpan(*variable_types_[variable], value, 1));
+          single_values[variable] = value;
+        }
+      }
+      call.fn->call(one_mask, call_params, context);
+    }
+
+    Array<GMutableSpan, 8> outputs(output_variables_.size());
+    for (const int output_i : output_variables_.index_range()) {
+      const int variable = output_variables_[output_i];
+      outputs[output_i] = params.uninitialized_single_output(inputs_num_ + output_i);
+      if (single_values[variable] != nullptr) {
+        variable_types_[variable]->fill_construct_indices(
+            single_values[variable], outputs[output_i].data(), mask);
+      }
+    }
+
+    if (!call_is_single.as_span().contains(false)) {
+      this->destruct_single_values(single_values);
+      return;
+    }
+
+    Array<void *, 16> buffers(buffer_types_.size());
+    for (const int buffer : buffer_types_.index_range()) {
+      buffers[buffer] = allocator.allocate_array(*buffer_types_[buffer], fused_batch_size);
+    }
+    /* Where the values of every variable are stored during the current batch. */
+    Array<void *, 16> variable_data(variables_num, nullptr);
+    for (const int variable : IndexRange(variables_num)) {
+      if (variable_buffers_[variable] != -1) {
+        variable_data[variable] = buffers[variable_buffers_[variable]];
+      }
+    }
+
+    for (int64_t start = 0; start < mask.size(); start += fused_batch_size) {
+      const int64_t size = std::min(fused_batch_size, mask.size() - start);
+      const IndexMask batch = mask.slice(start, size);
+      const std::optional<IndexRange> batch_range = batch.to_range();
+      const IndexMask batch_mask(size);
+
+      /* Whether the variable values are stored in one of the buffers during this batch, and have
+       * to be destructed after their last use. */
+      Array<bool, 16> owns_values(variables_num, true);
+
+      for (const int variable : IndexRange(inputs_num_)) {
+        if (single_values[variable] != nullptr) {
+          continue;
+        }
+        const GVArray &varray = *inputs[variable];
+        if (batch_range && varray.is_span()) {
+          /* Read the input directly without copying it. The data is never written to. */
+          variable_data[variable] = const_cast<void *>(
+              POINTER_OFFSET(varray.get_internal_span().data(),
+                             variable_types_[variable]->size * batch_range->start()));
+          owns_values[variable] = false;
+        }
+        else {
+          variable_data[variable] = buffers[variable_buffers_[variable]];
+          varray.materialize_compressed_to_uninitialized(batch, variable_data[variable]);
+        }
+      }
+      for (const int output_i : output_variables_.index_range()) {
+        const int variable = output_variables_[output_i];
+        if (single_values[variable] == nullptr && batch_range) {
+          /* Write the output directly to its final location. */
+          variable_data[variable] = POINTER_OFFSET(
+              outputs[output_i].data(), variable_types_[variable]->size * batch_range->start());
+          owns_values[variable] = false;
+        }
+        else {
+          variable_data[variable] = buffers[variable_buffers_[variable]];
+        }
+      }
+
+      for (const int call_i : IndexRange(calls_num)) {
+        if (call_is_single[call_i]) {
+          continue;
+        }
+        const FusedCall &call = calls_[call_i];
+        ParamsBuilder call_params{*call.fn, &batch_mask};
+        for (const int param_index : call.fn->param_indices()) {
+          const int variable = call.variables[param_index];
+          if (call.fn->param_type(param_index).interface_type() == ParamType::Input) {
+            const CPPType &type = *variable_types_[variable];
+            if (single_values[variable] != nullptr) {
+              call_params.add_readonly_single_input(GPointer(type, single_values[variable]));
+            }
+            else {
+              call_params.add_readonly_single_input(GSpan(type, variable_data[variable], size));
+            }
+          }
+          else if (variable == -1) {
+            call_params.add_ignored_single_output();
+          }
+          else {
+            call_params.add_uninitialized_single_output(
+                GMutableSpan(*variable_types_[variable], variable_data[variable], size));
+          }
+        }
+        call.fn->call(batch_mask, call_params, context);
+
+        for (const int variable : variables_to_destruct_[call_i]) {
+          if (single_values[variable] == nullptr && owns_values[variable]) {
+            variable_types_[variable]->destruct_n(variable_data[variable], size);
+          }
+        }
+      }
+
+      if (!batch_range) {
+        /* Move outputs that have been computed in a buffer to their final location. */
+        for (const int output_i : output_variables_.index_range()) {
+          const int variable = output_variables_[output_i];
+          if (single_values[variable] != nullptr) {
+            continue;
+          }
+          const CPPType &type = *variable_types_[variable];
+          void *src = variable_data[variable];
+          void *dst = outputs[output_i].data();
+          batch.foreach_index([&](const int64_t i, const int64_t pos) {
+            type.move_construct(POINTER_OFFSET(src, type.size * pos),
+                                POINTER_OFFSET(dst, type.size * i));
+          });
+          type.destruct_n(src, size);
+        }
+      }
+    }
+
+    this->destruct_single_values(single_values);
+  }
+
+ private:
+  void destruct_single_values(const Span<void *> single_values) const
+  {
+    for (const int variable : single_values.index_range()) {
+      if (single_values[variable] != nullptr) {
+        variable_types_[variable]->destruct(single_values[variable]);
+      }
+    }
+  }
+
+  /**
+   * Assign a batch buffer to every variable, reusing the buffers of variables that are not used
+   * anymore. Outputs of a call never share a buffer with its inputs.
+   */
+  void plan_buffers()
+  {
+    const int variables_num = variable_types_.size();
+    const int calls_num = calls_.size();
+
+    /* Index of the last call that uses every variable. */
+    Array<int> last_use(variables_num, -1);
+    for (const int call_i : IndexRange(calls_num)) {
+      for (const int variable : calls_[call_i].variables) {
+        if (variable != -1) {
+          last_use[variable] = call_i;
+        }
+      }
+    }
+    for (const int variable : output_variables_) {
+      /* Outputs are kept until the end of the batch. */
+      last_use[variable] = calls_num;
+    }
+
+    variable_buffers_ = Vector<int>(variables_num, -1);
+    variables_to_destruct_.resize(calls_num);
+    Vector<int> free_buffers;
+    auto add_buffer = [&](const int variable) {
+      const CPPType *type = variable_types_[variable];
+      for (const int i : free_buffers.index_range()) {
+        if (buffer_types_[free_buffers[i]] == type) {
+          variable_buffers_[variable] = free_buffers[i];
+          free_buffers.remove_and_reorder(i);
+          return;
+        }
+      }
+      variable_buffers_[variable] = buffer_types_.append_and_get_index(type);
+    };
+
+    for (const int variable : IndexRange(inputs_num_)) {
+      add_buffer(variable);
+    }
+    for (const int call_i : IndexRange(calls_num)) {
+      const FusedCall &call = calls_[call_i];
+      for (const int param_index : call.fn->param_indices()) {
+        const int variable = call.variables[param_index];
+        if (variable != -1 &&
+            call.fn->param_type(param_index).interface_type() == ParamType::Output)
+        {
+          add_buffer(variable);
+        }
+      }
+      for (const int variable : call.variables) {
+        if (variable != -1 && last_use[variable] == call_i &&
+            !variables_to_destruct_[call_i].contains(variable))
+        {
+          variables_to_destruct_[call_i].append(variable);
+          free_buffers.append(variable_buffers_[variable]);
+        }
+      }
+    }
+  }
+
+  ExecutionHints get_execution_hints() const override
+  {
+    return hints_;
+  }
+};
+
+static bool is_element_wise_call(const CallInstruction &instruction)
+{
+  const MultiFunction &fn = instruction.fn();
+  for (const int param_index : fn.param_indices()) {
+    const ParamCategory category = fn.param_type(param_index).category();
+    if (!ELEM(category, ParamCategory::SingleInput, ParamCategory::SingleOutput)) {
+      return false;
+    }
+  }
+  /* Functions that allocate arrays for all indices are better called with fewer, larger masks. */
+  return !fn.execution_hints().allocates_array;
+}
+
+static Instruction *next_instruction(Instruction &instruction)
+{
+  switch (instruction.type()) {
+    case InstructionType::Call:
+      return static_cast<CallInstruction &>(instruction).next();
+    case InstructionType::Destruct:
+      return static_cast<DestructInstruction &>(instruction).next();
+    case InstructionType::Dummy:
+      return static_cast<DummyInstruction &>(instruction).next();
+    case InstructionType::Branch:
+    case InstructionType::Return:
+      break;
+  }
+  return nullptr;
+}
+
+/**
+ * Replace the run of element-wise calls and destruct instructions starting at the given call with
+ * a single fused call.
+ * \return The first instruction after the run.
+ */
+static Instruction *fuse_calls_starting_at(Procedure &procedure, CallInstruction &first_call)
+{
+  Vector<Instruction *> run;
+  Vector<CallInstruction *> calls;
+  /* Variables that are initialized by a call in the run. */
+  VectorSet<Variable *> defined_variables;
+  /* Variables that are used as input or destructed in the run. */
+  Set<Variable *> used_variables;
+  Set<Variable *> destructed_variables;
+
+  Instruction *instruction = &first_call;
+  while (instruction != nullptr) {
+    if (instruction->type() == InstructionType::Destruct) {
+      DestructInstruction &destruct_instr = static_cast<DestructInstruction &>(*instruction);
+      used_variables.add(destruct_instr.variable());
+      destructed_variables.add(destruct_instr.variable());
+    }
+    else if (instruction->type() == InstructionType::Call) {
+      CallInstruction &call_instr = static_cast<CallInstruction &>(*instruction);
+      if (!is_element_wise_call(call_instr)) {
+        break;
+      }
+      const MultiFunction &fn = call_instr.fn();
+      /* Stop when a variable is initialized again, the fused function can only compute every
+       * variable once. */
+      bool reinitializes_variable = false;
+      for (const int param_index : fn.param_indices()) {
+        Variable *variable = call_instr.params()[param_index];
+        if (variable != nullptr && fn.param_type(param_index).interface_type() == ParamType::Output &&
+            (defined_variables.contains(variable) || used_variables.contains(variable)))
+        {
+          reinitializes_variable = true;
+          break;
+        }
+      }
+      if (reinitializes_variable) {
+        break;
+      }
+      for (const int param_index : fn.param_indices()) {
+        Variable *variable = call_instr.params()[param_index];
+        if (variable == nullptr) {
+          continue;
+        }
+        if (fn.param_type(param_index).interface_type() == ParamType::Input) {
+          used_variables.add(variable);
+        }
+        else {
+          defined_variables.add(variable);
+        }
+      }
+      calls.append(&call_instr);
+    }
+    else {
+      break;
+    }
+    run.append(instruction);
+    instruction = next_instruction(*instruction);
+  }
+  Instruction *next_after_run = instruction;
+
+  if (calls.size() < 2) {
+    return next_instruction(first_call);
+  }
+
+  /* Gather the variables of the fused function. Inputs come first, followed by the variables that
+   * are computed in the run. */
+  VectorSet<Variable *> fused_variables;
+  for (CallInstruction *call_instr : calls) {
+    const MultiFunction &fn = call_instr->fn();
+    for (const int param_index : fn.param_indices()) {
+      Variable *variable = call_instr->params()[param_index];
+      if (variable != nullptr && fn.param_type(param_index).interface_type() == ParamType::Input &&
+          !defined_variables.contains(variable))
+      {
+        fused_variables.add(variable);
+      }
+    }
+  }
+  const int inputs_num = fused_variables.size();
+  fused_variables.add_multiple(defined_variables.as_span());
+
+  Vector<const CPPType *> variable_types;
+  for (const Variable *variable : fused_variables) {
+    variable_types.append(&variable->data_type().single_type());
+  }
+
+  /* Variables that are not destructed in the run are still needed after it. */
+  Vector<int> output_variables;
+  Vector<Variable *> fused_params(fused_variables.as_span().take_front(inputs_num));
+  for (Variable *variable : defined_variables) {
+    if (!destructed_variables.contains(variable)) {
+      output_variables.append(fused_variables.index_of(variable));
+      fused_params.append(variable);
+    }
+  }
+
+  Vector<FusedCall> fused_calls;
+  for (CallInstruction *call_instr : calls) {
+    FusedCall fused_call{&call_instr->fn(), {}};
+    for (Variable *variable : call_instr->params()) {
+      fused_call.variables.append(variable ? fused_variables.index_of(variable) : -1);
+    }
+    fused_calls.append(std::move(fused_call));
+  }
+
+  const MultiFunction &fused_fn = procedure.construct_function<FusedElementWiseFunction>(
+      std::move(variable_types), inputs_num, std::move(output_variables), std::move(fused_calls));
+  CallInstruction &fused_call_instr = procedure.new_call_instruction(fused_fn);
+  fused_call_instr.set_params(fused_params);
+
+  /* Replace the run with the fused call, followed by the destruct instructions of the inputs. */
+  const Vector<InstructionCursor> prev_cursors = first_call.prev();
+  for (const InstructionCursor &cursor : prev_cursors) {
+    cursor.set_next(procedure, &fused_call_instr);
+  }
+  for (Instruction *run_instr : run) {
+    if (run_instr->type() == InstructionType::Call) {
+      static_cast<CallInstruction *>(run_instr)->set_next(nullptr);
+    }
+    else {
+      static_cast<DestructInstruction *>(run_instr)->set_next(nullptr);
+    }
+  }
+  InstructionCursor cursor{fused_call_instr};
+  for (Instruction *run_instr : run) {
+    if (run_instr->type() == InstructionType::Destruct) {
+      DestructInstruction &destruct_instr = static_cast<DestructInstruction &>(*run_instr);
+      if (!defined_variables.contains(destruct_instr.variable())) {
+        cursor.set_next(procedure, &destruct_instr);
+        cursor = InstructionCursor{destruct_instr};
+        continue;
+      }
+    }
+    procedure.remove_instruction(*run_instr);
+  }
+  cursor.set_next(procedure, next_after_run);
+
+  return next_after_run;
+}
+
+void fuse_element_wise_calls(Procedure &procedure)
+{
+  Instruction *instruction = procedure.entry();
+  while (instruction != nullptr) {
+    switch (instruction->type()) {
+      case InstructionType::Call: {
+        CallInstruction &call_instr = static_cast<CallInstruction &>(*instruction);
+        if (is_element_wise_call(call_instr)) {
+          instruction = fuse_calls_starting_at(procedure, call_instr);
+        }
+        else {
+          instruction = call_instr.next();
+        }
+        break;
+      }
+      case InstructionType::Destruct:
+      case InstructionType::Dummy: {
+        instruction = next_instruction(*instruction);
+        break;
+      }
+      case InstructionType::Branch:
+      case InstructionType::Return: {
+        /* Only the linear chain of instructions at the start is optimized. */
+        return;
+      }
+    }
+  }
+}
+
+/** \} */
+
 }  // namespace blender::fn::multi_function::procedure_optimization
@@ -8,8 +8,14 @@
 #include "FN_lazy_function_graph.hh"
 #include "FN_lazy_function_graph_executor.hh"
 
+#include "BLI_lazy_threading.hh"
+#include "BLI_system.h"
 #include "BLI_task.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 namespace blender::fn::lazy_function::tests {
 
 class AddLazyFunction : public LazyFunction {
@@ -17,6 +23,7 @@ class AddLazyFunction : public LazyFunction {
   AddLazyFunction()
   {
     debug_name_ = "Add";
+    is_cheap_ = true;
     inputs_.append({"A", CPPType::get<int>()});
     inputs_.append({"B", CPPType::get<int>()});
     outputs_.append({"Result", CPPType::get<int>()});
@@ -178,4 +185,334 @@ TEST(lazy_function, GraphWithCycle)
   EXPECT_EQ(result, 10 * 2 * 5);
 }
 
+class CountingForwardFunction : public LazyFunction {
+ private:
+  std::atomic<int> *execution_count_;
+
+ public:
+  CountingForwardFunction(std::atomic<int> *execution_count) : execution_count_(execution_count)
+  {
+    debug_name_ = "Counting Forward";
+    is_cheap_ = true;
+    inputs_.append({"A", CPPType::get<int>()});
+    outputs_.append({"A", CPPType::get<int>()});
+  }
+
+  void execute_impl(Params &params, const Context & /*context*/) const override
+  {
+    (*execution_count_)++;
+    params.set_output(0, params.get_input<int>(0));
+  }
+};
+
+/** Build a graph where most nodes only compute inputs for the last node. */
+static void build_eager_graph(Graph &graph,
+                              const LazyFunction &add_fn,
+                              const LazyFunction &forward_fn,
+                              FunctionNode *&r_forward_node,
+                              GraphInputSocket *&r_input,
+                              GraphOutputSocket *&r_output_1,
+                              GraphOutputSocket *&r_output_2)
+{
+  static const int value_1 = 1;
+  FunctionNode &add_node_1 = graph.add_function(add_fn);
+  FunctionNode &forward_node = graph.add_function(forward_fn);
+  FunctionNode &add_node_2 = graph.add_function(add_fn);
+  FunctionNode &add_node_3 = graph.add_function(add_fn);
+  FunctionNode &add_node_4 = graph.add_function(add_fn);
+  r_input = &graph.add_input(CPPType::get<int>());
+  r_output_1 = &graph.add_output(CPPType::get<int>());
+  r_output_2 = &graph.add_output(CPPType::get<int>());
+
+  add_node_1.input(1).set_default_value(&value_1);
+  graph.add_link(*r_input, add_node_1.input(0));
+  graph.add_link(add_node_1.output(0), forward_node.input(0));
+  graph.add_link(forward_node.output(0), add_node_2.input(0));
+  graph.add_link(forward_node.output(0), add_node_2.input(1));
+  graph.add_link(add_node_2.output(0), add_node_3.input(0));
+  graph.add_link(*r_input, add_node_3.input(1));
+  graph.add_link(add_node_3.output(0), *r_output_1);
+  /* This node is used by two nodes in different regions. */
+  graph.add_link(add_node_3.output(0), add_node_4.input(0));
+  graph.add_link(add_node_3.output(0), add_node_4.input(1));
+  graph.add_link(add_node_4.output(0), *r_output_2);
+
+  graph.update_node_indices();
+  r_forward_node = &forward_node;
+}
+
+TEST(lazy_function, EagerRegion)
+{
+  BLI_task_scheduler_init();
+  std::atomic<int> execution_count = 0;
+  const AddLazyFunction add_fn;
+  const CountingForwardFunction forward_fn{&execution_count};
+
+  Graph graph;
+  FunctionNode *forward_node;
+  GraphInputSocket *input;
+  GraphOutputSocket *output_1;
+  GraphOutputSocket *output_2;
+  build_eager_graph(graph, add_fn, forward_fn, forward_node, input, output_1, output_2);
+
+  GraphExecutor executor_fn{graph, {input}, {output_1, output_2}, nullptr, nullptr, nullptr};
+  int result_1 = 0;
+  int result_2 = 0;
+  execute_lazy_function_eagerly(
+      executor_fn, nullptr, nullptr, std::make_tuple(5), std::make_tuple(&result_1, &result_2));
+
+  EXPECT_EQ(result_1, (5 + 1) * 2 + 5);
+  EXPECT_EQ(result_2, result_1 * 2);
+  EXPECT_EQ(execution_count, 1);
+}
+
+TEST(lazy_function, EagerRegionWithSideEffects)
+{
+  BLI_task_scheduler_init();
+  std::atomic<int> execution_count = 0;
+  const AddLazyFunction add_fn;
+  const CountingForwardFunction forward_fn{&execution_count};
+
+  Graph graph;
+  FunctionNode *forward_node;
+  GraphInputSocket *input;
+  GraphOutputSocket *output_1;
+  GraphOutputSocket *output_2;
+  build_eager_graph(graph, add_fn, forward_fn, forward_node, input, output_1, output_2);
+
+  /* The node with side effects is executed even though no output is used. */
+  SimpleSideEffectProvider side_effect_provider{{forward_node}};
+  GraphExecutor executor_fn{graph, {input}, {}, nullptr, &side_effect_provider, nullptr};
+  execute_lazy_function_eagerly(
+      executor_fn, nullptr, nullptr, std::make_tuple(5), std::make_tuple());
+
+  EXPECT_EQ(execution_count, 1);
+}
+
+/** Records the order in which nodes are executed. */
+class ExecutionOrderLogger : public GraphExecutorLogger {
+ public:
+  mutable std::mutex mutex;
+  mutable Vector<const FunctionNode *> executed_nodes;
+
+  void log_before_node_execute(const FunctionNode &node,
+                               const Params & /*params*/,
+                               const Context & /*context*/) const override
+  {
+    std::lock_guard lock{mutex};
+    executed_nodes.append(&node);
+  }
+};
+
+TEST(lazy_function, EagerRegionExecutedTogether)
+{
+  BLI_task_scheduler_init();
+  std::atomic<int> execution_count = 0;
+  const AddLazyFunction add_fn;
+  const CountingForwardFunction forward_fn{&execution_count};
+
+  Graph graph;
+  FunctionNode *forward_node;
+  GraphInputSocket *input;
+  GraphOutputSocket *output_1;
+  GraphOutputSocket *output_2;
+  build_eager_graph(graph, add_fn, forward_fn, forward_node, input, output_1, output_2);
+  const FunctionNode &add_node_1 = static_cast<const FunctionNode &>(
+      forward_node->input(0).origin()->node());
+  const FunctionNode &add_node_2 = static_cast<const FunctionNode &>(
+      forward_node->output(0).targets()[0]->node());
+  const FunctionNode &add_node_3 = static_cast<const FunctionNode &>(
+      add_node_2.output(0).targets()[0]->node());
+
+  ExecutionOrderLogger logger;
+  GraphExecutor executor_fn{graph, {input}, {output_1, output_2}, &logger, nullptr, nullptr};
+  const Vector<const FunctionNode *> region_nodes = {&add_node_1, forward_node, &add_node_2};
+  EXPECT_EQ(executor_fn.eager_region_nodes(add_node_3).as_span(), region_nodes.as_span());
+
+  int result_1 = 0;
+  int result_2 = 0;
+  execute_lazy_function_eagerly(
+      executor_fn, nullptr, nullptr, std::make_tuple(5), std::make_tuple(&result_1, &result_2));
+  EXPECT_EQ(result_1, (5 + 1) * 2 + 5);
+  EXPECT_EQ(result_2, result_1 * 2);
+
+  /* The region nodes are executed in order right before the root, without being scheduled. */
+  const Span<const FunctionNode *> executed_nodes = logger.executed_nodes;
+  const int64_t root_index = executed_nodes.first_index_try(&add_node_3);
+  ASSERT_GE(root_index, region_nodes.size());
+  EXPECT_EQ(executed_nodes.slice(root_index - region_nodes.size(), region_nodes.size()),
+            region_nodes.as_span());
+}
+
+/**
+ * Same as #CountingForwardFunction, but expensive, so that it is never part of an eager region.
+ */
+class ExpensiveForwardFunction : public LazyFunction {
+ public:
+  ExpensiveForwardFunction()
+  {
+    debug_name_ = "Expensive Forward";
+    inputs_.append({"A", CPPType::get<int>()});
+    outputs_.append({"A", CPPType::get<int>()});
+  }
+
+  void execute_impl(Params &params, const Context & /*context*/) const override
+  {
+    params.set_output(0, params.get_input<int>(0));
+  }
+};
+
+/**
+ * Build a graph with two independent branches that each contain an expensive node and that are
+ * combined by a cheap node.
+ */
+static void build_parallel_branches_graph(Graph &graph,
+                                          const LazyFunction &add_fn,
+                                          const LazyFunction &expensive_fn,
+                                          GraphInputSocket *&r_input,
+                                          GraphOutputSocket *&r_output)
+{
+  static const int value_1 = 1;
+  static const int value_10 = 10;
+  r_input = &graph.add_input(CPPType::get<int>());
+  r_output = &graph.add_output(CPPType::get<int>());
+  FunctionNode &add_node_1 = graph.add_function(add_fn);
+  FunctionNode &expensive_node_1 = graph.add_function(expensive_fn);
+  FunctionNode &add_node_2 = graph.add_function(add_fn);
+  FunctionNode &expensive_node_2 = graph.add_function(expensive_fn);
+  FunctionNode &add_node_3 = graph.add_function(add_fn);
+  FunctionNode &combine_node = graph.add_function(add_fn);
+
+  add_node_1.input(1).set_default_value(&value_1);
+  add_node_2.input(1).set_default_value(&value_10);
+  add_node_3.input(1).set_default_value(&value_1);
+  graph.add_link(*r_input, add_node_1.input(0));
+  graph.add_link(add_node_1.output(0), expensive_node_1.input(0));
+  graph.add_link(expensive_node_1.output(0), add_node_3.input(0));
+  graph.add_link(add_node_3.output(0), combine_node.input(0));
+  graph.add_link(*r_input, add_node_2.input(0));
+  graph.add_link(add_node_2.output(0), expensive_node_2.input(0));
+  graph.add_link(expensive_node_2.output(0), combine_node.input(1));
+  graph.add_link(combine_node.output(0), *r_output);
+
+  graph.update_node_indices();
+}
+
+TEST(lazy_function, EagerRegionKeepsParallelBranches)
+{
+  BLI_task_scheduler_init();
+  const AddLazyFunction add_fn;
+  const ExpensiveForwardFunction expensive_fn;
+
+  Graph graph;
+  GraphInputSocket *input;
+  GraphOutputSocket *output;
+  build_parallel_branches_graph(graph, add_fn, expensive_fn, input, output);
+  const FunctionNode &combine_node = static_cast<const FunctionNode &>(
+      output->origin()->node());
+  const FunctionNode &add_node_3 = static_cast<const FunctionNode &>(
+      combine_node.input(0).origin()->node());
+  const FunctionNode &expensive_node_1 = static_cast<const FunctionNode &>(
+      add_node_3.input(0).origin()->node());
+  const FunctionNode &expensive_node_2 = static_cast<const FunctionNode &>(
+      combine_node.input(1).origin()->node());
+  const FunctionNode &add_node_1 = static_cast<const FunctionNode &>(
+      expensive_node_1.input(0).origin()->node());
+  const FunctionNode &add_node_2 = static_cast<const FunctionNode &>(
+      expensive_node_2.input(0).origin()->node());
+
+  GraphExecutor executor_fn{graph, {input}, {output}, nullptr, nullptr, nullptr};
+
+  /* The regions end at the expensive nodes, so that both branches are scheduled separately. Only
+   * the cheap nodes in between are executed together with the node that uses them. */
+  const Vector<const FunctionNode *> combine_region = {&add_node_3};
+  const Vector<const FunctionNode *> expensive_region_1 = {&add_node_1};
+  const Vector<const FunctionNode *> expensive_region_2 = {&add_node_2};
+  EXPECT_EQ(executor_fn.eager_region_nodes(combine_node).as_span(), combine_region.as_span());
+  EXPECT_EQ(executor_fn.eager_region_nodes(expensive_node_1).as_span(),
+            expensive_region_1.as_span());
+  EXPECT_EQ(executor_fn.eager_region_nodes(expensive_node_2).as_span(),
+            expensive_region_2.as_span());
+  EXPECT_TRUE(executor_fn.eager_region_nodes(add_node_1).is_empty());
+  EXPECT_TRUE(executor_fn.eager_region_nodes(add_node_2).is_empty());
+
+  int result = 0;
+  execute_lazy_function_eagerly(
+      executor_fn, nullptr, nullptr, std::make_tuple(5), std::make_tuple(&result));
+  EXPECT_EQ(result, (5 + 1 + 1) + (5 + 10));
+}
+
+#ifdef WITH_TBB
+
+/** Blocks all threads that arrive at it until the expected number of threads has arrived. */
+class Latch {
+ private:
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  int remaining_num_;
+
+ public:
+  Latch(const int expected_num) : remaining_num_(expected_num) {}
+
+  void arrive_and_wait()
+  {
+    std::unique_lock lock{mutex_};
+    remaining_num_--;
+    if (remaining_num_ == 0) {
+      condition_.notify_all();
+      return;
+    }
+    condition_.wait(lock, [&]() { return remaining_num_ == 0; });
+  }
+};
+
+/**
+ * An expensive function that only finishes once the other nodes using the same latch run at the
+ * same time. The graph executor only finishes when it executes these nodes on separate threads.
+ */
+class LatchForwardFunction : public LazyFunction {
+ private:
+  Latch *latch_;
+
+ public:
+  LatchForwardFunction(Latch *latch) : latch_(latch)
+  {
+    debug_name_ = "Latch Forward";
+    inputs_.append({"A", CPPType::get<int>()});
+    outputs_.append({"A", CPPType::get<int>()});
+  }
+
+  void execute_impl(Params &params, const Context & /*context*/) const override
+  {
+    /* Allow other scheduled nodes to be picked up by other threads. */
+    lazy_threading::send_hint();
+    latch_->arrive_and_wait();
+    params.set_output(0, params.get_input<int>(0));
+  }
+};
+
+TEST(lazy_function, ParallelBranchesExecutedConcurrently)
+{
+  BLI_task_scheduler_init();
+  if (BLI_system_thread_count() <= 1) {
+    GTEST_SKIP() << "Multiple threads are required";
+  }
+  Latch latch{2};
+  const AddLazyFunction add_fn;
+  const LatchForwardFunction latch_fn{&latch};
+
+  Graph graph;
+  GraphInputSocket *input;
+  GraphOutputSocket *output;
+  build_parallel_branches_graph(graph, add_fn, latch_fn, input, output);
+
+  GraphExecutor executor_fn{graph, {input}, {output}, nullptr, nullptr, nullptr};
+  int result = 0;
+  execute_lazy_function_eagerly(
+      executor_fn, nullptr, nullptr, std::make_tuple(5), std::make_tuple(&result));
+  EXPECT_EQ(result, (5 + 1 + 1) + (5 + 10));
+}
+
+#endif
+
 }  // namespace blender::fn::lazy_function::tests
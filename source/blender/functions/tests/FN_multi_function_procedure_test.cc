@@ -7,8 +7,11 @@
 #include "FN_multi_function_builder.hh"
 #include "FN_multi_function_procedure_builder.hh"
 #include "FN_multi_function_procedure_executor.hh"
+#include "FN_multi_function_procedure_optimization.hh"
 #include "FN_multi_function_test_common.hh"
 
+#include "BLI_timeit.hh"
+
 namespace blender::fn::multi_function::tests {
 
 TEST(multi_function_procedure, ConstantOutput)
@@ -423,4 +426,160 @@ TEST(multi_function_procedure, OutputBufferReplaced)
   EXPECT_EQ(output[2], output_value);
 }
 
+TEST(multi_function_procedure, FuseElementWiseCalls)
+{
+  /**
+   * procedure(int a, int b, std::string *out1, int *out2) {
+   *   c = a + b;
+   *   d = c * 2;
+   *   out2 = d + 1;
+   *   e = "x" * d;
+   *   out1 = e + "!";
+   * }
+   */
+
+  auto add_fn = build::SI2_SO<int, int, int>("Add", [](int a, int b) { return a + b; });
+  auto double_fn = build::SI1_SO<int, int>("Double", [](int a) { return a * 2; });
+  auto add_1_fn = build::SI1_SO<int, int>("Add 1", [](int a) { return a + 1; });
+  auto repeat_fn = build::SI1_SO<int, std::string>(
+      "Repeat", [](int a) { return std::string(a % 20, 'x'); });
+  auto exclaim_fn = build::SI1_SO<std::string, std::string>(
+      "Exclaim", [](const std::string &a) { return a + "!"; });
+
+  for (const bool fuse : {false, true}) {
+    Procedure procedure;
+    ProcedureBuilder builder{procedure};
+
+    Variable *var_a = &builder.add_single_input_parameter<int>();
+    Variable *var_b = &builder.add_single_input_parameter<int>();
+    auto [var_c] = builder.add_call<1>(add_fn, {var_a, var_b});
+    auto [var_d] = builder.add_call<1>(double_fn, {var_c});
+    auto [var_out2] = builder.add_call<1>(add_1_fn, {var_d});
+    auto [var_e] = builder.add_call<1>(repeat_fn, {var_d});
+    auto [var_out1] = builder.add_call<1>(exclaim_fn, {var_e});
+    builder.add_destruct({var_a, var_b, var_c, var_d, var_e});
+    ReturnInstruction &return_instr = builder.add_return();
+    builder.add_output_parameter(*var_out1);
+    builder.add_output_parameter(*var_out2);
+
+    procedure_optimization::move_destructs_up(procedure, return_instr);
+    if (fuse) {
+      procedure_optimization::fuse_element_wise_calls(procedure);
+      /* All calls are replaced by a single one, only the destructs of the inputs remain. */
+      int calls_num = 0;
+      const Instruction *instruction = procedure.entry();
+      while (instruction->type() != InstructionType::Return) {
+        if (instruction->type() == InstructionType::Call) {
+          calls_num++;
+          instruction = static_cast<const CallInstruction *>(instruction)->next();
+        }
+        else {
+          EXPECT_EQ(instruction->type(), InstructionType::Destruct);
+          instruction = static_cast<const DestructInstruction *>(instruction)->next();
+        }
+      }
+      EXPECT_EQ(calls_num, 1);
+    }
+    EXPECT_TRUE(procedure.validate());
+
+    ProcedureExecutor procedure_fn{procedure};
+
+    const int size = 2000;
+    Array<int> inputs_a(size);
+    for (const int i : inputs_a.index_range()) {
+      inputs_a[i] = i;
+    }
+    const int input_b = 3;
+    Array<std::string> results_1(size, "-");
+    Array<int> results_2(size, -1);
+
+    IndexMaskMemory memory;
+    const IndexMask mask = IndexMask::from_predicate(
+        IndexRange(size), GrainSize(512), memory, [](const int64_t i) { return i % 3 != 0; });
+    ParamsBuilder params{procedure_fn, &mask};
+    params.add_readonly_single_input(inputs_a.as_span());
+    params.add_readonly_single_input(&input_b);
+    params.add_uninitialized_single_output(results_1.as_mutable_span());
+    params.add_uninitialized_single_output(results_2.as_mutable_span());
+
+    ContextBuilder context;
+    procedure_fn.call(mask, params, context);
+
+    for (const int i : IndexRange(size)) {
+      if (i % 3 == 0) {
+        EXPECT_EQ(results_1[i], "-");
+        EXPECT_EQ(results_2[i], -1);
+      }
+      else {
+        const int d = (i + 3) * 2;
+        EXPECT_EQ(results_1[i], std::string(d % 20, 'x') + "!");
+        EXPECT_EQ(results_2[i], d + 1);
+      }
+    }
+  }
+}
+
+#if 0
+TEST(multi_function_procedure, FuseElementWiseCallsBenchmark)
+{
+  auto add_fn = build::SI2_SO<float, float, float>("Add", [](float a, float b) { return a + b; });
+  auto multiply_fn = build::SI2_SO<float, float, float>("Multiply",
+                                                        [](float a, float b) { return a * b; });
+  auto map_fn = build::SI1_SO<float, float>("Map", [](float a) { return a * 0.5f - 1.0f; });
+
+  const int64_t size = 10'000'000;
+  Array<float> inputs_a(size);
+  Array<float> inputs_b(size);
+  for (const int64_t i : IndexRange(size)) {
+    inputs_a[i] = float(i % 1000) * 0.001f;
+    inputs_b[i] = float(i % 37);
+  }
+  Array<float> results(size);
+
+  for ([[maybe_unused]] const int iteration : IndexRange(3)) {
+    for (const bool fuse : {false, true}) {
+      Procedure procedure;
+      ProcedureBuilder builder{procedure};
+      Variable *var_a = &builder.add_single_input_parameter<float>();
+      Variable *var_b = &builder.add_single_input_parameter<float>();
+      Vector<Variable *> variables_to_destruct = {var_b};
+      Variable *var_current = var_a;
+      for (const int i : IndexRange(25)) {
+        Variable *var_next;
+        switch (i % 3) {
+          case 0:
+            var_next = builder.add_call<1>(add_fn, {var_current, var_b})[0];
+            break;
+          case 1:
+            var_next = builder.add_call<1>(multiply_fn, {var_current, var_a})[0];
+            break;
+          default:
+            var_next = builder.add_call<1>(map_fn, {var_current})[0];
+            break;
+        }
+        variables_to_destruct.append(var_current);
+        var_current = var_next;
+      }
+      builder.add_destruct(variables_to_destruct);
+      ReturnInstruction &return_instr = builder.add_return();
+      builder.add_output_parameter(*var_current);
+      procedure_optimization::move_destructs_up(procedure, return_instr);
+      if (fuse) {
+        procedure_optimization::fuse_element_wise_calls(procedure);
+      }
+
+      ProcedureExecutor procedure_fn{procedure};
+      const IndexMask mask(size);
+      ParamsBuilder params{procedure_fn, &mask};
+      params.add_readonly_single_input(inputs_a.as_span());
+      params.add_readonly_single_input(inputs_b.as_span());
+      params.add_uninitialized_single_output(results.as_mutable_span());
+      ContextBuilder context;
+      SCOPED_TIMER(fuse ? "fused" : "unfused");
+      procedure_fn.call(mask, params, context);
+    }
+  }
+}
+#endif
+
 }  // namespace blender::fn::multi_function::tests
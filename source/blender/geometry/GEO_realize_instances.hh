@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "BLI_function_ref.hh"
+
 #include "BKE_geometry_set.hh"
 
 namespace blender::geometry {
@@ -70,4 +72,26 @@ bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
                                    const RealizeInstancesOptions &options,
                                    const VariedDepthOptions &varied_depth_option);
 
+/**
+ * Same as #realize_instances, but the realized geometry is split into multiple geometry sets that
+ * are passed to \a fn one after another, so that the realized data does not have to be in memory
+ * all at once. This is useful for consumers that process the geometry piece by piece, e.g. when
+ * writing it to a file.
+ *
+ * Every chunk contains at most \a max_chunk_points_num points (mesh vertices, point cloud points
+ * and curve control points), unless a single realized instance is larger than that. Instances are
+ * never split across chunks. The chunks contain the same attributes as the output of
+ * #realize_instances, and joining them in the order they are passed to \a fn gives the same
+ * element order. Non-realized instances, grease pencil and volumes are passed in the first chunk.
+ */
+void realize_instances_chunked(bke::GeometrySet geometry_set,
+                               const RealizeInstancesOptions &options,
+                               int64_t max_chunk_points_num,
+                               FunctionRef<void(bke::GeometrySet chunk)> fn);
+void realize_instances_chunked(bke::GeometrySet geometry_set,
+                               const RealizeInstancesOptions &options,
+                               const VariedDepthOptions &varied_depth_option,
+                               int64_t max_chunk_points_num,
+                               FunctionRef<void(bke::GeometrySet chunk)> fn);
+
 }  // namespace blender::geometry
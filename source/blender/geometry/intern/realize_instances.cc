@@ -2,6 +2,8 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <limits>
+
 #include "GEO_join_geometries.hh"
 #include "GEO_realize_instances.hh"
 
@@ -419,24 +421,6 @@ struct InstanceContext {
   }
 };
 
-static int64_t get_final_points_num(const GatherTasks &tasks)
-{
-  int64_t points_num = 0;
-  if (!tasks.pointcloud_tasks.is_empty()) {
-    const RealizePointCloudTask &task = tasks.pointcloud_tasks.last();
-    points_num += task.start_index + task.pointcloud_info->pointcloud->totpoint;
-  }
-  if (!tasks.mesh_tasks.is_empty()) {
-    const RealizeMeshTask &task = tasks.mesh_tasks.last();
-    points_num += task.start_indices.vertex + task.mesh_info->mesh->verts_num;
-  }
-  if (!tasks.curve_tasks.is_empty()) {
-    const RealizeCurveTask &task = tasks.curve_tasks.last();
-    points_num += task.start_indices.point + task.curve_info->curves->geometry.point_num;
-  }
-  return points_num;
-}
-
 static bool skip_transform(const float4x4 &transform)
 {
   return math::is_equal(transform, float4x4::identity(), 1e-6f);
@@ -1289,13 +1273,14 @@ static void execute_realize_pointcloud_tasks(const RealizeInstancesOptions &opti
                                              const AllPointCloudsInfo &all_pointclouds_info,
                                              const Span<RealizePointCloudTask> tasks,
                                              const OrderedAttributes &ordered_attributes,
+                                             const bool is_all_tasks,
                                              bke::GeometrySet &r_realized_geometry)
 {
   if (tasks.is_empty()) {
     return;
   }
 
-  if (tasks.size() == 1) {
+  if (is_all_tasks && tasks.size() == 1) {
     const RealizePointCloudTask &task = tasks.first();
     PointCloud *new_points = BKE_pointcloud_copy_for_eval(task.pointcloud_info->pointcloud);
     if (!skip_transform(task.transform)) {
@@ -1706,13 +1691,14 @@ static void execute_realize_mesh_tasks(const RealizeInstancesOptions &options,
                                        const Span<RealizeMeshTask> tasks,
                                        const OrderedAttributes &ordered_attributes,
                                        const VectorSet<Material *> &ordered_materials,
+                                       const bool is_all_tasks,
                                        bke::GeometrySet &r_realized_geometry)
 {
   if (tasks.is_empty()) {
     return;
   }
 
-  if (tasks.size() == 1) {
+  if (is_all_tasks && tasks.size() == 1) {
     const RealizeMeshTask &task = tasks.first();
     Mesh *new_mesh = BKE_mesh_copy_for_eval(*task.mesh_info->mesh);
     if (!skip_transform(task.transform)) {
@@ -2068,13 +2054,14 @@ static void execute_realize_curve_tasks(const RealizeInstancesOptions &options,
                                         const AllCurvesInfo &all_curves_info,
                                         const Span<RealizeCurveTask> tasks,
                                         const OrderedAttributes &ordered_attributes,
+                                        const bool is_all_tasks,
                                         bke::GeometrySet &r_realized_geometry)
 {
   if (tasks.is_empty()) {
     return;
   }
 
-  if (tasks.size() == 1) {
+  if (is_all_tasks && tasks.size() == 1) {
     const RealizeCurveTask &task = tasks.first();
     Curves *new_curves = BKE_curves_copy_for_eval(task.curve_info->curves);
     if (!skip_transform(task.transform)) {
@@ -2462,6 +2449,118 @@ static void propagate_instances_to_keep(const bke::GeometrySet &geometry_set,
   new_instances_components.replace(new_instances.release(), bke::GeometryOwnershipType::Owned);
 }
 
+static int64_t get_task_points_num(const RealizePointCloudTask &task)
+{
+  return task.pointcloud_info->pointcloud->totpoint;
+}
+
+static int64_t get_task_points_num(const RealizeMeshTask &task)
+{
+  return task.mesh_info->mesh->verts_num;
+}
+
+static int64_t get_task_points_num(const RealizeCurveTask &task)
+{
+  return task.curve_info->curves->geometry.point_num;
+}
+
+/** Make the start indices of the tasks relative to the first task, so that they can be realized
+ * into a separate geometry. */
+static void rebase_task_start_indices(MutableSpan<RealizePointCloudTask> tasks)
+{
+  const int offset = tasks.first().start_index;
+  for (RealizePointCloudTask &task : tasks) {
+    task.start_index -= offset;
+  }
+}
+
+static void rebase_task_start_indices(MutableSpan<RealizeMeshTask> tasks)
+{
+  const MeshElementStartIndices offsets = tasks.first().start_indices;
+  for (RealizeMeshTask &task : tasks) {
+    task.start_indices.vertex -= offsets.vertex;
+    task.start_indices.edge -= offsets.edge;
+    task.start_indices.face -= offsets.face;
+    task.start_indices.loop -= offsets.loop;
+  }
+}
+
+static void rebase_task_start_indices(MutableSpan<RealizeCurveTask> tasks)
+{
+  const CurvesElementStartIndices offsets = tasks.first().start_indices;
+  for (RealizeCurveTask &task : tasks) {
+    task.start_indices.point -= offsets.point;
+    task.start_indices.curve -= offsets.curve;
+    task.start_indices.custom_knot -= offsets.custom_knot;
+  }
+}
+
+/** The geometry that is currently filled with realized tasks before it is passed on. */
+struct RealizeChunk {
+  bke::GeometrySet geometry;
+  int64_t points_num = 0;
+  int64_t max_points_num;
+  FunctionRef<void(bke::GeometrySet chunk)> fn;
+
+  void flush()
+  {
+    fn(std::move(geometry));
+    geometry = {};
+    points_num = 0;
+  }
+};
+
+/**
+ * Split the tasks of one geometry type into consecutive ranges that fit into the remaining space
+ * of the current chunk and realize each range with #execute_fn. Every range is realized into a
+ * different chunk, so that each chunk contains at most one component of every type.
+ *
+ * The second argument of #execute_fn is true when the range contains all tasks. Only then can a
+ * single task be realized by copying its geometry, otherwise the chunk would miss the `id`
+ * attribute, the remapped material indices and the attributes that only exist on other inputs.
+ */
+template<typename Task, typename ExecuteFn>
+static void execute_tasks_in_chunks(MutableSpan<Task> tasks,
+                                    RealizeChunk &chunk,
+                                    const ExecuteFn &execute_fn)
+{
+  int64_t start = 0;
+  while (start < tasks.size()) {
+    int64_t end = start;
+    int64_t range_points_num = 0;
+    while (end < tasks.size()) {
+      const int64_t task_points_num = get_task_points_num(tasks[end]);
+      /* Every chunk contains at least one task, even if that is larger than the limit. */
+      const bool chunk_is_empty = chunk.points_num == 0 && end == start;
+      if (!chunk_is_empty &&
+          chunk.points_num + range_points_num + task_points_num > chunk.max_points_num)
+      {
+        break;
+      }
+      range_points_num += task_points_num;
+      end++;
+    }
+    if (end == start) {
+      chunk.flush();
+      continue;
+    }
+
+    const MutableSpan<Task> range_tasks = tasks.slice(start, end - start);
+    rebase_task_start_indices(range_tasks);
+    /* This doesn't have to be exact at all, it's just a rough estimate to make decisions about
+     * multi-threading (overhead). */
+    const int64_t approximate_used_bytes_num = range_points_num * 32;
+    const bool is_all_tasks = range_tasks.size() == tasks.size();
+    threading::memory_bandwidth_bound_task(
+        approximate_used_bytes_num, [&]() { execute_fn(range_tasks.as_span(), is_all_tasks); });
+    chunk.points_num += range_points_num;
+    start = end;
+    if (start < tasks.size()) {
+      chunk.flush();
+    }
+  }
+}
+
 bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
                                    const RealizeInstancesOptions &options)
 {
@@ -2479,17 +2578,57 @@ bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
 bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
                                    const RealizeInstancesOptions &options,
                                    const VariedDepthOptions &varied_depth_option)
+{
+  if (!geometry_set.has_instances()) {
+    return geometry_set;
+  }
+
+  /* Without a limit, all tasks are realized into a single chunk. */
+  bke::GeometrySet new_geometry_set;
+  realize_instances_chunked(std::move(geometry_set),
+                            options,
+                            varied_depth_option,
+                            std::numeric_limits<int64_t>::max(),
+                            [&](bke::GeometrySet chunk) { new_geometry_set = std::move(chunk); });
+  return new_geometry_set;
+}
+
+void realize_instances_chunked(bke::GeometrySet geometry_set,
+                               const RealizeInstancesOptions &options,
+                               const int64_t max_chunk_points_num,
+                               const FunctionRef<void(bke::GeometrySet chunk)> fn)
+{
+  if (!geometry_set.has_instances()) {
+    fn(std::move(geometry_set));
+    return;
+  }
+
+  VariedDepthOptions all_instances;
+  all_instances.depths = VArray<int>::ForSingle(VariedDepthOptions::MAX_DEPTH,
+                                                geometry_set.get_instances()->instances_num());
+  all_instances.selection = IndexMask(geometry_set.get_instances()->instances_num());
+  realize_instances_chunked(
+      std::move(geometry_set), options, all_instances, max_chunk_points_num, fn);
+}
+
+void realize_instances_chunked(bke::GeometrySet geometry_set,
+                               const RealizeInstancesOptions &options,
+                               const VariedDepthOptions &varied_depth_option,
+                               const int64_t max_chunk_points_num,
+                               const FunctionRef<void(bke::GeometrySet chunk)> fn)
 {
   /* The algorithm works in three steps:
    * 1. Preprocess each unique geometry that is instanced (e.g. each `Mesh`).
    * 2. Gather "tasks" that need to be executed to realize the instances. Each task corresponds
    * to instances of the previously preprocessed geometry.
-   * 3. Execute all tasks in parallel.
+   * 3. Execute the tasks in parallel, in consecutive ranges that fit into the chunk size.
    */
 
   if (!geometry_set.has_instances()) {
-    return geometry_set;
+    fn(std::move(geometry_set));
+    return;
   }
+  BLI_assert(max_chunk_points_num > 0);
 
   bke::GeometrySet not_to_realize_set;
   propagate_instances_to_keep(
@@ -2537,45 +2676,57 @@ bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
   gather_realize_tasks_recursive(
       gather_info, 0, VariedDepthOptions::MAX_DEPTH, geometry_set, transform, attribute_fallbacks);
 
-  bke::GeometrySet new_geometry_set;
+  /* Instances, grease pencil layers, edit data and volumes are small, they are all put into the
+   * first chunk. */
+  RealizeChunk chunk{{}, 0, max_chunk_points_num, fn};
   execute_instances_tasks(gather_info.instances.instances_components_to_merge,
                           gather_info.instances.instances_components_transforms,
                           all_instance_attributes,
                           gather_info.instances.attribute_fallback,
-                          new_geometry_set);
-
-  const int64_t total_points_num = get_final_points_num(gather_info.r_tasks);
-  /* This doesn't have to be exact at all, it's just a rough estimate to make decisions about
-   * multi-threading (overhead). */
-  const int64_t approximate_used_bytes_num = total_points_num * 32;
-  threading::memory_bandwidth_bound_task(approximate_used_bytes_num, [&]() {
-    execute_realize_pointcloud_tasks(options,
-                                     all_pointclouds_info,
-                                     gather_info.r_tasks.pointcloud_tasks,
-                                     all_pointclouds_info.attributes,
-                                     new_geometry_set);
-    execute_realize_mesh_tasks(options,
-                               all_meshes_info,
-                               gather_info.r_tasks.mesh_tasks,
-                               all_meshes_info.attributes,
-                               all_meshes_info.materials,
-                               new_geometry_set);
-    execute_realize_curve_tasks(options,
-                                all_curves_info,
-                                gather_info.r_tasks.curve_tasks,
-                                all_curves_info.attributes,
-                                new_geometry_set);
-    execute_realize_grease_pencil_tasks(all_grease_pencils_info,
-                                        gather_info.r_tasks.grease_pencil_tasks,
-                                        all_grease_pencils_info.attributes,
-                                        new_geometry_set);
-    execute_realize_edit_data_tasks(gather_info.r_tasks.edit_data_tasks, new_geometry_set);
-  });
+                          chunk.geometry);
+  execute_realize_grease_pencil_tasks(all_grease_pencils_info,
+                                      gather_info.r_tasks.grease_pencil_tasks,
+                                      all_grease_pencils_info.attributes,
+                                      chunk.geometry);
+  execute_realize_edit_data_tasks(gather_info.r_tasks.edit_data_tasks, chunk.geometry);
   if (gather_info.r_tasks.first_volume) {
-    new_geometry_set.add(*gather_info.r_tasks.first_volume);
-  }
-
-  return new_geometry_set;
+    chunk.geometry.add(*gather_info.r_tasks.first_volume);
+  }
+
+  execute_tasks_in_chunks(
+      gather_info.r_tasks.pointcloud_tasks.as_mutable_span(),
+      chunk,
+      [&](const Span<RealizePointCloudTask> tasks, const bool is_all_tasks) {
+        execute_realize_pointcloud_tasks(options,
+                                         all_pointclouds_info,
+                                         tasks,
+                                         all_pointclouds_info.attributes,
+                                         is_all_tasks,
+                                         chunk.geometry);
+      });
+  execute_tasks_in_chunks(gather_info.r_tasks.mesh_tasks.as_mutable_span(),
+                          chunk,
+                          [&](const Span<RealizeMeshTask> tasks, const bool is_all_tasks) {
+                            execute_realize_mesh_tasks(options,
+                                                       all_meshes_info,
+                                                       tasks,
+                                                       all_meshes_info.attributes,
+                                                       all_meshes_info.materials,
+                                                       is_all_tasks,
+                                                       chunk.geometry);
+                          });
+  execute_tasks_in_chunks(
+      gather_info.r_tasks.curve_tasks.as_mutable_span(),
+      chunk,
+      [&](const Span<RealizeCurveTask> tasks, const bool is_all_tasks) {
+        execute_realize_curve_tasks(options,
+                                    all_curves_info,
+                                    tasks,
+                                    all_curves_info.attributes,
+                                    is_all_tasks,
+                                    chunk.geometry);
+      });
+  chunk.flush();
 }
 
 /** \} */
@@ -0,0 +1,167 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "BKE_attribute.hh"
+#include "BKE_geometry_set.hh"
+#include "BKE_idtype.hh"
+#include "BKE_instances.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_material.hh"
+#include "BKE_mesh.hh"
+#include "BKE_pointcloud.hh"
+
+#include "BLI_math_matrix.hh"
+
+#include "DNA_material_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_pointcloud_types.h"
+
+#include "GEO_mesh_primitive_cuboid.hh"
+#include "GEO_mesh_primitive_grid.hh"
+#include "GEO_realize_instances.hh"
+
+#include "CLG_log.h"
+
+#include "testing/testing.h"
+
+namespace blender::geometry::tests {
+
+class RealizeInstancesTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    CLG_exit();
+  }
+};
+
+/**
+ * Instance the first geometry once and the second one twice, with an `id` attribute on the
+ * instances.
+ */
+static bke::GeometrySet instance_geometries(bke::GeometrySet geometry_a,
+                                            bke::GeometrySet geometry_b)
+{
+  auto instances = std::make_unique<bke::Instances>();
+  const int handle_a = instances->add_reference(bke::InstanceReference{std::move(geometry_a)});
+  const int handle_b = instances->add_reference(bke::InstanceReference{std::move(geometry_b)});
+  instances->add_instance(handle_a, math::from_location<float4x4>(float3(1.0f, 0.0f, 0.0f)));
+  instances->add_instance(handle_b, math::from_location<float4x4>(float3(0.0f, 2.0f, 0.0f)));
+  instances->add_instance(handle_b, math::from_location<float4x4>(float3(0.0f, 0.0f, 3.0f)));
+  bke::SpanAttributeWriter<int> ids =
+      instances->attributes_for_write().lookup_or_add_for_write_span<int>(
+          "id", bke::AttrDomain::Instance);
+  ids.span.copy_from({10, 20, 30});
+  ids.finish();
+  return bke::GeometrySet::from_instances(instances.release());
+}
+
+/**
+ * Check that joining the attributes of the chunks gives the attributes of the unchunked result.
+ */
+static void expect_chunks_equal_joined(const Span<bke::GeometrySet> chunks,
+                                       const bke::GeometrySet &joined,
+                                       const bke::GeometryComponent::Type component_type)
+{
+  const bke::AttributeAccessor joined_attributes =
+      *joined.get_component(component_type)->attributes();
+  joined_attributes.foreach_attribute([&](const bke::AttributeIter &iter) {
+    const GVArraySpan joined_data = *iter.get();
+    const CPPType &type = joined_data.type();
+    int64_t offset = 0;
+    for (const bke::GeometrySet &chunk : chunks) {
+      const bke::AttributeAccessor chunk_attributes =
+          *chunk.get_component(component_type)->attributes();
+      const bke::GAttributeReader chunk_data = chunk_attributes.lookup(
+          iter.name, iter.domain, iter.data_type);
+      ASSERT_TRUE(bool(chunk_data)) << iter.name;
+      const GVArraySpan chunk_span = *chunk_data;
+      for (const int64_t i : IndexRange(chunk_span.size())) {
+        EXPECT_TRUE(type.is_equal(chunk_span[i], joined_data[offset + i])) << iter.name;
+      }
+      offset += chunk_span.size();
+    }
+    EXPECT_EQ(offset, joined_data.size()) << iter.name;
+  });
+}
+
+TEST_F(RealizeInstancesTest, ChunkedPointCloudsWithSingleTask)
+{
+  PointCloud *pointcloud_a = BKE_pointcloud_new_nomain(3);
+  pointcloud_a->positions_for_write().fill(float3(1.0f));
+  bke::SpanAttributeWriter<float> attribute =
+      pointcloud_a->attributes_for_write().lookup_or_add_for_write_span<float>(
+          "a", bke::AttrDomain::Point);
+  attribute.span.copy_from({1.0f, 2.0f, 3.0f});
+  attribute.finish();
+  PointCloud *pointcloud_b = BKE_pointcloud_new_nomain(5);
+  pointcloud_b->positions_for_write().fill(float3(-1.0f));
+
+  const bke::GeometrySet geometry = instance_geometries(
+      bke::GeometrySet::from_pointcloud(pointcloud_a),
+      bke::GeometrySet::from_pointcloud(pointcloud_b));
+
+  const RealizeInstancesOptions options;
+  const bke::GeometrySet joined = realize_instances(geometry, options);
+  ASSERT_TRUE(joined.has_pointcloud());
+  EXPECT_TRUE(joined.get_pointcloud()->attributes().contains("id"));
+  EXPECT_TRUE(joined.get_pointcloud()->attributes().contains("a"));
+
+  /* Every chunk contains a single instance. */
+  Vector<bke::GeometrySet> chunks;
+  realize_instances_chunked(
+      geometry, options, 5, [&](bke::GeometrySet chunk) { chunks.append(std::move(chunk)); });
+  ASSERT_EQ(chunks.size(), 3);
+  EXPECT_EQ(chunks[0].get_pointcloud()->totpoint, 3);
+  EXPECT_EQ(chunks[1].get_pointcloud()->totpoint, 5);
+  EXPECT_EQ(chunks[2].get_pointcloud()->totpoint, 5);
+  expect_chunks_equal_joined(chunks, joined, bke::GeometryComponent::Type::PointCloud);
+}
+
+TEST_F(RealizeInstancesTest, ChunkedMeshesWithSingleTask)
+{
+  Material *material = BKE_id_new_nomain<Material>("Material");
+  {
+    Mesh *mesh_a = create_grid_mesh(2, 2, 1.0f, 1.0f, std::nullopt);
+    bke::SpanAttributeWriter<int> attribute =
+        mesh_a->attributes_for_write().lookup_or_add_for_write_span<int>("a",
+                                                                         bke::AttrDomain::Face);
+    attribute.span.fill(7);
+    attribute.finish();
+    Mesh *mesh_b = create_cuboid_mesh(float3(1.0f), 2, 2, 2);
+    BKE_id_material_eval_assign(&mesh_b->id, 1, material);
+
+    const bke::GeometrySet geometry = instance_geometries(bke::GeometrySet::from_mesh(mesh_a),
+                                                          bke::GeometrySet::from_mesh(mesh_b));
+
+    const RealizeInstancesOptions options;
+    const bke::GeometrySet joined = realize_instances(geometry, options);
+    const Mesh &joined_mesh = *joined.get_mesh();
+    EXPECT_EQ(joined_mesh.totcol, 2);
+    EXPECT_TRUE(joined_mesh.attributes().contains("id"));
+    EXPECT_TRUE(joined_mesh.attributes().contains("a"));
+    EXPECT_TRUE(joined_mesh.attributes().contains("material_index"));
+
+    /* Every chunk contains a single instance. */
+    Vector<bke::GeometrySet> chunks;
+    realize_instances_chunked(
+        geometry, options, 8, [&](bke::GeometrySet chunk) { chunks.append(std::move(chunk)); });
+    ASSERT_EQ(chunks.size(), 3);
+    EXPECT_EQ(chunks[0].get_mesh()->verts_num, 4);
+    EXPECT_EQ(chunks[1].get_mesh()->verts_num, 8);
+    EXPECT_EQ(chunks[2].get_mesh()->verts_num, 8);
+    for (const bke::GeometrySet &chunk : chunks) {
+      EXPECT_EQ(chunk.get_mesh()->totcol, joined_mesh.totcol);
+    }
+    expect_chunks_equal_joined(chunks, joined, bke::GeometryComponent::Type::Mesh);
+  }
+  BKE_id_free(nullptr, material);
+}
+
+}  // namespace blender::geometry::tests
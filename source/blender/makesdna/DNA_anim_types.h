@@ -22,6 +22,15 @@
 #  include <type_traits>
 #endif
 
+#ifdef __cplusplus
+namespace blender::bke {
+class AnimDataRuntime;
+}  // namespace blender::bke
+using AnimDataRuntimeHandle = blender::bke::AnimDataRuntime;
+#else
+typedef struct AnimDataRuntimeHandle AnimDataRuntimeHandle;
+#endif
+
 /* ************************************************ */
 /* F-Curve DataTypes */
 
@@ -713,6 +722,8 @@ typedef struct AnimData {
 
   /** Runtime data, for depsgraph evaluation. */
   FCurve **driver_array;
+  /** Runtime data, compiled evaluation plans. Only allocated for evaluated copies. */
+  AnimDataRuntimeHandle *runtime;
 
   /* settings for animation evaluation */
   /** User-defined settings. */
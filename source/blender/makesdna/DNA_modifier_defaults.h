@@ -615,6 +615,7 @@
     .uv_smooth = SUBSURF_UV_SMOOTH_PRESERVE_BOUNDARIES, \
     .quality = 3, \
     .boundary_smooth = SUBSURF_BOUNDARY_SMOOTH_ALL, \
+    .adaptive_pixel_size = 4.0f, \
     .emCache = NULL, \
     .mCache = NULL, \
   }
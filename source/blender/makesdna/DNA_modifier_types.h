@@ -229,6 +229,8 @@ typedef enum {
   eSubsurfModifierFlag_UseCrease = (1 << 4),
   eSubsurfModifierFlag_UseCustomNormals = (1 << 5),
   eSubsurfModifierFlag_UseRecursiveSubdivision = (1 << 6),
+  /** Lower the level when the object covers few pixels in the scene camera. */
+  eSubsurfModifierFlag_UseAdaptiveLevel = (1 << 7),
 } SubsurfModifierFlag;
 
 typedef enum {
@@ -258,6 +260,12 @@ typedef struct SubsurfModifierData {
   short quality;
   short boundary_smooth;
   char _pad[2];
+  /**
+   * Target on-screen length of subdivided edges in pixels, used with
+   * #eSubsurfModifierFlag_UseAdaptiveLevel.
+   */
+  float adaptive_pixel_size;
+  char _pad1[4];
 
   /* TODO(sergey): Get rid of those with the old CCG subdivision code. */
   void *emCache, *mCache;
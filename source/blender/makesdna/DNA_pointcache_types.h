@@ -153,4 +153,6 @@ enum {
   PTCACHE_COMPRESS_NO = 0,
   PTCACHE_COMPRESS_LZO = 1,
   PTCACHE_COMPRESS_LZMA = 2,
+  /** Zstandard, arrays of a frame are compressed and decompressed in parallel. */
+  PTCACHE_COMPRESS_ZSTD = 3,
 };
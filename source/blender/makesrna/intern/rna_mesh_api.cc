@@ -196,6 +196,7 @@ static void rna_Mesh_update(Mesh *mesh,
   mesh->runtime->vert_normals_cache.tag_dirty();
   mesh->runtime->face_normals_cache.tag_dirty();
   mesh->runtime->corner_normals_cache.tag_dirty();
+  mesh->runtime->uv_tangents_cache.tag_dirty();
   mesh->runtime->vert_normals_true_cache.tag_dirty();
   mesh->runtime->face_normals_true_cache.tag_dirty();
 
@@ -2541,6 +2541,24 @@ static void rna_def_modifier_subsurf(BlenderRNA *brna)
                            "levels of subdivision (smoothest possible shape)");
   RNA_def_property_update(prop, 0, "rna_Modifier_update");
 
+  prop = RNA_def_property(srna, "use_adaptive_level", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "flags", eSubsurfModifierFlag_UseAdaptiveLevel);
+  RNA_def_property_ui_text(prop,
+                           "Camera Adaptive",
+                           "Use fewer levels when the object covers few pixels in the active "
+                           "scene camera");
+  RNA_def_property_update(prop, 0, "rna_Modifier_dependency_update");
+
+  prop = RNA_def_property(srna, "adaptive_pixel_size", PROP_FLOAT, PROP_PIXEL);
+  RNA_def_property_float_sdna(prop, nullptr, "adaptive_pixel_size");
+  RNA_def_property_range(prop, 0.1f, 1000.0f);
+  RNA_def_property_ui_range(prop, 0.5f, 100.0f, 10, 1);
+  RNA_def_property_ui_text(prop,
+                           "Pixel Size",
+                           "Size of subdivided edges in pixels of the camera render resolution, "
+                           "levels are only added while edges are longer than this");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
   rna_def_modifier_panel_open_prop(srna, "open_adaptive_subdivision_panel", 0);
   rna_def_modifier_panel_open_prop(srna, "open_advanced_panel", 1);
 
@@ -961,6 +961,12 @@ static void rna_def_pointcache_common(StructRNA *srna)
       {PTCACHE_COMPRESS_NO, "NO", 0, "None", "No compression"},
       {PTCACHE_COMPRESS_LZO, "LIGHT", 0, "Lite", "Fast but not so effective compression"},
       {PTCACHE_COMPRESS_LZMA, "HEAVY", 0, "Heavy", "Effective but slow compression"},
+      {PTCACHE_COMPRESS_ZSTD,
+       "ZSTD",
+       0,
+       "Zstandard",
+       "Fast multi-threaded compression, suited for large caches that are played back often. "
+       "Caches written with it can not be read by Blender 4.4 and older"},
       {0, nullptr, 0, nullptr, nullptr},
   };
 
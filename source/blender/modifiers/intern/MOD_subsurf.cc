@@ -13,6 +13,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_math_matrix.hh"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.hh"
@@ -23,6 +24,7 @@
 #include "DNA_scene_types.h"
 #include "DNA_screen_types.h"
 
+#include "BKE_camera.h"
 #include "BKE_context.hh"
 #include "BKE_editmesh.hh"
 #include "BKE_global.hh"
@@ -45,6 +47,7 @@
 #include "RNA_prototypes.hh"
 
 #include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_build.hh"
 #include "DEG_depsgraph_query.hh"
 
 #include "MOD_modifiertypes.hh"
@@ -111,22 +114,65 @@ static bool is_disabled(const Scene *scene, ModifierData *md, bool use_render_pa
   return get_render_subsurf_level(&scene->r, levels, use_render_params != 0) == 0;
 }
 
+/**
+ * Lower the level so that subdivided edges are not much shorter than
+ * #SubsurfModifierData::adaptive_pixel_size in the scene camera.
+ */
+static int subdiv_adaptive_level_get(const SubsurfModifierData *smd,
+                                     const ModifierEvalContext *ctx,
+                                     const Mesh &mesh,
+                                     const int requested_levels)
+{
+  using namespace blender;
+  const Scene *scene = DEG_get_evaluated_scene(ctx->depsgraph);
+  const Object *camera = scene->camera;
+  if (camera == nullptr || camera->type != OB_CAMERA || smd->adaptive_pixel_size <= 0.0f) {
+    return requested_levels;
+  }
+
+  int width, height;
+  BKE_render_resolution(&scene->r, false, &width, &height);
+
+  CameraParams params;
+  BKE_camera_params_init(&params);
+  BKE_camera_params_from_object(&params, camera);
+  BKE_camera_params_compute_viewplane(&params, width, height, scene->r.xasp, scene->r.yasp);
+  BKE_camera_params_compute_matrix(&params);
+
+  const float4x4 object_to_clip = float4x4(params.winmat) * camera->world_to_object() *
+                                  ctx->object->object_to_world();
+  return BKE_subsurf_modifier_adaptive_level_get(mesh.vert_positions(),
+                                                 mesh.edges(),
+                                                 object_to_clip,
+                                                 int2(width, height),
+                                                 smd->adaptive_pixel_size,
+                                                 requested_levels);
+}
+
 static int subdiv_levels_for_modifier_get(const SubsurfModifierData *smd,
-                                          const ModifierEvalContext *ctx)
+                                          const ModifierEvalContext *ctx,
+                                          const Mesh &mesh)
 {
   Scene *scene = DEG_get_evaluated_scene(ctx->depsgraph);
   const bool use_render_params = (ctx->flag & MOD_APPLY_RENDER);
   const int requested_levels = (use_render_params) ? smd->renderLevels : smd->levels;
-  return get_render_subsurf_level(&scene->r, requested_levels, use_render_params);
+  const int levels = get_render_subsurf_level(&scene->r, requested_levels, use_render_params);
+  if ((smd->flags & eSubsurfModifierFlag_UseAdaptiveLevel) &&
+      !(ctx->flag & MOD_APPLY_TO_ORIGINAL))
+  {
+    return subdiv_adaptive_level_get(smd, ctx, mesh, levels);
+  }
+  return levels;
 }
 
 /* Subdivide into fully qualified mesh. */
 
 static void subdiv_mesh_settings_init(blender::bke::subdiv::ToMeshSettings *settings,
                                       const SubsurfModifierData *smd,
-                                      const ModifierEvalContext *ctx)
+                                      const ModifierEvalContext *ctx,
+                                      const Mesh &mesh)
 {
-  const int level = subdiv_levels_for_modifier_get(smd, ctx);
+  const int level = subdiv_levels_for_modifier_get(smd, ctx, mesh);
   settings->resolution = (1 << level) + 1;
   settings->use_optimal_display = (smd->flags & eSubsurfModifierFlag_ControlEdges) &&
                                   !(ctx->flag & MOD_APPLY_TO_ORIGINAL);
@@ -139,7 +185,7 @@ static Mesh *subdiv_as_mesh(SubsurfModifierData *smd,
 {
   Mesh *result = mesh;
   blender::bke::subdiv::ToMeshSettings mesh_settings;
-  subdiv_mesh_settings_init(&mesh_settings, smd, ctx);
+  subdiv_mesh_settings_init(&mesh_settings, smd, ctx, *mesh);
   if (mesh_settings.resolution < 3) {
     return result;
   }
@@ -151,9 +197,10 @@ static Mesh *subdiv_as_mesh(SubsurfModifierData *smd,
 
 static void subdiv_ccg_settings_init(SubdivToCCGSettings *settings,
                                      const SubsurfModifierData *smd,
-                                     const ModifierEvalContext *ctx)
+                                     const ModifierEvalContext *ctx,
+                                     const Mesh &mesh)
 {
-  const int level = subdiv_levels_for_modifier_get(smd, ctx);
+  const int level = subdiv_levels_for_modifier_get(smd, ctx, mesh);
   settings->resolution = (1 << level) + 1;
   settings->need_normal = true;
   settings->need_mask = false;
@@ -166,7 +213,7 @@ static Mesh *subdiv_as_ccg(SubsurfModifierData *smd,
 {
   Mesh *result = mesh;
   SubdivToCCGSettings ccg_settings;
-  subdiv_ccg_settings_init(&ccg_settings, smd, ctx);
+  subdiv_ccg_settings_init(&ccg_settings, smd, ctx, *mesh);
   if (ccg_settings.resolution < 3) {
     return result;
   }
@@ -183,7 +230,7 @@ static void subdiv_cache_mesh_wrapper_settings(const ModifierEvalContext *ctx,
                                                const bool has_gpu_subdiv)
 {
   blender::bke::subdiv::ToMeshSettings mesh_settings;
-  subdiv_mesh_settings_init(&mesh_settings, smd, ctx);
+  subdiv_mesh_settings_init(&mesh_settings, smd, ctx, *mesh);
 
   runtime_data->has_gpu_subdiv = has_gpu_subdiv;
   runtime_data->resolution = mesh_settings.resolution;
@@ -337,6 +384,20 @@ static void deform_matrices(ModifierData *md,
   }
 }
 
+static void update_depsgraph(ModifierData *md, const ModifierUpdateDepsgraphContext *ctx)
+{
+  SubsurfModifierData *smd = (SubsurfModifierData *)md;
+  if (smd->flags & eSubsurfModifierFlag_UseAdaptiveLevel) {
+    DEG_add_scene_camera_relation(
+        ctx->node, ctx->scene, DEG_OB_COMP_TRANSFORM, "Subdivision Surface Modifier");
+    DEG_add_scene_camera_relation(
+        ctx->node, ctx->scene, DEG_OB_COMP_PARAMETERS, "Subdivision Surface Modifier");
+    DEG_add_scene_relation(
+        ctx->node, ctx->scene, DEG_SCENE_COMP_PARAMETERS, "Subdivision Surface Modifier");
+    DEG_add_depends_on_transform_relation(ctx->node, "Subdivision Surface Modifier");
+  }
+}
+
 #ifdef WITH_CYCLES
 static bool get_show_adaptive_options(const bContext *C, Panel *panel)
 {
@@ -399,6 +460,12 @@ static void panel_draw(const bContext *C, Panel *panel)
   col->prop(ptr, "levels", UI_ITEM_NONE, IFACE_("Levels Viewport"), ICON_NONE);
   col->prop(ptr, "render_levels", UI_ITEM_NONE, IFACE_("Render"), ICON_NONE);
 
+  uiLayout *row = &layout->row(true, IFACE_("Camera Adaptive"));
+  row->prop(ptr, "use_adaptive_level", UI_ITEM_NONE, "", ICON_NONE);
+  uiLayout *sub = &row->row(true);
+  uiLayoutSetActive(sub, RNA_boolean_get(ptr, "use_adaptive_level"));
+  sub->prop(ptr, "adaptive_pixel_size", UI_ITEM_NONE, "", ICON_NONE);
+
   layout->prop(ptr, "show_only_control_edges", UI_ITEM_NONE, std::nullopt, ICON_NONE);
 
   Depsgraph *depsgraph = CTX_data_depsgraph_pointer(C);
@@ -510,7 +577,7 @@ ModifierTypeInfo modifierType_Subsurf = {
     /*required_data_mask*/ nullptr,
     /*free_data*/ free_data,
     /*is_disabled*/ is_disabled,
-    /*update_depsgraph*/ nullptr,
+    /*update_depsgraph*/ update_depsgraph,
     /*depends_on_time*/ nullptr,
     /*depends_on_normals*/ nullptr,
     /*foreach_ID_link*/ nullptr,
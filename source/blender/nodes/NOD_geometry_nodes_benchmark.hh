@@ -0,0 +1,20 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup nodes
+ */
+
+namespace blender::nodes {
+
+/**
+ * Register the `geometry-nodes-benchmark` command (see #BKE_blender_cli_command.hh). It evaluates
+ * the Geometry Nodes modifiers of the loaded file repeatedly without any UI, and writes the total
+ * and per-node execution times as well as the peak memory usage as JSON.
+ */
+void geometry_nodes_benchmark_command_register();
+
+}  // namespace blender::nodes
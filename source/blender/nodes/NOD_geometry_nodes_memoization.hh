@@ -0,0 +1,52 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup nodes
+ *
+ * Memoization of geometry node outputs across evaluations.
+ *
+ * Changing an input of a node tree re-evaluates the entire tree, even the nodes that don't depend
+ * on the changed input. For nodes marked with #bNodeType::geometry_node_memoizable, the outputs
+ * are stored in the global memory cache (see #BLI_memory_cache.hh), keyed by the compute context,
+ * the node settings and all input values. Geometry inputs are identified by the implicit sharing
+ * data of their attributes, so a node is only skipped when its input geometry is still made up of
+ * the same arrays. Since the outputs of a memoized node are reused as is, the nodes after it can
+ * be skipped as well, and only the part of the tree that depends on the change is evaluated again.
+ *
+ * Nodes are only memoized when the experimental preference is enabled and all their inputs can be
+ * identified, e.g. nodes with ID inputs, operation fields or volumes are always executed.
+ */
+
+#include "BLI_function_ref.hh"
+
+#include "FN_lazy_function.hh"
+
+struct bNode;
+
+namespace blender::nodes {
+
+namespace lf = fn::lazy_function;
+
+/**
+ * True when the node type allows memoization and the outputs of its lazy-function can be stored in
+ * the cache. Other nodes are always executed.
+ */
+bool geometry_node_is_memoizable(const bNode &node, Span<lf::Output> outputs);
+
+/**
+ * Execute the geometry node, or reuse the outputs of a previous execution with the same inputs.
+ * The caller has to make sure that all inputs are available already.
+ *
+ * \param execute_fn: Executes the node with the given params. They may wrap the original params
+ * to gather the outputs.
+ */
+void execute_geometry_node_memoized(const bNode &node,
+                                    lf::Params &params,
+                                    const lf::Context &context,
+                                    FunctionRef<void(lf::Params &params)> execute_fn);
+
+}  // namespace blender::nodes
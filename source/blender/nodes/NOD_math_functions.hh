@@ -34,6 +34,15 @@ const FloatMathOperationInfo *get_float_math_operation_info(int operation);
 const FloatMathOperationInfo *get_float3_math_operation_info(int operation);
 const FloatMathOperationInfo *get_float_compare_operation_info(int operation);
 
+/**
+ * Get a multi-function for the operation that uses the array functions from
+ * `BLI_math_vectorized.hh`, or null when there is none. Those are much faster than calling the
+ * standard library functions for every element, so they are used instead of the functions passed
+ * to the callbacks of the dispatch functions below.
+ */
+const mf::MultiFunction *get_vectorized_float_math_function(int operation);
+const mf::MultiFunction *get_vectorized_float3_math_function(NodeVectorMathOperation operation);
+
 /**
  * This calls the `callback` with two arguments:
  * 1. The math function that takes a float as input and outputs a new float.
@@ -227,6 +227,7 @@ static void node_register()
       ntype, "NodeGeometryCurveResample", node_free_standard_storage, node_copy_standard_storage);
   ntype.initfunc = node_init;
   ntype.geometry_node_execute = node_geo_exec;
+  ntype.geometry_node_memoizable = true;
   blender::bke::node_register_type(ntype);
 
   node_rna(ntype.rna_ext.srna);
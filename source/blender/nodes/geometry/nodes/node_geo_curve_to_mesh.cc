@@ -158,6 +158,7 @@ static void node_register()
   ntype.nclass = NODE_CLASS_GEOMETRY;
   ntype.declare = node_declare;
   ntype.geometry_node_execute = node_geo_exec;
+  ntype.geometry_node_memoizable = true;
   blender::bke::node_register_type(ntype);
 }
 NOD_REGISTER_NODE(node_register)
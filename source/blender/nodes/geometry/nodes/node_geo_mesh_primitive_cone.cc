@@ -162,6 +162,7 @@ static void node_register()
   blender::bke::node_type_storage(
       ntype, "NodeGeometryMeshCone", node_free_standard_storage, node_copy_standard_storage);
   ntype.geometry_node_execute = node_geo_exec;
+  ntype.geometry_node_memoizable = true;
   ntype.draw_buttons = node_layout;
   ntype.declare = node_declare;
   blender::bke::node_register_type(ntype);
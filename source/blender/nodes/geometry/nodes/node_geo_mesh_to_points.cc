@@ -247,6 +247,7 @@ static void node_register()
   ntype.nclass = NODE_CLASS_GEOMETRY;
   ntype.declare = node_declare;
   ntype.geometry_node_execute = node_geo_exec;
+  ntype.geometry_node_memoizable = true;
   ntype.initfunc = node_init;
   ntype.draw_buttons = node_layout;
   blender::bke::node_type_storage(
@@ -11,7 +11,7 @@
 
 #include "DNA_pointcloud_types.h"
 
-#include "BLI_sort.hh"
+#include "BLI_radix_sort.hh"
 #include "BLI_task.hh"
 
 #include "GEO_randomize.hh"
@@ -41,20 +41,10 @@ static void grouped_sort(const OffsetIndices<int> offsets,
                          const Span<float> weights,
                          MutableSpan<int> indices)
 {
-  const auto comparator = [&](const int index_a, const int index_b) {
-    const float weight_a = weights[index_a];
-    const float weight_b = weights[index_b];
-    if (UNLIKELY(weight_a == weight_b)) {
-      /* Approach to make it stable. */
-      return index_a < index_b;
-    }
-    return weight_a < weight_b;
-  };
-
+  /* Points with the same weight keep their original order in the curve. */
   threading::parallel_for(offsets.index_range(), 250, [&](const IndexRange range) {
     for (const int group_index : range) {
-      MutableSpan<int> group = indices.slice(offsets[group_index]);
-      parallel_sort(group.begin(), group.end(), comparator);
+      radix_sort_indices(weights, indices.slice(offsets[group_index]));
     }
   });
 }
@@ -9,7 +9,7 @@
 
 #include "BLI_array_utils.hh"
 #include "BLI_index_mask.hh"
-#include "BLI_sort.hh"
+#include "BLI_radix_sort.hh"
 #include "BLI_task.hh"
 
 #include "GEO_reorder.hh"
@@ -51,20 +51,11 @@ static void grouped_sort(const OffsetIndices<int> offsets,
                          const Span<float> weights,
                          MutableSpan<int> indices)
 {
-  const auto comparator = [&](const int index_a, const int index_b) {
-    const float weight_a = weights[index_a];
-    const float weight_b = weights[index_b];
-    if (UNLIKELY(weight_a == weight_b)) {
-      /* Approach to make it stable. */
-      return index_a < index_b;
-    }
-    return weight_a < weight_b;
-  };
-
+  /* The indices in each group are sorted already, so the stable sort orders indices with the same
+   * weight by their index. */
   threading::parallel_for(offsets.index_range(), 250, [&](const IndexRange range) {
     for (const int group_index : range) {
-      MutableSpan<int> group = indices.slice(offsets[group_index]);
-      parallel_sort(group.begin(), group.end(), comparator);
+      radix_sort_indices(weights, indices.slice(offsets[group_index]));
     }
   });
 }
@@ -112,9 +103,7 @@ static int identifiers_to_indices(MutableSpan<int> r_identifiers_to_indices)
 
   Array<int> indices(deduplicated_identifiers.size());
   array_utils::fill_index_range<int>(indices);
-  parallel_sort(indices.begin(), indices.end(), [&](const int index_a, const int index_b) {
-    return deduplicated_identifiers[index_a] < deduplicated_identifiers[index_b];
-  });
+  radix_sort_indices(deduplicated_identifiers.as_span(), indices);
   Array<int> permutation = invert_permutation(indices);
   parallel_transform(
       r_identifiers_to_indices, 4096, [&](const int index) { return permutation[index]; });
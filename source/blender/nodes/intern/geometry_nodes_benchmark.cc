@@ -0,0 +1,330 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup nodes
+ *
+ * Command-line benchmark for Geometry Nodes modifiers, e.g.:
+ * `blender -b file.blend --command geometry-nodes-benchmark --iterations 20 --output out.json`
+ *
+ * The per-node timings are the same ones that are displayed in the node editor overlay. They are
+ * only gathered for the nodes in the modifier node group itself, the time of nested node groups
+ * is attributed to the group node.
+ */
+
+#include <algorithm>
+#include <iostream>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_fileops.hh"
+#include "BLI_listbase.h"
+#include "BLI_map.hh"
+#include "BLI_serialize.hh"
+#include "BLI_string.h"
+#include "BLI_time.h"
+#include "BLI_vector.hh"
+
+#include "DNA_modifier_types.h"
+#include "DNA_node_types.h"
+#include "DNA_object_types.h"
+
+#include "BKE_blender_cli_command.hh"
+#include "BKE_compute_contexts.hh"
+#include "BKE_context.hh"
+#include "BKE_layer.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_main.hh"
+#include "BKE_modifier.hh"
+#include "BKE_node_runtime.hh"
+#include "BKE_scene.hh"
+
+#include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_query.hh"
+
+#include "MOD_nodes.hh"
+
+#include "NOD_geometry_nodes_benchmark.hh"
+#include "NOD_geometry_nodes_log.hh"
+
+namespace blender::nodes {
+
+namespace geo_log = geo_eval_log;
+
+struct BenchmarkSettings {
+  int iterations = 10;
+  int warmup = 2;
+  /** Only modifiers matching one of these filters (`Object` or `Object/Modifier`) are measured. */
+  Vector<std::string> filters;
+  std::string output_path;
+};
+
+/** A modifier that is evaluated by the benchmark and the timings gathered for it. */
+struct BenchmarkTarget {
+  Object *object;
+  NodesModifierData *nmd;
+  Vector<double> modifier_times;
+  /** Execution times of the nodes in the modifier node group, by node identifier. */
+  Map<int32_t, Vector<double>> node_times;
+};
+
+static void print_help()
+{
+  std::cout << "Usage: blender file.blend --command geometry-nodes-benchmark [options]\n"
+               "\n"
+               "Evaluate the Geometry Nodes modifiers of all visible objects repeatedly and write\n"
+               "the total and per-node execution times and the peak memory usage as JSON.\n"
+               "Per-node times only cover the nodes of the modifier node groups themselves, the\n"
+               "time spent in nested node groups is reported for the group node.\n"
+               "\n"
+               "Options:\n"
+               "  --iterations <count>  Number of measured evaluations (default 10).\n"
+               "  --warmup <count>      Number of evaluations before measuring (default 2).\n"
+               "  --modifier <name>     Only measure the modifiers of the given object, or a\n"
+               "                        single modifier with \"Object/Modifier\". Can be passed\n"
+               "                        multiple times.\n"
+               "  --output <path>       Write the results to a file instead of the standard\n"
+               "                        output.\n";
+}
+
+static bool parse_count(const char *str, int &r_value)
+{
+  char *end;
+  const long value = strtol(str, &end, 10);
+  if (end == str || *end != '\0' || value < 0 || value > INT32_MAX) {
+    return false;
+  }
+  r_value = int(value);
+  return true;
+}
+
+static bool parse_args(const int argc, const char **argv, BenchmarkSettings &r_settings)
+{
+  for (int i = 0; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (STR_ELEM(arg, "--iterations", "--warmup", "--modifier", "--output") && !value) {
+      std::cerr << "Missing value for " << arg << std::endl;
+      return false;
+    }
+    if (STREQ(arg, "--iterations")) {
+      if (!parse_count(value, r_settings.iterations) || r_settings.iterations == 0) {
+        std::cerr << "Invalid iteration count: " << value << std::endl;
+        return false;
+      }
+    }
+    else if (STREQ(arg, "--warmup")) {
+      if (!parse_count(value, r_settings.warmup)) {
+        std::cerr << "Invalid warmup count: " << value << std::endl;
+        return false;
+      }
+    }
+    else if (STREQ(arg, "--modifier")) {
+      r_settings.filters.append(value);
+    }
+    else if (STREQ(arg, "--output")) {
+      r_settings.output_path = value;
+    }
+    else {
+      std::cerr << "Unknown argument: " << arg << std::endl;
+      return false;
+    }
+    i++;
+  }
+  return true;
+}
+
+static bool target_matches_filters(const Object &object,
+                                   const ModifierData &md,
+                                   const Span<std::string> filters)
+{
+  if (filters.is_empty()) {
+    return true;
+  }
+  const std::string object_name = BKE_id_name(object.id);
+  const std::string modifier_name = object_name + "/" + md.name;
+  return std::any_of(filters.begin(), filters.end(), [&](const std::string &filter) {
+    return ELEM(filter, object_name, modifier_name);
+  });
+}
+
+static Vector<BenchmarkTarget> find_targets(const Scene &scene,
+                                            ViewLayer &view_layer,
+                                            const Span<std::string> filters)
+{
+  Vector<BenchmarkTarget> targets;
+  BKE_view_layer_synced_ensure(&scene, &view_layer);
+  LISTBASE_FOREACH (Base *, base, BKE_view_layer_object_bases_get(&view_layer)) {
+    Object *object = base->object;
+    LISTBASE_FOREACH (ModifierData *, md, &object->modifiers) {
+      if (md->type != eModifierType_Nodes || !(md->mode & eModifierMode_Realtime)) {
+        continue;
+      }
+      NodesModifierData *nmd = reinterpret_cast<NodesModifierData *>(md);
+      if (nmd->node_group == nullptr || !target_matches_filters(*object, *md, filters)) {
+        continue;
+      }
+      targets.append({object, nmd});
+    }
+  }
+  return targets;
+}
+
+/** Gather the timings of the last evaluation of the modifier. */
+static void gather_timings(const Depsgraph &depsgraph, BenchmarkTarget &target)
+{
+  const Object *object_eval = DEG_get_evaluated(&depsgraph, target.object);
+  if (const ModifierData *md_eval = BKE_modifiers_findby_persistent_uid(
+          object_eval, target.nmd->modifier.persistent_uid))
+  {
+    target.modifier_times.append(md_eval->execution_time);
+  }
+
+  geo_log::GeoNodesLog *eval_log = target.nmd->runtime->eval_log.get();
+  if (eval_log == nullptr) {
+    return;
+  }
+  const bke::ModifierComputeContext compute_context{nullptr, *target.nmd};
+  geo_log::GeoTreeLog &tree_log = eval_log->get_tree_log(compute_context.hash());
+  tree_log.ensure_execution_times();
+  for (const auto item : tree_log.nodes.items()) {
+    const double seconds = std::chrono::duration<double>(item.value.execution_time).count();
+    target.node_times.lookup_or_add_default(item.key).append(seconds);
+  }
+}
+
+static void add_timing_stats(io::serialize::DictionaryValue &dict, const Span<double> samples)
+{
+  double sum = 0.0;
+  for (const double sample : samples) {
+    sum += sample;
+  }
+  dict.append_double("mean", samples.is_empty() ? 0.0 : sum / samples.size());
+  dict.append_double("min",
+                     samples.is_empty() ? 0.0 : *std::min_element(samples.begin(), samples.end()));
+  dict.append_double("max",
+                     samples.is_empty() ? 0.0 : *std::max_element(samples.begin(), samples.end()));
+}
+
+static void add_target_results(io::serialize::ArrayValue &array, const BenchmarkTarget &target)
+{
+  const bNodeTree &tree = *target.nmd->node_group;
+  io::serialize::DictionaryValue &dict = *array.append_dict();
+  dict.append_str("object", BKE_id_name(target.object->id));
+  dict.append_str("modifier", target.nmd->modifier.name);
+  dict.append_str("node_group", BKE_id_name(tree.id));
+  add_timing_stats(*dict.append_dict("time"), target.modifier_times);
+
+  /* Sort the nodes by their mean execution time, so that the most expensive ones come first. */
+  Vector<std::pair<const bNode *, double>> nodes;
+  for (const auto item : target.node_times.items()) {
+    if (const bNode *node = tree.node_by_id(item.key)) {
+      double sum = 0.0;
+      for (const double sample : item.value) {
+        sum += sample;
+      }
+      nodes.append({node, sum / item.value.size()});
+    }
+  }
+  std::sort(nodes.begin(), nodes.end(), [](const auto &a, const auto &b) {
+    return a.second > b.second;
+  });
+
+  io::serialize::ArrayValue &nodes_array = *dict.append_array("nodes");
+  for (const auto &[node, mean] : nodes) {
+    io::serialize::DictionaryValue &node_dict = *nodes_array.append_dict();
+    node_dict.append_str("name", node->name);
+    node_dict.append_str("type", node->idname);
+    add_timing_stats(*node_dict.append_dict("time"), target.node_times.lookup(node->identifier));
+  }
+}
+
+static int run_benchmark(bContext *C, const BenchmarkSettings &settings)
+{
+  Main *bmain = CTX_data_main(C);
+  Scene *scene = CTX_data_scene(C);
+  ViewLayer *view_layer = CTX_data_view_layer(C);
+
+  Vector<BenchmarkTarget> targets = find_targets(*scene, *view_layer, settings.filters);
+  if (targets.is_empty()) {
+    std::cerr << "No Geometry Nodes modifiers to evaluate" << std::endl;
+    return 1;
+  }
+
+  /* The node timings are only logged for the active depsgraph. */
+  Depsgraph *depsgraph = CTX_data_ensure_evaluated_depsgraph(C);
+
+  Vector<double> total_times;
+  size_t peak_memory = 0;
+  for (const int iteration : IndexRange(settings.warmup + settings.iterations)) {
+    for (const BenchmarkTarget &target : targets) {
+      DEG_id_tag_update(&target.object->id, ID_RECALC_GEOMETRY);
+    }
+    MEM_reset_peak_memory();
+    const double start_time = BLI_time_now_seconds();
+    BKE_scene_graph_update_tagged(depsgraph, bmain);
+    const double end_time = BLI_time_now_seconds();
+
+    if (iteration < settings.warmup) {
+      continue;
+    }
+    total_times.append(end_time - start_time);
+    peak_memory = std::max(peak_memory, MEM_get_peak_memory());
+    for (BenchmarkTarget &target : targets) {
+      gather_timings(*depsgraph, target);
+    }
+  }
+
+  io::serialize::DictionaryValue results;
+  results.append_str("file", BKE_main_blendfile_path(bmain));
+  results.append_int("iterations", settings.iterations);
+  results.append_int("warmup", settings.warmup);
+  add_timing_stats(*results.append_dict("time"), total_times);
+  results.append_int("peak_memory", int64_t(peak_memory));
+  io::serialize::ArrayValue &modifiers = *results.append_array("modifiers");
+  for (const BenchmarkTarget &target : targets) {
+    add_target_results(modifiers, target);
+  }
+
+  io::serialize::JsonFormatter formatter;
+  formatter.indentation_len = 2;
+  if (settings.output_path.empty()) {
+    formatter.serialize(std::cout, results);
+    std::cout << std::endl;
+    return 0;
+  }
+  fstream file(settings.output_path, std::ios::out);
+  if (!file.is_open()) {
+    std::cerr << "Could not open output file: " << settings.output_path << std::endl;
+    return 1;
+  }
+  formatter.serialize(file, results);
+  return 0;
+}
+
+class GeometryNodesBenchmarkCommand : public CommandHandler {
+ public:
+  GeometryNodesBenchmarkCommand() : CommandHandler("geometry-nodes-benchmark") {}
+
+  int exec(bContext *C, const int argc, const char **argv) override
+  {
+    if (argc > 0 && STREQ(argv[0], "--help")) {
+      print_help();
+      return 0;
+    }
+    BenchmarkSettings settings;
+    if (!parse_args(argc, argv, settings)) {
+      print_help();
+      return 1;
+    }
+    return run_benchmark(C, settings);
+  }
+};
+
+void geometry_nodes_benchmark_command_register()
+{
+  BKE_blender_cli_command_register(std::make_unique<GeometryNodesBenchmarkCommand>());
+}
+
+}  // namespace blender::nodes
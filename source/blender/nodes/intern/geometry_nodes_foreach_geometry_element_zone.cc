@@ -2,8 +2,12 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <algorithm>
+
 #include "NOD_geometry_nodes_lazy_function.hh"
 
+#include "BLI_generic_array.hh"
+
 #include "BKE_anonymous_attribute_make.hh"
 #include "BKE_compute_contexts.hh"
 #include "BKE_curves.hh"
@@ -15,12 +19,15 @@
 #include "GEO_extract_elements.hh"
 #include "GEO_join_geometries.hh"
 
+#include "FN_lazy_function_execute.hh"
 #include "FN_lazy_function_graph_executor.hh"
 
 #include "BLT_translation.hh"
 
 #include "DEG_depsgraph_query.hh"
 
+#include "geometry_nodes_foreach_geometry_element_zone.hh"
+
 namespace blender::nodes {
 
 using bke::AttrDomain;
@@ -31,6 +38,8 @@ using bke::MutableAttributeAccessor;
 using bke::SocketValueVariant;
 using fn::Field;
 using fn::GField;
+using foreach_geometry_element_zone::CapturedGenerationField;
+using foreach_geometry_element_zone::PropagatedAttribute;
 
 class LazyFunctionForForeachGeometryElementZone;
 struct ForeachGeometryElementEvalStorage;
@@ -58,9 +67,14 @@ struct ForeachElementComponent {
   Array<Array<SocketValueVariant>> item_input_values;
   /** Geometry for each iteration. */
   std::optional<Array<GeometrySet>> element_geometries;
-  /** The set of body evaluation nodes that correspond to this component. This indexes into
-   * `lf_body_nodes`. */
+  /** The iterations that correspond to this component. When every iteration has its own node, this
+   * indexes into `lf_body_nodes`. */
   IndexRange body_nodes_range;
+  /**
+   * Attributes propagated to the geometries generated in each iteration. This is only gathered
+   * upfront when the iterations are evaluated in batches, which all need it.
+   */
+  Vector<PropagatedAttribute> propagated_attributes;
 
   void emplace_field_context(const GeometrySet &geometry)
   {
@@ -116,17 +130,42 @@ struct LazyFunctionForReduceForeachGeometryElement : public LazyFunction {
   void handle_main_items_and_geometry(lf::Params &params, const lf::Context &context) const;
   void handle_generation_items(lf::Params &params, const lf::Context &context) const;
   int handle_invalid_generation_items(lf::Params &params) const;
-  void handle_generation_item_groups(lf::Params &params,
-                                     const lf::Context &context,
-                                     int first_valid_item_i) const;
+  void handle_generation_item_groups(lf::Params &params, const lf::Context &context) const;
   void handle_generation_items_group(lf::Params &params,
                                      const lf::Context &context,
-                                     int geometry_item_i,
-                                     IndexRange generation_items_range) const;
+                                     int group_i) const;
   bool handle_generation_items_group_lazyness(lf::Params &params,
                                               const lf::Context &context,
-                                              int geometry_item_i,
-                                              IndexRange generation_items_range) const;
+                                              int group_i) const;
+};
+
+/**
+ * A lazy-function that evaluates the loop body for a range of iterations. When iterating over many
+ * elements, this is used instead of a separate node for every iteration, because the per-node
+ * overhead of the graph executor would dominate when the loop body is small. The batches are still
+ * separate nodes, so they are evaluated on multiple threads.
+ *
+ * All iterations in a batch are evaluated at once, so the values that are passed into the zone
+ * from the outside are always requested, even if the body would not use them.
+ *
+ * The results of the iterations are combined within the batch, so that the reduce node only has a
+ * few inputs per batch: the main item values are written into arrays in the eval storage and the
+ * geometries generated by the iterations are joined per generation group.
+ */
+class LazyFunctionForForeachGeometryElementBatch : public LazyFunction {
+ private:
+  const LazyFunctionForForeachGeometryElementZone &parent_;
+  ForeachGeometryElementEvalStorage &eval_storage_;
+  /** The iterations evaluated by this batch, indexing into all iterations across components. */
+  IndexRange iterations_;
+
+ public:
+  LazyFunctionForForeachGeometryElementBatch(
+      const LazyFunctionForForeachGeometryElementZone &parent,
+      ForeachGeometryElementEvalStorage &eval_storage,
+      IndexRange iterations);
+
+  void execute_impl(lf::Params &params, const lf::Context &context) const override;
 };
 
 /**
@@ -173,6 +212,8 @@ class ForeachGeometryElementZoneSideEffectProvider : public lf::GraphExecutorSid
  public:
   const bNode *output_bnode_ = nullptr;
   Span<lf::FunctionNode *> lf_body_nodes_;
+  /** Each node evaluates this many consecutive iterations. */
+  int iterations_per_node_ = 1;
 
   Vector<const lf::FunctionNode *> get_nodes_with_side_effects(
       const lf::Context &context) const override
@@ -189,8 +230,9 @@ class ForeachGeometryElementZoneSideEffectProvider : public lf::GraphExecutorSid
 
     Vector<const lf::FunctionNode *> lf_nodes;
     for (const int i : iterations_with_side_effects) {
-      if (i >= 0 && i < lf_body_nodes_.size()) {
-        lf_nodes.append(lf_body_nodes_[i]);
+      const int node_i = i / iterations_per_node_;
+      if (i >= 0 && node_i < lf_body_nodes_.size()) {
+        lf_nodes.append_non_duplicates(lf_body_nodes_[node_i]);
       }
     }
     return lf_nodes;
@@ -221,6 +263,21 @@ struct ForeachGeometryElementEvalStorage {
    */
   VectorSet<lf::FunctionNode *> lf_body_nodes;
 
+  /**
+   * Used instead of the body nodes when there are many iterations. Each node evaluates
+   * #iterations_per_batch consecutive iterations.
+   */
+  Vector<lf::FunctionNode *> lf_batch_nodes;
+  Vector<std::unique_ptr<LazyFunctionForForeachGeometryElementBatch>> batch_functions;
+  int iterations_per_batch = 0;
+  /** Inputs of the body function that get the same value in every iteration. */
+  Vector<int> batch_shared_body_inputs;
+  /**
+   * The value of every main item in every iteration, written by the batches. Every batch only
+   * writes to its own iterations, so this does not need synchronization.
+   */
+  Array<GArray<>> batch_main_item_values;
+
   /** The main input geometry that is iterated over. */
   GeometrySet main_geometry;
   /** Data for each geometry component that is iterated over. */
@@ -254,7 +311,15 @@ class LazyFunctionForForeachGeometryElementZone : public LazyFunction {
     ItemIndices generation;
   } indices_;
 
+  /**
+   * The generation items grouped by the geometry they belong to. Each group starts with a geometry
+   * item followed by the fields that are captured on it. Items before the first geometry are not
+   * part of any group.
+   */
+  Vector<IndexRange> generation_groups_;
+
   friend LazyFunctionForReduceForeachGeometryElement;
+  friend LazyFunctionForForeachGeometryElementBatch;
 
  public:
   LazyFunctionForForeachGeometryElementZone(const bNodeTree &btree,
@@ -304,6 +369,30 @@ class LazyFunctionForForeachGeometryElementZone : public LazyFunction {
                                                                     generation_items_num);
     indices_.generation.bsocket_inner = IndexRange::from_begin_size(1 + main_items_num,
                                                                     generation_items_num);
+
+    for (const int item_i : IndexRange(generation_items_num)) {
+      const NodeForeachGeometryElementGenerationItem &item =
+          node_storage.generation_items.items[item_i];
+      if (eNodeSocketDatatype(item.socket_type) == SOCK_GEOMETRY) {
+        generation_groups_.append(IndexRange::from_begin_size(item_i, 1));
+      }
+      else if (!generation_groups_.is_empty()) {
+        generation_groups_.last() = generation_groups_.last().with_new_end(item_i + 1);
+      }
+    }
+  }
+
+  /** Name of the anonymous attribute that a generation item is captured in. */
+  std::string generation_item_attribute_name(const GeoNodesUserData &user_data,
+                                             const int item_i) const
+  {
+    const auto &node_storage = *static_cast<const NodeGeometryForeachGeometryElementOutput *>(
+        output_bnode_.storage);
+    return bke::hash_to_anonymous_attribute_name(
+        user_data.call_data->self_object()->id.name,
+        user_data.compute_context->hash(),
+        output_bnode_.identifier,
+        node_storage.generation_items.items[item_i].identifier);
   }
 
   void *init_storage(LinearAllocator<> &allocator) const override
@@ -366,6 +455,13 @@ class LazyFunctionForForeachGeometryElementZone : public LazyFunction {
     /* Find all the things we need to iterate over in the input geometry. */
     this->prepare_components(params, eval_storage, node_storage);
 
+    /* With few iterations, every iteration gets its own node, which keeps the evaluation of the
+     * inputs lazy. Otherwise, the iterations are grouped into a few hundred batches. */
+    if (eval_storage.total_iterations_num > 256) {
+      eval_storage.iterations_per_batch = std::clamp(
+          eval_storage.total_iterations_num / 256, 32, 1024);
+    }
+
     /* Add interface sockets for the zone graph. Those are the same as for the entire zone, even
      * though some of the inputs are not strictly needed anymore. It's easier to avoid another
      * level of index remapping though. */
@@ -386,7 +482,13 @@ class LazyFunctionForForeachGeometryElementZone : public LazyFunction {
 
     eval_storage.side_effect_provider.emplace();
     eval_storage.side_effect_provider->output_bnode_ = &output_bnode_;
-    eval_storage.side_effect_provider->lf_body_nodes_ = eval_storage.lf_body_nodes;
+    if (eval_storage.iterations_per_batch > 0) {
+      eval_storage.side_effect_provider->lf_body_nodes_ = eval_storage.lf_batch_nodes;
+      eval_storage.side_effect_provider->iterations_per_node_ = eval_storage.iterations_per_batch;
+    }
+    else {
+      eval_storage.side_effect_provider->lf_body_nodes_ = eval_storage.lf_body_nodes;
+    }
 
     eval_storage.body_execute_wrapper.emplace();
     eval_storage.body_execute_wrapper->output_bnode_ = &output_bnode_;
@@ -640,6 +742,92 @@ class LazyFunctionForForeachGeometryElementZone : public LazyFunction {
   {
     lf::Graph &lf_graph = eval_storage.graph;
 
+    if (eval_storage.iterations_per_batch > 0) {
+      this->build_batch_nodes(eval_storage, node_storage, graph_inputs);
+    }
+    else {
+      this->build_body_nodes(eval_storage, node_storage, graph_inputs);
+    }
+
+    /* Add the reduce function that has all outputs from the zone bodies as input. */
+    eval_storage.reduce_function.emplace(*this, eval_storage);
+    lf::FunctionNode &lf_reduce = lf_graph.add_function(*eval_storage.reduce_function);
+
+    /* Link up body outputs to reduce function. */
+    if (eval_storage.iterations_per_batch > 0) {
+      const int batch_outputs_num = 1 + generation_groups_.size();
+      for (const int batch_i : eval_storage.lf_batch_nodes.index_range()) {
+        lf::FunctionNode &lf_batch_node = *eval_storage.lf_batch_nodes[batch_i];
+        for (const int i : IndexRange(batch_outputs_num)) {
+          lf_graph.add_link(lf_batch_node.output(i),
+                            lf_reduce.input(batch_i * batch_outputs_num + i));
+        }
+      }
+    }
+    else {
+      const int body_main_outputs_num = node_storage.main_items.items_num +
+                                        node_storage.generation_items.items_num;
+      BLI_assert(body_main_outputs_num == body_fn_.indices.outputs.main.size());
+      for (const int i : eval_storage.lf_body_nodes.index_range()) {
+        lf::FunctionNode &lf_body_node = *eval_storage.lf_body_nodes[i];
+        for (const int body_output_i : IndexRange(body_main_outputs_num)) {
+          lf_graph.add_link(lf_body_node.output(body_fn_.indices.outputs.main[body_output_i]),
+                            lf_reduce.input(i * body_main_outputs_num + body_output_i));
+        }
+      }
+    }
+
+    /* Link up reduce function outputs to final zone outputs. */
+    lf_graph.add_link(lf_reduce.output(0), *graph_outputs[zone_info_.indices.outputs.main[0]]);
+    for (const int item_i : IndexRange(node_storage.main_items.items_num)) {
+      const int output_i = indices_.main.lf_outer[item_i];
+      lf_graph.add_link(lf_reduce.output(output_i),
+                        *graph_outputs[zone_info_.indices.outputs.main[output_i]]);
+    }
+    for (const int item_i : IndexRange(node_storage.generation_items.items_num)) {
+      const int output_i = indices_.generation.lf_outer[item_i];
+      lf_graph.add_link(lf_reduce.output(output_i),
+                        *graph_outputs[zone_info_.indices.outputs.main[output_i]]);
+    }
+
+    /* All zone inputs are used for now. */
+    static bool static_true{true};
+    for (const int i : zone_info_.indices.outputs.input_usages) {
+      graph_outputs[i]->set_default_value(&static_true);
+    }
+
+    if (eval_storage.iterations_per_batch > 0) {
+      /* Batches always use all border-links. */
+      for (const int i : zone_info_.indices.outputs.border_link_usages) {
+        graph_outputs[i]->set_default_value(&static_true);
+      }
+      return;
+    }
+
+    /* Handle usage outputs for border-links. A border-link is used if it's used by any of the
+     * iterations. */
+    VectorSet<lf::FunctionNode *> &lf_body_nodes = eval_storage.lf_body_nodes;
+    eval_storage.or_function.emplace(eval_storage.total_iterations_num);
+    for (const int border_link_i : zone_.border_links.index_range()) {
+      lf::FunctionNode &lf_or = lf_graph.add_function(*eval_storage.or_function);
+      for (const int i : lf_body_nodes.index_range()) {
+        lf::FunctionNode &lf_body_node = *lf_body_nodes[i];
+        lf_graph.add_link(
+            lf_body_node.output(body_fn_.indices.outputs.border_link_usages[border_link_i]),
+            lf_or.input(i));
+      }
+      lf_graph.add_link(
+          lf_or.output(0),
+          *graph_outputs[zone_info_.indices.outputs.border_link_usages[border_link_i]]);
+    }
+  }
+
+  void build_body_nodes(ForeachGeometryElementEvalStorage &eval_storage,
+                        const NodeGeometryForeachGeometryElementOutput &node_storage,
+                        Span<lf::GraphInputSocket *> graph_inputs) const
+  {
+    lf::Graph &lf_graph = eval_storage.graph;
+
     /* Create body nodes. */
     VectorSet<lf::FunctionNode *> &lf_body_nodes = eval_storage.lf_body_nodes;
     for ([[maybe_unused]] const int i : IndexRange(eval_storage.total_iterations_num)) {
@@ -695,61 +883,71 @@ class LazyFunctionForForeachGeometryElementZone : public LazyFunction {
         }
       }
     }
+  }
 
-    /* Add the reduce function that has all outputs from the zone bodies as input. */
-    eval_storage.reduce_function.emplace(*this, eval_storage);
-    lf::FunctionNode &lf_reduce = lf_graph.add_function(*eval_storage.reduce_function);
+  void build_batch_nodes(ForeachGeometryElementEvalStorage &eval_storage,
+                         const NodeGeometryForeachGeometryElementOutput &node_storage,
+                         Span<lf::GraphInputSocket *> graph_inputs) const
+  {
+    lf::Graph &lf_graph = eval_storage.graph;
 
-    /* Link up body outputs to reduce function. */
-    const int body_main_outputs_num = node_storage.main_items.items_num +
-                                      node_storage.generation_items.items_num;
-    BLI_assert(body_main_outputs_num == body_fn_.indices.outputs.main.size());
-    for (const int i : IndexRange(eval_storage.total_iterations_num)) {
-      lf::FunctionNode &lf_body_node = *lf_body_nodes[i];
-      for (const int item_i : IndexRange(node_storage.main_items.items_num)) {
-        lf_graph.add_link(lf_body_node.output(body_fn_.indices.outputs.main[item_i]),
-                          lf_reduce.input(i * body_main_outputs_num + item_i));
+    /* Allocate the arrays that the batches write the main item values into. */
+    eval_storage.batch_main_item_values.reinitialize(node_storage.main_items.items_num);
+    for (const int item_i : IndexRange(node_storage.main_items.items_num)) {
+      const NodeForeachGeometryElementMainItem &item = node_storage.main_items.items[item_i];
+      const CPPType *base_cpp_type = bke::socket_type_to_geo_nodes_base_cpp_type(
+          eNodeSocketDatatype(item.socket_type));
+      if (base_cpp_type) {
+        eval_storage.batch_main_item_values[item_i] = GArray<>(*base_cpp_type,
+                                                               eval_storage.total_iterations_num);
       }
-      for (const int item_i : IndexRange(node_storage.generation_items.items_num)) {
-        const int body_output_i = item_i + node_storage.main_items.items_num;
-        lf_graph.add_link(lf_body_node.output(body_fn_.indices.outputs.main[body_output_i]),
-                          lf_reduce.input(i * body_main_outputs_num + body_output_i));
+    }
+
+    /* The batches prepare the generated geometries for joining, which requires the propagated
+     * attributes. Gather them once here instead of in every batch. */
+    if (!generation_groups_.is_empty()) {
+      /* TODO: Get propagation info from input, but that's not necessary for correctness. */
+      bke::AttributeFilter attribute_filter;
+      for (ForeachElementComponent &component_info : eval_storage.components) {
+        component_info.propagated_attributes =
+            foreach_geometry_element_zone::gather_propagated_attributes(
+                component_info.input_attributes(), component_info.id.domain, attribute_filter);
       }
     }
 
-    /* Link up reduce function outputs to final zone outputs. */
-    lf_graph.add_link(lf_reduce.output(0), *graph_outputs[zone_info_.indices.outputs.main[0]]);
-    for (const int item_i : IndexRange(node_storage.main_items.items_num)) {
-      const int output_i = indices_.main.lf_outer[item_i];
-      lf_graph.add_link(lf_reduce.output(output_i),
-                        *graph_outputs[zone_info_.indices.outputs.main[output_i]]);
+    /* Gather the body inputs that are the same for all iterations and where their values come
+     * from. */
+    Vector<int> &shared_body_inputs = eval_storage.batch_shared_body_inputs;
+    Vector<lf::GraphInputSocket *> shared_graph_inputs;
+    for (const int zone_output_i : body_fn_.indices.inputs.output_usages.index_range()) {
+      /* +1 because of geometry output. */
+      shared_body_inputs.append(body_fn_.indices.inputs.output_usages[zone_output_i]);
+      shared_graph_inputs.append(
+          graph_inputs[zone_info_.indices.inputs.output_usages[1 + zone_output_i]]);
     }
-    for (const int item_i : IndexRange(node_storage.generation_items.items_num)) {
-      const int output_i = indices_.generation.lf_outer[item_i];
-      lf_graph.add_link(lf_reduce.output(output_i),
-                        *graph_outputs[zone_info_.indices.outputs.main[output_i]]);
+    for (const int border_link_i : zone_info_.indices.inputs.border_links.index_range()) {
+      shared_body_inputs.append(body_fn_.indices.inputs.border_links[border_link_i]);
+      shared_graph_inputs.append(
+          graph_inputs[zone_info_.indices.inputs.border_links[border_link_i]]);
     }
-
-    /* All zone inputs are used for now. */
-    static bool static_true{true};
-    for (const int i : zone_info_.indices.outputs.input_usages) {
-      graph_outputs[i]->set_default_value(&static_true);
+    for (const auto &item : body_fn_.indices.inputs.reference_sets.items()) {
+      shared_body_inputs.append(item.value);
+      shared_graph_inputs.append(
+          graph_inputs[zone_info_.indices.inputs.reference_sets.lookup(item.key)]);
     }
 
-    /* Handle usage outputs for border-links. A border-link is used if it's used by any of the
-     * iterations. */
-    eval_storage.or_function.emplace(eval_storage.total_iterations_num);
-    for (const int border_link_i : zone_.border_links.index_range()) {
-      lf::FunctionNode &lf_or = lf_graph.add_function(*eval_storage.or_function);
-      for (const int i : lf_body_nodes.index_range()) {
-        lf::FunctionNode &lf_body_node = *lf_body_nodes[i];
-        lf_graph.add_link(
-            lf_body_node.output(body_fn_.indices.outputs.border_link_usages[border_link_i]),
-            lf_or.input(i));
+    const int iterations_per_batch = eval_storage.iterations_per_batch;
+    for (int start = 0; start < eval_storage.total_iterations_num; start += iterations_per_batch) {
+      const IndexRange iterations = IndexRange::from_begin_end(
+          start, std::min(start + iterations_per_batch, eval_storage.total_iterations_num));
+      eval_storage.batch_functions.append(
+          std::make_unique<LazyFunctionForForeachGeometryElementBatch>(
+              *this, eval_storage, iterations));
+      lf::FunctionNode &lf_node = lf_graph.add_function(*eval_storage.batch_functions.last());
+      for (const int i : shared_graph_inputs.index_range()) {
+        lf_graph.add_link(*shared_graph_inputs[i], lf_node.input(i));
       }
-      lf_graph.add_link(
-          lf_or.output(0),
-          *graph_outputs[zone_info_.indices.outputs.border_link_usages[border_link_i]]);
+      eval_storage.lf_batch_nodes.append(&lf_node);
     }
   }
 
@@ -764,6 +962,135 @@ class LazyFunctionForForeachGeometryElementZone : public LazyFunction {
   }
 };
 
+/** Gives the domain with the smallest number of elements that always exists. */
+static std::optional<AttrDomain> get_foreach_attribute_propagation_target_domain(
+    const GeometryComponent::Type component_type)
+{
+  switch (component_type) {
+    case GeometryComponent::Type::Mesh:
+    case GeometryComponent::Type::PointCloud:
+      return AttrDomain::Point;
+    case GeometryComponent::Type::Curve:
+      return AttrDomain::Curve;
+    case GeometryComponent::Type::Instance:
+      return AttrDomain::Instance;
+    case GeometryComponent::Type::GreasePencil:
+      return AttrDomain::Layer;
+    default:
+      break;
+  }
+  return std::nullopt;
+}
+
+namespace foreach_geometry_element_zone {
+
+Vector<PropagatedAttribute> gather_propagated_attributes(
+    const AttributeAccessor &src_attributes,
+    const AttrDomain iteration_domain,
+    const bke::AttributeFilter &attribute_filter)
+{
+  Vector<PropagatedAttribute> attributes;
+  src_attributes.foreach_attribute([&](const bke::AttributeIter &iter) {
+    if (iter.data_type == CD_PROP_STRING) {
+      return;
+    }
+    if (attribute_filter.allow_skip(iter.name)) {
+      return;
+    }
+    /* Get the source attribute adapted to the iteration domain. */
+    GVArray values = src_attributes.adapt_domain(*iter.get(), iter.domain, iteration_domain);
+    if (!values) {
+      return;
+    }
+    attributes.append(
+        {iter.name, iter.data_type, src_attributes.is_builtin(iter.name), std::move(values)});
+  });
+  return attributes;
+}
+
+void prepare_generated_geometry(GeometrySet &geometry,
+                                const Span<PropagatedAttribute> propagated_attributes,
+                                const int element_i,
+                                const Span<CapturedGenerationField> captured_fields)
+{
+  for (const GeometryComponent::Type dst_component_type : {GeometryComponent::Type::Mesh,
+                                                           GeometryComponent::Type::PointCloud,
+                                                           GeometryComponent::Type::Curve,
+                                                           GeometryComponent::Type::GreasePencil,
+                                                           GeometryComponent::Type::Instance})
+  {
+    if (!geometry.has(dst_component_type)) {
+      continue;
+    }
+    GeometryComponent &dst_component = geometry.get_component_for_write(dst_component_type);
+    MutableAttributeAccessor dst_attributes = *dst_component.attributes_for_write();
+
+    /* Determine the domain that we propagate the input attribute to. Technically, this is only
+     * a single value for the entire geometry, but we can't optimize for that yet. */
+    const std::optional<AttrDomain> propagation_domain =
+        get_foreach_attribute_propagation_target_domain(dst_component_type);
+    if (!propagation_domain) {
+      continue;
+    }
+
+    /* Propagate attributes from the input geometry. */
+    for (const PropagatedAttribute &src_attribute : propagated_attributes) {
+      const StringRef name = src_attribute.name;
+      if (src_attribute.is_builtin && !dst_attributes.is_builtin(name)) {
+        continue;
+      }
+      if (dst_attributes.contains(name)) {
+        /* Attributes created in the zone shouldn't be overridden. */
+        continue;
+      }
+      const CPPType &type = src_attribute.values.type();
+      BUFFER_FOR_CPP_TYPE_VALUE(type, element_value);
+      src_attribute.values.get_to_uninitialized(element_i, element_value);
+
+      /* Actually create the attribute. */
+      bke::GSpanAttributeWriter dst_attribute = dst_attributes.lookup_or_add_for_write_only_span(
+          name, *propagation_domain, src_attribute.type);
+      type.fill_assign_n(element_value, dst_attribute.span.data(), dst_attribute.span.size());
+      dst_attribute.finish();
+
+      type.destruct(element_value);
+    }
+  }
+
+  /* Create an attribute for each field that corresponds to the current geometry. */
+  for (const CapturedGenerationField &captured_field : captured_fields) {
+    if (captured_field.domain == AttrDomain::Instance) {
+      if (geometry.has_instances()) {
+        bke::try_capture_field_on_geometry(
+            geometry.get_component_for_write(GeometryComponent::Type::Instance),
+            captured_field.attribute_name,
+            captured_field.domain,
+            captured_field.field);
+      }
+    }
+    else {
+      geometry.modify_geometry_sets([&](GeometrySet &sub_geometry) {
+        for (const GeometryComponent::Type component_type :
+             {GeometryComponent::Type::Mesh,
+              GeometryComponent::Type::PointCloud,
+              GeometryComponent::Type::Curve,
+              GeometryComponent::Type::GreasePencil})
+        {
+          if (sub_geometry.has(component_type)) {
+            bke::try_capture_field_on_geometry(
+                sub_geometry.get_component_for_write(component_type),
+                captured_field.attribute_name,
+                captured_field.domain,
+                captured_field.field);
+          }
+        }
+      });
+    }
+  }
+}
+
+}  // namespace foreach_geometry_element_zone
+
 LazyFunctionForReduceForeachGeometryElement::LazyFunctionForReduceForeachGeometryElement(
     const LazyFunctionForForeachGeometryElementZone &parent,
     ForeachGeometryElementEvalStorage &eval_storage)
@@ -774,26 +1101,46 @@ LazyFunctionForReduceForeachGeometryElement::LazyFunctionForReduceForeachGeometr
   const auto &node_storage = *static_cast<NodeGeometryForeachGeometryElementOutput *>(
       parent.output_bnode_.storage);
 
-  inputs_.reserve(eval_storage.total_iterations_num *
-                  (node_storage.main_items.items_num + node_storage.generation_items.items_num));
-
-  for ([[maybe_unused]] const int i : eval_storage.lf_body_nodes.index_range()) {
-    /* Add parameters for main items. */
-    for (const int item_i : IndexRange(node_storage.main_items.items_num)) {
-      const NodeForeachGeometryElementMainItem &item = node_storage.main_items.items[item_i];
-      const bNodeSocket &socket = parent.output_bnode_.input_socket(
-          parent_.indices_.main.bsocket_inner[item_i]);
-      inputs_.append_as(
-          item.name, *socket.typeinfo->geometry_nodes_cpp_type, lf::ValueUsage::Used);
+  if (eval_storage.iterations_per_batch > 0) {
+    /* Every batch signals when its main item values are available and has one joined geometry
+     * for each generation group. Without main items, the batches only have to be evaluated when
+     * a generated geometry is used. */
+    const int batches_num = eval_storage.lf_batch_nodes.size();
+    const lf::ValueUsage main_items_usage = node_storage.main_items.items_num > 0 ?
+                                                lf::ValueUsage::Used :
+                                                lf::ValueUsage::Maybe;
+    inputs_.reserve(batches_num * (1 + parent.generation_groups_.size()));
+    for ([[maybe_unused]] const int batch_i : IndexRange(batches_num)) {
+      inputs_.append_as("Main Items", CPPType::get<bool>(), main_items_usage);
+      for (const IndexRange group : parent.generation_groups_) {
+        const NodeForeachGeometryElementGenerationItem &item =
+            node_storage.generation_items.items[group.first()];
+        inputs_.append_as(item.name, CPPType::get<GeometrySet>(), lf::ValueUsage::Maybe);
+      }
     }
-    /* Add parameters for generation items. */
-    for (const int item_i : IndexRange(node_storage.generation_items.items_num)) {
-      const NodeForeachGeometryElementGenerationItem &item =
-          node_storage.generation_items.items[item_i];
-      const bNodeSocket &socket = parent.output_bnode_.input_socket(
-          parent_.indices_.generation.bsocket_inner[item_i]);
-      inputs_.append_as(
-          item.name, *socket.typeinfo->geometry_nodes_cpp_type, lf::ValueUsage::Maybe);
+  }
+  else {
+    inputs_.reserve(eval_storage.total_iterations_num * (node_storage.main_items.items_num +
+                                                         node_storage.generation_items.items_num));
+
+    for ([[maybe_unused]] const int i : IndexRange(eval_storage.total_iterations_num)) {
+      /* Add parameters for main items. */
+      for (const int item_i : IndexRange(node_storage.main_items.items_num)) {
+        const NodeForeachGeometryElementMainItem &item = node_storage.main_items.items[item_i];
+        const bNodeSocket &socket = parent.output_bnode_.input_socket(
+            parent_.indices_.main.bsocket_inner[item_i]);
+        inputs_.append_as(
+            item.name, *socket.typeinfo->geometry_nodes_cpp_type, lf::ValueUsage::Used);
+      }
+      /* Add parameters for generation items. */
+      for (const int item_i : IndexRange(node_storage.generation_items.items_num)) {
+        const NodeForeachGeometryElementGenerationItem &item =
+            node_storage.generation_items.items[item_i];
+        const bNodeSocket &socket = parent.output_bnode_.input_socket(
+            parent_.indices_.generation.bsocket_inner[item_i]);
+        inputs_.append_as(
+            item.name, *socket.typeinfo->geometry_nodes_cpp_type, lf::ValueUsage::Maybe);
+      }
     }
   }
 
@@ -816,24 +1163,214 @@ LazyFunctionForReduceForeachGeometryElement::LazyFunctionForReduceForeachGeometr
   }
 }
 
-/** Gives the domain with the smallest number of elements that always exists. */
-static std::optional<AttrDomain> get_foreach_attribute_propagation_target_domain(
-    const GeometryComponent::Type component_type)
+LazyFunctionForForeachGeometryElementBatch::LazyFunctionForForeachGeometryElementBatch(
+    const LazyFunctionForForeachGeometryElementZone &parent,
+    ForeachGeometryElementEvalStorage &eval_storage,
+    const IndexRange iterations)
+    : parent_(parent), eval_storage_(eval_storage), iterations_(iterations)
 {
-  switch (component_type) {
-    case GeometryComponent::Type::Mesh:
-    case GeometryComponent::Type::PointCloud:
-      return AttrDomain::Point;
-    case GeometryComponent::Type::Curve:
-      return AttrDomain::Curve;
-    case GeometryComponent::Type::Instance:
-      return AttrDomain::Instance;
-    case GeometryComponent::Type::GreasePencil:
-      return AttrDomain::Layer;
-    default:
-      break;
+  debug_name_ = "Batch";
+
+  const auto &node_storage = *static_cast<NodeGeometryForeachGeometryElementOutput *>(
+      parent.output_bnode_.storage);
+  const LazyFunction &body_fn = *parent.body_fn_.function;
+  for (const int body_input_i : eval_storage.batch_shared_body_inputs) {
+    const lf::Input &body_input = body_fn.inputs()[body_input_i];
+    inputs_.append_as(body_input.debug_name, *body_input.type, lf::ValueUsage::Used);
   }
-  return std::nullopt;
+  /* The main item values are written into the eval storage directly, this output only signals
+   * that they are available. */
+  outputs_.append_as("Main Items", CPPType::get<bool>());
+  for (const IndexRange group : parent.generation_groups_) {
+    const NodeForeachGeometryElementGenerationItem &item =
+        node_storage.generation_items.items[group.first()];
+    outputs_.append_as(item.name, CPPType::get<GeometrySet>());
+  }
+}
+
+void LazyFunctionForForeachGeometryElementBatch::execute_impl(lf::Params &params,
+                                                              const lf::Context &context) const
+{
+  const GeoNodesUserData &user_data = *static_cast<GeoNodesUserData *>(context.user_data);
+  const auto &node_storage = *static_cast<NodeGeometryForeachGeometryElementOutput *>(
+      parent_.output_bnode_.storage);
+  const LazyFunction &body_fn = *parent_.body_fn_.function;
+  const ZoneFunctionIndices &body_indices = parent_.body_fn_.indices;
+  const Span<int> shared_body_inputs = eval_storage_.batch_shared_body_inputs;
+  const Span<IndexRange> generation_groups = parent_.generation_groups_;
+  const int main_items_num = node_storage.main_items.items_num;
+  const int body_main_outputs_num = body_indices.outputs.main.size();
+  const bool has_element_geometry =
+      parent_.zone_.input_node()->output_socket(1).is_available();
+  static const GeometrySet empty_geometry;
+
+  /* The buffers are reused for all iterations. The inputs are copied for every iteration because
+   * the body is allowed to move them. */
+  LinearAllocator<> allocator;
+  const int body_inputs_num = body_fn.inputs().size();
+  const int body_outputs_num = body_fn.outputs().size();
+  Array<const void *> input_sources(body_inputs_num, nullptr);
+  Array<GMutablePointer> input_buffers(body_inputs_num);
+  Array<GMutablePointer> inputs(body_inputs_num);
+  for (const int i : IndexRange(body_inputs_num)) {
+    const CPPType &type = *body_fn.inputs()[i].type;
+    input_buffers[i] = {type, allocator.allocate(type)};
+  }
+  Array<GMutablePointer> outputs(body_outputs_num);
+  for (const int i : IndexRange(body_outputs_num)) {
+    const CPPType &type = *body_fn.outputs()[i].type;
+    outputs[i] = {type, allocator.allocate(type)};
+  }
+  Array<std::optional<lf::ValueUsage>> input_usages(body_inputs_num);
+  Array<bool> set_outputs(body_outputs_num);
+
+  /* Main items are always needed for the attributes on the input geometry, while generation items
+   * are only computed when they are used outside of the zone. */
+  Array<lf::ValueUsage> output_usages(body_outputs_num, lf::ValueUsage::Unused);
+  for (const int i : IndexRange(body_main_outputs_num)) {
+    const bool is_used = i < main_items_num || params.get_input<bool>(i);
+    output_usages[body_indices.outputs.main[i]] = is_used ? lf::ValueUsage::Used :
+                                                            lf::ValueUsage::Unused;
+  }
+
+  for (const int i : shared_body_inputs.index_range()) {
+    input_sources[shared_body_inputs[i]] = params.try_get_input_data_ptr(i);
+  }
+
+  /* The geometries generated by the iterations of this batch, for every generation group whose
+   * geometry is used outside of the zone. */
+  Array<bool> group_is_used(generation_groups.size());
+  Array<Array<GeometrySet>> generated_geometries(generation_groups.size());
+  Array<std::string> attribute_names(node_storage.generation_items.items_num);
+  for (const int group_i : generation_groups.index_range()) {
+    const IndexRange group = generation_groups[group_i];
+    group_is_used[group_i] = params.get_input<bool>(main_items_num + group.first());
+    if (!group_is_used[group_i]) {
+      continue;
+    }
+    generated_geometries[group_i].reinitialize(iterations_.size());
+    for (const int item_i : group.drop_front(1)) {
+      attribute_names[item_i] = parent_.generation_item_attribute_name(user_data, item_i);
+    }
+  }
+
+  for (const ForeachElementComponent &component_info : eval_storage_.components) {
+    const IndexRange iterations = component_info.body_nodes_range.intersect(iterations_);
+    for (const int iteration_i : iterations) {
+      const int i = iteration_i - component_info.body_nodes_range.start();
+
+      input_sources[body_indices.inputs.main[0]] = &component_info.index_values[i];
+      if (has_element_geometry) {
+        input_sources[body_indices.inputs.main[1]] = component_info.element_geometries ?
+                                                         &(*component_info.element_geometries)[i] :
+                                                         &empty_geometry;
+      }
+      for (const int item_i : IndexRange(node_storage.input_items.items_num)) {
+        input_sources[body_indices.inputs.main[parent_.indices_.inputs.lf_inner[item_i]]] =
+            &component_info.item_input_values[item_i][i];
+      }
+      for (const int input_i : IndexRange(body_inputs_num)) {
+        if (const void *source = input_sources[input_i]) {
+          input_buffers[input_i].type()->copy_construct(source, input_buffers[input_i].get());
+          inputs[input_i] = input_buffers[input_i];
+        }
+        else {
+          inputs[input_i] = {};
+        }
+      }
+      input_usages.fill(std::nullopt);
+      set_outputs.fill(false);
+
+      /* Setup context for the loop body evaluation, like it's done for separate body nodes. */
+      bke::ForeachGeometryElementZoneComputeContext body_compute_context{
+          user_data.compute_context, parent_.output_bnode_, iteration_i};
+      GeoNodesUserData body_user_data = user_data;
+      body_user_data.compute_context = &body_compute_context;
+      body_user_data.log_socket_values = should_log_socket_values_for_context(
+          user_data, body_compute_context.hash());
+      GeoNodesLocalUserData body_local_user_data{body_user_data};
+
+      /* The storage only lives during this iteration. It uses a separate allocator, so that its
+       * memory is freed again instead of growing with the number of iterations. */
+      AlignedBuffer<1024, 8> storage_buffer;
+      LinearAllocator<> storage_allocator;
+      storage_allocator.provide_buffer(storage_buffer);
+
+      lf::BasicParams body_params{
+          body_fn, inputs, outputs, input_usages, output_usages, set_outputs};
+      lf::Context body_context{
+          body_fn.init_storage(storage_allocator), &body_user_data, &body_local_user_data};
+      body_fn.execute(body_params, body_context);
+      body_fn.destruct_storage(body_context.storage);
+
+      for (const int input_i : IndexRange(body_inputs_num)) {
+        if (inputs[input_i]) {
+          inputs[input_i].destruct();
+        }
+      }
+
+      /* Store the main item values of this iteration. The values keep their default if the body
+       * did not output them. */
+      for (const int item_i : IndexRange(main_items_num)) {
+        const int body_output_i = body_indices.outputs.main[item_i];
+        GArray<> &values = eval_storage_.batch_main_item_values[item_i];
+        if (!set_outputs[body_output_i] || values.is_empty()) {
+          continue;
+        }
+        auto &value_variant = *static_cast<SocketValueVariant *>(outputs[body_output_i].get());
+        value_variant.convert_to_single();
+        values.type().copy_assign(value_variant.get_single_ptr_raw(), values[iteration_i]);
+      }
+
+      /* Prepare the generated geometries for joining while the generated fields are available. */
+      const int element_i = component_info.index_values[i].get<int>();
+      for (const int group_i : generation_groups.index_range()) {
+        if (!group_is_used[group_i]) {
+          continue;
+        }
+        const IndexRange group = generation_groups[group_i];
+        const int geometry_output_i = body_indices.outputs.main[main_items_num + group.first()];
+        GeometrySet &geometry = generated_geometries[group_i][iteration_i - iterations_.start()];
+        if (set_outputs[geometry_output_i]) {
+          geometry = std::move(*static_cast<GeometrySet *>(outputs[geometry_output_i].get()));
+        }
+        Vector<CapturedGenerationField, 4> captured_fields;
+        for (const int item_i : group.drop_front(1)) {
+          const int field_output_i = body_indices.outputs.main[main_items_num + item_i];
+          if (!set_outputs[field_output_i]) {
+            /* The field is not used outside of the zone. */
+            continue;
+          }
+          const NodeForeachGeometryElementGenerationItem &item =
+              node_storage.generation_items.items[item_i];
+          captured_fields.append(
+              {attribute_names[item_i],
+               AttrDomain(item.domain),
+               static_cast<SocketValueVariant *>(outputs[field_output_i].get())->get<GField>()});
+        }
+        foreach_geometry_element_zone::prepare_generated_geometry(
+            geometry, component_info.propagated_attributes, element_i, captured_fields);
+      }
+
+      /* Other outputs like border-link usages are not needed. */
+      for (const int output_i : IndexRange(body_outputs_num)) {
+        if (set_outputs[output_i]) {
+          outputs[output_i].destruct();
+        }
+      }
+    }
+  }
+
+  /* Join the geometries of all iterations in the batch, the reduce node joins the batches. */
+  bke::AttributeFilter attribute_filter;
+  for (const int group_i : generation_groups.index_range()) {
+    GeometrySet joined_geometry;
+    if (group_is_used[group_i]) {
+      joined_geometry = geometry::join_geometries(generated_geometries[group_i], attribute_filter);
+    }
+    params.set_output(1 + group_i, std::move(joined_geometry));
+  }
+  params.set_output(0, true);
 }
 
 void LazyFunctionForReduceForeachGeometryElement::execute_impl(lf::Params &params,
@@ -899,13 +1436,24 @@ void LazyFunctionForReduceForeachGeometryElement::handle_main_items_and_geometry
       base_cpp_type->value_initialize_indices(attribute.span.data(), inverted_mask);
 
       /* Copy the values from each iteration into the attribute. */
-      mask.foreach_index([&](const int i, const int pos) {
-        const int lf_param_index = pos * body_main_outputs_num + item_i;
-        SocketValueVariant &value_variant = params.get_input<SocketValueVariant>(lf_param_index);
-        value_variant.convert_to_single();
-        const void *value = value_variant.get_single_ptr_raw();
-        base_cpp_type->copy_construct(value, attribute.span[i]);
-      });
+      if (eval_storage_.iterations_per_batch > 0) {
+        /* The batches have stored the values of all iterations already. */
+        const GArray<> &values = eval_storage_.batch_main_item_values[item_i];
+        mask.foreach_index([&](const int i, const int pos) {
+          base_cpp_type->copy_construct(values[component_info.body_nodes_range[pos]],
+                                        attribute.span[i]);
+        });
+      }
+      else {
+        mask.foreach_index([&](const int i, const int pos) {
+          const int lf_param_index = pos * body_main_outputs_num + item_i;
+          SocketValueVariant &value_variant = params.get_input<SocketValueVariant>(
+              lf_param_index);
+          value_variant.convert_to_single();
+          const void *value = value_variant.get_single_ptr_raw();
+          base_cpp_type->copy_construct(value, attribute.span[i]);
+        });
+      }
 
       attribute.finish();
     }
@@ -934,7 +1482,7 @@ void LazyFunctionForReduceForeachGeometryElement::handle_generation_items(
   if (first_valid_item_i == node_storage.generation_items.items_num) {
     return;
   }
-  this->handle_generation_item_groups(params, context, first_valid_item_i);
+  this->handle_generation_item_groups(params, context);
 }
 
 int LazyFunctionForReduceForeachGeometryElement::handle_invalid_generation_items(
@@ -963,205 +1511,93 @@ int LazyFunctionForReduceForeachGeometryElement::handle_invalid_generation_items
 }
 
 void LazyFunctionForReduceForeachGeometryElement::handle_generation_item_groups(
-    lf::Params &params, const lf::Context &context, const int first_valid_item_i) const
+    lf::Params &params, const lf::Context &context) const
 {
-  const auto &node_storage = *static_cast<NodeGeometryForeachGeometryElementOutput *>(
-      parent_.output_bnode_.storage);
-  int previous_geometry_item_i = first_valid_item_i;
   /* Iterate over all groups. A group starts with a geometry socket followed by an arbitrary number
    * of non-geometry sockets. */
-  for (const int item_i :
-       IndexRange::from_begin_end(first_valid_item_i + 1, node_storage.generation_items.items_num))
-  {
-    const NodeForeachGeometryElementGenerationItem &item =
-        node_storage.generation_items.items[item_i];
-    const eNodeSocketDatatype socket_type = eNodeSocketDatatype(item.socket_type);
-    if (socket_type == SOCK_GEOMETRY) {
-      this->handle_generation_items_group(
-          params,
-          context,
-          previous_geometry_item_i,
-          IndexRange::from_begin_end(previous_geometry_item_i + 1, item_i));
-      previous_geometry_item_i = item_i;
-    }
+  for (const int group_i : parent_.generation_groups_.index_range()) {
+    this->handle_generation_items_group(params, context, group_i);
   }
-  this->handle_generation_items_group(
-      params,
-      context,
-      previous_geometry_item_i,
-      IndexRange::from_begin_end(previous_geometry_item_i + 1,
-                                 node_storage.generation_items.items_num));
 }
 
 void LazyFunctionForReduceForeachGeometryElement::handle_generation_items_group(
-    lf::Params &params,
-    const lf::Context &context,
-    const int geometry_item_i,
-    const IndexRange generation_items_range) const
+    lf::Params &params, const lf::Context &context, const int group_i) const
 {
   auto &user_data = *static_cast<GeoNodesUserData *>(context.user_data);
   const auto &node_storage = *static_cast<NodeGeometryForeachGeometryElementOutput *>(
       parent_.output_bnode_.storage);
   const int body_main_outputs_num = node_storage.main_items.items_num +
                                     node_storage.generation_items.items_num;
+  const IndexRange group = parent_.generation_groups_[group_i];
+  const int geometry_item_i = group.first();
+  const IndexRange generation_items_range = group.drop_front(1);
 
   /* Handle the case when the output is not needed or the inputs have not been computed yet. */
-  if (!this->handle_generation_items_group_lazyness(
-          params, context, geometry_item_i, generation_items_range))
-  {
+  if (!this->handle_generation_items_group_lazyness(params, context, group_i)) {
     return;
   }
 
   /* TODO: Get propagation info from input, but that's not necessary for correctness for now. */
   bke::AttributeFilter attribute_filter;
 
-  const int bodies_num = eval_storage_.lf_body_nodes.size();
-  Array<GeometrySet> geometries(bodies_num + 1);
-
   /* Create attribute names for the outputs. */
   Array<std::string> attribute_names(generation_items_range.size());
   for (const int i : generation_items_range.index_range()) {
-    const int item_i = generation_items_range[i];
-    const NodeForeachGeometryElementGenerationItem &item =
-        node_storage.generation_items.items[item_i];
-    attribute_names[i] = bke::hash_to_anonymous_attribute_name(
-        user_data.call_data->self_object()->id.name,
-        user_data.compute_context->hash(),
-        parent_.output_bnode_.identifier,
-        item.identifier);
+    attribute_names[i] = parent_.generation_item_attribute_name(user_data,
+                                                                generation_items_range[i]);
   }
 
-  for (const ForeachElementComponent &component_info : eval_storage_.components) {
-    const AttributeAccessor src_attributes = component_info.input_attributes();
-
-    /* These are the attributes we need to propagate from the original input geometry. */
-    struct NameWithType {
-      StringRef name;
-      eCustomDataType type;
-    };
-    Vector<NameWithType> attributes_to_propagate;
-    src_attributes.foreach_attribute([&](const bke::AttributeIter &iter) {
-      if (iter.data_type == CD_PROP_STRING) {
-        return;
-      }
-      if (attribute_filter.allow_skip(iter.name)) {
-        return;
-      }
-      attributes_to_propagate.append({iter.name, iter.data_type});
-    });
-    Map<StringRef, GVArray> cached_adapted_src_attributes;
-
-    const IndexMask mask = component_info.field_evaluator->get_evaluated_selection_as_mask();
-
-    /* Add attributes for each field on the geometry created by each iteration. */
-    mask.foreach_index([&](const int element_i, const int local_body_i) {
-      const int body_i = component_info.body_nodes_range[local_body_i];
-      const int geometry_param_i = body_i * body_main_outputs_num +
-                                   parent_.indices_.generation.lf_inner[geometry_item_i];
-      GeometrySet &geometry = geometries[body_i];
-      geometry = params.extract_input<GeometrySet>(geometry_param_i);
-
-      for (const GeometryComponent::Type dst_component_type :
-           {GeometryComponent::Type::Mesh,
-            GeometryComponent::Type::PointCloud,
-            GeometryComponent::Type::Curve,
-            GeometryComponent::Type::GreasePencil,
-            GeometryComponent::Type::Instance})
-      {
-        if (!geometry.has(dst_component_type)) {
-          continue;
-        }
-        GeometryComponent &dst_component = geometry.get_component_for_write(dst_component_type);
-        MutableAttributeAccessor dst_attributes = *dst_component.attributes_for_write();
-
-        /* Determine the domain that we propagate the input attribute to. Technically, this is only
-         * a single value for the entire geometry, but we can't optimize for that yet. */
-        const std::optional<AttrDomain> propagation_domain =
-            get_foreach_attribute_propagation_target_domain(dst_component_type);
-        if (!propagation_domain) {
-          continue;
-        }
-
-        /* Propagate attributes from the input geometry. */
-        for (const NameWithType &name_with_type : attributes_to_propagate) {
-          const StringRef name = name_with_type.name;
-          const eCustomDataType cd_type = name_with_type.type;
-          if (src_attributes.is_builtin(name) && !dst_attributes.is_builtin(name)) {
-            continue;
-          }
-          if (dst_attributes.contains(name)) {
-            /* Attributes created in the zone shouldn't be overridden. */
-            continue;
-          }
-          /* Get the source attribute adapted to the iteration domain. */
-          const GVArray &src_attribute = cached_adapted_src_attributes.lookup_or_add_cb(
-              name, [&]() {
-                bke::GAttributeReader attribute = src_attributes.lookup(name);
-                return src_attributes.adapt_domain(
-                    *attribute, attribute.domain, component_info.id.domain);
-              });
-          if (!src_attribute) {
-            continue;
-          }
-          const CPPType &type = src_attribute.type();
-          BUFFER_FOR_CPP_TYPE_VALUE(type, element_value);
-          src_attribute.get_to_uninitialized(element_i, element_value);
-
-          /* Actually create the attribute. */
-          bke::GSpanAttributeWriter dst_attribute =
-              dst_attributes.lookup_or_add_for_write_only_span(name, *propagation_domain, cd_type);
-          type.fill_assign_n(element_value, dst_attribute.span.data(), dst_attribute.span.size());
-          dst_attribute.finish();
-
-          type.destruct(element_value);
-        }
-      }
+  Vector<GeometrySet> geometries;
+  if (eval_storage_.iterations_per_batch > 0) {
+    /* The batches have prepared and joined the geometries of their iterations already. */
+    const int batches_num = eval_storage_.lf_batch_nodes.size();
+    const int batch_inputs_num = 1 + parent_.generation_groups_.size();
+    geometries.reserve(batches_num + 1);
+    for (const int batch_i : IndexRange(batches_num)) {
+      geometries.append(
+          params.extract_input<GeometrySet>(batch_i * batch_inputs_num + 1 + group_i));
+    }
+  }
+  else {
+    geometries.resize(eval_storage_.total_iterations_num);
+    for (const ForeachElementComponent &component_info : eval_storage_.components) {
+      /* These are the attributes we need to propagate from the original input geometry. */
+      const Vector<PropagatedAttribute> propagated_attributes =
+          foreach_geometry_element_zone::gather_propagated_attributes(
+              component_info.input_attributes(), component_info.id.domain, attribute_filter);
 
-      /* Create an attribute for each field that corresponds to the current geometry. */
-      for (const int local_item_i : generation_items_range.index_range()) {
-        const int item_i = generation_items_range[local_item_i];
-        const NodeForeachGeometryElementGenerationItem &item =
-            node_storage.generation_items.items[item_i];
-        const AttrDomain capture_domain = AttrDomain(item.domain);
-        const int field_param_i = body_i * body_main_outputs_num +
-                                  parent_.indices_.generation.lf_inner[item_i];
-        GField field = params.get_input<SocketValueVariant>(field_param_i).get<GField>();
+      const IndexMask mask = component_info.field_evaluator->get_evaluated_selection_as_mask();
 
-        if (capture_domain == AttrDomain::Instance) {
-          if (geometry.has_instances()) {
-            bke::try_capture_field_on_geometry(
-                geometry.get_component_for_write(GeometryComponent::Type::Instance),
-                attribute_names[local_item_i],
-                capture_domain,
-                field);
-          }
-        }
-        else {
-          geometry.modify_geometry_sets([&](GeometrySet &sub_geometry) {
-            for (const GeometryComponent::Type component_type :
-                 {GeometryComponent::Type::Mesh,
-                  GeometryComponent::Type::PointCloud,
-                  GeometryComponent::Type::Curve,
-                  GeometryComponent::Type::GreasePencil})
-            {
-              if (sub_geometry.has(component_type)) {
-                bke::try_capture_field_on_geometry(
-                    sub_geometry.get_component_for_write(component_type),
-                    attribute_names[local_item_i],
-                    capture_domain,
-                    field);
-              }
-            }
-          });
+      /* Add attributes for each field on the geometry created by each iteration. */
+      mask.foreach_index([&](const int element_i, const int local_body_i) {
+        const int body_i = component_info.body_nodes_range[local_body_i];
+        const int geometry_param_i = body_i * body_main_outputs_num +
+                                     parent_.indices_.generation.lf_inner[geometry_item_i];
+        GeometrySet &geometry = geometries[body_i];
+        geometry = params.extract_input<GeometrySet>(geometry_param_i);
+
+        Vector<CapturedGenerationField, 4> captured_fields;
+        for (const int local_item_i : generation_items_range.index_range()) {
+          const int item_i = generation_items_range[local_item_i];
+          const NodeForeachGeometryElementGenerationItem &item =
+              node_storage.generation_items.items[item_i];
+          const int field_param_i = body_i * body_main_outputs_num +
+                                    parent_.indices_.generation.lf_inner[item_i];
+          captured_fields.append(
+              {attribute_names[local_item_i],
+               AttrDomain(item.domain),
+               params.get_input<SocketValueVariant>(field_param_i).get<GField>()});
         }
-      }
-    });
+        foreach_geometry_element_zone::prepare_generated_geometry(
+            geometry, propagated_attributes, element_i, captured_fields);
+      });
+    }
   }
 
   /* The last geometry contains the edit data from the main geometry. */
-  GeometrySet &edit_data_geometry = geometries.last();
-  edit_data_geometry = eval_storage_.main_geometry;
+  GeometrySet edit_data_geometry = eval_storage_.main_geometry;
   edit_data_geometry.keep_only({GeometryComponent::Type::Edit});
+  geometries.append(std::move(edit_data_geometry));
 
   /* Join the geometries from all iterations into a single one. */
   GeometrySet joined_geometry = geometry::join_geometries(geometries, attribute_filter);
@@ -1190,15 +1626,14 @@ void LazyFunctionForReduceForeachGeometryElement::handle_generation_items_group(
 }
 
 bool LazyFunctionForReduceForeachGeometryElement::handle_generation_items_group_lazyness(
-    lf::Params &params,
-    const lf::Context & /*context*/,
-    const int geometry_item_i,
-    const IndexRange generation_items_range) const
+    lf::Params &params, const lf::Context & /*context*/, const int group_i) const
 {
   const auto &node_storage = *static_cast<NodeGeometryForeachGeometryElementOutput *>(
       parent_.output_bnode_.storage);
   const int body_main_outputs_num = node_storage.main_items.items_num +
                                     node_storage.generation_items.items_num;
+  const IndexRange group = parent_.generation_groups_[group_i];
+  const int geometry_item_i = group.first();
 
   const int geometry_output_param = parent_.indices_.generation.lf_outer[geometry_item_i];
 
@@ -1210,14 +1645,14 @@ bool LazyFunctionForReduceForeachGeometryElement::handle_generation_items_group_
   if (geometry_output_usage == lf::ValueUsage::Unused) {
     /* Output dummy values. */
     const int start_bsocket_i = parent_.indices_.generation.bsocket_outer[geometry_item_i];
-    for (const int i : IndexRange(1 + generation_items_range.size())) {
+    for (const int i : group.index_range()) {
       const bNodeSocket &bsocket = parent_.output_bnode_.output_socket(start_bsocket_i + i);
       set_default_value_for_output_socket(params, geometry_output_param + i, bsocket);
     }
     return false;
   }
   bool any_output_used = false;
-  for (const int i : IndexRange(1 + generation_items_range.size())) {
+  for (const int i : group.index_range()) {
     const lf::ValueUsage usage = params.get_output_usage(geometry_output_param + i);
     if (usage == lf::ValueUsage::Used) {
       any_output_used = true;
@@ -1228,20 +1663,31 @@ bool LazyFunctionForReduceForeachGeometryElement::handle_generation_items_group_
     /* Only execute below if we are sure that the output is actually needed. */
     return false;
   }
-  const int bodies_num = eval_storage_.lf_body_nodes.size();
 
   /* Check if all inputs are available, and request them if not. */
   bool has_missing_input = false;
-  for (const int body_i : IndexRange(bodies_num)) {
-    const int offset = body_i * body_main_outputs_num +
-                       parent_.indices_.generation.lf_inner[geometry_item_i];
-    for (const int i : IndexRange(1 + generation_items_range.size())) {
-      const bool is_available = params.try_get_input_data_ptr_or_request(offset + i) != nullptr;
-      if (!is_available) {
+  if (eval_storage_.iterations_per_batch > 0) {
+    const int batch_inputs_num = 1 + parent_.generation_groups_.size();
+    for (const int batch_i : eval_storage_.lf_batch_nodes.index_range()) {
+      const int input_i = batch_i * batch_inputs_num + 1 + group_i;
+      if (params.try_get_input_data_ptr_or_request(input_i) == nullptr) {
         has_missing_input = true;
       }
     }
   }
+  else {
+    for (const int body_i : IndexRange(eval_storage_.total_iterations_num)) {
+      const int offset = body_i * body_main_outputs_num +
+                         parent_.indices_.generation.lf_inner[geometry_item_i];
+      for (const int i : group.index_range()) {
+        const bool is_available = params.try_get_input_data_ptr_or_request(offset + i) !=
+                                  nullptr;
+        if (!is_available) {
+          has_missing_input = true;
+        }
+      }
+    }
+  }
   if (has_missing_input) {
     /* Come back when all inputs are available. */
     return false;
@@ -0,0 +1,64 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup nodes
+ *
+ * Utilities for the For Each Geometry Element zone that are shared by the code paths that reduce
+ * the iterations one by one and in batches.
+ */
+
+#pragma once
+
+#include "BLI_generic_virtual_array.hh"
+#include "BLI_string_ref.hh"
+#include "BLI_vector.hh"
+
+#include "BKE_attribute.hh"
+#include "BKE_geometry_set.hh"
+
+#include "FN_field.hh"
+
+namespace blender::nodes::foreach_geometry_element_zone {
+
+/** An attribute of the iterated geometry that is propagated to the generated geometries. */
+struct PropagatedAttribute {
+  StringRef name;
+  eCustomDataType type;
+  /** Built-in attributes are only propagated to geometries where they are built-in too. */
+  bool is_builtin;
+  /** The source attribute adapted to the iteration domain. */
+  GVArray values;
+};
+
+/**
+ * Gather the attributes that are propagated from the iterated geometry to the geometries
+ * generated in each iteration. This is done once, so that the attributes don't have to be adapted
+ * to the iteration domain again for every iteration.
+ */
+Vector<PropagatedAttribute> gather_propagated_attributes(
+    const bke::AttributeAccessor &src_attributes,
+    bke::AttrDomain iteration_domain,
+    const bke::AttributeFilter &attribute_filter);
+
+/** A field that is evaluated on a generated geometry and stored as anonymous attribute. */
+struct CapturedGenerationField {
+  StringRef attribute_name;
+  bke::AttrDomain domain;
+  fn::GField field;
+};
+
+/**
+ * Prepare the geometry generated by a single iteration for joining it with the geometries of the
+ * other iterations. The attribute values of the iterated element are propagated to it and the
+ * generated fields are captured. Since this only depends on the iteration itself, joining the
+ * prepared geometries in groups of consecutive iterations gives the same result as joining them
+ * all at once.
+ */
+void prepare_generated_geometry(bke::GeometrySet &geometry,
+                                Span<PropagatedAttribute> propagated_attributes,
+                                int element_i,
+                                Span<CapturedGenerationField> captured_fields);
+
+}  // namespace blender::nodes::foreach_geometry_element_zone
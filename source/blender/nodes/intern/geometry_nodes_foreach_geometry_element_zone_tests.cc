@@ -0,0 +1,141 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BKE_idtype.hh"
+#include "BKE_pointcloud.hh"
+
+#include "DNA_pointcloud_types.h"
+
+#include "GEO_join_geometries.hh"
+
+#include "CLG_log.h"
+
+#include "geometry_nodes_foreach_geometry_element_zone.hh"
+
+namespace blender::nodes::tests {
+
+using bke::AttrDomain;
+using bke::GeometrySet;
+
+class ForeachGeometryElementZoneTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    CLG_exit();
+  }
+};
+
+/** The geometry that is iterated over, with an attribute that is propagated to the iterations. */
+static GeometrySet create_source_geometry(const int points_num)
+{
+  PointCloud *pointcloud = BKE_pointcloud_new_nomain(points_num);
+  bke::SpanAttributeWriter<float> weights =
+      pointcloud->attributes_for_write().lookup_or_add_for_write_only_span<float>(
+          "weight", AttrDomain::Point);
+  for (const int i : IndexRange(points_num)) {
+    pointcloud->positions_for_write()[i] = float3(float(i), 0.0f, 0.0f);
+    weights.span[i] = float(i) * 0.25f;
+  }
+  weights.finish();
+  return GeometrySet::from_pointcloud(pointcloud);
+}
+
+/** The geometry generated by an iteration, with a different number of points per element. */
+static GeometrySet create_generated_geometry(const int element_i)
+{
+  const int points_num = element_i % 3 + 1;
+  PointCloud *pointcloud = BKE_pointcloud_new_nomain(points_num);
+  for (const int i : IndexRange(points_num)) {
+    pointcloud->positions_for_write()[i] = float3(float(element_i), float(i), 0.0f);
+  }
+  return GeometrySet::from_pointcloud(pointcloud);
+}
+
+static void expect_attribute_equal(const GeometrySet &expected,
+                                   const GeometrySet &actual,
+                                   const StringRef name)
+{
+  const bke::AttributeAccessor expected_attributes = expected.get_pointcloud()->attributes();
+  const bke::AttributeAccessor actual_attributes = actual.get_pointcloud()->attributes();
+  const GVArraySpan expected_values = *expected_attributes.lookup(name, AttrDomain::Point);
+  const GVArraySpan actual_values = *actual_attributes.lookup(name, AttrDomain::Point);
+  ASSERT_EQ(expected_values.type(), actual_values.type());
+  ASSERT_EQ(expected_values.size(), actual_values.size());
+  for (const int i : IndexRange(expected_values.size())) {
+    EXPECT_TRUE(expected_values.type().is_equal(expected_values[i], actual_values[i]))
+        << name << " at index " << i;
+  }
+}
+
+TEST_F(ForeachGeometryElementZoneTest, BatchedJoinMatchesUnbatched)
+{
+  const GeometrySet source = create_source_geometry(20);
+  const bke::AttributeAccessor src_attributes = source.get_pointcloud()->attributes();
+  const Vector<foreach_geometry_element_zone::PropagatedAttribute> propagated_attributes =
+      foreach_geometry_element_zone::gather_propagated_attributes(
+          src_attributes, AttrDomain::Point, {});
+
+  /* Only iterate over some of the elements, so that the iteration and element indices differ. */
+  Vector<int> elements;
+  for (int element_i = 1; element_i < 20; element_i += 2) {
+    elements.append(element_i);
+  }
+
+  Array<GeometrySet> geometries(elements.size());
+  for (const int i : elements.index_range()) {
+    const int element_i = elements[i];
+    geometries[i] = create_generated_geometry(element_i);
+    const foreach_geometry_element_zone::CapturedGenerationField captured_field{
+        "generated", AttrDomain::Point, fn::make_constant_field<int>(element_i * 10)};
+    foreach_geometry_element_zone::prepare_generated_geometry(
+        geometries[i], propagated_attributes, element_i, {captured_field});
+  }
+
+  /* Join all iterations at once, like when every iteration has its own node. */
+  const GeometrySet unbatched = geometry::join_geometries(geometries, {});
+
+  /* Join batches of consecutive iterations first, with a smaller last batch. */
+  const int iterations_per_batch = 4;
+  Vector<GeometrySet> batch_geometries;
+  for (int start = 0; start < geometries.size(); start += iterations_per_batch) {
+    const IndexRange batch = IndexRange::from_begin_end(
+        start, std::min<int>(start + iterations_per_batch, geometries.size()));
+    batch_geometries.append(geometry::join_geometries(geometries.as_span().slice(batch), {}));
+  }
+  const GeometrySet batched = geometry::join_geometries(batch_geometries, {});
+
+  ASSERT_TRUE(unbatched.has_pointcloud());
+  ASSERT_TRUE(batched.has_pointcloud());
+  EXPECT_EQ(unbatched.get_pointcloud()->totpoint, batched.get_pointcloud()->totpoint);
+  expect_attribute_equal(unbatched, batched, "position");
+  expect_attribute_equal(unbatched, batched, "weight");
+  expect_attribute_equal(unbatched, batched, "generated");
+
+  /* The points are in iteration order and have the values of the element they were created
+   * for. */
+  const bke::AttributeAccessor attributes = batched.get_pointcloud()->attributes();
+  const VArraySpan<float3> positions = *attributes.lookup<float3>("position", AttrDomain::Point);
+  const VArraySpan<float> weights = *attributes.lookup<float>("weight", AttrDomain::Point);
+  const VArraySpan<int> generated = *attributes.lookup<int>("generated", AttrDomain::Point);
+  int point_i = 0;
+  for (const int element_i : elements) {
+    for ([[maybe_unused]] const int i : IndexRange(element_i % 3 + 1)) {
+      EXPECT_EQ(positions[point_i].x, float(element_i));
+      EXPECT_EQ(weights[point_i], float(element_i) * 0.25f);
+      EXPECT_EQ(generated[point_i], element_i * 10);
+      point_i++;
+    }
+  }
+  EXPECT_EQ(point_i, positions.size());
+}
+
+}  // namespace blender::nodes::tests
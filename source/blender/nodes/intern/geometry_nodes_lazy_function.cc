@@ -22,6 +22,7 @@
 
 #include "NOD_geometry_exec.hh"
 #include "NOD_geometry_nodes_lazy_function.hh"
+#include "NOD_geometry_nodes_memoization.hh"
 #include "NOD_multi_function.hh"
 #include "NOD_node_declaration.hh"
 
@@ -141,6 +142,8 @@ class LazyFunctionForGeometryNode : public LazyFunction {
    * does not have to execute.
    */
   Vector<bool> is_attribute_output_bsocket_;
+  /** The node allows memoization and all its outputs can be stored in the cache. */
+  bool is_memoizable_ = false;
 
  public:
   LazyFunctionForGeometryNode(const bNode &node,
@@ -153,6 +156,7 @@ class LazyFunctionForGeometryNode : public LazyFunction {
     debug_name_ = node.name;
     lazy_function_interface_from_node(
         node, inputs_, outputs_, own_lf_graph_info.mapping.lf_index_by_bsocket);
+    is_memoizable_ = geometry_node_is_memoizable(node, outputs_);
 
     const NodeDeclaration &node_decl = *node.declaration();
     const aal::RelationsInNode *relations = node_decl.anonymous_attribute_relations();
@@ -248,15 +252,23 @@ class LazyFunctionForGeometryNode : public LazyFunction {
       return this->anonymous_attribute_name_for_output(*user_data, i);
     };
 
-    GeoNodeExecParams geo_params{
-        node_,
-        params,
-        context,
-        own_lf_graph_info_.mapping.lf_input_index_for_output_bsocket_usage,
-        own_lf_graph_info_.mapping.lf_input_index_for_reference_set_for_output,
-        get_anonymous_attribute_name};
+    auto execute = [&](lf::Params &params) {
+      GeoNodeExecParams geo_params{
+          node_,
+          params,
+          context,
+          own_lf_graph_info_.mapping.lf_input_index_for_output_bsocket_usage,
+          own_lf_graph_info_.mapping.lf_input_index_for_reference_set_for_output,
+          get_anonymous_attribute_name};
+      node_.typeinfo->geometry_node_execute(geo_params);
+    };
 
-    node_.typeinfo->geometry_node_execute(geo_params);
+    if (is_memoizable_) {
+      execute_geometry_node_memoized(node_, params, context, execute);
+    }
+    else {
+      execute(params);
+    }
   }
 
   std::string input_name(const int index) const override
@@ -376,6 +388,7 @@ class LazyFunctionForRerouteNode : public LazyFunction {
   LazyFunctionForRerouteNode(const CPPType &type)
   {
     debug_name_ = "Reroute";
+    is_cheap_ = true;
     inputs_.append({"Input", type});
     outputs_.append({"Output", type});
   }
@@ -554,7 +567,7 @@ static void execute_multi_function_on_value_variant__field(
 
   if (any_input_is_volume_grid) {
     return execute_multi_function_on_value_variant__volume_grid(
-        fn, input_values, output_values, r_error_message);
+        fn, owned_fn, input_values, output_values, r_error_message);
   }
   if (any_input_is_field) {
     execute_multi_function_on_value_variant__field(fn, owned_fn, input_values, output_values);
@@ -607,6 +620,7 @@ class LazyFunctionForImplicitConversion : public LazyFunction {
       : fn_(fn), dst_type_(dst_type)
   {
     debug_name_ = "Convert";
+    is_cheap_ = true;
     inputs_.append_as("From", CPPType::get<SocketValueVariant>());
     outputs_.append_as("To", CPPType::get<SocketValueVariant>());
   }
@@ -739,6 +753,8 @@ class LazyFunctionForMultiFunctionNode : public LazyFunction {
   {
     BLI_assert(fn_item_.fn != nullptr);
     debug_name_ = node.name;
+    /* Fields and grids are computed lazily, so only single values are computed directly. */
+    is_cheap_ = true;
     lazy_function_interface_from_node(node, inputs_, outputs_, r_lf_index_by_bsocket);
   }
 
@@ -0,0 +1,549 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup nodes
+ */
+
+#include <cstring>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_implicit_sharing_key.hh"
+#include "BLI_listbase.h"
+#include "BLI_memory_cache.hh"
+#include "BLI_memory_counter.hh"
+
+#include "DNA_curves_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_node_types.h"
+#include "DNA_object_types.h"
+#include "DNA_pointcloud_types.h"
+#include "DNA_userdef_types.h"
+
+#include "BKE_curves.hh"
+#include "BKE_geometry_nodes_reference_set.hh"
+#include "BKE_geometry_set.hh"
+#include "BKE_instances.hh"
+#include "BKE_mesh_types.hh"
+#include "BKE_node_runtime.hh"
+#include "BKE_node_socket_value.hh"
+
+#include "FN_field.hh"
+
+#include "NOD_geometry_nodes_lazy_function.hh"
+#include "NOD_geometry_nodes_log.hh"
+#include "NOD_geometry_nodes_memoization.hh"
+
+namespace blender::nodes {
+
+using bke::GeometryComponent;
+using bke::GeometrySet;
+using bke::SocketValueVariant;
+
+/* -------------------------------------------------------------------- */
+/** \name Memoization Key
+ * \{ */
+
+/**
+ * Identifies the execution of a node in a specific compute context with specific inputs. Most
+ * data is stored as plain words, only values that have to be compared with their own equality
+ * operator are stored separately.
+ */
+class NodeMemoizationKey : public ImplicitSharingKey {
+ public:
+  /**
+   * Single values and field inputs passed to the node. The fields keep their nodes alive, so
+   * fields that are compared by identity can't be confused with newer fields.
+   */
+  Vector<SocketValueVariant> values;
+
+  uint64_t hash() const override
+  {
+    uint64_t hash = ImplicitSharingKey::hash();
+    for (const SocketValueVariant &value : this->values) {
+      hash = get_default_hash(hash, value_hash(value));
+    }
+    return hash;
+  }
+
+  bool equal_to(const GenericKey &other) const override
+  {
+    if (!ImplicitSharingKey::equal_to(other)) {
+      return false;
+    }
+    const auto &other_key = static_cast<const NodeMemoizationKey &>(other);
+    if (this->values.size() != other_key.values.size()) {
+      return false;
+    }
+    for (const int i : this->values.index_range()) {
+      if (!values_equal(this->values[i], other_key.values[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::unique_ptr<GenericKey> to_storable() const override
+  {
+    return std::make_unique<NodeMemoizationKey>(*this);
+  }
+
+ private:
+  static uint64_t value_hash(const SocketValueVariant &value)
+  {
+    if (value.is_single()) {
+      const GPointer ptr = value.get_single_ptr();
+      return ptr.type()->hash(ptr.get());
+    }
+    return value.get<fn::GField>().hash();
+  }
+
+  static bool values_equal(const SocketValueVariant &a, const SocketValueVariant &b)
+  {
+    if (a.is_single() != b.is_single()) {
+      return false;
+    }
+    if (a.is_single()) {
+      const GPointer a_ptr = a.get_single_ptr();
+      const GPointer b_ptr = b.get_single_ptr();
+      return a_ptr.type() == b_ptr.type() && a_ptr.type()->is_equal(a_ptr.get(), b_ptr.get());
+    }
+    return a.get<fn::GField>() == b.get<fn::GField>();
+  }
+};
+
+static void add_materials(NodeMemoizationKey &key, const Span<const Material *> materials)
+{
+  key.words.append(uint64_t(materials.size()));
+  for (const Material *material : materials) {
+    key.words.append(material ? reinterpret_cast<const ID *>(material)->session_uid : 0);
+  }
+}
+
+static void add_vertex_group_names(NodeMemoizationKey &key, const ListBase &vertex_group_names)
+{
+  key.words.append(uint64_t(BLI_listbase_count(&vertex_group_names)));
+  LISTBASE_FOREACH (const bDeformGroup *, group, &vertex_group_names) {
+    key.strings.append(group->name);
+  }
+}
+
+static bool add_mesh(NodeMemoizationKey &key, const Mesh &mesh)
+{
+  if (mesh.runtime->wrapper_type != ME_WRAPPER_TYPE_MDATA) {
+    return false;
+  }
+  key.words.extend({uint64_t(mesh.verts_num),
+                    uint64_t(mesh.edges_num),
+                    uint64_t(mesh.faces_num),
+                    uint64_t(mesh.corners_num)});
+  if (!key.add_array(mesh.face_offset_indices != nullptr,
+                     mesh.runtime->face_offsets_sharing_info))
+  {
+    return false;
+  }
+  add_vertex_group_names(key, mesh.vertex_group_names);
+  add_materials(key, {mesh.mat, mesh.totcol});
+  return bke::attributes_add_to_key(key, mesh.attributes());
+}
+
+static bool add_pointcloud(NodeMemoizationKey &key, const PointCloud &pointcloud)
+{
+  key.words.append(uint64_t(pointcloud.totpoint));
+  add_materials(key, {pointcloud.mat, pointcloud.totcol});
+  return bke::attributes_add_to_key(key, pointcloud.attributes());
+}
+
+static bool add_curves(NodeMemoizationKey &key, const Curves &curves_id)
+{
+  const bke::CurvesGeometry &curves = curves_id.geometry.wrap();
+  key.words.extend({uint64_t(curves.points_num()), uint64_t(curves.curves_num())});
+  if (!key.add_array(curves.curve_offsets != nullptr,
+                     curves.runtime->curve_offsets_sharing_info))
+  {
+    return false;
+  }
+  if (!key.add_array(curves.custom_knots != nullptr,
+                     curves.runtime->custom_knots_sharing_info))
+  {
+    return false;
+  }
+  add_vertex_group_names(key, curves.vertex_group_names);
+  add_materials(key, {curves_id.mat, curves_id.totcol});
+  key.words.append(curves_id.surface ? curves_id.surface->id.session_uid : 0);
+  key.strings.append(curves_id.surface_uv_map ? curves_id.surface_uv_map : "");
+  return bke::attributes_add_to_key(key, curves.attributes());
+}
+
+static bool add_geometry(NodeMemoizationKey &key, const GeometrySet &geometry);
+
+static bool add_instances(NodeMemoizationKey &key, const bke::Instances &instances)
+{
+  key.words.append(uint64_t(instances.instances_num()));
+  key.words.append(uint64_t(instances.references().size()));
+  for (const bke::InstanceReference &reference : instances.references()) {
+    key.words.append(uint64_t(reference.type()));
+    switch (reference.type()) {
+      case bke::InstanceReference::Type::None:
+        break;
+      case bke::InstanceReference::Type::Object:
+      case bke::InstanceReference::Type::Collection:
+        /* The evaluated data-blocks may change without changing their identity. */
+        return false;
+      case bke::InstanceReference::Type::GeometrySet:
+        if (!add_geometry(key, reference.geometry_set())) {
+          return false;
+        }
+        break;
+    }
+  }
+  return bke::attributes_add_to_key(key, instances.attributes());
+}
+
+static bool add_geometry(NodeMemoizationKey &key, const GeometrySet &geometry)
+{
+  key.strings.append(geometry.name);
+  for (const GeometryComponent *component : geometry.get_components()) {
+    key.words.append(uint64_t(component->type()));
+    switch (component->type()) {
+      case GeometryComponent::Type::Mesh: {
+        const Mesh *mesh = static_cast<const bke::MeshComponent *>(component)->get();
+        if (!mesh || !add_mesh(key, *mesh)) {
+          return false;
+        }
+        break;
+      }
+      case GeometryComponent::Type::PointCloud: {
+        const PointCloud *pointcloud =
+            static_cast<const bke::PointCloudComponent *>(component)->get();
+        if (!pointcloud || !add_pointcloud(key, *pointcloud)) {
+          return false;
+        }
+        break;
+      }
+      case GeometryComponent::Type::Curve: {
+        const Curves *curves = static_cast<const bke::CurveComponent *>(component)->get();
+        if (!curves || !add_curves(key, *curves)) {
+          return false;
+        }
+        break;
+      }
+      case GeometryComponent::Type::Instance: {
+        const bke::Instances *instances =
+            static_cast<const bke::InstancesComponent *>(component)->get();
+        if (!instances || !add_instances(key, *instances)) {
+          return false;
+        }
+        break;
+      }
+      case GeometryComponent::Type::Volume:
+      case GeometryComponent::Type::Edit:
+      case GeometryComponent::Type::GreasePencil:
+        return false;
+    }
+  }
+  return true;
+}
+
+static bool add_value(NodeMemoizationKey &key, const SocketValueVariant &value)
+{
+  if (value.is_volume_grid()) {
+    return false;
+  }
+  if (value.is_context_dependent_field()) {
+    /* Field inputs (e.g. the position or a named attribute) compare equal when they read the same
+     * data. Operations are newly created on every evaluation, so they never compare equal. */
+    const fn::GField field = value.get<fn::GField>();
+    if (field.node().node_type() != fn::FieldNodeType::Input) {
+      return false;
+    }
+    key.values.append(value);
+    return true;
+  }
+  SocketValueVariant single_value = value;
+  single_value.convert_to_single();
+  const CPPType &type = *single_value.get_single_ptr().type();
+  if (!type.is_hashable() || !type.is_equality_comparable()) {
+    return false;
+  }
+  key.values.append(std::move(single_value));
+  return true;
+}
+
+static bool add_node_settings(NodeMemoizationKey &key, const bNode &node)
+{
+  key.words.append(uint64_t(node.identifier));
+  key.words.extend({uint64_t(node.custom1), uint64_t(node.custom2)});
+  uint32_t custom3_bits, custom4_bits;
+  memcpy(&custom3_bits, &node.custom3, sizeof(float));
+  memcpy(&custom4_bits, &node.custom4, sizeof(float));
+  key.words.extend({custom3_bits, custom4_bits});
+  if (node.storage) {
+    key.strings.append(std::string(static_cast<const char *>(node.storage),
+                                   MEM_allocN_len(node.storage)));
+  }
+  else {
+    key.strings.append("");
+  }
+  return node.id == nullptr;
+}
+
+static std::optional<NodeMemoizationKey> build_key(const bNode &node,
+                                                   lf::Params &params,
+                                                   const GeoNodesUserData &user_data,
+                                                   const bool is_logged)
+{
+  NodeMemoizationKey key;
+  const ComputeContextHash context_hash = user_data.compute_context->hash();
+  key.words.extend({context_hash.v1, context_hash.v2});
+  key.words.append(node.owner_tree().id.session_uid);
+  /* Names of anonymous attributes created by the node depend on the object. */
+  const Object *self_object = user_data.call_data->self_object();
+  key.strings.append(self_object ? self_object->id.name : "");
+  /* Different entries are cached for logged evaluations, so that warnings can be replayed. */
+  key.words.append(uint64_t(is_logged));
+
+  if (!add_node_settings(key, node)) {
+    return std::nullopt;
+  }
+
+  /* Nodes may skip outputs that are not used. */
+  const Span<lf::Output> outputs = params.fn_.outputs();
+  for (const int i : outputs.index_range()) {
+    key.words.append(uint64_t(params.get_output_usage(i) != lf::ValueUsage::Unused));
+  }
+
+  const Span<lf::Input> inputs = params.fn_.inputs();
+  for (const int i : inputs.index_range()) {
+    const CPPType &type = *inputs[i].type;
+    const void *value = params.try_get_input_data_ptr(i);
+    BLI_assert(value != nullptr);
+    if (type.is<bool>()) {
+      key.words.append(uint64_t(*static_cast<const bool *>(value)));
+    }
+    else if (type.is<SocketValueVariant>()) {
+      if (!add_value(key, *static_cast<const SocketValueVariant *>(value))) {
+        return std::nullopt;
+      }
+    }
+    else if (type.is<GeometrySet>()) {
+      if (!add_geometry(key, *static_cast<const GeometrySet *>(value))) {
+        return std::nullopt;
+      }
+    }
+    else if (type.is<bke::GeometryNodesReferenceSet>()) {
+      const bke::GeometryNodesReferenceSet &reference_set =
+          *static_cast<const bke::GeometryNodesReferenceSet *>(value);
+      if (reference_set.names) {
+        Vector<std::string> names(reference_set.names->begin(), reference_set.names->end());
+        std::sort(names.begin(), names.end());
+        key.words.append(uint64_t(names.size()));
+        key.strings.extend(names);
+      }
+      else {
+        key.words.append(0);
+      }
+    }
+    else {
+      /* E.g. data-blocks, bundles or closures. */
+      return std::nullopt;
+    }
+  }
+  return key;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Memoized Outputs
+ * \{ */
+
+class MemoizedNodeOutputs : public memory_cache::CachedValue {
+ public:
+  /** Copies of the outputs set by the node, with their lazy-function output index. */
+  Vector<std::pair<int, GeometrySet>> geometries;
+  Vector<std::pair<int, SocketValueVariant>> values;
+  /** Logged data of the node, only gathered when the evaluation was logged. */
+  Vector<geo_eval_log::NodeWarning> warnings;
+  Vector<std::pair<std::string, geo_eval_log::NamedAttributeUsage>> used_named_attributes;
+
+  void count_memory(MemoryCounter &memory) const override
+  {
+    for (const auto &item : this->geometries) {
+      item.second.count_memory(memory);
+    }
+    memory.add(this->values.size() * sizeof(SocketValueVariant));
+  }
+};
+
+/**
+ * Forwards everything to the original params, but copies every output before it is passed on.
+ * The original params may move the value away immediately.
+ */
+class MemoizingParams : public lf::Params {
+ private:
+  lf::Params &params_;
+  MemoizedNodeOutputs &outputs_;
+
+ public:
+  MemoizingParams(lf::Params &params, MemoizedNodeOutputs &outputs)
+      : lf::Params(params.fn_, false), params_(params), outputs_(outputs)
+  {
+  }
+
+ private:
+  void *try_get_input_data_ptr_impl(const int index) const override
+  {
+    return params_.try_get_input_data_ptr(index);
+  }
+
+  void *try_get_input_data_ptr_or_request_impl(const int index) override
+  {
+    return params_.try_get_input_data_ptr_or_request(index);
+  }
+
+  void *get_output_data_ptr_impl(const int index) override
+  {
+    return params_.get_output_data_ptr(index);
+  }
+
+  void output_set_impl(const int index) override
+  {
+    const CPPType &type = *fn_.outputs()[index].type;
+    const void *value = params_.get_output_data_ptr(index);
+    if (type.is<GeometrySet>()) {
+      GeometrySet geometry = *static_cast<const GeometrySet *>(value);
+      /* The output may reference data owned by other data-blocks. */
+      geometry.ensure_owns_direct_data();
+      outputs_.geometries.append({index, std::move(geometry)});
+    }
+    else {
+      BLI_assert(type.is<SocketValueVariant>());
+      outputs_.values.append({index, *static_cast<const SocketValueVariant *>(value)});
+    }
+    params_.output_set(index);
+  }
+
+  bool output_was_set_impl(const int index) const override
+  {
+    return params_.output_was_set(index);
+  }
+
+  lf::ValueUsage get_output_usage_impl(const int index) const override
+  {
+    return params_.get_output_usage(index);
+  }
+
+  void set_input_unused_impl(const int index) override
+  {
+    params_.set_input_unused(index);
+  }
+
+  bool try_enable_multi_threading_impl() override
+  {
+    return params_.try_enable_multi_threading();
+  }
+};
+
+static void gather_logged_data(const bNode &node,
+                               const geo_eval_log::GeoTreeLogger &tree_logger,
+                               MemoizedNodeOutputs &outputs)
+{
+  for (const geo_eval_log::GeoTreeLogger::WarningWithNode &item : tree_logger.node_warnings) {
+    if (item.node_id == node.identifier) {
+      outputs.warnings.append(item.warning);
+    }
+  }
+  for (const geo_eval_log::GeoTreeLogger::AttributeUsageWithNode &item :
+       tree_logger.used_named_attributes)
+  {
+    if (item.node_id == node.identifier) {
+      outputs.used_named_attributes.append({item.attribute_name, item.usage});
+    }
+  }
+}
+
+static void replay_logged_data(const bNode &node,
+                               const MemoizedNodeOutputs &outputs,
+                               geo_eval_log::GeoTreeLogger &tree_logger)
+{
+  for (const geo_eval_log::NodeWarning &warning : outputs.warnings) {
+    tree_logger.node_warnings.append(*tree_logger.allocator, {node.identifier, warning});
+  }
+  for (const auto &[name, usage] : outputs.used_named_attributes) {
+    tree_logger.used_named_attributes.append(
+        *tree_logger.allocator, {node.identifier, tree_logger.allocator->copy_string(name), usage});
+  }
+}
+
+/** \} */
+
+bool geometry_node_is_memoizable(const bNode &node, const Span<lf::Output> outputs)
+{
+  if (!node.typeinfo->geometry_node_memoizable) {
+    return false;
+  }
+  for (const lf::Output &output : outputs) {
+    if (!output.type->is_any<GeometrySet, SocketValueVariant>()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void execute_geometry_node_memoized(const bNode &node,
+                                    lf::Params &params,
+                                    const lf::Context &context,
+                                    const FunctionRef<void(lf::Params &params)> execute_fn)
+{
+  if (!USER_EXPERIMENTAL_TEST(&U, use_geometry_nodes_memoization)) {
+    execute_fn(params);
+    return;
+  }
+  const GeoNodesUserData &user_data = *static_cast<GeoNodesUserData *>(context.user_data);
+  const GeoNodesLocalUserData &local_user_data = *static_cast<GeoNodesLocalUserData *>(
+      context.local_user_data);
+  geo_eval_log::GeoTreeLogger *tree_logger = local_user_data.try_get_tree_logger(user_data);
+
+  const std::optional<NodeMemoizationKey> key = build_key(
+      node, params, user_data, tree_logger != nullptr);
+  if (!key) {
+    execute_fn(params);
+    return;
+  }
+
+  bool executed = false;
+  const std::shared_ptr<const MemoizedNodeOutputs> outputs =
+      memory_cache::get<MemoizedNodeOutputs>(*key, [&]() {
+        executed = true;
+        auto outputs = std::make_unique<MemoizedNodeOutputs>();
+        MemoizingParams memoizing_params{params, *outputs};
+        execute_fn(memoizing_params);
+        if (tree_logger) {
+          gather_logged_data(node, *tree_logger, *outputs);
+        }
+        return outputs;
+      });
+  if (executed) {
+    /* The outputs have been set already. */
+    return;
+  }
+
+  for (const auto &[index, geometry] : outputs->geometries) {
+    if (!params.output_was_set(index)) {
+      params.set_output(index, geometry);
+    }
+  }
+  for (const auto &[index, value] : outputs->values) {
+    if (!params.output_was_set(index)) {
+      params.set_output(index, value);
+    }
+  }
+  if (tree_logger) {
+    replay_logged_data(node, *outputs, *tree_logger);
+  }
+}
+
+}  // namespace blender::nodes
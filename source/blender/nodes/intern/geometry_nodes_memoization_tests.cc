@@ -0,0 +1,245 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_memory_cache.hh"
+#include "BLI_memory_utils.hh"
+
+#include "CLG_log.h"
+
+#include "DNA_pointcloud_types.h"
+#include "DNA_userdef_types.h"
+
+#include "BKE_compute_contexts.hh"
+#include "BKE_geometry_set.hh"
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_node.hh"
+#include "BKE_node_runtime.hh"
+#include "BKE_node_socket_value.hh"
+#include "BKE_pointcloud.hh"
+
+#include "FN_lazy_function_execute.hh"
+
+#include "NOD_geometry_nodes_lazy_function.hh"
+#include "NOD_geometry_nodes_memoization.hh"
+
+#include "RNA_define.hh"
+
+namespace blender::nodes::tests {
+
+using bke::GeometrySet;
+using bke::SocketValueVariant;
+
+/**
+ * Executes a node like #LazyFunctionForGeometryNode does, but with a simple execute function that
+ * offsets the positions of a point cloud. It counts how often the node is actually executed.
+ */
+class LazyFunctionForMemoizationTestNode : public LazyFunction {
+ private:
+  const bNode &node_;
+  bool is_memoizable_;
+
+ public:
+  mutable int executions_num = 0;
+
+  LazyFunctionForMemoizationTestNode(const bNode &node) : node_(node)
+  {
+    debug_name_ = node.name;
+    inputs_.append_as("Geometry", CPPType::get<GeometrySet>());
+    inputs_.append_as("Offset", CPPType::get<SocketValueVariant>());
+    outputs_.append_as("Geometry", CPPType::get<GeometrySet>());
+    is_memoizable_ = geometry_node_is_memoizable(node, outputs_);
+  }
+
+  const bNode &node() const
+  {
+    return node_;
+  }
+
+  void execute_impl(lf::Params &params, const lf::Context &context) const override
+  {
+    auto execute = [&](lf::Params &params) {
+      executions_num++;
+      GeometrySet geometry = params.get_input<GeometrySet>(0);
+      const float offset = params.get_input<SocketValueVariant>(1).get<float>();
+      if (PointCloud *pointcloud = geometry.get_pointcloud_for_write()) {
+        for (float3 &position : pointcloud->positions_for_write()) {
+          position.z += offset;
+        }
+      }
+      params.set_output(0, std::move(geometry));
+    };
+    if (is_memoizable_) {
+      execute_geometry_node_memoized(node_, params, context, execute);
+    }
+    else {
+      execute(params);
+    }
+  }
+};
+
+class GeometryNodesMemoizationTest : public ::testing::Test {
+ protected:
+  bNodeTree *tree_ = nullptr;
+
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+    RNA_init();
+    bke::node_system_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    bke::node_system_exit();
+    RNA_exit();
+    CLG_exit();
+  }
+
+  void SetUp() override
+  {
+    U.flag |= USER_DEVELOPER_UI;
+    U.experimental.use_geometry_nodes_memoization = true;
+    memory_cache::clear();
+    tree_ = bke::node_tree_add_tree(nullptr, "Test", "GeometryNodeTree");
+  }
+
+  void TearDown() override
+  {
+    memory_cache::clear();
+    U.flag &= ~USER_DEVELOPER_UI;
+    U.experimental.use_geometry_nodes_memoization = false;
+    BKE_id_free(nullptr, &tree_->id);
+  }
+
+  const bNode &add_node(const StringRef idname)
+  {
+    bNode *node = bke::node_add_node(nullptr, *tree_, idname);
+    tree_->ensure_topology_cache();
+    return *node;
+  }
+
+  /** Execute the node with the inputs like the lazy-function graph executor would. */
+  static GeometrySet execute(const LazyFunctionForMemoizationTestNode &fn,
+                             const GeometrySet &geometry,
+                             const float offset)
+  {
+    bke::ModifierComputeContext compute_context{nullptr, 0};
+    GeoNodesCallData call_data;
+    GeoNodesUserData user_data;
+    user_data.call_data = &call_data;
+    user_data.compute_context = &compute_context;
+    GeoNodesLocalUserData local_user_data{user_data};
+
+    TypedBuffer<GeometrySet> output;
+    lf::execute_lazy_function_eagerly(fn,
+                                      &user_data,
+                                      &local_user_data,
+                                      std::make_tuple(geometry, SocketValueVariant(offset)),
+                                      std::make_tuple(static_cast<GeometrySet *>(output)));
+    GeometrySet result = std::move(*output);
+    std::destroy_at(static_cast<GeometrySet *>(output));
+    return result;
+  }
+};
+
+static GeometrySet create_pointcloud(const int points_num)
+{
+  PointCloud *pointcloud = BKE_pointcloud_new_nomain(points_num);
+  MutableSpan<float3> positions = pointcloud->positions_for_write();
+  for (const int i : positions.index_range()) {
+    positions[i] = float3(float(i), 0.0f, 0.0f);
+  }
+  return GeometrySet::from_pointcloud(pointcloud);
+}
+
+static float first_z(const GeometrySet &geometry)
+{
+  return geometry.get_pointcloud()->positions().first().z;
+}
+
+TEST_F(GeometryNodesMemoizationTest, HitOnUnchangedInputs)
+{
+  const LazyFunctionForMemoizationTestNode fn{this->add_node("GeometryNodeSubdivideMesh")};
+  const GeometrySet geometry = create_pointcloud(100);
+
+  EXPECT_EQ(first_z(execute(fn, geometry, 1.0f)), 1.0f);
+  EXPECT_EQ(fn.executions_num, 1);
+  /* The same inputs give the cached output without executing the node again. */
+  EXPECT_EQ(first_z(execute(fn, geometry, 1.0f)), 1.0f);
+  EXPECT_EQ(fn.executions_num, 1);
+  /* A copy of the geometry shares the same arrays, so it's identified as the same input. */
+  const GeometrySet geometry_copy = geometry;
+  EXPECT_EQ(first_z(execute(fn, geometry_copy, 1.0f)), 1.0f);
+  EXPECT_EQ(fn.executions_num, 1);
+  /* Changing a single value input executes the node again. */
+  EXPECT_EQ(first_z(execute(fn, geometry, 2.0f)), 2.0f);
+  EXPECT_EQ(fn.executions_num, 2);
+}
+
+TEST_F(GeometryNodesMemoizationTest, MissAfterSharingVersionChange)
+{
+  const LazyFunctionForMemoizationTestNode fn{this->add_node("GeometryNodeSubdivideMesh")};
+  GeometrySet geometry = create_pointcloud(100);
+
+  EXPECT_EQ(first_z(execute(fn, geometry, 1.0f)), 1.0f);
+  EXPECT_EQ(fn.executions_num, 1);
+
+  /* The positions are not shared, so they are changed in place. That keeps the same sharing info
+   * but increases its version, which has to invalidate the cached output. */
+  PointCloud &pointcloud = *geometry.get_pointcloud_for_write();
+  const float3 *old_positions = pointcloud.positions().data();
+  pointcloud.positions_for_write().first().z = 5.0f;
+  ASSERT_EQ(pointcloud.positions().data(), old_positions);
+
+  EXPECT_EQ(first_z(execute(fn, geometry, 1.0f)), 6.0f);
+  EXPECT_EQ(fn.executions_num, 2);
+  EXPECT_EQ(first_z(execute(fn, geometry, 1.0f)), 6.0f);
+  EXPECT_EQ(fn.executions_num, 2);
+}
+
+TEST_F(GeometryNodesMemoizationTest, EvictionOverBudget)
+{
+  const LazyFunctionForMemoizationTestNode fn{this->add_node("GeometryNodeSubdivideMesh")};
+  const GeometrySet geometry = create_pointcloud(100);
+
+  /* The output does not fit into the cache, so it is removed again immediately. */
+  memory_cache::set_approximate_size_limit(1);
+  EXPECT_EQ(first_z(execute(fn, geometry, 1.0f)), 1.0f);
+  EXPECT_EQ(first_z(execute(fn, geometry, 1.0f)), 1.0f);
+  EXPECT_EQ(fn.executions_num, 2);
+
+  /* With enough space, the output is kept. */
+  memory_cache::set_approximate_size_limit(1024 * 1024 * 1024);
+  EXPECT_EQ(first_z(execute(fn, geometry, 1.0f)), 1.0f);
+  EXPECT_EQ(first_z(execute(fn, geometry, 1.0f)), 1.0f);
+  EXPECT_EQ(fn.executions_num, 3);
+}
+
+TEST_F(GeometryNodesMemoizationTest, NonMemoizableNodesBypassCache)
+{
+  /* Nodes that don't opt in are always executed. */
+  const LazyFunctionForMemoizationTestNode set_position_fn{
+      this->add_node("GeometryNodeSetPosition")};
+  EXPECT_FALSE(geometry_node_is_memoizable(set_position_fn.node(), set_position_fn.outputs()));
+  const GeometrySet geometry = create_pointcloud(100);
+  EXPECT_EQ(first_z(execute(set_position_fn, geometry, 1.0f)), 1.0f);
+  EXPECT_EQ(first_z(execute(set_position_fn, geometry, 1.0f)), 1.0f);
+  EXPECT_EQ(set_position_fn.executions_num, 2);
+
+  /* Memoizable nodes are executed as well when an input can't be identified. */
+  const LazyFunctionForMemoizationTestNode subdivide_fn{
+      this->add_node("GeometryNodeSubdivideMesh")};
+  EXPECT_TRUE(geometry_node_is_memoizable(subdivide_fn.node(), subdivide_fn.outputs()));
+  GeometrySet geometry_with_edit_data = geometry;
+  geometry_with_edit_data.get_component_for_write<bke::GeometryComponentEditData>();
+  EXPECT_EQ(first_z(execute(subdivide_fn, geometry_with_edit_data, 1.0f)), 1.0f);
+  EXPECT_EQ(first_z(execute(subdivide_fn, geometry_with_edit_data, 1.0f)), 1.0f);
+  EXPECT_EQ(subdivide_fn.executions_num, 2);
+}
+
+}  // namespace blender::nodes::tests
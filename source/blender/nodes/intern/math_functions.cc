@@ -2,13 +2,82 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <array>
+
+#include "BLI_math_vectorized.hh"
+
 #include "NOD_math_functions.hh"
 
 namespace blender::nodes {
 
+/**
+ * Evaluates an elementary function with one of the array functions from `BLI_math_vectorized.hh`.
+ * Vectors are processed as arrays with three times as many floats.
+ */
+template<typename T> class VectorizedMathFunction : public mf::MultiFunction {
+ private:
+  using ArrayFn = void (*)(const float *src, float *dst, size_t length);
+
+  static constexpr int64_t components_num = sizeof(T) / sizeof(float);
+  /** Number of elements that are gathered at once when the input or mask is not contiguous. */
+  static constexpr int64_t chunk_size = 1024;
+
+  ArrayFn array_fn_;
+  mf::Signature signature_;
+
+ public:
+  VectorizedMathFunction(const char *name, const ArrayFn array_fn) : array_fn_(array_fn)
+  {
+    mf::SignatureBuilder builder{name, signature_};
+    builder.single_input<T>("Value");
+    builder.single_output<T>("Result");
+    this->set_signature(&signature_);
+  }
+
+  void call(const IndexMask &mask, mf::Params params, mf::Context /*context*/) const override
+  {
+    const VArray<T> &values = params.readonly_single_input<T>(0, "Value");
+    MutableSpan<T> results = params.uninitialized_single_output<T>(1, "Result");
+
+    if (const std::optional<T> value = values.get_if_single()) {
+      T result;
+      this->apply(&*value, &result, 1);
+      index_mask::masked_fill(results, result, mask);
+      return;
+    }
+    if (values.is_span()) {
+      if (const std::optional<IndexRange> range = mask.to_range()) {
+        const Span<T> src = values.get_internal_span().slice(*range);
+        this->apply(src.data(), results.slice(*range).data(), range->size());
+        return;
+      }
+    }
+
+    std::array<T, chunk_size> buffer;
+    for (int64_t start = 0; start < mask.size(); start += chunk_size) {
+      const IndexMask chunk = mask.slice(start, std::min(chunk_size, mask.size() - start));
+      values.materialize_compressed(chunk, MutableSpan<T>(buffer.data(), chunk.size()));
+      this->apply(buffer.data(), buffer.data(), chunk.size());
+      chunk.foreach_index([&](const int64_t i, const int64_t pos) { results[i] = buffer[pos]; });
+    }
+  }
+
+ private:
+  void apply(const T *src, T *dst, const int64_t size) const
+  {
+    array_fn_(reinterpret_cast<const float *>(src),
+              reinterpret_cast<float *>(dst),
+              size_t(size * components_num));
+  }
+};
+
 static const mf::MultiFunction *get_base_multi_function(const bNode &node)
 {
   const int mode = node.custom1;
+  if (const mf::MultiFunction *fn = get_vectorized_float_math_function(mode)) {
+    return fn;
+  }
+
   const mf::MultiFunction *base_fn = nullptr;
 
   try_dispatch_float_math_fl_to_fl(
@@ -83,6 +152,50 @@ void node_math_build_multi_function(NodeMultiFunctionBuilder &builder)
   }
 }
 
+const mf::MultiFunction *get_vectorized_float_math_function(const int operation)
+{
+  const FloatMathOperationInfo *info = get_float_math_operation_info(operation);
+  if (info == nullptr) {
+    return nullptr;
+  }
+  switch (operation) {
+    case NODE_MATH_SINE: {
+      static VectorizedMathFunction<float> fn{info->title_case_name.c_str(), math::sin_array};
+      return &fn;
+    }
+    case NODE_MATH_COSINE: {
+      static VectorizedMathFunction<float> fn{info->title_case_name.c_str(), math::cos_array};
+      return &fn;
+    }
+    case NODE_MATH_EXPONENT: {
+      static VectorizedMathFunction<float> fn{info->title_case_name.c_str(), math::exp_array};
+      return &fn;
+    }
+  }
+  return nullptr;
+}
+
+const mf::MultiFunction *get_vectorized_float3_math_function(
+    const NodeVectorMathOperation operation)
+{
+  const FloatMathOperationInfo *info = get_float3_math_operation_info(operation);
+  if (info == nullptr) {
+    return nullptr;
+  }
+  switch (operation) {
+    case NODE_VECTOR_MATH_SINE: {
+      static VectorizedMathFunction<float3> fn{info->title_case_name.c_str(), math::sin_array};
+      return &fn;
+    }
+    case NODE_VECTOR_MATH_COSINE: {
+      static VectorizedMathFunction<float3> fn{info->title_case_name.c_str(), math::cos_array};
+      return &fn;
+    }
+    default:
+      return nullptr;
+  }
+}
+
 const FloatMathOperationInfo *get_float_math_operation_info(const int operation)
 {
 
@@ -2,9 +2,15 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include "BLI_map.hh"
+#include "BLI_set.hh"
+
 #include "BKE_customdata.hh"
 #include "BLT_translation.hh"
+#include "FN_field.hh"
 #include "FN_multi_function.hh"
+#include "FN_multi_function_procedure.hh"
+#include "FN_multi_function_procedure_executor.hh"
 
 #include "BKE_anonymous_attribute_make.hh"
 #include "BKE_node.hh"
@@ -13,6 +19,8 @@
 #include "BKE_volume_grid_fields.hh"
 #include "BKE_volume_openvdb.hh"
 
+#include <algorithm>
+
 #include <fmt/format.h>
 
 #ifdef WITH_OPENVDB
@@ -610,11 +618,14 @@ BLI_NOINLINE static void process_tiles(const mf::MultiFunction &fn,
   }
 }
 
-bool execute_multi_function_on_value_variant__volume_grid(
-    const mf::MultiFunction &fn,
-    const Span<bke::SocketValueVariant *> input_values,
-    const Span<bke::SocketValueVariant *> output_values,
-    std::string &r_error_message)
+/**
+ * Evaluate the multi-function on all active voxels and tiles of the input grids and create a new
+ * grid for every output of the function.
+ */
+static bool evaluate_multi_function_on_grids(const mf::MultiFunction &fn,
+                                             const Span<bke::SocketValueVariant *> input_values,
+                                             MutableSpan<openvdb::GridBase::Ptr> output_grids,
+                                             std::string &r_error_message)
 {
   const int inputs_num = input_values.size();
   Array<bke::VolumeTreeAccessToken> input_volume_tokens(inputs_num);
@@ -662,8 +673,7 @@ bool execute_multi_function_on_value_variant__volume_grid(
     to_typed_grid(*grid, [&](const auto &grid) { mask_tree.topologyUnion(grid.tree()); });
   }
 
-  Array<openvdb::GridBase::Ptr> output_grids(output_values.size());
-  for (const int i : output_values.index_range()) {
+  for (const int i : output_grids.index_range()) {
     const int param_index = input_values.size() + i;
     const mf::ParamType param_type = fn.param_type(param_index);
     const CPPType &cpp_type = param_type.data_type().single_type();
@@ -708,19 +718,308 @@ bool execute_multi_function_on_value_variant__volume_grid(
         process_tiles(fn, input_values, input_grids, output_grids, *transform, tiles);
       });
 
+  return true;
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Fused Evaluation
+ *
+ * Grids computed by multi-functions are not computed right away. Instead, the output grids keep a
+ * field that describes how their values are computed. When such a grid is used as input of another
+ * multi-function, the fields are combined, so that a chain of e.g. math nodes is evaluated leaf by
+ * leaf in one go, without creating intermediate grids. The grid is only computed when it is
+ * accessed in some other way.
+ * \{ */
+
+/**
+ * Represents a grid in the fields of #FusedGridSource. It is not evaluated like other field
+ * inputs, the grid is passed to #evaluate_multi_function_on_grids instead.
+ */
+class GridFieldInput : public fn::FieldInput {
+ public:
+  bke::GVolumeGrid grid;
+
+  GridFieldInput(const CPPType &type, bke::GVolumeGrid grid)
+      : fn::FieldInput(type, "Grid"), grid(std::move(grid))
+  {
+  }
+
+  GVArray get_varray_for_context(const fn::FieldContext & /*context*/,
+                                 const IndexMask & /*mask*/,
+                                 ResourceScope & /*scope*/) const override
+  {
+    BLI_assert_unreachable();
+    return {};
+  }
+
+  uint64_t hash() const override
+  {
+    return get_default_hash(&grid.get());
+  }
+
+  bool is_equal_to(const fn::FieldNode &other) const override
+  {
+    if (const auto *other_input = dynamic_cast<const GridFieldInput *>(&other)) {
+      return &grid.get() == &other_input->grid.get();
+    }
+    return false;
+  }
+};
+
+static void gather_field_inputs(const fn::GField &field,
+                                Set<const fn::FieldNode *> &r_handled_nodes,
+                                Map<const fn::FieldNode *, fn::GField> &r_inputs)
+{
+  const fn::FieldNode &node = field.node();
+  if (!r_handled_nodes.add(&node)) {
+    return;
+  }
+  if (node.node_type() == fn::FieldNodeType::Input) {
+    r_inputs.add(&node, field);
+    return;
+  }
+  if (node.node_type() == fn::FieldNodeType::Operation) {
+    for (const fn::GField &input : static_cast<const fn::FieldOperation &>(node).inputs()) {
+      gather_field_inputs(input, r_handled_nodes, r_inputs);
+    }
+  }
+}
+
+/**
+ * Computes a grid from a field that is evaluated on the union of the active voxels and tiles of
+ * the grids it depends on.
+ */
+class FusedGridSource : public bke::volume_grid::LazyGridSource {
+ public:
+  fn::GField field;
+  /** All grids that the field depends on. Their topology is the topology of the result. */
+  Vector<bke::GVolumeGrid> grids;
+
+  FusedGridSource(fn::GField field, Vector<bke::GVolumeGrid> grids)
+      : field(std::move(field)), grids(std::move(grids))
+  {
+  }
+
+  bool depends_on_same_grids(const FusedGridSource &other) const
+  {
+    return this->depends_on_grids(other.grids) && other.depends_on_grids(grids);
+  }
+
+  bool depends_on_grids(const Span<bke::GVolumeGrid> other_grids) const
+  {
+    return std::all_of(other_grids.begin(), other_grids.end(), [&](const bke::GVolumeGrid &a) {
+      return std::any_of(grids.begin(), grids.end(), [&](const bke::GVolumeGrid &b) {
+        return &a.get() == &b.get();
+      });
+    });
+  }
+
+  bke::volume_grid::LazyLoadedGrid compute() const override
+  {
+    /* Build the procedure only once for all leaves. */
+    ResourceScope scope;
+    mf::Procedure procedure;
+    Vector<std::reference_wrapper<const fn::FieldInput>> field_inputs;
+    fn::build_procedure_for_fields(procedure, scope, {field}, field_inputs);
+    const mf::ProcedureExecutor procedure_fn{procedure};
+
+    Set<const fn::FieldNode *> handled_nodes;
+    Map<const fn::FieldNode *, fn::GField> fields_by_input;
+    gather_field_inputs(field, handled_nodes, fields_by_input);
+
+    Array<bke::SocketValueVariant> input_values(field_inputs.size());
+    Array<bke::SocketValueVariant *> input_value_ptrs(field_inputs.size());
+    for (const int i : field_inputs.index_range()) {
+      const fn::FieldInput &field_input = field_inputs[i];
+      if (const auto *grid_input = dynamic_cast<const GridFieldInput *>(&field_input)) {
+        input_values[i].set(grid_input->grid);
+      }
+      else {
+        /* Other inputs like the position are evaluated on the voxels. */
+        input_values[i].set(fields_by_input.lookup(&field_input));
+      }
+      input_value_ptrs[i] = &input_values[i];
+    }
+
+    /* Everything that can make the evaluation fail is checked when the fused grid is created, so
+     * that the error is reported on the node. The error is still kept on the grid in case
+     * something is missed there. */
+    openvdb::GridBase::Ptr grid;
+    std::string error_message;
+    if (!evaluate_multi_function_on_grids(
+            procedure_fn, input_value_ptrs, {&grid, 1}, error_message))
+    {
+      BLI_assert_unreachable();
+      return {nullptr, {}, std::move(error_message)};
+    }
+    return {std::move(grid), {}};
+  }
+};
+
+/**
+ * Get the not yet computed source of the grid, if it can be fused into the computation of another
+ * grid. Grids that are used in multiple places are better computed once.
+ */
+static std::shared_ptr<const FusedGridSource> get_fusable_source(const bke::GVolumeGrid &grid)
+{
+  if (!grid->is_mutable()) {
+    return {};
+  }
+  return std::dynamic_pointer_cast<const FusedGridSource>(grid->lazy_source());
+}
+
+static void add_grid_dependency(Vector<bke::GVolumeGrid> &grids, const bke::GVolumeGrid &grid)
+{
+  for (const bke::GVolumeGrid &other : grids) {
+    if (&other.get() == &grid.get()) {
+      return;
+    }
+  }
+  grids.append(grid);
+}
+
+bool execute_multi_function_on_value_variant__volume_grid(
+    const mf::MultiFunction &fn,
+    const std::shared_ptr<mf::MultiFunction> &owned_fn,
+    const Span<bke::SocketValueVariant *> input_values,
+    const Span<bke::SocketValueVariant *> output_values,
+    std::string &r_error_message)
+{
+  const int inputs_num = input_values.size();
+  Array<bke::GVolumeGrid> input_grids(inputs_num);
+  Array<std::shared_ptr<const FusedGridSource>> input_sources(inputs_num);
+
+  for (const int input_i : IndexRange(inputs_num)) {
+    bke::SocketValueVariant &value_variant = *input_values[input_i];
+    if (value_variant.is_volume_grid()) {
+      input_grids[input_i] = value_variant.extract<bke::GVolumeGrid>();
+      input_sources[input_i] = get_fusable_source(input_grids[input_i]);
+    }
+    else if (!value_variant.is_context_dependent_field()) {
+      value_variant.convert_to_single();
+    }
+  }
+
+  const openvdb::math::Transform *transform = nullptr;
+  for (const bke::GVolumeGrid &grid : input_grids) {
+    if (!grid) {
+      continue;
+    }
+    const openvdb::math::Transform &other_transform = grid->transform();
+    if (!transform) {
+      transform = &other_transform;
+      continue;
+    }
+    if (*transform != other_transform) {
+      r_error_message = TIP_("Input grids have incompatible transforms");
+      return false;
+    }
+  }
+  if (transform == nullptr) {
+    r_error_message = TIP_("No input grid found that can determine the topology");
+    return false;
+  }
+
+  /* Fusing only works if all fused inputs have the same topology as the result. Otherwise, the
+   * voxels that are not active in an input would not have the background value. */
+  const FusedGridSource *first_source = nullptr;
+  bool fuse_sources = true;
+  for (const int input_i : IndexRange(inputs_num)) {
+    if (const FusedGridSource *source = input_sources[input_i].get()) {
+      if (!first_source) {
+        first_source = source;
+      }
+      else if (!source->depends_on_same_grids(*first_source)) {
+        fuse_sources = false;
+      }
+      /* The transform of the computed grid may have been changed after it was created. The fused
+       * evaluation uses the grids of the source directly, so they have to match as well. */
+      for (const bke::GVolumeGrid &source_grid : source->grids) {
+        if (source_grid->transform() != *transform) {
+          fuse_sources = false;
+        }
+      }
+    }
+  }
+  for (const int input_i : IndexRange(inputs_num)) {
+    if (input_grids[input_i] && !input_sources[input_i] && first_source &&
+        !first_source->depends_on_grids({input_grids[input_i]}))
+    {
+      fuse_sources = false;
+    }
+  }
+
+  Vector<fn::GField> input_fields;
+  Vector<bke::GVolumeGrid> dependency_grids;
+  for (const int input_i : IndexRange(inputs_num)) {
+    const bke::SocketValueVariant &value_variant = *input_values[input_i];
+    const CPPType &param_type = fn.param_type(input_i).data_type().single_type();
+    if (const bke::GVolumeGrid &grid = input_grids[input_i]) {
+      if (fuse_sources && input_sources[input_i]) {
+        const FusedGridSource &source = *input_sources[input_i];
+        input_fields.append(source.field);
+        for (const bke::GVolumeGrid &source_grid : source.grids) {
+          add_grid_dependency(dependency_grids, source_grid);
+        }
+      }
+      else {
+        input_fields.append(fn::GField(std::make_shared<GridFieldInput>(param_type, grid)));
+        add_grid_dependency(dependency_grids, grid);
+      }
+    }
+    else if (value_variant.is_context_dependent_field()) {
+      input_fields.append(value_variant.get<fn::GField>());
+    }
+    else {
+      input_fields.append(fn::make_constant_field(param_type, value_variant.get_single_ptr_raw()));
+    }
+  }
+
+  std::shared_ptr<fn::FieldOperation> operation;
+  if (owned_fn) {
+    operation = fn::FieldOperation::Create(owned_fn, std::move(input_fields));
+  }
+  else {
+    operation = fn::FieldOperation::Create(fn, std::move(input_fields));
+  }
+
   for (const int i : output_values.index_range()) {
-    if (bke::SocketValueVariant *output_value = output_values[i]) {
-      output_value->set(bke::GVolumeGrid(std::move(output_grids[i])));
+    const int param_index = inputs_num + i;
+    const CPPType &cpp_type = fn.param_type(param_index).data_type().single_type();
+    const std::optional<VolumeGridType> grid_type = cpp_type_to_grid_type(cpp_type);
+    if (!grid_type) {
+      r_error_message = TIP_("Grid type not supported");
+      return false;
+    }
+    bke::SocketValueVariant *output_value = output_values[i];
+    if (!output_value) {
+      continue;
     }
+
+    /* The grid type and transform are known without computing the grid. */
+    openvdb::GridBase::Ptr meta_data_and_transform_grid;
+    BKE_volume_grid_type_to_static_type(*grid_type, [&](auto type_tag) {
+      using GridT = typename decltype(type_tag)::type;
+      meta_data_and_transform_grid = GridT::create();
+    });
+    meta_data_and_transform_grid->setTransform(transform->copy());
+
+    auto source = std::make_shared<const FusedGridSource>(fn::GField(operation, i),
+                                                          dependency_grids);
+    output_value->set(bke::GVolumeGrid(MEM_new<bke::VolumeGridData>(
+        __func__, std::move(source), std::move(meta_data_and_transform_grid))));
   }
 
   return true;
 }
 
+/** \} */
+
 #else
 
 bool execute_multi_function_on_value_variant__volume_grid(
     const mf::MultiFunction & /*fn*/,
+    const std::shared_ptr<mf::MultiFunction> & /*owned_fn*/,
     const Span<bke::SocketValueVariant *> /*input_values*/,
     const Span<bke::SocketValueVariant *> /*output_values*/,
     std::string &r_error_message)
@@ -18,7 +18,13 @@ namespace blender::nodes {
  * Execute the multi-function with the given parameters. It is assumed that at least one of the
  * inputs is a grid. Otherwise the topology of the output grids is not known.
  *
+ * The output grids are computed when they are first accessed. When they are used as input of
+ * another multi-function before that, both computations are fused, so that no intermediate grid
+ * has to be created.
+ *
  * \param fn: The multi-function to call.
+ * \param owned_fn: Owner of #fn if it is not static, because the output grids may be computed
+ *   later.
  * \param input_values: All input values which may be grids, fields or single values.
  * \param output_values: Where the output grids will be stored.
  * \param r_error_message: An error message that is set if false is returned.
@@ -27,6 +33,7 @@ namespace blender::nodes {
  */
 [[nodiscard]] bool execute_multi_function_on_value_variant__volume_grid(
     const mf::MultiFunction &fn,
+    const std::shared_ptr<mf::MultiFunction> &owned_fn,
     const Span<SocketValueVariant *> input_values,
     const Span<SocketValueVariant *> output_values,
     std::string &r_error_message);
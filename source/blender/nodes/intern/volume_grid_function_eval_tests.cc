@@ -0,0 +1,139 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#ifdef WITH_OPENVDB
+
+#  include "BKE_node_socket_value.hh"
+#  include "BKE_volume_grid.hh"
+#  include "BKE_volume_openvdb.hh"
+
+#  include "FN_multi_function_builder.hh"
+
+#  include "volume_grid_function_eval.hh"
+
+#  include <openvdb/openvdb.h>
+
+namespace blender::nodes::tests {
+
+static bke::GVolumeGrid create_test_grid()
+{
+  openvdb::FloatGrid::Ptr grid = openvdb::FloatGrid::create(0.0f);
+  openvdb::FloatGrid::Accessor accessor = grid->getAccessor();
+  for (const int i : IndexRange(1000)) {
+    accessor.setValue(openvdb::Coord(i % 10, (i / 10) % 10, i / 100), float(i) * 0.5f);
+  }
+  /* Also use a tile, which is evaluated separately from the voxels in leaf nodes. */
+  grid->tree().addTile(1, openvdb::Coord(64, 0, 0), 3.0f, true);
+  return bke::GVolumeGrid(std::move(grid));
+}
+
+/** Execute a function with two inputs and one output, like a math node does. */
+static bke::GVolumeGrid execute(const mf::MultiFunction &fn,
+                                bke::SocketValueVariant a,
+                                bke::SocketValueVariant b,
+                                std::string &r_error_message)
+{
+  bke::SocketValueVariant result;
+  Array<bke::SocketValueVariant *> inputs = {&a, &b};
+  Array<bke::SocketValueVariant *> outputs = {&result};
+  if (!execute_multi_function_on_value_variant__volume_grid(
+          fn, {}, inputs, outputs, r_error_message))
+  {
+    return {};
+  }
+  return result.extract<bke::GVolumeGrid>();
+}
+
+static bke::SocketValueVariant make_variant(bke::GVolumeGrid grid)
+{
+  bke::SocketValueVariant value;
+  value.set(std::move(grid));
+  return value;
+}
+
+static bke::SocketValueVariant make_variant(const float value)
+{
+  bke::SocketValueVariant variant;
+  variant.set(value);
+  return variant;
+}
+
+static void expect_grids_equal(const bke::GVolumeGrid &a, const bke::GVolumeGrid &b)
+{
+  bke::VolumeTreeAccessToken token_a, token_b;
+  const auto &grid_a = static_cast<const openvdb::FloatGrid &>(a->grid(token_a));
+  const auto &grid_b = static_cast<const openvdb::FloatGrid &>(b->grid(token_b));
+  EXPECT_EQ(grid_a.activeVoxelCount(), grid_b.activeVoxelCount());
+  EXPECT_EQ(grid_a.tree().activeTileCount(), grid_b.tree().activeTileCount());
+  openvdb::FloatGrid::ConstAccessor accessor_b = grid_b.getConstAccessor();
+  for (auto iter = grid_a.cbeginValueOn(); iter; ++iter) {
+    EXPECT_TRUE(accessor_b.isValueOn(iter.getCoord()));
+    EXPECT_FLOAT_EQ(*iter, accessor_b.getValue(iter.getCoord()));
+  }
+}
+
+TEST(volume_grid_function_eval, FusedEqualsUnfused)
+{
+  openvdb::initialize();
+  static auto add_fn = mf::build::SI2_SO<float, float, float>(
+      "Add", [](float a, float b) { return a + b; });
+  static auto mul_fn = mf::build::SI2_SO<float, float, float>(
+      "Multiply", [](float a, float b) { return a * b; });
+  const bke::GVolumeGrid grid = create_test_grid();
+  std::string error_message;
+
+  /* The intermediate grid is not computed, so the second function is fused into it. */
+  bke::GVolumeGrid fused = execute(add_fn, make_variant(grid), make_variant(grid), error_message);
+  ASSERT_TRUE(fused);
+  fused = execute(mul_fn, make_variant(std::move(fused)), make_variant(grid), error_message);
+  ASSERT_TRUE(fused);
+  fused = execute(add_fn, make_variant(std::move(fused)), make_variant(1.0f), error_message);
+  ASSERT_TRUE(fused);
+
+  /* Computing the intermediate grids prevents fusing. */
+  bke::VolumeTreeAccessToken token;
+  bke::GVolumeGrid unfused = execute(
+      add_fn, make_variant(grid), make_variant(grid), error_message);
+  ASSERT_TRUE(unfused);
+  unfused->grid(token);
+  EXPECT_FALSE(unfused->lazy_source());
+  unfused = execute(mul_fn, make_variant(std::move(unfused)), make_variant(grid), error_message);
+  ASSERT_TRUE(unfused);
+  unfused->grid(token);
+  unfused = execute(add_fn, make_variant(std::move(unfused)), make_variant(1.0f), error_message);
+  ASSERT_TRUE(unfused);
+
+  expect_grids_equal(fused, unfused);
+  EXPECT_TRUE(fused->error_message().empty());
+
+  bke::VolumeTreeAccessToken result_token;
+  const auto &result = static_cast<const openvdb::FloatGrid &>(fused->grid(result_token));
+  EXPECT_FLOAT_EQ(result.tree().getValue(openvdb::Coord(3, 2, 1)), 123.0f * 61.5f + 1.0f);
+  EXPECT_FLOAT_EQ(result.tree().getValue(openvdb::Coord(70, 5, 5)), 19.0f);
+}
+
+TEST(volume_grid_function_eval, FusedIncompatibleTransform)
+{
+  openvdb::initialize();
+  static auto add_fn = mf::build::SI2_SO<float, float, float>(
+      "Add", [](float a, float b) { return a + b; });
+  const bke::GVolumeGrid grid = create_test_grid();
+  std::string error_message;
+
+  bke::GVolumeGrid fused = execute(add_fn, make_variant(grid), make_variant(grid), error_message);
+  ASSERT_TRUE(fused);
+  fused.get_for_write().transform_for_write().preScale(2.0);
+
+  /* The error is reported when the function is executed, not when the grid is computed. */
+  const bke::GVolumeGrid result = execute(
+      add_fn, make_variant(std::move(fused)), make_variant(grid), error_message);
+  EXPECT_FALSE(result);
+  EXPECT_FALSE(error_message.empty());
+}
+
+}  // namespace blender::nodes::tests
+
+#endif
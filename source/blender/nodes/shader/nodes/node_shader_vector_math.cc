@@ -237,6 +237,10 @@ static const mf::MultiFunction *get_multi_function(const bNode &node)
 {
   NodeVectorMathOperation operation = NodeVectorMathOperation(node.custom1);
 
+  if (const mf::MultiFunction *fn = get_vectorized_float3_math_function(operation)) {
+    return fn;
+  }
+
   const mf::MultiFunction *multi_fn = nullptr;
 
   try_dispatch_float_math_fl3_fl3_to_fl3(
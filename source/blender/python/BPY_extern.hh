@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "BLI_span.hh"
 #include "BLI_sys_types.h"
 
 #ifdef WITH_INTERNATIONAL
@@ -95,6 +96,22 @@ float BPY_driver_exec(PathResolvedRNA *anim_rna,
                       ChannelDriver *driver_orig,
                       const AnimationEvalContext *anim_eval_context);
 
+/** A Python driver to evaluate with #BPY_driver_exec_batch. */
+struct BPy_DriverExecItem {
+  PathResolvedRNA *anim_rna;
+  ChannelDriver *driver;
+  ChannelDriver *driver_orig;
+  const AnimationEvalContext *anim_eval_context;
+  /** The value #BPY_driver_exec would return for this driver. */
+  float result;
+};
+
+/**
+ * Evaluate multiple Python drivers in order, acquiring the GIL and updating the driver
+ * name-space only once for all of them.
+ */
+void BPY_driver_exec_batch(blender::Span<BPy_DriverExecItem *> items);
+
 /**
  * Acquire the global-interpreter-lock (GIL) and wrap `Py_DECREF`.
  * as there are some cases when this needs to be called outside the Python API code.
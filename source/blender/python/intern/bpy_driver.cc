@@ -512,10 +512,12 @@ bool BPY_driver_secure_bytecode_test(PyObject *expr_code,
 }
 
 #endif /* USE_BYTECODE_WHITELIST */
-float BPY_driver_exec(PathResolvedRNA *anim_rna,
-                      ChannelDriver *driver,
-                      ChannelDriver *driver_orig,
-                      const AnimationEvalContext *anim_eval_context)
+
+/**
+ * Acquire the GIL and prepare the global name-space for evaluating drivers.
+ * Returns false (with the GIL released) when the name-space can't be created.
+ */
+static bool bpy_driver_exec_begin(PyGILState_STATE *r_gilstate)
 {
   /* (old) NOTE: PyGILState_Ensure() isn't always called because python can call
    * the bake operator which intern starts a thread which calls scene update
@@ -530,6 +532,43 @@ float BPY_driver_exec(PathResolvedRNA *anim_rna,
    * original driver, otherwise these would get freed while editing.
    * Due to the GIL this is thread-safe. */
 
+  *r_gilstate = PyGILState_Ensure();
+
+  /* Needed since drivers are updated directly after undo where `main` is re-allocated #28807. */
+  BPY_update_rna_module();
+
+  /* Initialize global dictionary for Python driver evaluation settings. */
+  if (!bpy_pydriver_Dict) {
+    if (bpy_pydriver_create_dict() != 0) {
+      fprintf(stderr, "%s: couldn't create Python dictionary\n", __func__);
+      PyGILState_Release(*r_gilstate);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Update the parts of the global name-space that only depend on the evaluation context,
+ * the GIL must be held by the caller.
+ */
+static void bpy_pydriver_namespace_update_context(const AnimationEvalContext *anim_eval_context)
+{
+  bpy_pydriver_namespace_update_frame(anim_eval_context->eval_time);
+  bpy_pydriver_namespace_update_depsgraph(anim_eval_context->depsgraph);
+}
+
+/**
+ * Evaluate a single driver expression, the GIL must be held by the caller
+ * (see #bpy_driver_exec_begin) and the name-space must be up to date with
+ * `anim_eval_context` (see #bpy_pydriver_namespace_update_context).
+ */
+static float bpy_driver_exec_with_gil(PathResolvedRNA *anim_rna,
+                                      ChannelDriver *driver,
+                                      ChannelDriver *driver_orig,
+                                      const AnimationEvalContext *anim_eval_context)
+{
   PyObject *driver_vars = nullptr;
   PyObject *retval = nullptr;
 
@@ -537,8 +576,6 @@ float BPY_driver_exec(PathResolvedRNA *anim_rna,
   PyObject *expr_vars;
 
   PyObject *expr_code;
-  PyGILState_STATE gilstate;
-  bool use_gil;
 
   DriverVar *dvar;
   double result = 0.0; /* Default return. */
@@ -567,29 +604,7 @@ float BPY_driver_exec(PathResolvedRNA *anim_rna,
   bool is_recompile = false;
 #endif
 
-  use_gil = true; /* !PyC_IsInterpreterActive(); */
-
-  if (use_gil) {
-    gilstate = PyGILState_Ensure();
-  }
-
-  /* Needed since drivers are updated directly after undo where `main` is re-allocated #28807. */
-  BPY_update_rna_module();
-
-  /* Initialize global dictionary for Python driver evaluation settings. */
-  if (!bpy_pydriver_Dict) {
-    if (bpy_pydriver_create_dict() != 0) {
-      fprintf(stderr, "%s: couldn't create Python dictionary\n", __func__);
-      if (use_gil) {
-        PyGILState_Release(gilstate);
-      }
-      return 0.0f;
-    }
-  }
-
-  /* Update global name-space. */
-  bpy_pydriver_namespace_update_frame(anim_eval_context->eval_time);
-
+  /* Update global name-space, `self` is the only driver specific item. */
   if (driver_orig->flag & DRIVER_FLAG_USE_SELF) {
     bpy_pydriver_namespace_update_self(anim_rna);
   }
@@ -597,8 +612,6 @@ float BPY_driver_exec(PathResolvedRNA *anim_rna,
     bpy_pydriver_namespace_clear_self();
   }
 
-  bpy_pydriver_namespace_update_depsgraph(anim_eval_context->depsgraph);
-
   if (driver_orig->expr_comp == nullptr) {
     driver_orig->flag |= DRIVER_FLAG_RECOMPILE;
   }
@@ -761,10 +774,6 @@ float BPY_driver_exec(PathResolvedRNA *anim_rna,
     Py_DECREF(retval);
   }
 
-  if (use_gil) {
-    PyGILState_Release(gilstate);
-  }
-
   if (UNLIKELY(!isfinite(result))) {
     fprintf(stderr, "\t%s: driver '%s' evaluates to '%f'\n", __func__, driver->expression, result);
     return 0.0f;
@@ -772,3 +781,58 @@ float BPY_driver_exec(PathResolvedRNA *anim_rna,
 
   return float(result);
 }
+
+float BPY_driver_exec(PathResolvedRNA *anim_rna,
+                      ChannelDriver *driver,
+                      ChannelDriver *driver_orig,
+                      const AnimationEvalContext *anim_eval_context)
+{
+  if (driver_orig->expression[0] == '\0') {
+    return 0.0f;
+  }
+
+  PyGILState_STATE gilstate;
+  if (!bpy_driver_exec_begin(&gilstate)) {
+    return 0.0f;
+  }
+
+  bpy_pydriver_namespace_update_context(anim_eval_context);
+  const float result = bpy_driver_exec_with_gil(anim_rna, driver, driver_orig, anim_eval_context);
+
+  PyGILState_Release(gilstate);
+
+  return result;
+}
+
+void BPY_driver_exec_batch(const blender::Span<BPy_DriverExecItem *> items)
+{
+  if (items.is_empty()) {
+    return;
+  }
+
+  PyGILState_STATE gilstate;
+  if (!bpy_driver_exec_begin(&gilstate)) {
+    for (BPy_DriverExecItem *item : items) {
+      item->result = 0.0f;
+    }
+    return;
+  }
+
+  /* The frame and depsgraph in the name-space only change when a batch mixes evaluations
+   * (e.g. multiple frames evaluated at once), otherwise they are set for the first item only. */
+  const AnimationEvalContext *anim_eval_context_prev = nullptr;
+  for (BPy_DriverExecItem *item : items) {
+    const AnimationEvalContext *anim_eval_context = item->anim_eval_context;
+    if (anim_eval_context_prev == nullptr ||
+        anim_eval_context->eval_time != anim_eval_context_prev->eval_time ||
+        anim_eval_context->depsgraph != anim_eval_context_prev->depsgraph)
+    {
+      bpy_pydriver_namespace_update_context(anim_eval_context);
+      anim_eval_context_prev = anim_eval_context;
+    }
+    item->result = bpy_driver_exec_with_gil(
+        item->anim_rna, item->driver, item->driver_orig, item->anim_eval_context);
+  }
+
+  PyGILState_Release(gilstate);
+}
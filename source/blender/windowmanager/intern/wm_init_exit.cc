@@ -109,6 +109,8 @@
 
 #include "COM_compositor.hh"
 
+#include "NOD_geometry_nodes_benchmark.hh"
+
 #include "DEG_depsgraph.hh"
 #include "DEG_depsgraph_query.hh"
 
@@ -227,6 +229,8 @@ void WM_init(bContext *C, int argc, const char **argv)
 
   ED_node_init_butfuncs();
 
+  blender::nodes::geometry_nodes_benchmark_command_register();
+
   BLF_init();
 
   BLT_lang_init();
@@ -0,0 +1,67 @@
+# SPDX-FileCopyrightText: 2025 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+
+
+def _run(args):
+    import bpy
+    import time
+
+    # Build the scene procedurally so the benchmark doesn't depend on any file: a subdivided
+    # cloth grid draped over a sphere collider, optionally with self collision.
+    bpy.ops.object.select_all(action='SELECT')
+    bpy.ops.object.delete(use_global=False)
+
+    bpy.ops.mesh.primitive_uv_sphere_add(segments=64, ring_count=32, radius=1.0)
+    bpy.context.object.modifiers.new("Collision", 'COLLISION')
+
+    bpy.ops.mesh.primitive_grid_add(
+        x_subdivisions=args['resolution'], y_subdivisions=args['resolution'], size=4.0, location=(0.0, 0.0, 1.5))
+    cloth = bpy.context.object.modifiers.new("Cloth", 'CLOTH')
+    cloth.collision_settings.use_self_collision = args['self_collision']
+
+    scene = bpy.context.scene
+    scene.frame_start = 1
+    scene.frame_end = args['frames']
+    cloth.point_cache.frame_start = scene.frame_start
+    cloth.point_cache.frame_end = scene.frame_end
+
+    scene.frame_set(scene.frame_start)
+
+    start_time = time.time()
+    for frame in range(scene.frame_start + 1, scene.frame_end + 1):
+        scene.frame_set(frame)
+    elapsed_time = time.time() - start_time
+
+    result = {'time': elapsed_time / (scene.frame_end - scene.frame_start)}
+    return result
+
+
+class ClothTest(api.Test):
+    def __init__(self, resolution, self_collision):
+        self.resolution = resolution
+        self.self_collision = self_collision
+
+    def name(self):
+        suffix = "_self_collision" if self.self_collision else ""
+        return f"grid_{self.resolution}{suffix}"
+
+    def category(self):
+        return "cloth"
+
+    def run(self, env, device_id):
+        args = {
+            'resolution': self.resolution,
+            'self_collision': self.self_collision,
+            'frames': 30,
+        }
+        result, _ = env.run_in_blender(_run, args)
+        return result
+
+
+def generate(env):
+    return [ClothTest(resolution, self_collision)
+            for resolution in (100, 200)
+            for self_collision in (False, True)]
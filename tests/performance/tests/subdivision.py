@@ -0,0 +1,60 @@
+# SPDX-FileCopyrightText: 2025 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+
+
+def _run(args):
+    import bpy
+    import time
+
+    # Measure the CPU evaluator, also when a GPU is available.
+    bpy.context.preferences.system.use_gpu_subdivision = False
+
+    objects = []
+    for ob in bpy.context.scene.objects:
+        subsurf_modifiers = [md for md in ob.modifiers if md.type == 'SUBSURF']
+        for md in subsurf_modifiers:
+            md.levels = args['level']
+        if subsurf_modifiers:
+            objects.append(ob)
+
+    depsgraph = bpy.context.evaluated_depsgraph_get()
+
+    start_time = time.time()
+    elapsed_time = 0.0
+    num_evaluations = 0
+
+    while elapsed_time < 10.0 or num_evaluations < 3:
+        for ob in objects:
+            ob.update_tag(refresh={'DATA'})
+        depsgraph.update()
+
+        num_evaluations += 1
+        elapsed_time = time.time() - start_time
+
+    result = {'time': elapsed_time / num_evaluations}
+    return result
+
+
+class SubdivisionTest(api.Test):
+    def __init__(self, filepath, level):
+        self.filepath = filepath
+        self.level = level
+
+    def name(self):
+        return f"{self.filepath.stem}_level_{self.level}"
+
+    def category(self):
+        return "subdivision"
+
+    def run(self, env, device_id):
+        args = {'level': self.level}
+        result, _ = env.run_in_blender(_run, args, [self.filepath])
+        return result
+
+
+def generate(env):
+    filepaths = env.find_blend_files('subdivision/*')
+    return [SubdivisionTest(filepath, level) for filepath in filepaths for level in range(1, 5)]